@@ -560,6 +560,45 @@ template<class T, typename U, proc_ch_t channels = DynamicChannelCount>
 concept AudioBufferView = SampleType<U> && (std::convertible_to<T, InterleavedBufferView<U, channels>>
 	|| std::convertible_to<T, PlanarBufferView<U, channels>>);
 
+
+//! Copies an interleaved buffer into a planar buffer with the same channel count and at least as many frames
+template<SampleType T, proc_ch_t channelCount>
+constexpr void deinterleave(InterleavedBufferView<const T, channelCount> src,
+	PlanarBufferView<T, channelCount> dst) noexcept
+{
+	assert(src.channels() == dst.channels());
+	assert(src.frames() <= dst.frames());
+
+	for (proc_ch_t channel = 0; channel < src.channels(); ++channel)
+	{
+		T* out = dst.bufferPtr(channel);
+		const T* in = src.data() + channel;
+		for (f_cnt_t frame = 0; frame < src.frames(); ++frame)
+		{
+			out[frame] = in[frame * src.channels()];
+		}
+	}
+}
+
+//! Copies a planar buffer into an interleaved buffer with the same channel count and at least as many frames
+template<SampleType T, proc_ch_t channelCount>
+constexpr void interleave(PlanarBufferView<const T, channelCount> src,
+	InterleavedBufferView<T, channelCount> dst) noexcept
+{
+	assert(src.channels() == dst.channels());
+	assert(src.frames() <= dst.frames());
+
+	for (proc_ch_t channel = 0; channel < src.channels(); ++channel)
+	{
+		const T* in = src.bufferPtr(channel);
+		T* out = dst.data() + channel;
+		for (f_cnt_t frame = 0; frame < src.frames(); ++frame)
+		{
+			out[frame * src.channels()] = in[frame];
+		}
+	}
+}
+
 } // namespace lmms
 
 #endif // LMMS_AUDIO_BUFFER_VIEW_H
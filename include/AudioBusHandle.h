@@ -26,6 +26,7 @@
 #ifndef LMMS_AUDIO_BUS_HANDLE_H
 #define LMMS_AUDIO_BUS_HANDLE_H
 
+#include <atomic>
 #include <memory>
 #include <QString>
 #include <QMutex>
@@ -38,6 +39,7 @@ namespace lmms
 class EffectChain;
 class FloatModel;
 class BoolModel;
+class MixerChannel;
 
 /**
 	@brief Job between @ref PlayHandle and @ref MixerChannel
@@ -82,7 +84,16 @@ public:
 	void addPlayHandle(PlayHandle* handle);
 	void removePlayHandle(PlayHandle* handle);
 
+	// job graph stuff, see AudioEngine::renderStageGraph()
+	void prepareJob();
+	void addInput() { ++m_pendingInputs; }
+	//! Called when an input is done, queues this job after the last one
+	void inputProcessed();
+
 private:
+	//! Lets the mixer channel fed by this handle know that we are done
+	void notifyMixerChannel();
+
 	volatile bool m_bufferUsage;
 
 	SampleFrame* const m_buffer;
@@ -101,6 +112,10 @@ private:
 	FloatModel* m_panningModel;
 	BoolModel* m_mutedModel;
 
+	std::atomic_int m_pendingInputs;
+	//! The mixer channel waiting for this job in the current period, if any
+	MixerChannel* m_jobMixerChannel;
+
 	friend class AudioEngine;
 	friend class AudioEngineWorkerThread;
 };
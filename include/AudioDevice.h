@@ -92,6 +92,10 @@ protected:
 	// called by according driver for fetching new sound-data
 	fpp_t getNextBuffer(SampleFrame* _ab);
 
+	// like getNextBuffer(), but points _ab to the audio engine's buffer
+	// instead of copying it. It stays valid until the next call.
+	fpp_t readNextBuffer(const SampleFrame*& _ab);
+
 	// convert a given audio-buffer to a buffer in signed 16-bit samples
 	// returns num of bytes in outbuf
 	int convertToS16(const SampleFrame* _ab,
@@ -133,7 +137,6 @@ private:
 
 	QMutex m_devMutex;
 
-	SampleFrame* m_buffer;
 
 };
 
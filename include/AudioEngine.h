@@ -37,8 +37,8 @@
 #include "LmmsTypes.h"
 #include "SampleFrame.h"
 #include "LocklessList.h"
-#include "FifoBuffer.h"
 #include "AudioEngineProfiler.h"
+#include "PeriodRing.h"
 #include "PlayHandle.h"
 
 
@@ -46,6 +46,7 @@ namespace lmms
 {
 
 class MidiClient;
+class StemExporter;
 class AudioBusHandle;  // IWYU pragma: keep
 class AudioEngineWorkerThread;
 
@@ -182,6 +183,9 @@ public:
 
 	void removeAudioBusHandle(AudioBusHandle* busHandle);
 
+	//! Set the exporter that captures the stems of every rendered period, or nullptr
+	void setStemExporter(StemExporter* exporter);
+
 
 	// MIDI-client-stuff
 	inline const QString & midiClientName() const
@@ -295,9 +299,16 @@ public:
 		return m_inputBufferFrames[ m_inputBufferRead ];
 	}
 
+	//! The returned buffer stays valid until the next call
 	inline const SampleFrame* nextBuffer()
 	{
-		return hasFifoWriter() ? m_fifo->read() : renderNextBuffer();
+		return hasFifoWriter() ? m_periodRing->read() : renderNextBuffer();
+	}
+
+	//! The periods rendered ahead for the audio device, e.g. for their fill level and underruns
+	const PeriodRing& periodRing() const
+	{
+		return *m_periodRing;
 	}
 
 	void changeQuality(const struct qualitySettings & qs);
@@ -322,28 +333,24 @@ signals:
 
 
 private:
-	using Fifo = FifoBuffer<SampleFrame*>;
-
 	class fifoWriter : public QThread
 	{
 	public:
-		fifoWriter( AudioEngine * audioEngine, Fifo * fifo );
+		fifoWriter( AudioEngine * audioEngine, PeriodRing * ring );
 
 		void finish();
 
 
 	private:
 		AudioEngine * m_audioEngine;
-		Fifo * m_fifo;
+		PeriodRing * m_ring;
 		volatile bool m_writing;
 
 		void run() override;
-
-		void write(SampleFrame* buffer);
 	} ;
 
 
-	AudioEngine( bool renderOnly );
+	AudioEngine( bool renderOnly, fpp_t framesPerPeriod );
 	~AudioEngine() override;
 
 	void startProcessing(bool needsFifo = true);
@@ -354,10 +361,11 @@ private:
 	MidiClient * tryMidiClients();
 
 	void renderStageNoteSetup();
-	void renderStageInstruments();
-	void renderStageEffects();
+	void renderStageGraph();
 	void renderStageMix();
 
+	void removeFinishedPlayHandles();
+
 	const SampleFrame* renderNextBuffer();
 
 	void swapBuffers();
@@ -405,8 +413,10 @@ private:
 	MidiClient * m_midiClient;
 	QString m_midiClientName;
 
+	StemExporter* m_stemExporter;
+
 	// FIFO stuff
-	Fifo * m_fifo;
+	std::unique_ptr<PeriodRing> m_periodRing;
 	fifoWriter * m_fifoWriter;
 
 	AudioEngineProfiler m_profiler;
@@ -417,6 +427,7 @@ private:
 
 	friend class Engine;
 	friend class AudioEngineWorkerThread;
+	friend class EngineBenchmark;
 	friend class ProjectRenderer;
 } ;
 
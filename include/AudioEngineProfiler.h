@@ -27,7 +27,14 @@
 
 #include <array>
 #include <atomic>
-#include <QFile>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <QHash>
+#include <QString>
 
 #include "LmmsTypes.h"
 #include "MicroTimer.h"
@@ -39,11 +46,13 @@ class AudioEngineProfiler
 {
 public:
 	AudioEngineProfiler();
-	~AudioEngineProfiler() = default;
+	~AudioEngineProfiler();
 
 	void startPeriod()
 	{
 		m_periodTimer.reset();
+		m_detailTime.fill(0);
+		m_periodStart = now();
 	}
 
 	void finishPeriod( sample_rate_t sampleRate, fpp_t framesPerPeriod );
@@ -53,6 +62,9 @@ public:
 		return m_cpuLoad;
 	}
 
+	//! Writes the time of each period to @p outputFile. If the file name ends
+	//! with ".json", a Chrome trace (also readable by Perfetto) containing
+	//! every processed job is written instead.
 	void setOutputFile( const QString& outputFile );
 
 	enum class DetailType {
@@ -70,16 +82,49 @@ public:
 		return m_detailLoad[static_cast<std::size_t>(type)].load(std::memory_order_relaxed);
 	}
 
+	//! Time spent on @p type in the last period, in microseconds, without averaging.
+	//! Only valid on the rendering thread, between two periods.
+	int detailTime(const DetailType type) const
+	{
+		return m_detailTime[static_cast<std::size_t>(type)];
+	}
+
+	//! Averaged load of a single track or mixer channel
+	struct NodeLoad
+	{
+		QString name;
+		//! CPU time spent per period, relative to the period length, in percent
+		std::array<float, DetailCount> load{};
+
+		float totalLoad() const;
+	};
+
+	//! Returns the nodes with the highest load, sorted by load.
+	//! Must not be called from the rendering threads.
+	std::vector<NodeLoad> nodeLoads(std::size_t maxCount) const;
+
+	//! Sets the name shown for the track or mixer channel @p node. Must be
+	//! called whenever the name changes, as the profiler never reads the
+	//! names of the nodes themselves.
+	void setNodeName(const void* node, const QString& name);
+	//! Forgets the name of @p node, must be called before it's deleted
+	void removeNode(const void* node);
+
 	class Probe
 	{
 	public:
 		Probe(AudioEngineProfiler& profiler, AudioEngineProfiler::DetailType type)
 			: m_profiler(profiler)
 			, m_type(type)
+			, m_start(now())
 		{
 			profiler.startDetail(type);
 		}
-		~Probe() { m_profiler.finishDetail(m_type); }
+		~Probe()
+		{
+			m_profiler.finishDetail(m_type);
+			m_profiler.recordEvent(nullptr, m_type, m_start, now());
+		}
 		Probe& operator=(const Probe&) = delete;
 		Probe(const Probe&) = delete;
 		Probe(Probe&&) = delete;
@@ -87,23 +132,162 @@ public:
 	private:
 		AudioEngineProfiler &m_profiler;
 		const AudioEngineProfiler::DetailType m_type;
+		const std::int64_t m_start;
+	};
+
+	//! Measures the processing time of a single job of the job graph.
+	//! Can be used from any thread. @p node identifies the track or mixer
+	//! channel the job belongs to, its name is set with setNodeName().
+	class JobProbe
+	{
+	public:
+		JobProbe(AudioEngineProfiler& profiler, AudioEngineProfiler::DetailType type,
+				const void* node = nullptr)
+			: m_profiler(profiler)
+			, m_type(type)
+			, m_node(node)
+			, m_start(now())
+		{
+		}
+		~JobProbe()
+		{
+			const auto end = now();
+			m_profiler.addJobTime(m_type, static_cast<int>(end - m_start));
+			m_profiler.recordEvent(m_node, m_type, m_start, end);
+		}
+		JobProbe& operator=(const JobProbe&) = delete;
+		JobProbe(const JobProbe&) = delete;
+		JobProbe(JobProbe&&) = delete;
+
+	private:
+		AudioEngineProfiler &m_profiler;
+		const AudioEngineProfiler::DetailType m_type;
+		const void* m_node;
+		const std::int64_t m_start;
 	};
 
+	//! Usage of the NotePlayHandle pool
+	struct NotePoolUsage
+	{
+		int used;
+		int highWaterMark;
+		int capacity;
+		//! notes which could not be played because the pool was exhausted
+		int dropped;
+	};
+
+	NotePoolUsage notePoolUsage() const;
+
+	//! Splits the wall-clock time the job graph took between the detail types,
+	//! in proportion to the processing time their jobs accumulated
+	void distributeJobTime(int graphTime);
+
 private:
+	struct Event
+	{
+		const void* node;
+		DetailType type;
+		int thread;
+		std::int64_t start;
+		int duration;
+	};
+
+	class Writer;
+
+	//! Names of the nodes, only written by the threads owning the nodes and
+	//! read by the threads showing or writing them
+	class NodeNames
+	{
+	public:
+		void set(const void* node, const QString& name);
+		void remove(const void* node);
+		QString name(const void* node) const;
+
+	private:
+		mutable std::mutex m_mutex;
+		QHash<const void*, QString> m_names;
+	};
+
+	//! Wait-free single-producer/single-consumer event buffer. Each thread
+	//! recording events owns one, the rendering thread drains all of them
+	//! at the end of each period.
+	class EventRing
+	{
+	public:
+		static constexpr std::size_t Size = 1024;
+
+		bool push(const Event& event);
+		bool pop(Event& event);
+
+	private:
+		std::array<Event, Size> m_events;
+		std::atomic_size_t m_writeIndex = 0;
+		std::atomic_size_t m_readIndex = 0;
+	};
+
+	struct NodeEntry
+	{
+		const void* node = nullptr;
+		std::array<int, DetailCount> time{};
+		std::array<float, DetailCount> load{};
+	};
+
+	static std::int64_t now()
+	{
+		using namespace std::chrono;
+		return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	void recordEvent(const void* node, DetailType type, std::int64_t start, std::int64_t end);
+	int threadIndex();
+	EventRing* threadRing();
+	void drainEvents();
+	NodeEntry* findNode(const void* node);
+	void updateNodeLoads(std::uint64_t timeLimit);
+	void updateNotePoolUsage();
+
+	void addJobTime(const DetailType type, int time)
+	{
+		m_jobTime[static_cast<std::size_t>(type)].fetch_add(time, std::memory_order_relaxed);
+	}
+
 	void startDetail(const DetailType type) { m_detailTimer[static_cast<std::size_t>(type)].reset(); }
 	void finishDetail(const DetailType type)
 	{
-		m_detailTime[static_cast<std::size_t>(type)] = m_detailTimer[static_cast<std::size_t>(type)].elapsed();
+		m_detailTime[static_cast<std::size_t>(type)] += m_detailTimer[static_cast<std::size_t>(type)].elapsed();
 	}
 
 	MicroTimer m_periodTimer;
+	std::int64_t m_periodStart;
 	std::atomic<float> m_cpuLoad;
-	QFile m_outputFile;
+	//! declared before m_writer, which uses it until it's destroyed
+	NodeNames m_nodeNames;
+	//! Formats the output and writes it to the output file on its own thread
+	std::unique_ptr<Writer> m_writer;
+	bool m_writeTrace;
+	int m_droppedNotes;
 
 	// Use arrays to avoid dynamic allocations in realtime code
 	std::array<MicroTimer, DetailCount> m_detailTimer;
 	std::array<int, DetailCount> m_detailTime{0};
 	std::array<std::atomic<float>, DetailCount> m_detailLoad{0};
+	std::array<std::atomic_int, DetailCount> m_jobTime{0};
+
+	// one event ring per thread, assigned on the first event of each thread
+	std::vector<std::unique_ptr<EventRing>> m_eventRings;
+	std::atomic_int m_numThreads;
+	//! distinguishes the thread indices of this profiler from those of
+	//! previous ones
+	const unsigned m_generation;
+
+	// open addressing hash table of per-node loads, only accessed by the
+	// rendering thread - m_publishedNodes is the copy shown to other threads
+	std::vector<NodeEntry> m_nodes;
+	std::vector<NodeEntry> m_rehashNodes;
+	std::size_t m_numNodes;
+	//! published without names, nodeLoads() looks them up
+	std::vector<std::pair<const void*, std::array<float, DetailCount>>> m_publishedNodes;
+	mutable std::mutex m_publishMutex;
 };
 
 } // namespace lmms
@@ -27,9 +27,13 @@
 
 #include <QThread>
 
+#include <array>
 #include <atomic>
-
-class QWaitCondition;
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace lmms
 {
@@ -42,6 +46,12 @@ class AudioEngineWorkerThread : public QThread
 	Q_OBJECT
 public:
 	// internal representation of the job queue - all functions are thread-safe
+	//
+	// Every thread taking part in processing (the worker threads plus the
+	// rendering thread, which acts as the last worker, see InlineWorker)
+	// owns a deque. Jobs are pushed to and popped from the bottom of the
+	// calling thread's own deque; idle threads steal from the top of the
+	// other deques.
 	class JobQueue
 	{
 	public:
@@ -51,34 +61,86 @@ public:
 			Dynamic	// jobs can be added while processing queue
 		} ;
 
+		//! Capacity of each per-thread deque, must be a power of two
 		static constexpr size_t JOB_QUEUE_SIZE = 8192;
 
+		//! Bounded Chase-Lev deque. push() and pop() may only be called by
+		//! the owning thread, steal() by any thread.
+		class Deque
+		{
+		public:
+			Deque();
+
+			bool push(ThreadableJob* job);
+			ThreadableJob* pop();
+			ThreadableJob* steal();
+
+		private:
+			static constexpr std::int64_t Mask = JOB_QUEUE_SIZE - 1;
+
+			alignas(64) std::atomic<std::int64_t> m_top;
+			alignas(64) std::atomic<std::int64_t> m_bottom;
+			std::array<std::atomic<ThreadableJob*>, JOB_QUEUE_SIZE> m_items;
+		} ;
+
 		JobQueue() :
-			m_items(),
-			m_writeIndex( 0 ),
-			m_itemsDone( 0 ),
-			m_opMode( OperationMode::Static )
+			m_deques(),
+			m_itemsQueued( 0 ),
+			m_itemsDone( 0 )
 		{
-			std::fill(m_items, m_items + JOB_QUEUE_SIZE, nullptr);
 		}
 
+		//! Creates a new deque and returns its slot index. Must be called
+		//! before any worker thread is started.
+		int addSlot();
+
+		//! Removes all deques. Must only be called while no worker thread
+		//! is running.
+		void clearSlots();
+
+		// the operation mode is kept for API compatibility - jobs added while
+		// processing are always picked up by the work-stealing loop
 		void reset( OperationMode _opMode );
 
-		void addJob( ThreadableJob * _job );
+		//! Returns false if the job didn't require processing
+		bool addJob( ThreadableJob * _job );
 
-		void run();
-		void wait();
+		//! Processes at most one job, preferring the deque of @p slot and
+		//! stealing from the others otherwise. Returns whether a job was run.
+		bool runOne( int slot );
+
+		//! Helps processing until all queued jobs are done
+		void run( int slot );
+
+		bool isDone() const
+		{
+			return m_itemsDone.load() >= m_itemsQueued.load();
+		}
 
 	private:
-		std::atomic<ThreadableJob*> m_items[JOB_QUEUE_SIZE];
-		std::atomic_size_t m_writeIndex;
+		std::vector<std::unique_ptr<Deque>> m_deques;
+		std::atomic_size_t m_itemsQueued;
 		std::atomic_size_t m_itemsDone;
-		OperationMode m_opMode;
 	} ;
 
+	//! Number of idle iterations a worker busy-waits before parking
+	static constexpr int DEFAULT_SPIN_COUNT = 2000;
+
+	//! Makes the calling thread the worker which is processed "inline" for
+	//! as long as the object lives, so it may add jobs and call
+	//! startAndWaitForJobs(). Only one thread may do so at a time.
+	class InlineWorker
+	{
+	public:
+		InlineWorker();
+		~InlineWorker();
+
+		InlineWorker(const InlineWorker&) = delete;
+		InlineWorker& operator=(const InlineWorker&) = delete;
+	} ;
 
 	AudioEngineWorkerThread( AudioEngine* audioEngine );
-	~AudioEngineWorkerThread() override;
+	~AudioEngineWorkerThread() override = default;
 
 	virtual void quit();
 
@@ -88,9 +150,9 @@ public:
 		globalJobQueue.reset( _opMode );
 	}
 
-	static void addJob( ThreadableJob * _job )
+	static bool addJob( ThreadableJob * _job )
 	{
-		globalJobQueue.addJob( _job );
+		return globalJobQueue.addJob( _job );
 	}
 
 	// a convenient helper function allowing to pass a container with pointers
@@ -108,15 +170,33 @@ public:
 
 	static void startAndWaitForJobs();
 
+	//! Wakes parked worker threads, if there are any
+	static void wakeWorkers();
+
+	//! Removes the deques of all workers, called once they are finished
+	static void removeWorkers()
+	{
+		globalJobQueue.clearSlots();
+	}
+
 
 private:
 	void run() override;
 
+	void park( std::uint64_t generation );
+	void pinToCore();
+
 	static JobQueue globalJobQueue;
-	static QWaitCondition * queueReadyWaitCond;
-	static QList<AudioEngineWorkerThread *> workerThreads;
 
-	volatile bool m_quit;
+	static std::mutex s_parkMutex;
+	static std::condition_variable s_parkCond;
+	static std::atomic<std::uint64_t> s_wakeGeneration;
+	static std::atomic_int s_parkedWorkers;
+
+	const int m_slot;
+	int m_spinCount;
+	bool m_pinToCore;
+	std::atomic_bool m_quit;
 } ;
 
 } // namespace lmms
@@ -49,6 +49,12 @@ public:
 
 	OutputSettings const & getOutputSettings() const { return m_outputSettings; }
 
+	//! Encodes frames that don't come from the audio engine, e.g. a stem of the song
+	void write(const SampleFrame* buf, const fpp_t frames)
+	{
+		writeBuffer(buf, frames);
+	}
+
 
 protected:
 	int writeData( const void* data, int len );
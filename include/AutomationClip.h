@@ -31,6 +31,7 @@
 #include <QPointer>
 
 #include "AutomationNode.h"
+#include "AutomationSchedule.h"
 #include "Clip.h"
 
 
@@ -197,7 +198,11 @@ public:
 		return new AutomationClip(*this);
 	}
 
-	void clearObjects() { m_objects.clear(); }
+	void clearObjects()
+	{
+		m_objects.clear();
+		AutomationSchedule::invalidate();
+	}
 
 public slots:
 	void clear();
@@ -0,0 +1,156 @@
+/*
+ * AutomationSchedule.h - precompiled automation timeline of the song
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUTOMATION_SCHEDULE_H
+#define LMMS_AUTOMATION_SCHEDULE_H
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include <QPointer>
+
+#include "AutomatableModel.h"
+#include "LmmsTypes.h"
+#include "TimePos.h"
+
+namespace lmms
+{
+
+class AutomationClip;
+class Clip;
+class Track;
+
+
+/**
+	@brief Automation timeline compiled from the clips of the song
+
+	Instead of collecting all automation clips into a freshly allocated
+	AutomatedValueMap on every tick, the schedule keeps, for every automated
+	model, the clips which may automate it sorted by start position together
+	with a playback cursor. A tick then only advances the cursors and
+	evaluates one clip per model, and models whose value did not change are
+	not touched at all.
+
+	Which clips automate which models is compiled once and recompiled
+	lazily after invalidate() was called, i.e. when clips or tracks were
+	added, removed or moved, or when the objects of an automation clip
+	changed. Things that can change while playing without affecting the
+	structure (muting, automation points, offsets and lengths) are evaluated
+	on every tick, so the result is the same as the one of
+	TrackContainer::automatedValuesAt().
+*/
+class LMMS_EXPORT AutomationSchedule
+{
+public:
+	//! Marks all schedules as outdated, can be called from any thread
+	static void invalidate()
+	{
+		s_generation.fetch_add(1, std::memory_order_release);
+	}
+
+	//! Applies the automation of the song at @p time. If @p patternIndex
+	//! is not negative, the pattern with this index is played on its own
+	//! as in the pattern editor.
+	void process(TimePos time, int patternIndex = -1);
+
+	//! Gives control of all currently automated models back to their
+	//! controllers, e.g. when playback stops
+	void releaseModels();
+
+	//! Forgets about all models without touching them
+	void clear();
+
+private:
+	//! A clip on a song track which may automate a model
+	struct Segment
+	{
+		tick_t start;
+		Track* track;
+		Clip* clip;
+		//! index of the played pattern, or -1 for automation clips
+		int pattern;
+	} ;
+
+	//! An automation clip in the pattern store which automates a model
+	struct PatternCandidate
+	{
+		int pattern;
+		Track* track;
+		AutomationClip* clip;
+	} ;
+
+	struct Target
+	{
+		QPointer<AutomatableModel> model;
+		std::vector<Segment> segments;
+		//! sorted by pattern, then by track order
+		std::vector<PatternCandidate> patternCandidates;
+		//! number of segments starting at or before the last processed time
+		std::size_t cursor = 0;
+		//! whether the model was automated during the last tick
+		bool automated = false;
+		//! set while a clip records the model
+		bool recording = false;
+		float lastValue = 0;
+		//! the value of the model right after it was last automated, used
+		//! to notice changes made by the user or by other code
+		float appliedValue = 0;
+	} ;
+
+	struct RecordingClip
+	{
+		AutomationClip* clip;
+		//! whether the clip is located in the pattern store
+		bool inPattern;
+		//! target of the first object of the clip, or -1
+		int target;
+	} ;
+
+	void compile();
+	Target& targetFor(AutomatableModel* model);
+	void addSongTrack(Track* track);
+	void addPatternStoreTrack(Track* track);
+
+	void processRecording(TimePos time, bool patternMode);
+	bool valueAt(Target& target, TimePos time, float& value);
+	bool patternValueAt(const Target& target, int pattern, TimePos patTime, float& value) const;
+	void apply(Target& target, bool automated, float value);
+
+	static std::atomic<unsigned> s_generation;
+	unsigned m_generation = 0;
+	bool m_compiled = false;
+
+	std::vector<Target> m_targets;
+	std::vector<RecordingClip> m_recordingClips;
+	std::unordered_map<const AutomatableModel*, std::size_t> m_targetIndex;
+	//! targets of the previous compilation, to keep the state of models
+	//! which are still automated afterwards
+	std::vector<Target> m_previousTargets;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_AUTOMATION_SCHEDULE_H
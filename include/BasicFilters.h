@@ -35,9 +35,15 @@
 #include <array>
 #include <cmath>
 #include <numbers>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "lmms_constants.h"
 #include "LmmsTypes.h"
+#include "SampleFrame.h"
 
 
 namespace lmms
@@ -259,34 +265,51 @@ public:
 		return( 0.01f );
 	}
 
+	//! Time constant of the cutoff and resonance smoothing in process(), in seconds
+	static constexpr float SmoothingTime = 0.001f;
+
 	inline void setFilterType( const FilterType _idx )
 	{
+		const FilterType oldType = m_type;
+		const bool wasDoubleFilter = m_doubleFilter;
+
 		m_doubleFilter = _idx == FilterType::DoubleLowPass || _idx == FilterType::DoubleMoog;
 		if( !m_doubleFilter )
 		{
 			m_type = _idx;
-			return;
+		}
+		else
+		{
+			// Double lowpass mode, backwards-compat for the goofy
+			// Add-NumFilters to signify doubleFilter stuff
+			m_type = _idx == FilterType::DoubleLowPass
+				? FilterType::LowPass
+				: FilterType::Moog;
+			if( m_subFilter == nullptr )
+			{
+				m_subFilter = new BasicFilters<CHANNELS>(
+							static_cast<sample_rate_t>(
+								m_sampleRate ) );
+			}
+			m_subFilter->m_type = m_type;
 		}
 
-		// Double lowpass mode, backwards-compat for the goofy
-		// Add-NumFilters to signify doubleFilter stuff
-		m_type = _idx == FilterType::DoubleLowPass 
-			? FilterType::LowPass
-			: FilterType::Moog;
-		if( m_subFilter == nullptr )
+		// the coefficients of the new type have to be calculated by process()
+		if (m_type != oldType || m_doubleFilter != wasDoubleFilter)
 		{
-			m_subFilter = new BasicFilters<CHANNELS>(
-						static_cast<sample_rate_t>(
-							m_sampleRate ) );
+			m_coeffsValid = false;
 		}
-		m_subFilter->m_type = m_type;
 	}
 
 	inline BasicFilters( const sample_rate_t _sample_rate ) :
+		m_type( FilterType::LowPass ),
 		m_doubleFilter( false ),
 		m_sampleRate( (float) _sample_rate ),
 		m_sampleRatio( 1.0f / m_sampleRate ),
-		m_subFilter( nullptr )
+		m_subFilter( nullptr ),
+		m_coeffsValid( false ),
+		m_smoothingStarted( false ),
+		m_smoothing( smoothingCoeff( m_sampleRate ) )
 	{
 		clearHistory();
 	}
@@ -331,6 +354,8 @@ public:
 	{
 		m_sampleRate = sampleRate;
 		m_sampleRatio = 1.f / m_sampleRate;
+		m_smoothing = smoothingCoeff(m_sampleRate);
+		m_coeffsValid = false;
 		if (m_subFilter != nullptr)
 		{
 			m_subFilter->setSampleRate(m_sampleRate);
@@ -339,372 +364,48 @@ public:
 
 	inline sample_t update( sample_t _in0, ch_cnt_t _chnl )
 	{
-		sample_t out = 0.0f;
-		switch( m_type )
-		{
-			case FilterType::Moog:
-			{
-				sample_t x = _in0 - m_r*m_y4[_chnl];
-
-				// four cascaded onepole filters
-				// (bilinear transform)
-				m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
-							- m_k * m_y1[_chnl], -10.0f,
-								10.0f);
-				m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
-							- m_k * m_y2[_chnl], -10.0f,
-								10.0f);
-				m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
-							- m_k * m_y3[_chnl], -10.0f,
-								10.0f );
-				m_y4[_chnl] = std::clamp((m_y3[_chnl] + m_oldy3[_chnl]) * m_p
-							- m_k * m_y4[_chnl], -10.0f,
-								10.0f);
-
-				m_oldx[_chnl] = x;
-				m_oldy1[_chnl] = m_y1[_chnl];
-				m_oldy2[_chnl] = m_y2[_chnl];
-				m_oldy3[_chnl] = m_y3[_chnl];
-				out = m_y4[_chnl] - m_y4[_chnl] * m_y4[_chnl] *
-						m_y4[_chnl] * ( 1.0f / 6.0f );
-				break;
-			}
-			
-			// 3x onepole filters with 4x oversampling and interpolation of oversampled signal:
-			// input signal is linear-interpolated after oversampling, output signal is averaged from oversampled outputs
-			case FilterType::Tripole:
-			{
-				float ip = 0.0f;
-				for( int i = 0; i < 4; ++i )
-				{
-					ip += 0.25f;
-					sample_t x = std::lerp(m_last[_chnl], _in0, ip) - m_r * m_y3[_chnl];
-					
-					m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
-							- m_k * m_y1[_chnl], -10.0f,
-								10.0f);
-					m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
-								- m_k * m_y2[_chnl], -10.0f,
-									10.0f);
-					m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
-								- m_k * m_y3[_chnl], -10.0f,
-									10.0f);
-					m_oldx[_chnl] = x;
-					m_oldy1[_chnl] = m_y1[_chnl];
-					m_oldy2[_chnl] = m_y2[_chnl];
-					
-					out += ( m_y3[_chnl] - m_y3[_chnl] * m_y3[_chnl] * m_y3[_chnl] * ( 1.0f / 6.0f ) );
-				}
-				out *= 0.25f;
-				m_last[_chnl] = _in0;
-				return out;
-			}
-			
-			// 4-pole state-variant lowpass filter, adapted from Nekobee source code
-			// and extended to other SV filter types
-			// /* Hal Chamberlin's state variable filter */
-			
-			case FilterType::Lowpass_SV:
-			case FilterType::Bandpass_SV:
-			{
-				float highpass;
-				
-				for( int i = 0; i < 2; ++i ) // 2x oversample
-				{
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
-					highpass = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * highpass + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
-
-					m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
-					highpass = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
-					m_delay3[_chnl] = m_svf2 * highpass + m_delay3[_chnl];
-				}
-
-				/* mix filter output into output buffer */
-				return m_type == FilterType::Lowpass_SV 
-					? m_delay4[_chnl]
-					: m_delay3[_chnl];
-			}
-			
-			case FilterType::Highpass_SV:
-			{
-				float hp;
-				for( int i = 0; i < 2; ++i ) // 2x oversample
-				{				
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];
-					hp = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * hp + m_delay1[_chnl];
-				}
-				
-				return hp;
-			}
-			
-			case FilterType::Notch_SV:
-			{
-				float hp1;
-				for( int i = 0; i < 2; ++i ) // 2x oversample
-				{
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
-					hp1 = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * hp1 + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
-
-					m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
-					float hp2 = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
-					m_delay3[_chnl] = m_svf2 * hp2 + m_delay3[_chnl];
-				}
-
-				/* mix filter output into output buffer */
-				return m_delay4[_chnl] + hp1;
-			}
-
-
-			// 4-times oversampled simulation of an active RC-Bandpass,-Lowpass,-Highpass-
-			// Filter-Network as it was used in nearly all modern analog synthesizers. This
-			// can be driven up to self-oscillation (BTW: do not remove the limits!!!).
-			// (C) 1998 ... 2009 S.Fendt. Released under the GPL v2.0  or any later version.
+		return dispatch([&](auto type) { return tick<decltype(type)::value>(_in0, _chnl); });
+	}
 
-			case FilterType::Lowpass_RC12:
-			{
-				sample_t lp = 0.0f;
-				for( int n = 4; n != 0; --n )
-				{
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
-					lp = std::clamp(lp, -1.0f, 1.0f);
-
-					sample_t hp = m_rcc * (m_rchp0[_chnl] + in - m_rclast0[_chnl]);
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_rclast0[_chnl] = in;
-					m_rclp0[_chnl] = lp;
-					m_rchp0[_chnl] = hp;
-					m_rcbp0[_chnl] = bp;
-				}
-				return lp;
-			}
-			case FilterType::Highpass_RC12:
-			case FilterType::Bandpass_RC12:
+	//! Filters @p frames frames of @p buf in place. Cutoff and resonance move
+	//! towards @p freq and @p q sample by sample, so changing them between calls
+	//! doesn't cause zipper noise. The coefficients are only recalculated while
+	//! they are moving.
+	void process(SampleFrame* buf, fpp_t frames, float freq, float q)
+	{
+		static_assert(CHANNELS == DEFAULT_CHANNELS, "Block processing is only available for stereo filters");
+		dispatch([&](auto type) {
+			fpp_t frame = 0;
+			for (; frame < frames && !smoothCoeffs(freq, q); ++frame)
 			{
-				sample_t hp, bp;
-				for( int n = 4; n != 0; --n )
-				{
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_rclast0[_chnl] = in;
-					m_rchp0[_chnl] = hp;
-					m_rcbp0[_chnl] = bp;
-				}
-				return m_type == FilterType::Highpass_RC12 ? hp : bp;
+				run<decltype(type)::value>(buf + frame, 1);
 			}
+			run<decltype(type)::value>(buf + frame, frames - frame);
+		});
+	}
 
-			case FilterType::Lowpass_RC24:
+	//! Same as above, with a cutoff and resonance target for every frame,
+	//! e.g. from an envelope or LFO
+	void process(SampleFrame* buf, fpp_t frames, const float* freq, const float* q)
+	{
+		static_assert(CHANNELS == DEFAULT_CHANNELS, "Block processing is only available for stereo filters");
+		dispatch([&](auto type) {
+			for (fpp_t frame = 0; frame < frames; ++frame)
 			{
-				sample_t lp;
-				for( int n = 4; n != 0; --n )
-				{
-					// first stage is as for the 12dB case...
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
-					lp = std::clamp(lp, -1.0f, 1.0f);
-
-					sample_t hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_rclast0[_chnl] = in;
-					m_rclp0[_chnl] = lp;
-					m_rcbp0[_chnl] = bp;
-					m_rchp0[_chnl] = hp;
-
-					// second stage gets the output of the first stage as input...
-					in = lp + m_rcbp1[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f );
-
-					lp = in * m_rcb + m_rclp1[_chnl] * m_rca;
-					lp = std::clamp(lp, -1.0f, 1.0f);
-
-					hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_rclast1[_chnl] = in;
-					m_rclp1[_chnl] = lp;
-					m_rcbp1[_chnl] = bp;
-					m_rchp1[_chnl] = hp;
-				}
-				return lp;
+				smoothCoeffs(freq[frame], q[frame]);
+				run<decltype(type)::value>(buf + frame, 1);
 			}
-			case FilterType::Highpass_RC24:
-			case FilterType::Bandpass_RC24:
-			{
-				sample_t hp, bp;
-				for( int n = 4; n != 0; --n )
-				{
-					// first stage is as for the 12dB case...
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_rclast0[_chnl] = in;
-					m_rchp0[_chnl] = hp;
-					m_rcbp0[_chnl] = bp;
-
-					// second stage gets the output of the first stage as input...
-					in = m_type == FilterType::Highpass_RC24
-						? hp + m_rcbp1[_chnl] * m_rcq
-						: bp + m_rcbp1[_chnl] * m_rcq;
-
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_rclast1[_chnl] = in;
-					m_rchp1[_chnl] = hp;
-					m_rcbp1[_chnl] = bp;
-				}
-				return m_type == FilterType::Highpass_RC24 ? hp : bp;
-			}
-
-			case FilterType::Formantfilter:
-			case FilterType::FastFormant:
-			{
-				if (std::abs(_in0) < F_EPSILON && std::abs(m_vflast[0][_chnl]) < F_EPSILON) { return 0.0f; } // performance hack - skip processing when the numbers get too small
-
-				const int os = m_type == FilterType::FastFormant ? 1 : 4; // no oversampling for fast formant
-				for( int o = 0; o < os; ++o )
-				{
-					// first formant
-					sample_t in = _in0 + m_vfbp[0][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					sample_t hp = m_vfc[0] * ( m_vfhp[0][_chnl] + in - m_vflast[0][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					sample_t bp = hp * m_vfb[0] + m_vfbp[0][_chnl] * m_vfa[0];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[0][_chnl] = in;
-					m_vfhp[0][_chnl] = hp;
-					m_vfbp[0][_chnl] = bp;
-
-					in = bp + m_vfbp[2][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[0] * ( m_vfhp[2][_chnl] + in - m_vflast[2][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[0] + m_vfbp[2][_chnl] * m_vfa[0];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[2][_chnl] = in;
-					m_vfhp[2][_chnl] = hp;
-					m_vfbp[2][_chnl] = bp;
-
-					in = bp + m_vfbp[4][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[0] * ( m_vfhp[4][_chnl] + in - m_vflast[4][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[0] + m_vfbp[4][_chnl] * m_vfa[0];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[4][_chnl] = in;
-					m_vfhp[4][_chnl] = hp;
-					m_vfbp[4][_chnl] = bp;
-
-					out += bp;
-
-					// second formant
-					in = _in0 + m_vfbp[0][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[1] * ( m_vfhp[1][_chnl] + in - m_vflast[1][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[1] + m_vfbp[1][_chnl] * m_vfa[1];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[1][_chnl] = in;
-					m_vfhp[1][_chnl] = hp;
-					m_vfbp[1][_chnl] = bp;
-
-					in = bp + m_vfbp[3][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[1] * ( m_vfhp[3][_chnl] + in - m_vflast[3][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[1] + m_vfbp[3][_chnl] * m_vfa[1];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[3][_chnl] = in;
-					m_vfhp[3][_chnl] = hp;
-					m_vfbp[3][_chnl] = bp;
-
-					in = bp + m_vfbp[5][_chnl] * m_vfq;
-					in = std::clamp(in, -1.0f, 1.0f);
-
-					hp = m_vfc[1] * ( m_vfhp[5][_chnl] + in - m_vflast[5][_chnl] );
-					hp = std::clamp(hp, -1.0f, 1.0f);
-
-					bp = hp * m_vfb[1] + m_vfbp[5][_chnl] * m_vfa[1];
-					bp = std::clamp(bp, -1.0f, 1.0f);
-
-					m_vflast[5][_chnl] = in;
-					m_vfhp[5][_chnl] = hp;
-					m_vfbp[5][_chnl] = bp;
-
-					out += bp;
-				}
-            	return m_type == FilterType::FastFormant ? out * 2.0f : out * 0.5f;
-			}
-
-			default:
-				out = m_biQuad.update( _in0, _chnl );
-				break;
-		}
-
-		if( m_doubleFilter )
-		{
-			return m_subFilter->update( out, _chnl );
-		}
-
-		// Clipper band limited sigmoid
-		return out;
+		});
 	}
 
 
 	inline void calcFilterCoeffs( float _freq, float _q )
 	{
 		using namespace std::numbers;
+		m_coeffFreq = _freq;
+		m_coeffQ = _q;
+		m_coeffsValid = true;
+
 		// temp coef vars
 		_q = std::max(_q, minQ());
 
@@ -870,6 +571,519 @@ public:
 
 
 private:
+	//! Filters a single sample with the kernel of @p type, which has to match m_type
+	template<FilterType type>
+	inline sample_t tick( sample_t _in0, ch_cnt_t _chnl )
+	{
+		sample_t out = 0.0f;
+		if constexpr (type == FilterType::Moog)
+		{
+			sample_t x = _in0 - m_r*m_y4[_chnl];
+
+			// four cascaded onepole filters
+			// (bilinear transform)
+			m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
+						- m_k * m_y1[_chnl], -10.0f,
+							10.0f);
+			m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
+						- m_k * m_y2[_chnl], -10.0f,
+							10.0f);
+			m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
+						- m_k * m_y3[_chnl], -10.0f,
+							10.0f );
+			m_y4[_chnl] = std::clamp((m_y3[_chnl] + m_oldy3[_chnl]) * m_p
+						- m_k * m_y4[_chnl], -10.0f,
+							10.0f);
+
+			m_oldx[_chnl] = x;
+			m_oldy1[_chnl] = m_y1[_chnl];
+			m_oldy2[_chnl] = m_y2[_chnl];
+			m_oldy3[_chnl] = m_y3[_chnl];
+			out = m_y4[_chnl] - m_y4[_chnl] * m_y4[_chnl] *
+					m_y4[_chnl] * ( 1.0f / 6.0f );
+		}
+		
+		// 3x onepole filters with 4x oversampling and interpolation of oversampled signal:
+		// input signal is linear-interpolated after oversampling, output signal is averaged from oversampled outputs
+		else if constexpr (type == FilterType::Tripole)
+		{
+			float ip = 0.0f;
+			for( int i = 0; i < 4; ++i )
+			{
+				ip += 0.25f;
+				sample_t x = std::lerp(m_last[_chnl], _in0, ip) - m_r * m_y3[_chnl];
+				
+				m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
+						- m_k * m_y1[_chnl], -10.0f,
+							10.0f);
+				m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
+							- m_k * m_y2[_chnl], -10.0f,
+								10.0f);
+				m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
+							- m_k * m_y3[_chnl], -10.0f,
+								10.0f);
+				m_oldx[_chnl] = x;
+				m_oldy1[_chnl] = m_y1[_chnl];
+				m_oldy2[_chnl] = m_y2[_chnl];
+				
+				out += ( m_y3[_chnl] - m_y3[_chnl] * m_y3[_chnl] * m_y3[_chnl] * ( 1.0f / 6.0f ) );
+			}
+			out *= 0.25f;
+			m_last[_chnl] = _in0;
+			return out;
+		}
+		
+		// 4-pole state-variant lowpass filter, adapted from Nekobee source code
+		// and extended to other SV filter types
+		// /* Hal Chamberlin's state variable filter */
+		
+		else if constexpr (type == FilterType::Lowpass_SV || type == FilterType::Bandpass_SV)
+		{
+			float highpass;
+			
+			for( int i = 0; i < 2; ++i ) // 2x oversample
+			{
+				m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
+				highpass = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
+				m_delay1[_chnl] = m_svf1 * highpass + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
+
+				m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
+				highpass = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
+				m_delay3[_chnl] = m_svf2 * highpass + m_delay3[_chnl];
+			}
+
+			/* mix filter output into output buffer */
+			return type == FilterType::Lowpass_SV 
+				? m_delay4[_chnl]
+				: m_delay3[_chnl];
+		}
+		
+		else if constexpr (type == FilterType::Highpass_SV)
+		{
+			float hp;
+			for( int i = 0; i < 2; ++i ) // 2x oversample
+			{				
+				m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];
+				hp = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
+				m_delay1[_chnl] = m_svf1 * hp + m_delay1[_chnl];
+			}
+			
+			return hp;
+		}
+		
+		else if constexpr (type == FilterType::Notch_SV)
+		{
+			float hp1;
+			for( int i = 0; i < 2; ++i ) // 2x oversample
+			{
+				m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
+				hp1 = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
+				m_delay1[_chnl] = m_svf1 * hp1 + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
+
+				m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
+				float hp2 = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
+				m_delay3[_chnl] = m_svf2 * hp2 + m_delay3[_chnl];
+			}
+
+			/* mix filter output into output buffer */
+			return m_delay4[_chnl] + hp1;
+		}
+
+
+		// 4-times oversampled simulation of an active RC-Bandpass,-Lowpass,-Highpass-
+		// Filter-Network as it was used in nearly all modern analog synthesizers. This
+		// can be driven up to self-oscillation (BTW: do not remove the limits!!!).
+		// (C) 1998 ... 2009 S.Fendt. Released under the GPL v2.0  or any later version.
+
+		else if constexpr (type == FilterType::Lowpass_RC12)
+		{
+			sample_t lp = 0.0f;
+			for( int n = 4; n != 0; --n )
+			{
+				sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
+				lp = std::clamp(lp, -1.0f, 1.0f);
+
+				sample_t hp = m_rcc * (m_rchp0[_chnl] + in - m_rclast0[_chnl]);
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_rclast0[_chnl] = in;
+				m_rclp0[_chnl] = lp;
+				m_rchp0[_chnl] = hp;
+				m_rcbp0[_chnl] = bp;
+			}
+			return lp;
+		}
+		else if constexpr (type == FilterType::Highpass_RC12 || type == FilterType::Bandpass_RC12)
+		{
+			sample_t hp, bp;
+			for( int n = 4; n != 0; --n )
+			{
+				sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_rclast0[_chnl] = in;
+				m_rchp0[_chnl] = hp;
+				m_rcbp0[_chnl] = bp;
+			}
+			return type == FilterType::Highpass_RC12 ? hp : bp;
+		}
+
+		else if constexpr (type == FilterType::Lowpass_RC24)
+		{
+			sample_t lp;
+			for( int n = 4; n != 0; --n )
+			{
+				// first stage is as for the 12dB case...
+				sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
+				lp = std::clamp(lp, -1.0f, 1.0f);
+
+				sample_t hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_rclast0[_chnl] = in;
+				m_rclp0[_chnl] = lp;
+				m_rcbp0[_chnl] = bp;
+				m_rchp0[_chnl] = hp;
+
+				// second stage gets the output of the first stage as input...
+				in = lp + m_rcbp1[_chnl] * m_rcq;
+				in = std::clamp(in, -1.0f, 1.0f );
+
+				lp = in * m_rcb + m_rclp1[_chnl] * m_rca;
+				lp = std::clamp(lp, -1.0f, 1.0f);
+
+				hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_rclast1[_chnl] = in;
+				m_rclp1[_chnl] = lp;
+				m_rcbp1[_chnl] = bp;
+				m_rchp1[_chnl] = hp;
+			}
+			return lp;
+		}
+		else if constexpr (type == FilterType::Highpass_RC24 || type == FilterType::Bandpass_RC24)
+		{
+			sample_t hp, bp;
+			for( int n = 4; n != 0; --n )
+			{
+				// first stage is as for the 12dB case...
+				sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_rclast0[_chnl] = in;
+				m_rchp0[_chnl] = hp;
+				m_rcbp0[_chnl] = bp;
+
+				// second stage gets the output of the first stage as input...
+				in = type == FilterType::Highpass_RC24
+					? hp + m_rcbp1[_chnl] * m_rcq
+					: bp + m_rcbp1[_chnl] * m_rcq;
+
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_rclast1[_chnl] = in;
+				m_rchp1[_chnl] = hp;
+				m_rcbp1[_chnl] = bp;
+			}
+			return type == FilterType::Highpass_RC24 ? hp : bp;
+		}
+
+		else if constexpr (type == FilterType::Formantfilter || type == FilterType::FastFormant)
+		{
+			if (std::abs(_in0) < F_EPSILON && std::abs(m_vflast[0][_chnl]) < F_EPSILON) { return 0.0f; } // performance hack - skip processing when the numbers get too small
+
+			const int os = type == FilterType::FastFormant ? 1 : 4; // no oversampling for fast formant
+			for( int o = 0; o < os; ++o )
+			{
+				// first formant
+				sample_t in = _in0 + m_vfbp[0][_chnl] * m_vfq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				sample_t hp = m_vfc[0] * ( m_vfhp[0][_chnl] + in - m_vflast[0][_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				sample_t bp = hp * m_vfb[0] + m_vfbp[0][_chnl] * m_vfa[0];
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_vflast[0][_chnl] = in;
+				m_vfhp[0][_chnl] = hp;
+				m_vfbp[0][_chnl] = bp;
+
+				in = bp + m_vfbp[2][_chnl] * m_vfq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_vfc[0] * ( m_vfhp[2][_chnl] + in - m_vflast[2][_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_vfb[0] + m_vfbp[2][_chnl] * m_vfa[0];
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_vflast[2][_chnl] = in;
+				m_vfhp[2][_chnl] = hp;
+				m_vfbp[2][_chnl] = bp;
+
+				in = bp + m_vfbp[4][_chnl] * m_vfq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_vfc[0] * ( m_vfhp[4][_chnl] + in - m_vflast[4][_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_vfb[0] + m_vfbp[4][_chnl] * m_vfa[0];
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_vflast[4][_chnl] = in;
+				m_vfhp[4][_chnl] = hp;
+				m_vfbp[4][_chnl] = bp;
+
+				out += bp;
+
+				// second formant
+				in = _in0 + m_vfbp[0][_chnl] * m_vfq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_vfc[1] * ( m_vfhp[1][_chnl] + in - m_vflast[1][_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_vfb[1] + m_vfbp[1][_chnl] * m_vfa[1];
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_vflast[1][_chnl] = in;
+				m_vfhp[1][_chnl] = hp;
+				m_vfbp[1][_chnl] = bp;
+
+				in = bp + m_vfbp[3][_chnl] * m_vfq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_vfc[1] * ( m_vfhp[3][_chnl] + in - m_vflast[3][_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_vfb[1] + m_vfbp[3][_chnl] * m_vfa[1];
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_vflast[3][_chnl] = in;
+				m_vfhp[3][_chnl] = hp;
+				m_vfbp[3][_chnl] = bp;
+
+				in = bp + m_vfbp[5][_chnl] * m_vfq;
+				in = std::clamp(in, -1.0f, 1.0f);
+
+				hp = m_vfc[1] * ( m_vfhp[5][_chnl] + in - m_vflast[5][_chnl] );
+				hp = std::clamp(hp, -1.0f, 1.0f);
+
+				bp = hp * m_vfb[1] + m_vfbp[5][_chnl] * m_vfa[1];
+				bp = std::clamp(bp, -1.0f, 1.0f);
+
+				m_vflast[5][_chnl] = in;
+				m_vfhp[5][_chnl] = hp;
+				m_vfbp[5][_chnl] = bp;
+
+				out += bp;
+			}
+			return type == FilterType::FastFormant ? out * 2.0f : out * 0.5f;
+		}
+		else
+		{
+			out = m_biQuad.update( _in0, _chnl );
+		}
+
+		if( m_doubleFilter )
+		{
+			return m_subFilter->template tick<type>( out, _chnl );
+		}
+
+		// Clipper band limited sigmoid
+		return out;
+	}
+
+	//! Smoothed values closer to their target than this (relative to the
+	//! target, but at least 1) are set to the target
+	static constexpr float SmoothingThreshold = 1e-5f;
+
+	//! Calls @p func with the type of the filter as std::integral_constant, so
+	//! the kernel is selected once instead of for every sample
+	template<typename Func>
+	inline auto dispatch(Func&& func)
+	{
+		using T = FilterType;
+		switch (m_type)
+		{
+			case T::HiPass: return func(std::integral_constant<T, T::HiPass>{});
+			case T::BandPass_CSG: return func(std::integral_constant<T, T::BandPass_CSG>{});
+			case T::BandPass_CZPG: return func(std::integral_constant<T, T::BandPass_CZPG>{});
+			case T::Notch: return func(std::integral_constant<T, T::Notch>{});
+			case T::AllPass: return func(std::integral_constant<T, T::AllPass>{});
+			case T::Moog: return func(std::integral_constant<T, T::Moog>{});
+			case T::Lowpass_RC12: return func(std::integral_constant<T, T::Lowpass_RC12>{});
+			case T::Bandpass_RC12: return func(std::integral_constant<T, T::Bandpass_RC12>{});
+			case T::Highpass_RC12: return func(std::integral_constant<T, T::Highpass_RC12>{});
+			case T::Lowpass_RC24: return func(std::integral_constant<T, T::Lowpass_RC24>{});
+			case T::Bandpass_RC24: return func(std::integral_constant<T, T::Bandpass_RC24>{});
+			case T::Highpass_RC24: return func(std::integral_constant<T, T::Highpass_RC24>{});
+			case T::Formantfilter: return func(std::integral_constant<T, T::Formantfilter>{});
+			case T::Lowpass_SV: return func(std::integral_constant<T, T::Lowpass_SV>{});
+			case T::Bandpass_SV: return func(std::integral_constant<T, T::Bandpass_SV>{});
+			case T::Highpass_SV: return func(std::integral_constant<T, T::Highpass_SV>{});
+			case T::Notch_SV: return func(std::integral_constant<T, T::Notch_SV>{});
+			case T::FastFormant: return func(std::integral_constant<T, T::FastFormant>{});
+			case T::Tripole: return func(std::integral_constant<T, T::Tripole>{});
+			// m_type is never one of the double filters, see setFilterType()
+			default: return func(std::integral_constant<T, T::LowPass>{});
+		}
+	}
+
+	static constexpr bool usesBiQuad(FilterType type)
+	{
+		return type == FilterType::LowPass || type == FilterType::HiPass
+			|| type == FilterType::BandPass_CSG || type == FilterType::BandPass_CZPG
+			|| type == FilterType::Notch || type == FilterType::AllPass;
+	}
+
+	//! Moves the smoothed cutoff and resonance one sample towards their targets
+	//! and recalculates the coefficients if needed. Returns whether both targets
+	//! have been reached.
+	inline bool smoothCoeffs(float freq, float q)
+	{
+		if (!m_smoothingStarted)
+		{
+			// nothing to smooth from for the first samples of a filter
+			m_freq = freq;
+			m_q = q;
+			m_smoothingStarted = true;
+		}
+
+		const bool freqReached = smooth(m_freq, freq);
+		const bool qReached = smooth(m_q, q);
+		if (!m_coeffsValid || m_freq != m_coeffFreq || m_q != m_coeffQ)
+		{
+			calcFilterCoeffs(m_freq, m_q);
+		}
+		return freqReached && qReached;
+	}
+
+	static inline float smoothingCoeff(float sampleRate)
+	{
+		return 1.0f - std::exp(-1.0f / (SmoothingTime * sampleRate));
+	}
+
+	inline bool smooth(float& value, float target) const
+	{
+		const float diff = target - value;
+		if (std::abs(diff) <= SmoothingThreshold * std::max(std::abs(target), 1.0f))
+		{
+			value = target;
+			return true;
+		}
+		value += diff * m_smoothing;
+		return false;
+	}
+
+	//! Filters both channels of @p frames frames with the current coefficients.
+	//! The biquad kernel processes the channels in the lanes of an SSE register.
+	//! The other kernels are bound by the latency of their feedback loops
+	//! rather than by the number of instructions, so they process the channels
+	//! one after the other.
+	template<FilterType type>
+	inline void run(SampleFrame* buf, fpp_t frames)
+	{
+#ifdef __SSE2__
+		if constexpr (usesBiQuad(type))
+		{
+			return m_doubleFilter ? runBiQuad<true>(buf, frames) : runBiQuad<false>(buf, frames);
+		}
+#endif
+		for (fpp_t frame = 0; frame < frames; ++frame)
+		{
+			buf[frame][0] = tick<type>(buf[frame][0], 0);
+			buf[frame][1] = tick<type>(buf[frame][1], 1);
+		}
+	}
+
+#ifdef __SSE2__
+	static inline __m128 loadLanes(const float* channels)
+	{
+		return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(channels));
+	}
+
+	static inline void storeLanes(float* channels, __m128 lanes)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64*>(channels), lanes);
+	}
+
+	//! Same operations as BiQuad::update(), for both channels at once
+	template<bool Double>
+	inline void runBiQuad(SampleFrame* buf, fpp_t frames)
+	{
+		BiQuad<CHANNELS>& first = m_biQuad;
+		BiQuad<CHANNELS>& second = Double ? m_subFilter->m_biQuad : m_biQuad;
+
+		const __m128 a1 = _mm_set1_ps(first.m_a1);
+		const __m128 a2 = _mm_set1_ps(first.m_a2);
+		const __m128 b0 = _mm_set1_ps(first.m_b0);
+		const __m128 b1 = _mm_set1_ps(first.m_b1);
+		const __m128 b2 = _mm_set1_ps(first.m_b2);
+
+		const auto update = [&](__m128 in, __m128& z1, __m128& z2) {
+			const __m128 out = _mm_add_ps(z1, _mm_mul_ps(b0, in));
+			z1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1, in), z2), _mm_mul_ps(a1, out));
+			z2 = _mm_sub_ps(_mm_mul_ps(b2, in), _mm_mul_ps(a2, out));
+			return out;
+		};
+
+		__m128 z1 = loadLanes(first.m_z1);
+		__m128 z2 = loadLanes(first.m_z2);
+		__m128 z3 = loadLanes(second.m_z1);
+		__m128 z4 = loadLanes(second.m_z2);
+		for (fpp_t frame = 0; frame < frames; ++frame)
+		{
+			__m128 out = update(loadLanes(buf[frame].data()), z1, z2);
+			if constexpr (Double) { out = update(out, z3, z4); }
+			storeLanes(buf[frame].data(), out);
+		}
+
+		storeLanes(first.m_z1, z1);
+		storeLanes(first.m_z2, z2);
+		if constexpr (Double)
+		{
+			storeLanes(second.m_z1, z3);
+			storeLanes(second.m_z2, z4);
+		}
+	}
+#endif
+
 	// biquad filter
 	BiQuad<CHANNELS> m_biQuad;
 
@@ -909,6 +1123,14 @@ private:
 	float m_sampleRatio;
 	BasicFilters<CHANNELS> * m_subFilter;
 
+	// cutoff and resonance smoothed by process(), and the values the
+	// coefficients were calculated for the last time
+	float m_freq, m_q;
+	float m_coeffFreq, m_coeffQ;
+	bool m_coeffsValid;
+	bool m_smoothingStarted;
+	float m_smoothing;
+
 } ;
 
 
@@ -0,0 +1,134 @@
+/*
+ * BinaryDataFile.h - binary container for DataFile with memory-mapped
+ *                    sample chunks
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_BINARY_DATA_FILE_H
+#define LMMS_BINARY_DATA_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include "lmms_export.h"
+
+class QDomDocument;
+class QDomElement;
+class QIODevice;
+
+namespace lmms
+{
+
+/**
+ * @brief Binary alternative to the XML project format (*.mmpb).
+ *
+ * The settings tree is stored as a compact node list with interned strings,
+ * embedded samples as raw, 64 byte aligned chunks. When loading, the file is
+ * memory-mapped and the sample attributes of the DOM only get a short
+ * reference to their chunk, see findChunk(). The chunks are read from the
+ * mapped pages when the sample is created, so they are never held as base64
+ * text in memory.
+ *
+ * Layout (little endian):
+ * - header: magic, format version, reserved
+ * - chunks, each one aligned to ChunkAlignment bytes
+ * - node list, string table, chunk table (offset and size of each chunk)
+ * - footer: offsets of node list, string table and chunk table, number of
+ *   chunks, and the magic once more
+ */
+class LMMS_EXPORT BinaryDataFile
+{
+public:
+	static constexpr std::size_t MagicSize = 8;
+	static constexpr std::size_t ChunkAlignment = 64;
+
+	//! A raw chunk, valid as long as @p owner is held
+	struct Chunk
+	{
+		const char* data = nullptr;
+		std::size_t size = 0;
+		std::shared_ptr<const BinaryDataFile> owner;
+
+		explicit operator bool() const { return owner != nullptr; }
+	};
+
+	~BinaryDataFile();
+
+	//! Checks whether @p data starts with the magic of a binary file
+	static bool isBinary(const QByteArray& data);
+
+	//! Maps @p fileName and fills @p doc with its tree. Returns nullptr on error.
+	//! The returned object must be kept alive as long as the chunks referenced
+	//! by @p doc are needed.
+	static std::shared_ptr<const BinaryDataFile> read(const QString& fileName, QDomDocument& doc,
+		QString* errorMsg = nullptr);
+	static std::shared_ptr<const BinaryDataFile> read(const QByteArray& data, QDomDocument& doc,
+		QString* errorMsg = nullptr);
+
+	//! Writes @p doc to @p device. Embedded samples and chunk references are
+	//! written as raw chunks, one at a time.
+	static bool write(const QDomDocument& doc, QIODevice& device);
+
+	static bool isChunkReference(const QString& value);
+
+	//! Resolves a chunk reference created by read(), returns an invalid
+	//! chunk if @p reference is none or its file has been closed
+	static Chunk findChunk(const QString& reference);
+
+	//! Replaces all chunk references below @p elem with base64 text, so that
+	//! the tree can be written as XML
+	static void inlineChunks(QDomElement elem);
+
+private:
+	BinaryDataFile() = default;
+
+	static std::shared_ptr<const BinaryDataFile> load(std::shared_ptr<BinaryDataFile> file, QDomDocument& doc,
+		QString* errorMsg);
+	bool parse(QDomDocument& doc, QString* errorMsg);
+	QString chunkReference(std::size_t index) const;
+	//! Copies @p data to memory aligned like the chunks of a mapped file
+	void copy(const char* data, qint64 size);
+
+	struct AlignedDelete
+	{
+		void operator()(char* p) const { ::operator delete[](p, std::align_val_t{ChunkAlignment}); }
+	};
+
+	QFile m_file;
+	//! the contents if the file couldn't be mapped or was read from memory
+	std::unique_ptr<char[], AlignedDelete> m_copy;
+	const char* m_data = nullptr;
+	qint64 m_size = 0;
+	int m_id = 0;
+	//! offset and size of each chunk
+	std::vector<std::pair<quint64, quint64>> m_chunks;
+};
+
+} // namespace lmms
+
+#endif // LMMS_BINARY_DATA_FILE_H
@@ -26,14 +26,32 @@
 #ifndef LMMS_BUFFER_MANAGER_H
 #define LMMS_BUFFER_MANAGER_H
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
 #include "lmms_export.h"
 #include "LmmsTypes.h"
 
 namespace lmms
 {
 
+class LocklessAllocator;
 class SampleFrame;
 
+/**
+	@brief Pool of period-sized audio buffers
+
+	The buffers are taken from a cache-line aligned LocklessAllocator sized
+	in init() from the period size, so acquiring and releasing buffers while
+	rendering doesn't touch the heap. Each thread keeps a small magazine of
+	free buffers, so most calls don't touch the shared pool either.
+
+	If the pool is exhausted, buffers are allocated on the heap instead.
+	These fallback allocations are counted, so tests and the profiler can
+	check that rendering does not allocate.
+*/
 class LMMS_EXPORT BufferManager
 {
 public:
@@ -41,8 +59,34 @@ public:
 	static SampleFrame* acquire();
 	static void release( SampleFrame* buf );
 
+	//! Number of buffers in the pool
+	static std::size_t capacity();
+	//! Number of buffers allocated on the heap because the pool was
+	//! exhausted, since the start of the program
+	static std::size_t heapAllocations()
+	{
+		return s_heapAllocations.load(std::memory_order_relaxed);
+	}
+	//! Number of heap allocated buffers which are still in use
+	static std::size_t heapBuffersInUse()
+	{
+		return s_heapBuffersInUse.load(std::memory_order_relaxed);
+	}
+
 private:
+	class Magazine;
+
+	static Magazine& threadMagazine();
+	static SampleFrame* allocateFromHeap();
+
 	static fpp_t s_framesPerPeriod;
+	static std::unique_ptr<LocklessAllocator> s_pool;
+	//! pools replaced by init(), kept as their buffers may still be in use
+	static std::vector<std::unique_ptr<LocklessAllocator>> s_retiredPools;
+	//! changed by every init(), so magazines return buffers to an old pool
+	static std::atomic_uint s_generation;
+	static std::atomic_size_t s_heapAllocations;
+	static std::atomic_size_t s_heapBuffersInUse;
 };
 
 
@@ -56,6 +56,8 @@ protected slots:
 
 
 private:
+	static constexpr std::size_t MaxNodesInToolTip = 5;
+
 	int stepSize() const { return std::max(1, m_stepSize); }
 
 	int m_currentLoad;
@@ -0,0 +1,82 @@
+/*
+ * ClipIntervalIndex.h - position-ordered index of the clips of a track
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_CLIP_INTERVAL_INDEX_H
+#define LMMS_CLIP_INTERVAL_INDEX_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "LmmsTypes.h"
+
+namespace lmms
+{
+
+class Clip;
+
+/**
+	@brief Interval index over the clips of a @ref Track
+
+	Keeps the clips ordered by start position, together with a segment tree
+	of their end positions, so all clips intersecting a range can be found in
+	O(log n + k) instead of scanning every clip of the track.
+
+	The index is invalidated whenever a clip is added, removed, moved or
+	resized and rebuilt on the next query.
+*/
+class ClipIntervalIndex
+{
+public:
+	void invalidate()
+	{
+		m_dirty.store(true, std::memory_order_release);
+	}
+
+	//! Appends all clips in @p clips intersecting [@p start, @p end] to @p result,
+	//! keeping @p result sorted by start position
+	void findInRange(const std::vector<Clip*>& clips, std::vector<Clip*>& result,
+		tick_t start, tick_t end);
+
+private:
+	void rebuild(const std::vector<Clip*>& clips);
+	void collect(std::size_t node, std::size_t begin, std::size_t end, std::size_t limit,
+		tick_t start, std::vector<Clip*>& result) const;
+
+	//! clips sorted by start position
+	std::vector<Clip*> m_sorted;
+	//! start positions of m_sorted at the time of the last rebuild
+	std::vector<tick_t> m_starts;
+	//! segment tree with the maximum end position of each subtree, the
+	//! leaves start at index m_leaves
+	std::vector<tick_t> m_maxEnds;
+	std::size_t m_leaves = 0;
+
+	std::atomic_bool m_dirty = true;
+	std::mutex m_mutex;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_CLIP_INTERVAL_INDEX_H
@@ -27,6 +27,7 @@
 #define LMMS_DATA_FILE_H
 
 #include <map>
+#include <memory>
 #include <QDomDocument>
 #include <vector>
 
@@ -37,6 +38,7 @@ class QTextStream;
 namespace lmms
 {
 
+class BinaryDataFile;
 class ProjectVersion;
 
 
@@ -99,6 +101,7 @@ private:
 	static Type type( const QString& typeName );
 	static QString typeName( Type type );
 
+	void cleanMetaNodes();
 	void cleanMetaNodes( QDomElement de );
 
 	void mapSrcAttributeInElementsWithResources(const QMap<QString, QString>& map);
@@ -148,12 +151,17 @@ private:
 	void upgrade();
 
 	void loadData( const QByteArray & _data, const QString & _sourceFile );
+	void loadBinary(std::shared_ptr<const BinaryDataFile> file, const QString& errorMsg, const QString& sourceFile);
+	void loadContent(const QString& sourceFile);
+	void showLoadError(const QString& sourceFile);
 
 	QString m_fileName; //!< The origin file name or "" if this DataFile didn't originate from a file
 	QDomElement m_content;
 	QDomElement m_head;
 	Type m_type;
 	unsigned int m_fileVersion;
+	//! Keeps the sample chunks of a binary file mapped while the file is loaded
+	std::shared_ptr<const BinaryDataFile> m_binaryFile;
 } ;
 
 
@@ -28,6 +28,7 @@
 
 #include <span>
 
+#include "AudioBufferView.h"
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
 #include "Engine.h"
@@ -65,8 +66,30 @@ public:
 		return "effect";
 	}
 
+	//! The layouts of the buffers an effect can process
+	enum class BufferLayout
+	{
+		//! Interleaved sample frames
+		Interleaved,
+		//! One buffer per channel
+		Planar
+	};
+
+	/**
+	 * The layout the effect processes without converting the buffer.
+	 * Effect chains only convert between layouts where it changes from one
+	 * effect to the next, so neighbouring planar effects share one planar buffer.
+	 * The result may change between periods, but not during one.
+	 */
+	virtual BufferLayout bufferLayout() const
+	{
+		return BufferLayout::Interleaved;
+	}
+
 	//! Returns true if audio was processed and should continue being processed
 	bool processAudioBuffer(SampleFrame* buf, const fpp_t frames);
+	//! Same as above for planar buffers of at most `framesPerPeriod()` frames
+	bool processAudioBuffer(PlanarBufferView<float, 2> buf);
 
 	inline bool isOkay() const
 	{
@@ -163,9 +186,12 @@ protected:
 	};
 
 	/**
-	 * The main audio processing method that runs when plugin is not asleep
+	 * The main audio processing method that runs when plugin is not asleep.
+	 * Effects override the variant matching their `bufferLayout()`, only that
+	 * one is called. processAudioBuffer() converts buffers of the other layout.
 	 */
-	virtual ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) = 0;
+	virtual ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames);
+	virtual ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> buf);
 
 	/**
 	 * Optional method that runs when plugin is sleeping (not enabled,
@@ -209,6 +235,20 @@ private:
 	 * turned off and won't be processed again until it receives new audio input.
 	 */
 	void handleAutoQuit(std::span<const SampleFrame> output);
+	void handleAutoQuit(PlanarBufferView<const float, 2> output);
+	void updateQuietBufferCount(bool quiet);
+
+	//! Returns the result of processAudioBuffer() for a processed period
+	bool finishProcessing(ProcessStatus status, auto&& output);
+
+	//! Call the processing method of the effect's layout with a buffer of the other one
+	ProcessStatus processAsPlanar(SampleFrame* buf, const fpp_t frames);
+	ProcessStatus processAsInterleaved(PlanarBufferView<float, 2> buf);
+
+	bool isSleeping() const
+	{
+		return !isOkay() || dontRun() || !isEnabled() || !isRunning();
+	}
 
 
 	EffectChain * m_parent;
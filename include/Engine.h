@@ -52,7 +52,9 @@ class LMMS_EXPORT Engine : public QObject
 {
 	Q_OBJECT
 public:
-	static void init( bool renderOnly );
+	//! @p framesPerPeriod overrides the period size of a render-only engine,
+	//! 0 keeps the default
+	static void init( bool renderOnly, fpp_t framesPerPeriod = 0 );
 	static void destroy();
 
 	// core
@@ -0,0 +1,111 @@
+/*
+ * EngineBenchmark.h - measures the rendering performance of a project
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_ENGINE_BENCHMARK_H
+#define LMMS_ENGINE_BENCHMARK_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <QByteArray>
+#include <QString>
+
+#include "AudioEngineProfiler.h"
+#include "LmmsTypes.h"
+#include "PluginCache.h"
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+ * @brief Renders the loaded song as fast as possible and measures the audio engine
+ *
+ * The song is exported @p passes times in the calling thread, without any
+ * device consuming the periods, so the results only depend on the engine
+ * itself. Used by `lmms bench`.
+ */
+class LMMS_EXPORT EngineBenchmark
+{
+public:
+	struct Result
+	{
+		sample_rate_t sampleRate = 0;
+		fpp_t framesPerPeriod = 0;
+		int passes = 0;
+		std::size_t periods = 0;
+
+		//! Length of the rendered audio and the time it took, in seconds
+		double audioTime = 0.;
+		double renderTime = 0.;
+
+		//! Time needed for a single period, in milliseconds
+		double latencyMedian = 0.;
+		double latency90 = 0.;
+		double latency99 = 0.;
+		double latencyMax = 0.;
+		//! Periods which took longer than their playback
+		std::size_t overruns = 0;
+
+		//! Time spent on each stage, relative to the length of the audio, in percent
+		std::array<double, AudioEngineProfiler::DetailCount> stageLoad{};
+
+		std::uint64_t peakResidentSetSize = 0;
+
+		//! Time it took to load each track of the project, in milliseconds
+		struct TrackLoad
+		{
+			QString name;
+			double prepareTime;
+			double attachTime;
+		};
+		std::vector<TrackLoad> trackLoads;
+
+		//! Discovery of the LMMS plugins and the LADSPA plugins at startup,
+		//! which is warm if every library was found in the plugin cache
+		PluginCache::Statistics pluginDiscovery;
+		PluginCache::Statistics ladspaDiscovery;
+
+		double realtimeFactor() const { return renderTime > 0. ? audioTime / renderTime : 0.; }
+	};
+
+	EngineBenchmark(sample_rate_t sampleRate, int passes);
+
+	//! Exports the song, which has to be loaded already
+	Result run();
+
+	static QByteArray toJson(const Result& result, const QString& project);
+
+	//! Peak physical memory usage of the process in bytes, 0 if unknown
+	static std::uint64_t peakResidentSetSize();
+
+private:
+	const sample_rate_t m_sampleRate;
+	const int m_passes;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_ENGINE_BENCHMARK_H
@@ -28,6 +28,7 @@
 #include <QDir>
 #include <QMutex>
 #include <memory>
+#include <vector>
 
 #include "embed.h"
 
@@ -43,6 +44,7 @@ class QProgressBar;
 namespace lmms
 {
 
+class FileIndex;
 class FileSearch;
 class InstrumentTrack;
 class PlayHandle;
@@ -137,6 +139,8 @@ private:
 	QBoxLayout *outerLayout = nullptr;
 	QString m_userDir;
 	QString m_factoryDir;
+	//! Indexes of the user and factory directories, kept alive while the browser exists
+	std::vector<std::shared_ptr<FileIndex>> m_indexes;
 	QList<QString> m_savedExpandedDirs;
 	QString m_previousFilterValue;
 } ;
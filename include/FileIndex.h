@@ -0,0 +1,167 @@
+/*
+ * FileIndex.h - Persistent index of the files below a directory
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_FILE_INDEX_H
+#define LMMS_FILE_INDEX_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "lmms_export.h"
+
+namespace lmms {
+/**
+ * @brief Index of the names of all files and directories below a directory, for searching them quickly
+ *
+ * The index is loaded from disk or built in the background, and kept up to date through a file system watcher.
+ * After loading, every directory whose modification time changed since the index was saved is listed again, so
+ * changes made while LMMS wasn't running are picked up without crawling the whole tree.
+ *
+ * Names are searched through a table of their trigrams, so a query only has to look at the names which contain the
+ * rarest trigram of the filter.
+ */
+class LMMS_EXPORT FileIndex : public QObject
+{
+	Q_OBJECT
+public:
+	//! Directories beyond this number are only checked for changes when loading the index or on refresh(), to stay
+	//! within the limits of the operating system
+	static constexpr int MaxWatchedDirectories = 4096;
+
+	struct Match
+	{
+		QString path;
+		bool isDir;
+	};
+
+	//! Returns the index of @p directory, loading or building it in the background if there is none yet.
+	//! Must be called from the main thread. The index is deleted on the main thread as well, even if the last reference
+	//! is dropped on another one.
+	static auto forDirectory(const QString& directory) -> std::shared_ptr<FileIndex>;
+
+	//! Returns the index of @p directory, or nullptr if nobody requested one
+	static auto find(const QString& directory) -> std::shared_ptr<FileIndex>;
+
+	//! Saves the index if it changed since it was loaded
+	~FileIndex() override;
+
+	auto directory() const -> const QString& { return m_directory; }
+
+	//! Whether the index is complete, i.e. it was loaded from disk or the first crawl finished
+	auto isReady() const -> bool { return m_ready.load(std::memory_order_acquire); }
+
+	//! Returns all directories and all files with one of the suffixes in @p extensions whose name contains @p filter,
+	//! ignoring case. Better matches come first: exact names, then names starting with the filter, then names with a
+	//! word starting with it. Entries below @p excludedPaths are skipped. Returns early if @p cancel is set.
+	auto search(const QString& filter, const QStringList& extensions, const QStringList& excludedPaths = {},
+		const std::atomic<bool>* cancel = nullptr) const -> std::vector<Match>;
+
+	//! Checks every directory for changes, e.g. those which are not watched
+	void refresh();
+
+	//! Blocks until the background work is done
+	void wait();
+
+	//! Where the indexes are stored
+	static auto cacheDirectory() -> QString;
+	//! Overrides cacheDirectory(), e.g. for tests
+	static void setCacheDirectory(const QString& directory);
+
+private:
+	struct Entry
+	{
+		QString name;
+		//! The parent directory, -1 for the indexed directory itself
+		qint32 parent;
+		bool isDir;
+		bool removed = false;
+		//! Modification time of directories, for finding those which changed while the index wasn't watching
+		qint64 modified = 0;
+		std::vector<qint32> children;
+	};
+
+	//! A directory to list again, -1 for the indexed directory itself
+	struct Scan
+	{
+		qint32 dir;
+		//! Whether to list it even if its modification time didn't change
+		bool force;
+	};
+
+	explicit FileIndex(const QString& directory);
+
+	auto fileName() const -> QString;
+	auto load() -> bool;
+	void save();
+
+	void schedule(const std::vector<Scan>& scans);
+	void run(bool saveWhenDone);
+	void scan(Scan scan);
+	auto allDirectories() const -> std::vector<Scan>;
+
+	auto entryPath(qint32 entry) const -> QString;
+	auto addEntry(qint32 parent, const QString& name, bool isDir) -> qint32;
+	void removeEntry(qint32 entry);
+	auto children(qint32 dir) -> std::vector<qint32>&;
+	void watch(const QStringList& paths);
+	void directoryChanged(const QString& path);
+
+	const QString m_directory;
+	//! m_directory with a trailing separator
+	const QString m_prefix;
+
+	mutable std::mutex m_mutex;
+	std::vector<Entry> m_entries;
+	std::vector<qint32> m_rootChildren;
+	qint64 m_rootModified = 0;
+	//! Entries of the directories by path, for applying changes reported by the watcher
+	QHash<QString, qint32> m_dirs;
+	//! Entries whose names contain each trigram, in ascending order
+	QHash<quint64, std::vector<qint32>> m_trigrams;
+	bool m_dirty = false;
+
+	std::deque<Scan> m_pending;
+	//! Directories listed by the background task which are not watched yet
+	QStringList m_unwatched;
+
+	bool m_running = false;
+	std::condition_variable m_idle;
+	std::atomic<bool> m_ready = false;
+	std::atomic<bool> m_cancel = false;
+
+	QFileSystemWatcher m_watcher;
+
+	static QString s_cacheDirectory;
+};
+} // namespace lmms
+
+#endif // LMMS_FILE_INDEX_H
@@ -47,6 +47,7 @@ public:
 		QDir::SortFlags sortFlags = QDir::SortFlags{});
 
 	//! Execute the search, emitting the `foundResult` signal when matches are found.
+	//! Paths with a complete `FileIndex` are answered from the index instead of the file system.
 	void operator()();
 
 	//! Cancel the search.
@@ -86,7 +86,8 @@ public:
 
 	// needed for deleting plugin-specific-data of a note - plugin has to
 	// cast void-ptr so that the plugin-data is deleted properly
-	// (call of dtor if it's a class etc.)
+	// (call of dtor if it's a class etc.) - not needed for data created in
+	// NotePlayHandle::pluginDataArena(), which is destroyed by the handle
 	virtual void deleteNotePluginData( NotePlayHandle * _note_to_play );
 
 	// Get number of sample-frames that should be used when playing beat
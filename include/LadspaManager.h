@@ -37,6 +37,7 @@
 
 #include "lmms_export.h"
 #include "LmmsTypes.h"
+#include "PluginCache.h"
 
 
 namespace lmms
@@ -74,11 +75,16 @@ enum class LadspaPluginType
 
 struct LadspaManagerDescription
 {
+	//! nullptr until the library is loaded, which is done on first use
+	//! for plug-ins found through the plugin cache
 	LADSPA_Descriptor_Function descriptorFunction;
 	uint32_t index;
 	LadspaPluginType type;
 	uint16_t inputChannels;
 	uint16_t outputChannels;
+	QString file;
+	QString name;
+	bool realTimeCapable;
 };
 
 class LMMS_EXPORT LadspaManager
@@ -92,6 +98,13 @@ public:
 	LadspaManagerDescription * getDescription( const ladspa_key_t &
 								_plugin );
 
+	/* How long the plug-in libraries took to scan and how many
+	of them had to be loaded for that. */
+	const PluginCache::Statistics & discoveryStatistics() const
+	{
+		return m_statistics;
+	}
+
 	/* This identifier can be used as a unique, case-sensitive
 	identifier for the plugin type within the plugin file. Plugin
 	types should be identified by file and label rather than by index
@@ -330,8 +343,9 @@ public:
 						LADSPA_Handle _instance );
 
 private:
-	void  addPlugins( LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file );
+	void  addPlugins( const QFileInfo & _file, PluginCache & _cache );
+	LADSPA_Descriptor_Function loadLibrary(
+					LadspaManagerDescription * _plugin );
 	uint16_t  getPluginInputs( const LADSPA_Descriptor * _descriptor );
 	uint16_t  getPluginOutputs( const LADSPA_Descriptor * _descriptor );
 
@@ -343,6 +357,7 @@ private:
 	using LadspaManagerMapType = QMap<ladspa_key_t, LadspaManagerDescription*>;
 	LadspaManagerMapType m_ladspaManagerMap;
 	l_sortable_plugin_t m_sortedPlugins;
+	PluginCache::Statistics m_statistics;
 
 } ;
 
@@ -36,16 +36,32 @@ namespace lmms
 class LocklessAllocator
 {
 public:
-	LocklessAllocator( size_t nmemb, size_t size );
+	//! Creates a pool of @p nmemb elements of @p size bytes each, every
+	//! element aligned to @p alignment bytes
+	LocklessAllocator( size_t nmemb, size_t size, size_t alignment = sizeof( void * ) );
 	virtual ~LocklessAllocator();
 	void * alloc();
+	//! Like alloc(), but doesn't complain if the pool is exhausted
+	void * tryAlloc();
 	void free( void * ptr );
 
+	//! Returns whether @p ptr points into the pool
+	bool owns( const void * ptr ) const
+	{
+		return ptr >= m_pool && ptr < m_pool + m_capacity * m_elementSize;
+	}
+
+	size_t capacity() const
+	{
+		return m_capacity;
+	}
+
 
 private:
 	char * m_pool;
 	size_t m_capacity;
 	size_t m_elementSize;
+	size_t m_alignment;
 
 	std::atomic_int * m_freeState;
 	size_t m_freeStateSets;
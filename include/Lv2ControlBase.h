@@ -32,6 +32,7 @@
 #include <lilv/lilv.h>
 #include <memory>
 
+#include "AudioBufferView.h"
 #include "LinkedModelGroups.h"
 #include "lmms_export.h"
 #include "Plugin.h"
@@ -121,6 +122,10 @@ protected:
 	void copyBuffersFromLmms(const SampleFrame* buf, fpp_t frames);
 	//! Copy our ports into buffers passed by LMMS
 	void copyBuffersToLmms(SampleFrame* buf, fpp_t frames) const;
+	//! Copy planar buffer passed by LMMS into our ports
+	void copyBuffersFromLmms(PlanarBufferView<const float, 2> buf);
+	//! Copy our ports into planar buffers passed by LMMS
+	void copyBuffersToLmms(PlanarBufferView<float, 2> buf) const;
 	//! Run the Lv2 plugin instance for @param frames frames
 	void run(fpp_t frames);
 
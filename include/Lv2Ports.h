@@ -195,6 +195,13 @@ struct Audio : public VisitablePort<Audio, PortBase>
 	//! @param channel channel index into each sample frame
 	void copyBuffersToCore(SampleFrame* lmmsBuf,
 		unsigned channel, fpp_t frames) const;
+	//! Copy one channel of a planar buffer passed by LMMS into our ports
+	void copyBuffersFromCore(const float* lmmsChannel, fpp_t frames);
+	//! Add one channel of a planar buffer passed by LMMS into our ports,
+	//! and halve the result
+	void averageWithBuffersFromCore(const float* lmmsChannel, fpp_t frames);
+	//! Copy our ports into one channel of a planar buffer passed by LMMS
+	void copyBuffersToCore(float* lmmsChannel, fpp_t frames) const;
 
 	bool isSideChain() const { return m_sidechain; }
 	bool isOptional() const { return m_optional; }
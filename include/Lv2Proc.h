@@ -35,6 +35,7 @@
 
 #include <ringbuffer/ringbuffer.h>
 
+#include "AudioBufferView.h"
 #include "LinkedModelGroups.h"
 #include "LmmsSemaphore.h"
 #include "Lv2Basics.h"
@@ -146,6 +147,12 @@ public:
 	 */
 	void copyBuffersToCore(SampleFrame* buf, unsigned firstChan, unsigned num,
 								fpp_t frames) const;
+	//! Like above, but for planar buffers, where each channel is copied as a whole
+	void copyBuffersFromCore(PlanarBufferView<const float, 2> buf,
+								unsigned firstChan, unsigned num);
+	//! Like above, but for planar buffers, where each channel is copied as a whole
+	void copyBuffersToCore(PlanarBufferView<float, 2> buf,
+								unsigned firstChan, unsigned num) const;
 	//! Run the Lv2 plugin instance for @param frames frames
 	void run(fpp_t frames);
 
@@ -26,9 +26,12 @@
 #define LMMS_MIDI_CLIENT_H
 
 #include <QStringList>
+#include <chrono>
+#include <mutex>
 #include <vector>
 
 
+#include "LmmsTypes.h"
 #include "MidiEvent.h"
 
 class QObject;
@@ -63,6 +66,10 @@ public:
 	// re-implemented methods HAVE to call removePort() of base-class!!
 	virtual void removePort( MidiPort * _port );
 
+	// called by the render thread once per period: passes the events the
+	// ports received since the last period on to their event processors
+	void dispatchInEvents( sample_rate_t sampleRate, fpp_t framesPerPeriod );
+
 
 	// returns whether client works with raw-MIDI, only needs to be
 	// re-implemented by MidiClientRaw for returning true
@@ -113,6 +120,11 @@ public:
 protected:
 	std::vector<MidiPort *> m_midiPorts;
 
+private:
+	// guards m_midiPorts against the render thread, which only tries to lock it
+	std::mutex m_portsMutex;
+	std::chrono::steady_clock::time_point m_lastDispatch;
+
 } ;
 
 
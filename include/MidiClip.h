@@ -28,6 +28,7 @@
 
 #include "Clip.h"
 #include "Note.h"
+#include "NoteStartIndex.h"
 
 
 namespace lmms
@@ -75,6 +76,18 @@ public:
 		return m_notes;
 	}
 
+	//! Notes starting exactly at @p time, for playback
+	NoteStartIndex::Range notesStartingAt(TimePos time)
+	{
+		return m_noteStartIndex.startingAt(m_notes, time.getTicks());
+	}
+
+	//! Notes starting before @p time, for playback
+	NoteStartIndex::Range notesStartingBefore(TimePos time)
+	{
+		return m_noteStartIndex.startingBefore(m_notes, time.getTicks());
+	}
+
 	Note * addStepNote( int step );
 	void setStep( int step, bool enabled );
 
@@ -153,6 +166,7 @@ private:
 
 	// data-stuff
 	NoteVector m_notes;
+	NoteStartIndex m_noteStartIndex;
 	int m_steps;
 
 	MidiClip * adjacentMidiClipByOffset(int offset) const;
@@ -0,0 +1,120 @@
+/*
+ * MidiInputQueue.h - timestamped queue for incoming MIDI events
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIDI_INPUT_QUEUE_H
+#define LMMS_MIDI_INPUT_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "LocklessRingBuffer.h"
+#include "MidiEvent.h"
+#include "TimePos.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class MidiEventProcessor;
+
+
+/**
+	@brief Hands incoming MIDI events from the MIDI client threads to the render thread
+
+	MIDI clients push events together with the time they arrived. The render
+	thread drains the queue once per period during note setup and converts the
+	arrival times into frame offsets, so events keep their relative timing
+	within a period instead of all starting at its first frame. This adds a
+	constant latency of one period, but neither side ever waits for the other.
+*/
+class LMMS_EXPORT MidiInputQueue
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Stats
+	{
+		std::size_t depth = 0;      //!< events waiting for the next period
+		std::size_t maxDepth = 0;   //!< highest depth since the last reset
+		std::size_t dropped = 0;    //!< events lost because the queue was full
+		float latency = 0.f;        //!< mean time from arrival to playback in ms
+		float jitter = 0.f;         //!< standard deviation of the latency in ms
+	};
+
+	static constexpr std::size_t DefaultCapacity = 1024;
+
+	explicit MidiInputQueue(std::size_t capacity = DefaultCapacity);
+
+	//! Can be called by several threads at once. Returns false if the queue
+	//! was full and the event had to be dropped.
+	bool push(const MidiEvent& event, const TimePos& time, Clock::time_point arrival = Clock::now());
+
+	//! Passes all queued events to @p processor. An event that arrived n frames
+	//! after @p previousPeriod gets an offset of n frames, limited to the
+	//! period. Must only be called by the render thread.
+	void dispatch(MidiEventProcessor& processor, Clock::time_point previousPeriod, Clock::time_point periodStart,
+		sample_rate_t sampleRate, fpp_t framesPerPeriod);
+
+	Stats stats() const;
+
+	//! Resets the maximum depth, the dropped events and the latency
+	//! statistics once the render thread has dispatched the next period
+	void resetStats()
+	{
+		m_resetRequested = true;
+	}
+
+private:
+	struct Entry
+	{
+		MidiEvent event;
+		TimePos time;
+		Clock::time_point arrival;
+	};
+
+	void recordLatency(double seconds);
+
+	LocklessRingBuffer<Entry> m_buffer;
+	LocklessRingBufferReader<Entry> m_reader;
+	//! the ringbuffer only allows one writer at a time
+	std::atomic_flag m_writeLock = ATOMIC_FLAG_INIT;
+
+	std::atomic<std::size_t> m_depth = 0;
+	std::atomic<std::size_t> m_maxDepth = 0;
+	std::atomic<std::size_t> m_dropped = 0;
+	std::atomic<float> m_latency = 0.f;
+	std::atomic<float> m_jitter = 0.f;
+	std::atomic<bool> m_resetRequested = false;
+
+	// running mean and variance of the latency, only used by the render thread
+	std::size_t m_latencyCount = 0;
+	double m_latencyMean = 0.;
+	double m_latencySquaredDiffs = 0.;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_MIDI_INPUT_QUEUE_H
@@ -31,6 +31,7 @@
 #include <QMap>
 
 #include "Midi.h"
+#include "MidiInputQueue.h"
 #include "TimePos.h"
 #include "AutomatableModel.h"
 
@@ -111,9 +112,21 @@ public:
 		return outputChannel() ? outputChannel() - 1 : 0;
 	}
 
+	//! Called by the MIDI client threads. The event is queued and passed to
+	//! the event processor by the render thread in dispatchInEvents().
 	void processInEvent( const MidiEvent& event, const TimePos& time = TimePos() );
 	void processOutEvent( const MidiEvent& event, const TimePos& time = TimePos() );
 
+	void dispatchInEvents( MidiInputQueue::Clock::time_point previousPeriod,
+				MidiInputQueue::Clock::time_point periodStart,
+				sample_rate_t sampleRate, fpp_t framesPerPeriod );
+
+	//! Queue depth and timing statistics of the incoming events
+	MidiInputQueue::Stats inputStats() const
+	{
+		return m_inputQueue.stats();
+	}
+
 
 	void saveSettings( QDomDocument& doc, QDomElement& thisElement ) override;
 	void loadSettings( const QDomElement& thisElement ) override;
@@ -173,6 +186,8 @@ private:
 	Map m_readablePorts;
 	Map m_writablePorts;
 
+	MidiInputQueue m_inputQueue;
+
 
 	friend class gui::ControllerConnectionDialog;
 	friend class gui::InstrumentMidiIOView;
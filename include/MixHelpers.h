@@ -25,6 +25,7 @@
 #ifndef LMMS_MIX_HELPERS_H
 #define LMMS_MIX_HELPERS_H
 
+#include "AudioBufferView.h"
 #include "LmmsTypes.h"
 
 namespace lmms
@@ -36,6 +37,23 @@ class SampleFrame;
 namespace MixHelpers
 {
 
+/*! \brief Instruction sets the hot mixing functions are implemented for */
+enum class SimdLevel
+{
+	Scalar,
+	Sse2,
+	Avx2,
+	Avx512
+};
+
+/*! \brief The best instruction set supported by both the build and the CPU, used by default */
+SimdLevel supportedSimdLevel();
+
+SimdLevel simdLevel();
+
+/*! \brief Use the implementations for `level` (at most supportedSimdLevel()), e.g. to compare them in tests */
+void setSimdLevel( SimdLevel level );
+
 bool isSilent( const SampleFrame* src, int frames );
 
 bool useNaNHandler();
@@ -44,6 +62,9 @@ void setNaNHandler( bool use );
 
 bool sanitize( SampleFrame* src, int frames );
 
+/*! \brief Same as sanitize() for planar buffers, clears all channels if one of them contains infs/nans */
+bool sanitize( PlanarBufferView<float, 2> buf );
+
 /*! \brief Add samples from src to dst */
 void add( SampleFrame* dst, const SampleFrame* src, int frames );
 
@@ -61,6 +61,7 @@ class MixerChannel : public ThreadableJob
 		BoolModel m_muteModel;
 		BoolModel m_soloModel;
 		FloatModel m_volumeModel;
+		//! Only changed with setName(), so the profiler knows the name
 		QString m_name;
 		QMutex m_lock;
 		bool m_queued; // are we queued up for rendering yet?
@@ -77,6 +78,8 @@ class MixerChannel : public ThreadableJob
 
 		bool isMaster() { return m_channelIndex == 0; }
 
+		void setName(const QString& name);
+
 		bool requiresProcessing() const override { return true; }
 		void unmuteForSolo();
 		void unmuteSenderForSolo();
@@ -86,6 +89,8 @@ class MixerChannel : public ThreadableJob
 		void setColor(const std::optional<QColor>& color) { m_color = color; }
 
 		std::atomic_size_t m_dependenciesMet;
+		// number of inputs (senders and audio bus handles) to wait for in the current period
+		std::size_t m_dependencies;
 		void incrementDeps();
 		void processed();
 		
@@ -146,6 +151,15 @@ public:
 	void mixToChannel( const SampleFrame* _buf, mix_ch_t _ch );
 
 	void prepareMasterMix();
+
+	// job graph stuff, see AudioEngine::renderStageGraph()
+	void prepareChannelJobs();
+	// registers an input of channel _ch for the current period, returns the
+	// channel if it has to wait for that input
+	MixerChannel * addChannelInput( mix_ch_t _ch );
+	void startChannelJobs();
+
+	// requires all channel jobs of the current period to be done
 	void masterMix( SampleFrame* _buf );
 
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
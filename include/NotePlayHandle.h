@@ -26,14 +26,15 @@
 #ifndef LMMS_NOTE_PLAY_HANDLE_H
 #define LMMS_NOTE_PLAY_HANDLE_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 #include "BasicFilters.h"
 #include "Note.h"
 #include "PlayHandle.h"
 #include "Track.h"
-
-class QReadWriteLock;
+#include "VoiceArena.h"
 
 namespace lmms
 {
@@ -47,6 +48,9 @@ using ConstNotePlayHandleList = QList<const NotePlayHandle*>;
 class LMMS_EXPORT NotePlayHandle : public PlayHandle, public Note
 {
 public:
+	//! Storage for the per-note data of instruments, see pluginDataArena()
+	using PluginDataArena = VoiceArena<4096>;
+
 	void * m_pluginData;
 	std::unique_ptr<BasicFilters<>> m_filter;
 
@@ -268,6 +272,14 @@ public:
 		m_frequencyNeedsUpdate = true;
 	}
 
+	/*! Returns storage for the per-note data of the instrument. Objects created
+	    in it are destroyed with the handle, after Instrument::deleteNotePluginData()
+	    has been called, and their memory is reused by the next note. */
+	PluginDataArena& pluginDataArena()
+	{
+		return m_pluginDataArena;
+	}
+
 private:
 	class BaseDetuning
 	{
@@ -330,16 +342,31 @@ private:
 	Origin m_origin;
 
 	bool m_frequencyNeedsUpdate;				// used to update pitch
+
+	PluginDataArena m_pluginDataArena;
 } ;
 
 
-const int INITIAL_NPH_CACHE = 256;
-const int NPH_CACHE_INCREMENT = 16;
+//! Number of NotePlayHandles which can exist at the same time
+const int NPH_POOL_SIZE = 4096;
+
+/**
+	@brief Fixed-size, lock-free pool of NotePlayHandles
+
+	All handles are allocated once in init(), so playing notes never
+	allocates memory. Free handles are kept in a lock-free stack, and each
+	thread keeps a small cache of free handles in front of it, so most
+	acquire() and release() calls don't touch shared state at all.
 
+	If the pool is exhausted, acquire() returns nullptr and the note is not
+	played. Such drops and the pool usage are reported by the
+	AudioEngineProfiler.
+*/
 class NotePlayHandleManager
 {
 public:
 	static void init();
+	//! Returns nullptr if the pool is exhausted
 	static NotePlayHandle * acquire( InstrumentTrack* instrumentTrack,
 					const f_cnt_t offset,
 					const f_cnt_t frames,
@@ -348,14 +375,38 @@ public:
 					int midiEventChannel = -1,
 					NotePlayHandle::Origin origin = NotePlayHandle::Origin::MidiClip );
 	static void release( NotePlayHandle * nph );
-	static void extend( int i );
 	static void free();
 
+	static int capacity() { return NPH_POOL_SIZE; }
+	//! Number of handles currently in use
+	static int used() { return s_used.load(std::memory_order_relaxed); }
+	//! Highest number of handles used at the same time
+	static int highWaterMark() { return s_highWaterMark.load(std::memory_order_relaxed); }
+	//! Number of notes which were dropped because the pool was exhausted
+	static int dropped() { return s_dropped.load(std::memory_order_relaxed); }
+
 private:
-	static NotePlayHandle ** s_available;
-	static QReadWriteLock s_mutex;
-	static std::atomic_int s_availableIndex;
-	static int s_size;
+	class ThreadCache;
+
+	static ThreadCache& threadCache();
+	static int pop();
+	static void push(int index);
+
+	static NotePlayHandle* handle(int index)
+	{
+		return reinterpret_cast<NotePlayHandle*>(s_storage + index * sizeof(NotePlayHandle));
+	}
+
+	static unsigned char* s_storage;
+	//! next free handle for each free handle, as index + 1 (0 marks the end)
+	static std::atomic<std::uint32_t>* s_next;
+	//! index + 1 of the first free handle in the low 32 bits, and a counter
+	//! against the ABA problem in the high 32 bits
+	static std::atomic<std::uint64_t> s_freeHead;
+
+	static std::atomic_int s_used;
+	static std::atomic_int s_highWaterMark;
+	static std::atomic_int s_dropped;
 };
 
 
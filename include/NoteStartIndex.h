@@ -0,0 +1,93 @@
+/*
+ * NoteStartIndex.h - start-time index of the notes of a MIDI clip
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_NOTE_START_INDEX_H
+#define LMMS_NOTE_START_INDEX_H
+
+#include <atomic>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "lmms_export.h"
+#include "Note.h"
+
+namespace lmms
+{
+
+/**
+	@brief Start-time index of the notes of a @ref MidiClip with a playback cursor
+
+	Playback asks for the notes starting at the current tick once per tick.
+	The index keeps the notes sorted by start position and remembers where the
+	last lookup ended, so while playing forwards each lookup only costs the
+	notes it returns. Seeking or looping backwards is detected and falls back
+	to a binary search.
+
+	The notes of a clip can be reordered without the index being notified
+	directly (e.g. while notes are dragged in the piano roll), so the index
+	is invalidated whenever the clip reports a change and rebuilt on the next
+	lookup.
+*/
+class LMMS_EXPORT NoteStartIndex
+{
+public:
+	using Iterator = std::vector<Note*>::const_iterator;
+
+	struct Range
+	{
+		Iterator first;
+		Iterator last;
+
+		Iterator begin() const { return first; }
+		Iterator end() const { return last; }
+	} ;
+
+	void invalidate()
+	{
+		m_dirty.store(true, std::memory_order_release);
+	}
+
+	//! Returns the notes of @p notes starting exactly at @p time. The range
+	//! stays valid until the next call.
+	Range startingAt(const NoteVector& notes, tick_t time);
+
+	//! Returns the notes of @p notes starting before @p time
+	Range startingBefore(const NoteVector& notes, tick_t time);
+
+private:
+	void update(const NoteVector& notes);
+	//! Moves the cursor to the first note starting at or after @p time
+	void seek(tick_t time);
+
+	std::vector<Note*> m_sorted;
+	//! start positions of m_sorted at the time of the last rebuild
+	std::vector<tick_t> m_starts;
+	std::size_t m_cursor = 0;
+
+	std::atomic_bool m_dirty = true;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_NOTE_START_INDEX_H
@@ -34,6 +34,7 @@
 
 #include "Engine.h"
 #include "lmms_math.h"
+#include "AudioBufferView.h"
 #include "AudioEngine.h"
 #include "OscillatorConstants.h"
 #include "SampleBuffer.h"
@@ -77,6 +78,8 @@ public:
 	} ;
 	constexpr static auto NumModulationAlgos = static_cast<std::size_t>(ModulationAlgo::Count);
 
+	//! The sub oscillator isn't owned by the oscillator, so both can be
+	//! created in NotePlayHandle::pluginDataArena()
 	Oscillator( const IntModel *wave_shape_model,
 			const IntModel *mod_algo_model,
 			const float &freq,
@@ -84,10 +87,7 @@ public:
 			const float &phase_offset,
 			const float &volume,
 			Oscillator *m_subOsc = nullptr);
-	virtual ~Oscillator()
-	{
-		delete m_subOsc;
-	}
+	virtual ~Oscillator() = default;
 
 	static void waveTableInit();
 	static void destroyFFTPlans();
@@ -110,6 +110,11 @@ public:
 
 	void update(SampleFrame* ab, const fpp_t frames, const ch_cnt_t chnl, bool modulator = false);
 
+	//! Renders the oscillators of both channels of a voice into @p buffer. Gives the same results as
+	//! calling update() for each channel, up to rounding, but works on blocks of frames and looks up
+	//! the band-limited wavetables with the SIMD kernels in OscillatorKernels.h.
+	static void update(Oscillator& left, Oscillator& right, PlanarBufferView<sample_t, 2> buffer);
+
 	// now follow the wave-shape-routines...
 	static inline sample_t sinSample( const float _sample )
 	{
@@ -313,6 +318,13 @@ private:
 	template<WaveShape W>
 	inline sample_t getSample( const float _sample );
 
+	//! Number of frames whose phases are computed at once by the planar update
+	static constexpr fpp_t PlanarBlockSize = 64;
+
+	void updatePlanar(sample_t* buffer, const fpp_t frames, bool modulator);
+	template<WaveShape W>
+	void updatePlanar(sample_t* buffer, const fpp_t frames);
+
 	inline void recalcPhase();
 
 } ;
@@ -0,0 +1,115 @@
+/*
+ * PeriodRing.h - preallocated ring of audio periods between renderer and device
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PERIOD_RING_H
+#define LMMS_PERIOD_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "LmmsSemaphore.h"
+#include "LmmsTypes.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class SampleFrame;
+
+/**
+	@brief Fixed pool of period buffers passed from the renderer to the audio device
+
+	The fifo writer thread copies each rendered period into a free slot and
+	publishes it, the audio device reads the published slot in place and
+	hands it back with its next read. With a single writer and a single reader, taking and
+	returning slots is wait-free. A side only sleeps when the ring is full
+	(writer) or empty (reader), and the other side only posts a semaphore when
+	it actually finds the first one sleeping.
+*/
+class LMMS_EXPORT PeriodRing
+{
+public:
+	PeriodRing(std::size_t depth, fpp_t framesPerPeriod);
+	~PeriodRing();
+
+	PeriodRing(const PeriodRing&) = delete;
+	PeriodRing& operator=(const PeriodRing&) = delete;
+
+	//! Waits for a free slot and returns it to render the next period into
+	SampleFrame* beginWrite();
+	//! Publishes the slot returned by beginWrite()
+	void endWrite();
+	//! Lets the reader get nullptr once it read all published periods
+	void close();
+	//! Waits until the reader returned all periods
+	void waitUntilRead();
+	//! Starts over after the ring was closed and read completely
+	void reopen();
+
+	//! Hands back the period returned by the last call and waits for the
+	//! next one, which stays valid until the next call. Returns nullptr
+	//! once the ring was closed and everything has been read.
+	const SampleFrame* read();
+
+	std::size_t depth() const { return m_depth; }
+	fpp_t framesPerPeriod() const { return m_framesPerPeriod; }
+	//! Number of periods rendered but not yet handed back by the reader
+	std::size_t fillLevel() const;
+	//! Number of times the reader found the ring empty and had to wait
+	std::size_t underruns() const { return m_underruns.load(std::memory_order_relaxed); }
+
+private:
+	SampleFrame* slot(std::size_t index) const;
+
+	//! Releases the period held by the reader, if any
+	void release();
+
+	//! Sleeps on @p wake until @p ready returns true, see the comment in the implementation
+	template<typename Ready>
+	static void waitFor(std::atomic<bool>& waiting, Semaphore& wake, Ready ready);
+	static void wakeUp(std::atomic<bool>& waiting, Semaphore& wake);
+
+	const std::size_t m_depth;
+	const fpp_t m_framesPerPeriod;
+	std::unique_ptr<SampleFrame[]> m_frames;
+
+	//! Number of periods published by the writer
+	alignas(64) std::atomic<std::size_t> m_written = 0;
+	std::atomic<bool> m_closed = false;
+	std::atomic<bool> m_writerWaiting = false;
+	Semaphore m_writerWake{0};
+
+	//! Number of periods handed back by the reader
+	alignas(64) std::atomic<std::size_t> m_released = 0;
+	//! Number of periods taken by the reader, only used by the reader
+	std::size_t m_taken = 0;
+	std::atomic<bool> m_readerWaiting = false;
+	Semaphore m_readerWake{0};
+	std::atomic<std::size_t> m_underruns = 0;
+};
+
+} // namespace lmms
+
+#endif // LMMS_PERIOD_RING_H
@@ -149,6 +149,8 @@ public:
 	SampleFrame* buffer();
 
 private:
+	void render();
+
 	Type m_type;
 	f_cnt_t m_offset;
 	QThread* m_affinity;
@@ -0,0 +1,103 @@
+/*
+ * PluginCache.h - remembers what was found in plugin libraries
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PLUGIN_CACHE_H
+#define LMMS_PLUGIN_CACHE_H
+
+#include <optional>
+
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+
+#include "lmms_export.h"
+
+class QFileInfo;
+
+namespace lmms
+{
+
+/**
+ * @brief Persistent cache of what was found in plugin libraries
+ *
+ * Finding out what a library contains means loading it, which takes seconds
+ * with hundreds of plugins installed. The cache stores an entry for each
+ * library, keyed by its path, modification time and size, so only the
+ * libraries which changed since the last run have to be probed again.
+ *
+ * The cache is written back on destruction. Entries of libraries which were
+ * not looked up in the meantime are dropped.
+ */
+class LMMS_EXPORT PluginCache
+{
+public:
+	//! How plugin discovery went, for reporting startup times
+	struct Statistics
+	{
+		//! Libraries whose entry was taken from the cache
+		int cached = 0;
+		//! Libraries which had to be loaded
+		int probed = 0;
+		qint64 milliseconds = 0;
+
+		bool warm() const { return probed == 0 && cached > 0; }
+	};
+
+	//! Loads the cache named @p name from the cache directory
+	explicit PluginCache(const QString& name);
+	~PluginCache();
+
+	PluginCache(const PluginCache&) = delete;
+	PluginCache& operator=(const PluginCache&) = delete;
+
+	//! Returns the entry of @p file, or nothing if it was never stored or
+	//! the file has changed since
+	std::optional<QJsonObject> find(const QFileInfo& file);
+	void insert(const QFileInfo& file, const QJsonObject& entry);
+
+	//! Writes the cache to disk, if anything changed
+	void save();
+
+	QString fileName() const { return m_fileName; }
+	const Statistics& statistics() const { return m_statistics; }
+
+	//! Where the caches and the artwork copied out of plugins are stored
+	static QString directory();
+	//! Overrides directory(), e.g. for tests
+	static void setDirectory(const QString& directory);
+
+private:
+	QString m_fileName;
+	QHash<QString, QJsonObject> m_entries;
+	QSet<QString> m_used;
+	bool m_modified = false;
+	Statistics m_statistics;
+
+	static QString s_directory;
+};
+
+} // namespace lmms
+
+#endif // LMMS_PLUGIN_CACHE_H
@@ -32,9 +32,11 @@
 #include <QFileInfo>
 #include <QList>
 #include <QString>
+#include <QStringList>
 
 #include "lmms_export.h"
 #include "Plugin.h"
+#include "PluginCache.h"
 
 class QLibrary;  // IWYU pragma: keep
 
@@ -48,6 +50,8 @@ public:
 	{
 		QString name() const;
 		QFileInfo file;
+		//! Plugins discovered through the PluginCache are not loaded until
+		//! PluginFactory::loadLibrary() is called
 		std::shared_ptr<QLibrary> library = nullptr;
 		Plugin::Descriptor* descriptor = nullptr;
 
@@ -57,7 +61,7 @@ public:
 	using DescriptorMap = QMultiMap<Plugin::Type, Plugin::Descriptor*>;
 
 	PluginFactory();
-	~PluginFactory() = default;
+	~PluginFactory();
 
 	static void setupSearchPaths();
 	static QList<QRegularExpression> getExcludePatterns(const char* envVar);
@@ -91,6 +95,13 @@ public:
 	/// It can be retrieved by calling this function.
 	QString errorString(QString pluginName) const;
 
+	/// Loads the library of @p info, which is only done on demand for plugins
+	/// discovered through the cache. Returns false if it can't be loaded.
+	bool loadLibrary(const PluginInfo& info);
+
+	/// How long the last discovery took and how many libraries were probed
+	const PluginCache::Statistics& discoveryStatistics() const { return m_statistics; }
+
 public slots:
 	void discoverPlugins();
 
@@ -103,9 +114,21 @@ private:
 
 	QHash<QString, QString> m_errors;
 
+	struct CachedDescriptor;
+	std::vector<std::unique_ptr<CachedDescriptor>> m_cachedDescriptors; //!< cleaned up at destruction
+
+	//! Libraries without plugins, which plugins may depend on
+	QStringList m_helperLibraries;
+	bool m_helpersLoaded = false;
+
+	PluginCache::Statistics m_statistics;
+
 	static std::unique_ptr<PluginFactory> s_instance;
 
 	static void filterPlugins(QSet<QFileInfo>& files);
+
+	void loadHelperLibraries();
+	Plugin::Descriptor* cachedDescriptor(const PluginInfo& info, const QJsonObject& entry);
 };
 
 //Short-hand function
@@ -31,6 +31,7 @@
 #include <QRecursiveMutex>  // IWYU pragma: keep
 #endif
 
+#include "AudioBufferView.h"
 #include "RemotePluginBase.h"
 #include "SharedMemory.h"
 #include "LmmsTypes.h"
@@ -101,9 +102,29 @@ public:
 	bool processMessage( const message & _m ) override;
 
 	bool process( const SampleFrame* _in_buf, SampleFrame* _out_buf );
+	//! Same as above with planar buffers of `framesPerPeriod()` frames, empty
+	//! views take the place of null pointers
+	bool process( PlanarBufferView<const float, 2> in, PlanarBufferView<float, 2> out );
 
 	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset );
 
+	/**
+	 * In pipelined mode, process() hands the period to the remote and
+	 * returns the output of the previous period instead of waiting for the
+	 * remote to finish. That way the remotes of all plugins process their
+	 * periods at the same time, at the cost of one period of latency.
+	 * Off unless enabled with the `audioengine/pipelinedremoteplugins` setting.
+	 */
+	void setPipelined( bool on );
+
+	bool isPipelined() const
+	{
+		return m_pipelined;
+	}
+
+	//! Number of frames the output of process() is delayed by
+	f_cnt_t latency() const;
+
 	void updateSampleRate( sample_rate_t _sr )
 	{
 		lock();
@@ -159,6 +180,16 @@ protected:
 private:
 	void resizeSharedProcessingMemory();
 
+	//! Returns false if there is nothing to process yet
+	bool isReadyToProcess();
+	//! Returns the cleared part of the shared memory to write the next period to
+	float* beginPeriod();
+	//! Lets the remote process the period written after beginPeriod(), and
+	//! returns the part of the shared memory to read the output from, if any
+	const float* finishPeriod( bool wantOutput );
+	//! Waits until at most @p maxPending periods are still being processed by the remote
+	bool waitForPendingPeriods( int maxPending );
+
 
 	QProcess m_process;
 	ProcessWatcher m_watcher;
@@ -175,6 +206,15 @@ private:
 
 	SharedMemory<float[]> m_audioBuffer;
 	std::size_t m_audioBufferSize;
+	//! number of samples in the shared memory per period
+	std::size_t m_periodBufferSize = 0;
+
+	bool m_pipelined = false;
+	//! periods sent to the remote without having received IdProcessingDone
+	int m_pendingPeriods = 0;
+	//! half of the shared memory the next period is written to in pipelined mode
+	int m_currentHalf = 0;
+	bool m_previousPeriodStarted = false;
 
 	int m_inputCount;
 	int m_outputCount;
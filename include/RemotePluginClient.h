@@ -126,7 +126,7 @@ public:
 
 private:
 	void setShmKey(const std::string& key);
-	void doProcessing();
+	void doProcessing(int half);
 
 	SharedMemory<float[]> m_audioBuffer;
 	SharedMemory<const VstSyncData> m_vstSyncData;
@@ -296,7 +296,9 @@ bool RemotePluginClient::processMessage( const message & _m )
 			break;
 
 		case IdStartProcessing:
-			doProcessing();
+			// in pipelined mode, the host tells us which half of the
+			// shared memory holds the period
+			doProcessing(_m.data.empty() ? 0 : _m.getInt(0));
 			reply_message.id = IdProcessingDone;
 			reply = true;
 			break;
@@ -342,12 +344,13 @@ void RemotePluginClient::setShmKey(const std::string& key)
 
 
 
-void RemotePluginClient::doProcessing()
+void RemotePluginClient::doProcessing(int half)
 {
 	if (m_audioBuffer)
 	{
-		process( (SampleFrame*)( m_inputCount > 0 ? m_audioBuffer.get() : nullptr ),
-				(SampleFrame*)( m_audioBuffer.get() +
+		float* buffer = m_audioBuffer.get() + half * (m_inputCount + m_outputCount) * m_bufferSize;
+		process( (SampleFrame*)( m_inputCount > 0 ? buffer : nullptr ),
+				(SampleFrame*)( buffer +
 					( m_inputCount*m_bufferSize ) ) );
 	}
 	else
@@ -30,6 +30,7 @@
 
 #include "ProjectRenderer.h"
 #include "OutputSettings.h"
+#include "StemExporter.h"
 
 
 namespace lmms
@@ -40,6 +41,12 @@ class RenderManager : public QObject
 {
 	Q_OBJECT
 public:
+	enum class StemSource
+	{
+		Tracks,
+		MixerChannels
+	} ;
+
 	RenderManager(
 		const AudioEngine::qualitySettings & qualitySettings,
 		const OutputSettings & outputSettings,
@@ -54,6 +61,10 @@ public:
 	/// Export all unmuted tracks into individual file
 	void renderTracks();
 
+	/// Export the master and a stem of each unmuted track or each mixer
+	/// channel into individual files, rendering the song only once
+	void renderStems( StemSource source );
+
 	void abortProcessing();
 
 signals:
@@ -62,10 +73,13 @@ signals:
 
 private slots:
 	void renderNextTrack();
+	void finishStems();
 	void updateConsoleProgress();
 
 private:
-	QString pathForTrack( const Track *track, int num );
+	static std::vector<Track*> unmutedTracks();
+	void abortStems();
+	QString pathForTrack( const QString& trackName, int num );
 	void restoreMutedState();
 
 	void render( QString outputPath );
@@ -77,6 +91,7 @@ private:
 	QString m_outputPath;
 
 	std::unique_ptr<ProjectRenderer> m_activeRenderer;
+	std::unique_ptr<StemExporter> m_stems;
 
 	std::vector<Track*> m_tracksToRender;
 	std::vector<Track*> m_unmuted;
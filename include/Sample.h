@@ -26,6 +26,7 @@
 #define LMMS_SAMPLE_H
 
 #include <memory>
+#include <vector>
 
 #include "AudioResampler.h"
 #include "Note.h"
@@ -42,6 +43,10 @@ public:
 	// may need to be higher - conversely, to optimize, some may work with lower values
 	static constexpr auto s_interpolationMargins = std::array<int, 5>{64, 64, 64, 4, 4};
 
+	//! Input frames per output frame the scratch buffer of a PlaybackState is
+	//! sized for, e.g. a sample at twice the output rate played two octaves up
+	static constexpr auto s_maxScratchRatio = 8;
+
 	enum class Loop
 	{
 		Off,
@@ -52,11 +57,7 @@ public:
 	class LMMS_EXPORT PlaybackState
 	{
 	public:
-		PlaybackState(bool varyingPitch = false, int interpolationMode = SRC_LINEAR)
-			: m_resampler(interpolationMode, DEFAULT_CHANNELS)
-			, m_varyingPitch(varyingPitch)
-		{
-		}
+		PlaybackState(bool varyingPitch = false, int interpolationMode = SRC_LINEAR);
 
 		auto resampler() -> AudioResampler& { return m_resampler; }
 		auto frameIndex() const -> int { return m_frameIndex; }
@@ -69,6 +70,9 @@ public:
 
 	private:
 		AudioResampler m_resampler;
+		//! Holds the raw frames fed to the resampler. It's sized for a period
+		//! at s_maxScratchRatio on creation, so playback doesn't allocate.
+		std::vector<SampleFrame> m_scratch;
 		int m_frameIndex = 0;
 		bool m_varyingPitch = false;
 		bool m_backwards = false;
@@ -117,6 +121,8 @@ public:
 
 private:
 	void playRaw(SampleFrame* dst, size_t numFrames, const PlaybackState* state, Loop loopMode) const;
+	//! Copies @p numFrames frames starting at @p index, reading backwards through the sample if @p backwards
+	void copyFrames(SampleFrame* dst, int index, size_t numFrames, bool backwards) const;
 	void advance(PlaybackState* state, size_t advanceAmount, Loop loopMode) const;
 
 private:
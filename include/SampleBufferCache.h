@@ -0,0 +1,91 @@
+/*
+ * SampleBufferCache.h - shares the sample buffers of equal samples
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SAMPLE_BUFFER_CACHE_H
+#define LMMS_SAMPLE_BUFFER_CACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "lmms_export.h"
+
+namespace lmms {
+class SampleBuffer;
+
+/**
+ * @brief Process-wide cache of decoded samples
+ *
+ * Files are identified by their path and modification time, embedded samples
+ * by a hash of their data, so every sample is decoded and stored once no
+ * matter how many clips and instruments of how many projects use it.
+ *
+ * The cache only holds weak references, a buffer is freed as soon as its last
+ * user is gone. With a budget set, the most recently used buffers up to that
+ * size are kept alive in addition, e.g. for reopening a project.
+ */
+class LMMS_EXPORT SampleBufferCache
+{
+public:
+	static auto instance() -> SampleBufferCache&;
+
+	//! Returns the buffer for @p audioFile, decoding the file only if needed.
+	//! Throws like SampleBuffer's constructor.
+	auto fromFile(const QString& audioFile) -> std::shared_ptr<const SampleBuffer>;
+	auto fromBase64(const QString& base64, int sampleRate) -> std::shared_ptr<const SampleBuffer>;
+
+	//! Bytes of sample data held by all cached buffers which are alive
+	auto memoryUsage() const -> std::size_t;
+
+	//! Bytes of unused sample data to keep alive, 0 to keep none
+	auto budget() const -> std::size_t;
+	void setBudget(std::size_t bytes);
+
+	//! Drops the buffers kept alive for the budget
+	void clear();
+
+private:
+	SampleBufferCache();
+
+	auto find(const QByteArray& key) -> std::shared_ptr<const SampleBuffer>;
+	auto insert(const QByteArray& key, std::shared_ptr<const SampleBuffer> buffer) -> std::shared_ptr<const SampleBuffer>;
+	void retain(const std::shared_ptr<const SampleBuffer>& buffer);
+	void trimRetained();
+
+	mutable std::mutex m_mutex;
+	QHash<QByteArray, std::weak_ptr<const SampleBuffer>> m_buffers;
+	int m_pruneSize = 64;
+
+	//! Most recently used buffers first
+	std::list<std::shared_ptr<const SampleBuffer>> m_retained;
+	std::size_t m_retainedBytes = 0;
+	std::size_t m_budget = 0;
+};
+} // namespace lmms
+
+#endif // LMMS_SAMPLE_BUFFER_CACHE_H
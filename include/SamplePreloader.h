@@ -0,0 +1,124 @@
+/*
+ * SamplePreloader.h - prepares the samples of a project on the thread pool
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SAMPLE_PRELOADER_H
+#define LMMS_SAMPLE_PRELOADER_H
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include "OscillatorConstants.h"
+#include "lmms_export.h"
+
+class QDomElement;
+
+namespace lmms
+{
+
+class SampleBuffer;
+
+/**
+ * @brief Decodes the samples of tracks on the thread pool while they are being loaded
+ *
+ * Loading a project is split into two phases: prepare() walks the settings of
+ * a track and decodes every sample file, embedded sample and user wave table
+ * it references in the background. The track is then created as usual on the
+ * calling thread; SampleLoader and Oscillator pick up the prepared data
+ * instead of decoding it again. Anything that isn't ready (yet) is simply
+ * loaded the old way.
+ *
+ * Only one preloader can be active at a time, it keeps the prepared data
+ * until it is destroyed.
+ */
+class LMMS_EXPORT SamplePreloader
+{
+public:
+	//! The jobs started for a single track
+	class Task
+	{
+	public:
+		//! Waits until the track is prepared and returns the time its jobs
+		//! took on the thread pool, in microseconds
+		int wait();
+
+	private:
+		friend class SamplePreloader;
+		std::vector<std::shared_future<int>> m_jobs;
+	};
+
+	SamplePreloader();
+	~SamplePreloader();
+
+	SamplePreloader(const SamplePreloader&) = delete;
+	SamplePreloader& operator=(const SamplePreloader&) = delete;
+
+	//! Starts preparing everything referenced by the track @p track
+	Task prepare(const QDomElement& track);
+
+	static bool isActive();
+
+	//! The buffers are shared between all users of the same sample
+	static std::shared_ptr<const SampleBuffer> sampleFromFile(const QString& path);
+	static std::shared_ptr<const SampleBuffer> sampleFromBase64(const QString& base64, int sampleRate);
+
+	//! Returns the anti-aliased wave table prepared for @p buffer and hands over its ownership
+	static std::unique_ptr<OscillatorConstants::waveform_t> takeUserWaveTable(const SampleBuffer* buffer);
+
+private:
+	struct Job
+	{
+		QString source;
+		bool embedded = false;
+		int sampleRate = 0;
+		bool waveTable = false;
+	};
+
+	void collect(const QDomElement& elem, Task& task);
+	void addJob(Job job, Task& task);
+	int run(const Job& job);
+
+	static SamplePreloader* s_instance;
+
+	std::atomic_bool m_cancelled = false;
+	std::vector<std::shared_future<int>> m_jobs;
+	//! Sources a job has been started for already
+	QSet<QString> m_scheduledFiles;
+	QSet<QString> m_scheduledEmbedded;
+
+	std::mutex m_mutex;
+	QHash<QString, std::shared_ptr<const SampleBuffer>> m_files;
+	QHash<QString, std::shared_ptr<const SampleBuffer>> m_embedded;
+	std::unordered_map<const SampleBuffer*, std::unique_ptr<OscillatorConstants::waveform_t>> m_waveTables;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_SAMPLE_PRELOADER_H
@@ -27,11 +27,13 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include <QString>
 #include <QHash>  // IWYU pragma: keep
 
 #include "AudioEngine.h"
+#include "AutomationSchedule.h"
 #include "Controller.h"
 #include "Metronome.h"
 #include "lmms_constants.h"
@@ -137,6 +139,26 @@ public:
 		return m_nLoadingTrack;
 	}
 
+	//! How long loading a track of the last project took, in microseconds
+	struct TrackLoadTime
+	{
+		QString name;
+		//! Time its samples took to prepare on the thread pool
+		int prepareTime;
+		//! Time it took to create the track afterwards
+		int attachTime;
+	};
+
+	const std::vector<TrackLoadTime>& trackLoadTimes() const
+	{
+		return m_trackLoadTimes;
+	}
+
+	void addTrackLoadTime(TrackLoadTime loadTime)
+	{
+		m_trackLoadTimes.push_back(std::move(loadTime));
+	}
+
 	inline int getMilliseconds() const
 	{
 		return getMilliseconds(m_playMode);
@@ -465,6 +487,7 @@ private:
 	ControllerVector m_controllers;
 
 	int m_nLoadingTrack;
+	std::vector<TrackLoadTime> m_trackLoadTimes;
 
 	QString m_fileName;
 	QString m_oldFileName;
@@ -512,7 +535,7 @@ private:
 	std::shared_ptr<Scale> m_scales[MaxScaleCount];
 	std::shared_ptr<Keymap> m_keymaps[MaxKeymapCount];
 
-	AutomatedValueMap m_oldAutomatedValues;
+	AutomationSchedule m_automationSchedule;
 
 	Metronome m_metronome;
 
@@ -0,0 +1,108 @@
+/*
+ * StemExporter.h - writes the stems of a rendered song into separate files
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_STEM_EXPORTER_H
+#define LMMS_STEM_EXPORTER_H
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "AutomatableModel.h"
+#include "ProjectRenderer.h"
+#include "SampleFrame.h"
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class AudioFileDevice;
+
+/**
+ * @brief Captures several buffers of the audio engine while a song is rendered once
+ *
+ * Each stem taps a buffer that is valid at the end of every period, like the
+ * buffer of a track's AudioBusHandle or of a mixer channel. The render thread
+ * copies the buffers into per-stem chunks, and full chunks are encoded on the
+ * ThreadPool, so the encoders don't hold up the rendering. Chunks of the same
+ * stem are encoded one after the other.
+ */
+class LMMS_EXPORT StemExporter
+{
+public:
+	struct Source
+	{
+		//! The buffer that is copied after each period
+		const SampleFrame* buffer;
+		//! Fader to apply to the copy, for buffers that are taken before their fader
+		FloatModel* volume = nullptr;
+		//! When set, the stem is silent instead of copying the (stale) buffer
+		BoolModel* muted = nullptr;
+	};
+
+	static constexpr f_cnt_t ChunkFrames = 8192;
+
+	StemExporter(const OutputSettings& outputSettings, ProjectRenderer::ExportFileFormat format);
+	~StemExporter();
+
+	StemExporter(const StemExporter&) = delete;
+	StemExporter& operator=(const StemExporter&) = delete;
+
+	//! Opens @p outputPath for the stem, returns false if there is no encoder for it
+	bool addStem(Source source, const QString& outputPath);
+
+	std::size_t stemCount() const { return m_stems.size(); }
+
+	//! Called by the audio engine at the end of every rendered period, before the master mix
+	void capture(fpp_t frames);
+
+	//! Writes the remaining frames and closes the files
+	void finish();
+	//! Closes the files and removes them
+	void abort();
+
+private:
+	struct Stem
+	{
+		Source source;
+		std::unique_ptr<AudioFileDevice> device;
+		std::vector<SampleFrame> filling;
+		std::vector<SampleFrame> encoding;
+		f_cnt_t filled = 0;
+		std::future<void> pending;
+	};
+
+	void copyPeriod(Stem& stem, f_cnt_t offset, fpp_t frames);
+	void encode(Stem& stem);
+	void close(bool remove);
+
+	const OutputSettings m_outputSettings;
+	const ProjectRenderer::ExportFileFormat m_format;
+	std::vector<std::unique_ptr<Stem>> m_stems;
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_STEM_EXPORTER_H
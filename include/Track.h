@@ -30,6 +30,7 @@
 #include <QColor>
 
 #include "AutomatableModel.h"
+#include "ClipIntervalIndex.h"
 #include "JournallingObject.h"
 #include "LmmsTypes.h"
 #include <optional>
@@ -121,6 +122,8 @@ public:
 	// -- for usage by Clip only ---------------
 	Clip * addClip( Clip * clip );
 	void removeClip( Clip * clip );
+	//! Called when a clip has been moved or resized
+	void clipPositionChanged() { clipsChanged(); }
 	// -------------------------------------------------------
 	void deleteClips();
 
@@ -222,9 +225,13 @@ protected:
 	BoolModel m_soloModel;
 
 private:
+	//! Invalidates everything derived from the positions of the clips
+	void clipsChanged();
+
 	bool m_mutedBeforeSolo;
 
 	clipVector m_clips;
+	ClipIntervalIndex m_clipIndex;
 
 	QMutex m_processingLock;
 	
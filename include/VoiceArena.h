@@ -0,0 +1,141 @@
+/*
+ * VoiceArena.h - fixed-size storage for the per-note data of instruments
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_VOICE_ARENA_H
+#define LMMS_VOICE_ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace lmms {
+
+/**
+	@brief Fixed-size storage for the objects an instrument needs per note
+
+	Objects are constructed in place one after another and destroyed
+	together, in reverse order, by clear(). Each NotePlayHandle owns an
+	arena, which is recycled with the pooled handle, so creating the state
+	of a voice on the rendering threads doesn't allocate memory.
+
+	Objects which don't fit into the remaining space (or need a stricter
+	alignment than std::max_align_t) are allocated on the heap instead, so
+	instruments don't need to handle a full arena.
+*/
+template<std::size_t Capacity>
+class VoiceArena
+{
+public:
+	VoiceArena() = default;
+	VoiceArena(const VoiceArena&) = delete;
+	VoiceArena& operator=(const VoiceArena&) = delete;
+
+	~VoiceArena()
+	{
+		clear();
+	}
+
+	//! Constructs a @p T from @p args in the arena
+	template<typename T, typename... Args>
+	auto create(Args&&... args) -> T*
+	{
+		const auto headerOffset = align(m_used, alignof(Header));
+		const auto objectOffset = align(headerOffset + sizeof(Header), alignof(T));
+		if (alignof(T) > alignof(std::max_align_t) || objectOffset + sizeof(T) > Capacity)
+		{
+			return createOnHeap<T>(std::forward<Args>(args)...);
+		}
+
+		auto object = new (m_storage.data() + objectOffset) T(std::forward<Args>(args)...);
+		m_last = new (m_storage.data() + headerOffset) Header{m_last, object, &destroy<T>, false};
+		m_used = objectOffset + sizeof(T);
+		return object;
+	}
+
+	//! Destroys all objects in the reverse order of their creation
+	void clear()
+	{
+		while (m_last != nullptr)
+		{
+			Header* header = m_last;
+			m_last = header->previous;
+			header->destroy(header->object, header->onHeap);
+			if (header->onHeap) { delete header; }
+		}
+		m_used = 0;
+	}
+
+	//! Number of bytes used in the arena, not counting objects on the heap
+	auto used() const -> std::size_t { return m_used; }
+
+	static constexpr auto capacity() -> std::size_t { return Capacity; }
+
+private:
+	struct Header
+	{
+		Header* previous;
+		void* object;
+		void (*destroy)(void*, bool);
+		bool onHeap;
+	};
+
+	static constexpr auto align(std::size_t offset, std::size_t alignment) -> std::size_t
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	template<typename T>
+	static void destroy(void* object, bool onHeap)
+	{
+		static_cast<T*>(object)->~T();
+		if (onHeap) { ::operator delete(object, std::align_val_t{alignof(T)}); }
+	}
+
+	template<typename T, typename... Args>
+	auto createOnHeap(Args&&... args) -> T*
+	{
+		void* memory = ::operator new(sizeof(T), std::align_val_t{alignof(T)});
+		T* object = nullptr;
+		try
+		{
+			object = new (memory) T(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			::operator delete(memory, std::align_val_t{alignof(T)});
+			throw;
+		}
+		m_last = new Header{m_last, object, &destroy<T>, true};
+		return object;
+	}
+
+	alignas(std::max_align_t) std::array<std::byte, Capacity> m_storage;
+	std::size_t m_used = 0;
+	Header* m_last = nullptr;
+};
+
+} // namespace lmms
+
+#endif // LMMS_VOICE_ARENA_H
@@ -27,6 +27,8 @@
 #include <QVarLengthArray>
 #include <QMessageBox>
 
+#include <algorithm>
+
 #include "LadspaEffect.h"
 #include "DataFile.h"
 #include "AudioEngine.h"
@@ -128,6 +130,17 @@ void LadspaEffect::changeSampleRate()
 
 
 
+Effect::BufferLayout LadspaEffect::bufferLayout() const
+{
+	// resampling is only implemented for interleaved buffers
+	return m_maxSampleRate < Engine::audioEngine()->outputSampleRate()
+		? BufferLayout::Interleaved
+		: BufferLayout::Planar;
+}
+
+
+
+
 Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t frames)
 {
 	m_pluginMutex.lock();
@@ -150,9 +163,114 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 				Engine::audioEngine()->outputSampleRate();
 	}
 
-	// Copy the LMMS audio buffer to the LADSPA input buffer and initialize
-	// the control ports.
+	// Copy the LMMS audio buffer to the LADSPA input buffers.
+	ch_cnt_t channel = 0;
+	for (const auto& ports : m_ports)
+	{
+		for (port_desc_t* pp : ports)
+		{
+			if (pp->rate == BufferRate::ChannelIn)
+			{
+				for (fpp_t frame = 0; frame < outFrames; ++frame)
+				{
+					pp->buffer[frame] = buf[frame][channel];
+				}
+				++channel;
+			}
+		}
+	}
+
+	runPlugin(outFrames);
+
+	// Copy the LADSPA output buffers to the LMMS buffer.
+	channel = 0;
+	const float d = dryLevel();
+	const float w = wetLevel();
+	for (const auto& ports : m_ports)
+	{
+		for (port_desc_t* pp : ports)
+		{
+			if (pp->rate == BufferRate::ChannelOut)
+			{
+				for (fpp_t frame = 0; frame < outFrames; ++frame)
+				{
+					buf[frame][channel] = d * buf[frame][channel] + w * pp->buffer[frame];
+				}
+				++channel;
+			}
+		}
+	}
+
+	if (outBuf != nullptr)
+	{
+		sampleBack(buf, outBuf, m_maxSampleRate);
+	}
+
+	m_pluginMutex.unlock();
+
+	return ProcessStatus::ContinueIfNotQuiet;
+}
+
+
+
+
+Effect::ProcessStatus LadspaEffect::processPlanarImpl(PlanarBufferView<float, 2> buf)
+{
+	m_pluginMutex.lock();
+	if (!isOkay() || dontRun() || !isEnabled() || !isRunning())
+	{
+		m_pluginMutex.unlock();
+		return ProcessStatus::Sleep;
+	}
+
+	// The channels already have the layout of the LADSPA port buffers, so
+	// they can be copied as a whole
+	const fpp_t frames = buf.frames();
 	ch_cnt_t channel = 0;
+	for (const auto& ports : m_ports)
+	{
+		for (port_desc_t* pp : ports)
+		{
+			if (pp->rate == BufferRate::ChannelIn)
+			{
+				std::copy_n(buf.bufferPtr(channel), frames, pp->buffer);
+				++channel;
+			}
+		}
+	}
+
+	runPlugin(frames);
+
+	channel = 0;
+	const float d = dryLevel();
+	const float w = wetLevel();
+	for (const auto& ports : m_ports)
+	{
+		for (port_desc_t* pp : ports)
+		{
+			if (pp->rate == BufferRate::ChannelOut)
+			{
+				float* samples = buf.bufferPtr(channel);
+				for (fpp_t frame = 0; frame < frames; ++frame)
+				{
+					samples[frame] = d * samples[frame] + w * pp->buffer[frame];
+				}
+				++channel;
+			}
+		}
+	}
+
+	m_pluginMutex.unlock();
+
+	return ProcessStatus::ContinueIfNotQuiet;
+}
+
+
+
+
+void LadspaEffect::runPlugin(fpp_t frames)
+{
+	// Initialize the control ports.
 	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
 	{
 		for( int port = 0; port < m_portCount; ++port )
@@ -160,19 +278,12 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 			port_desc_t * pp = m_ports.at( proc ).at( port );
 			switch( pp->rate )
 			{
-				case BufferRate::ChannelIn:
-					for (fpp_t frame = 0; frame < outFrames; ++frame)
-					{
-						pp->buffer[frame] = buf[frame][channel];
-					}
-					++channel;
-					break;
 				case BufferRate::AudioRateInput:
 				{
 					ValueBuffer * vb = pp->control->valueBuffer();
 					if( vb )
 					{
-						memcpy(pp->buffer, vb->values(), outFrames * sizeof(float));
+						memcpy(pp->buffer, vb->values(), frames * sizeof(float));
 					}
 					else
 					{
@@ -181,7 +292,7 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 						// This only supports control rate ports, so the audio rates are
 						// treated as though they were control rate by setting the
 						// port buffer to all the same value.
-						for (fpp_t frame = 0; frame < outFrames; ++frame)
+						for (fpp_t frame = 0; frame < frames; ++frame)
 						{
 							pp->buffer[frame] = pp->value;
 						}
@@ -198,6 +309,7 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 					pp->buffer[0] =
 						pp->value;
 					break;
+				case BufferRate::ChannelIn:
 				case BufferRate::ChannelOut:
 				case BufferRate::AudioRateOutput:
 				case BufferRate::ControlRateOutput:
@@ -208,52 +320,11 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const fpp_t fr
 		}
 	}
 
-
 	// Process the buffers.
 	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
 	{
-		(m_descriptor->run)(m_handles[proc], outFrames);
-	}
-
-	// Copy the LADSPA output buffers to the LMMS buffer.
-	channel = 0;
-	const float d = dryLevel();
-	const float w = wetLevel();
-	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
-	{
-		for( int port = 0; port < m_portCount; ++port )
-		{
-			port_desc_t * pp = m_ports.at( proc ).at( port );
-			switch( pp->rate )
-			{
-				case BufferRate::ChannelIn:
-				case BufferRate::AudioRateInput:
-				case BufferRate::ControlRateInput:
-					break;
-				case BufferRate::ChannelOut:
-					for (fpp_t frame = 0; frame < outFrames; ++frame)
-					{
-						buf[frame][channel] = d * buf[frame][channel] + w * pp->buffer[frame];
-					}
-					++channel;
-					break;
-				case BufferRate::AudioRateOutput:
-				case BufferRate::ControlRateOutput:
-					break;
-				default:
-					break;
-			}
-		}
+		(m_descriptor->run)(m_handles[proc], frames);
 	}
-
-	if (outBuf != nullptr)
-	{
-		sampleBack(buf, outBuf, m_maxSampleRate);
-	}
-
-	m_pluginMutex.unlock();
-
-	return ProcessStatus::ContinueIfNotQuiet;
 }
 
 
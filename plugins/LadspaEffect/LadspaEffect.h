@@ -47,7 +47,10 @@ public:
 			const Descriptor::SubPluginFeatures::Key * _key );
 	~LadspaEffect() override;
 
+	BufferLayout bufferLayout() const override;
+
 	ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> buf) override;
 
 	void setControl( int _control, LADSPA_Data _data );
 
@@ -74,6 +77,9 @@ private:
 	void pluginInstantiation();
 	void pluginDestruction();
 
+	//! Copies the controls to their ports and runs all processors
+	void runPlugin(fpp_t frames);
+
 	static sample_rate_t maxSamplerate( const QString & _name );
 
 
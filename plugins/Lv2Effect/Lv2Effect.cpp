@@ -61,18 +61,20 @@ Plugin::Descriptor PLUGIN_EXPORT lv2effect_plugin_descriptor =
 Lv2Effect::Lv2Effect(Model* parent, const Descriptor::SubPluginFeatures::Key *key) :
 	Effect(&lv2effect_plugin_descriptor, parent, key),
 	m_controls(this, key->attributes["uri"]),
-	m_tmpOutputSmps(Engine::audioEngine()->framesPerPeriod())
+	m_tmpOutputSmps(2 * Engine::audioEngine()->framesPerPeriod()),
+	m_tmpOutputChannels{m_tmpOutputSmps.data(), m_tmpOutputSmps.data() + Engine::audioEngine()->framesPerPeriod()}
 {
 }
 
 
 
 
-Effect::ProcessStatus Lv2Effect::processImpl(SampleFrame* buf, const fpp_t frames)
+Effect::ProcessStatus Lv2Effect::processPlanarImpl(PlanarBufferView<float, 2> buf)
 {
-	Q_ASSERT(frames <= static_cast<fpp_t>(m_tmpOutputSmps.size()));
+	const fpp_t frames = buf.frames();
+	Q_ASSERT(frames <= Engine::audioEngine()->framesPerPeriod());
 
-	m_controls.copyBuffersFromLmms(buf, frames);
+	m_controls.copyBuffersFromLmms(buf);
 	m_controls.copyModelsFromLmms();
 
 //	m_pluginMutex.lock();
@@ -80,15 +82,20 @@ Effect::ProcessStatus Lv2Effect::processImpl(SampleFrame* buf, const fpp_t frame
 //	m_pluginMutex.unlock();
 
 	m_controls.copyModelsToLmms();
-	m_controls.copyBuffersToLmms(m_tmpOutputSmps.data(), frames);
+	const auto output = PlanarBufferView<float, 2>{m_tmpOutputChannels.data(), frames};
+	m_controls.copyBuffersToLmms(output);
 
 	bool corrupt = wetLevel() < 0; // #3261 - if w < 0, bash w := 0, d := 1
 	const float d = corrupt ? 1 : dryLevel();
 	const float w = corrupt ? 0 : wetLevel();
-	for(fpp_t f = 0; f < frames; ++f)
+	for (proc_ch_t ch = 0; ch < buf.channels(); ++ch)
 	{
-		buf[f][0] = d * buf[f][0] + w * m_tmpOutputSmps[f][0];
-		buf[f][1] = d * buf[f][1] + w * m_tmpOutputSmps[f][1];
+		float* dst = buf[ch];
+		const float* src = output[ch];
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			dst[f] = d * dst[f] + w * src[f];
+		}
 	}
 
 	return ProcessStatus::ContinueIfNotQuiet;
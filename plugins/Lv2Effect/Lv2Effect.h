@@ -25,6 +25,9 @@
 #ifndef LV2_EFFECT_H
 #define LV2_EFFECT_H
 
+#include <array>
+#include <vector>
+
 #include "Effect.h"
 #include "Lv2FxControls.h"
 
@@ -42,7 +45,8 @@ public:
 	*/
 	Lv2Effect(Model* parent, const Descriptor::SubPluginFeatures::Key* _key);
 
-	ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) override;
+	BufferLayout bufferLayout() const override { return BufferLayout::Planar; }
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> buf) override;
 
 	EffectControls* controls() override { return &m_controls; }
 
@@ -51,7 +55,9 @@ public:
 
 private:
 	Lv2FxControls m_controls;
-	std::vector<SampleFrame> m_tmpOutputSmps;
+	//! both channels of the plugin output, one after another
+	std::vector<float> m_tmpOutputSmps;
+	std::array<float*, 2> m_tmpOutputChannels;
 };
 
 
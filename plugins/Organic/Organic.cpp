@@ -230,8 +230,9 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 	{
 		auto oscs_l = std::array<Oscillator*, NUM_OSCILLATORS>{};
 		auto oscs_r = std::array<Oscillator*, NUM_OSCILLATORS>{};
+		auto& arena = _n->pluginDataArena();
 
-		_n->m_pluginData = new oscPtr;
+		_n->m_pluginData = arena.create<oscPtr>();
 
 		for( int i = m_numOscillators - 1; i >= 0; --i )
 		{
@@ -245,7 +246,7 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 			if( i == m_numOscillators - 1 )
 			{
 				// create left oscillator
-				oscs_l[i] = new Oscillator(
+				oscs_l[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShape,
 						&m_modulationAlgo,
 						_n->frequency(),
@@ -253,7 +254,7 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 						static_cast<oscPtr *>( _n->m_pluginData )->phaseOffsetLeft[i],
 						m_osc[i]->m_volumeLeft );
 				// create right oscillator
-				oscs_r[i] = new Oscillator(
+				oscs_r[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShape,
 						&m_modulationAlgo,
 						_n->frequency(),
@@ -264,7 +265,7 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 			else
 			{
 				// create left oscillator
-				oscs_l[i] = new Oscillator(
+				oscs_l[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShape,
 						&m_modulationAlgo,
 						_n->frequency(),
@@ -273,7 +274,7 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 						m_osc[i]->m_volumeLeft,
 						oscs_l[i + 1] );
 				// create right oscillator
-				oscs_r[i] = new Oscillator(
+				oscs_r[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShape,
 						&m_modulationAlgo,
 						_n->frequency(),
@@ -316,16 +317,6 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 
 
 
-void OrganicInstrument::deleteNotePluginData( NotePlayHandle * _n )
-{
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscLeft );
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscRight );
-
-	delete static_cast<oscPtr *>( _n->m_pluginData );
-}
-
 /*float inline OrganicInstrument::foldback(float in, float threshold)
 {
   if (in>threshold || in<-threshold)
@@ -125,7 +125,6 @@ public:
 
 	void playNote( NotePlayHandle * _n,
 						SampleFrame* _working_buffer ) override;
-	void deleteNotePluginData( NotePlayHandle * _n ) override;
 
 
 	void saveSettings(QDomDocument& doc, QDomElement& elem) override;
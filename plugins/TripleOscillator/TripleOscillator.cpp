@@ -25,10 +25,12 @@
 
 #include <QDomElement>
 #include <QFileInfo>
+#include <array>
 
 #include "TripleOscillator.h"
 #include "AudioEngine.h"
 #include "AutomatableButton.h"
+#include "BufferManager.h"
 #include "Engine.h"
 #include "InstrumentTrack.h"
 #include "Knob.h"
@@ -310,6 +312,7 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 	{
 		auto oscs_l = std::array<Oscillator*, NUM_OF_OSCILLATORS>{};
 		auto oscs_r = std::array<Oscillator*, NUM_OF_OSCILLATORS>{};
+		auto& arena = _n->pluginDataArena();
 
 		for( int i = NUM_OF_OSCILLATORS - 1; i >= 0; --i )
 		{
@@ -317,7 +320,7 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 			// the last oscs needs no sub-oscs...
 			if( i == NUM_OF_OSCILLATORS - 1 )
 			{
-				oscs_l[i] = new Oscillator(
+				oscs_l[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShapeModel,
 						&m_osc[i]->m_modulationAlgoModel,
 						_n->frequency(),
@@ -325,7 +328,7 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 						m_osc[i]->m_phaseOffsetLeft,
 						m_osc[i]->m_volumeLeft );
 				oscs_l[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
-				oscs_r[i] = new Oscillator(
+				oscs_r[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShapeModel,
 						&m_osc[i]->m_modulationAlgoModel,
 						_n->frequency(),
@@ -336,7 +339,7 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 			}
 			else
 			{
-				oscs_l[i] = new Oscillator(
+				oscs_l[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShapeModel,
 						&m_osc[i]->m_modulationAlgoModel,
 						_n->frequency(),
@@ -345,7 +348,7 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 						m_osc[i]->m_volumeLeft,
 						oscs_l[i + 1] );
 				oscs_l[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
-				oscs_r[i] = new Oscillator(
+				oscs_r[i] = arena.create<Oscillator>(
 						&m_osc[i]->m_waveShapeModel,
 						&m_osc[i]->m_modulationAlgoModel,
 						_n->frequency(),
@@ -362,10 +365,7 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 			oscs_r[i]->setUserAntiAliasWaveTable(m_osc[i]->m_userAntiAliasWaveTable);
 		}
 
-		_n->m_pluginData = new oscPtr;
-		static_cast<oscPtr *>( _n->m_pluginData )->oscLeft = oscs_l[0];
-		static_cast< oscPtr *>( _n->m_pluginData )->oscRight =
-								oscs_r[0];
+		_n->m_pluginData = arena.create<oscPtr>( oscPtr{ oscs_l[0], oscs_r[0] } );
 	}
 
 	Oscillator * osc_l = static_cast<oscPtr *>( _n->m_pluginData )->oscLeft;
@@ -374,23 +374,20 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 	const fpp_t frames = _n->framesLeftForCurrentPeriod();
 	const f_cnt_t offset = _n->noteOffset();
 
-	osc_l->update( _working_buffer + offset, frames, 0 );
-	osc_r->update( _working_buffer + offset, frames, 1 );
-
-	applyFadeIn(_working_buffer, _n);
-	applyRelease( _working_buffer, _n );
-}
+	// render both channels into planar scratch, where the oscillators can work
+	// on blocks of frames, and interleave them into the working buffer afterwards
+	SampleFrame* storage = BufferManager::acquire();
+	const auto samples = reinterpret_cast<float*>(storage);
+	const auto channels = std::array{samples, samples + Engine::audioEngine()->framesPerPeriod()};
+	const auto planar = PlanarBufferView<float, 2>{channels.data(), frames};
 
+	Oscillator::update(*osc_l, *osc_r, planar);
+	interleave<float, 2>(planar, std::span<SampleFrame>{_working_buffer + offset, frames});
 
+	BufferManager::release(storage);
 
-
-void TripleOscillator::deleteNotePluginData( NotePlayHandle * _n )
-{
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscLeft );
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscRight );
-	delete static_cast<oscPtr *>( _n->m_pluginData );
+	applyFadeIn(_working_buffer, _n);
+	applyRelease( _working_buffer, _n );
 }
 
 
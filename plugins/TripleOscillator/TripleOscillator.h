@@ -112,7 +112,6 @@ public:
 
 	void playNote( NotePlayHandle * _n,
 						SampleFrame* _working_buffer ) override;
-	void deleteNotePluginData( NotePlayHandle * _n ) override;
 
 
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
@@ -25,6 +25,9 @@
 
 #include "VstEffect.h"
 
+#include <algorithm>
+#include <array>
+
 #include "GuiApplication.h"
 #include "Song.h"
 #include "TextFloat.h"
@@ -79,24 +82,36 @@ VstEffect::VstEffect( Model * _parent,
 
 
 
-Effect::ProcessStatus VstEffect::processImpl(SampleFrame* buf, const fpp_t frames)
+Effect::ProcessStatus VstEffect::processPlanarImpl(PlanarBufferView<float, 2> buf)
 {
 	assert(m_plugin != nullptr);
-	static thread_local auto tempBuf = std::array<SampleFrame, MAXIMUM_BUFFER_SIZE>();
+	static thread_local auto tempBuf = std::array<float, 2 * MAXIMUM_BUFFER_SIZE>();
+
+	const fpp_t frames = buf.frames();
+	const auto channels = std::array{tempBuf.data(), tempBuf.data() + frames};
+	const auto wet = PlanarBufferView<float, 2>{channels.data(), frames};
+
+	// the wet signal stays the dry one if the plugin doesn't produce any
+	// output, e.g. because it has no outputs or is busy
+	for (proc_ch_t ch = 0; ch < buf.channels(); ++ch)
+	{
+		std::copy_n(buf[ch], frames, wet[ch]);
+	}
 
-	std::memcpy(tempBuf.data(), buf, sizeof(SampleFrame) * frames);
 	if (m_pluginMutex.tryLock(Engine::getSong()->isExporting() ? -1 : 0))
 	{
-		m_plugin->process(tempBuf.data(), tempBuf.data());
+		m_plugin->process(buf, wet);
 		m_pluginMutex.unlock();
 	}
 
 	const float w = wetLevel();
 	const float d = dryLevel();
-	for (fpp_t f = 0; f < frames; ++f)
+	for (proc_ch_t ch = 0; ch < buf.channels(); ++ch)
 	{
-		buf[f][0] = w * tempBuf[f][0] + d * buf[f][0];
-		buf[f][1] = w * tempBuf[f][1] + d * buf[f][1];
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			buf[ch][f] = w * wet[ch][f] + d * buf[ch][f];
+		}
 	}
 
 	return ProcessStatus::ContinueIfNotQuiet;
@@ -45,7 +45,8 @@ public:
 			const Descriptor::SubPluginFeatures::Key * _key );
 	~VstEffect() override = default;
 
-	ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) override;
+	BufferLayout bufferLayout() const override { return BufferLayout::Planar; }
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> buf) override;
 
 	EffectControls * controls() override
 	{
@@ -0,0 +1,603 @@
+/*
+ * ExprBlock.cpp - evaluates Xpressive expressions a whole period at a time
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ExprBlock.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <string_view>
+
+namespace lmms
+{
+
+namespace
+{
+
+std::string toLower(std::string name)
+{
+	std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+	return name;
+}
+
+//! The multiplication sequence ExprTk uses for integer exponents
+float integerPower(float v, int exponent)
+{
+	const auto power = [](float v, unsigned int n) -> float {
+		switch (n)
+		{
+			case 0: return 1.f;
+			case 1: return v;
+			case 2: return v * v;
+			case 3: return v * v * v;
+			case 4: { const float v2 = v * v; return v2 * v2; }
+			case 5: { const float v2 = v * v; return v2 * v2 * v; }
+			case 6: { const float v3 = v * v * v; return v3 * v3; }
+			case 7: { const float v3 = v * v * v; return v3 * v3 * v; }
+			case 8: { const float v2 = v * v; const float v4 = v2 * v2; return v4 * v4; }
+			case 9: { const float v2 = v * v; const float v4 = v2 * v2; return v4 * v4 * v; }
+			case 10: { const float v2 = v * v; const float v5 = v2 * v2 * v; return v5 * v5; }
+		}
+
+		float result = 1.f;
+		while (n)
+		{
+			if (n % 2 == 1)
+			{
+				result *= v;
+				--n;
+			}
+			v *= v;
+			n /= 2;
+		}
+		return result;
+	};
+
+	return exponent < 0
+		? 1.f / power(v, static_cast<unsigned int>(-exponent))
+		: power(v, static_cast<unsigned int>(exponent));
+}
+
+constexpr int MaxIntegerExponent = 60;
+
+} // namespace
+
+
+
+
+//! Recursive descent parser for the supported subset of the ExprTk syntax.
+//! Every parse function returns the index of the node it added, or -1 if the
+//! expression can't be block compiled.
+class ExprBlock::Parser
+{
+public:
+	Parser(const std::string& text, const ExprBlock& block) :
+		m_text(text),
+		m_block(block)
+	{
+	}
+
+	std::vector<Node> parse()
+	{
+		const int root = comparison();
+		skipSpace();
+		if (root < 0 || m_pos != m_text.size()) { m_nodes.clear(); }
+		return std::move(m_nodes);
+	}
+
+private:
+	void skipSpace()
+	{
+		while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) { ++m_pos; }
+	}
+
+	bool accept(const char* token)
+	{
+		skipSpace();
+		const auto length = std::char_traits<char>::length(token);
+		if (m_text.compare(m_pos, length, token) != 0) { return false; }
+		m_pos += length;
+		return true;
+	}
+
+	int add(Node node, int a = -1, int b = -1, int c = -1)
+	{
+		node.args[0] = a;
+		node.args[1] = b;
+		node.args[2] = c;
+
+		const bool pure = node.op != Op::Variable && node.op != Op::Input
+			&& node.op != Op::Function1 && node.op != Op::Function2;
+		node.varying = node.op == Op::Input;
+		node.constant = node.op == Op::Constant || (pure && a >= 0);
+		for (int arg : node.args)
+		{
+			if (arg < 0) { continue; }
+			node.varying = node.varying || m_nodes[arg].varying;
+			node.constant = node.constant && m_nodes[arg].constant;
+		}
+
+		m_nodes.push_back(node);
+		return static_cast<int>(m_nodes.size()) - 1;
+	}
+
+	int add(Op op, int a = -1, int b = -1, int c = -1)
+	{
+		return add(Node{op}, a, b, c);
+	}
+
+	int comparison()
+	{
+		const int left = additive();
+		if (left < 0) { return -1; }
+
+		// ExprTk's equality operators compare with a tolerance
+		skipSpace();
+		if (accept("==") || accept("!=") || accept("<>") || accept("=")) { return -1; }
+
+		Op op;
+		if (accept("<=")) { op = Op::LessEqual; }
+		else if (accept(">=")) { op = Op::GreaterEqual; }
+		else if (accept("<")) { op = Op::Less; }
+		else if (accept(">")) { op = Op::Greater; }
+		else { return left; }
+
+		const int right = additive();
+		if (right < 0) { return -1; }
+
+		// chained comparisons are left to ExprTk
+		skipSpace();
+		if (m_pos < m_text.size() && std::string_view{"<>=!"}.find(m_text[m_pos]) != std::string_view::npos)
+		{
+			return -1;
+		}
+		return add(op, left, right);
+	}
+
+	int additive()
+	{
+		int left = multiplicative();
+		while (left >= 0)
+		{
+			Op op;
+			if (accept("+")) { op = Op::Add; }
+			else if (accept("-")) { op = Op::Subtract; }
+			else { break; }
+
+			const int right = multiplicative();
+			left = right < 0 ? -1 : add(op, left, right);
+		}
+		return left;
+	}
+
+	int multiplicative()
+	{
+		int left = unary();
+		while (left >= 0)
+		{
+			Op op;
+			if (accept("*")) { op = Op::Multiply; }
+			else if (accept("/")) { op = Op::Divide; }
+			else if (accept("%")) { op = Op::Modulo; }
+			else { break; }
+
+			const int right = unary();
+			left = right < 0 ? -1 : add(op, left, right);
+		}
+		return left;
+	}
+
+	int unary()
+	{
+		if (accept("-"))
+		{
+			// whether the minus binds to the base or the power of "-x^y" is
+			// left to ExprTk
+			bool hasPower = false;
+			const int operand = power(hasPower);
+			return operand < 0 || hasPower ? -1 : add(Op::Negate, operand);
+		}
+		if (accept("+")) { return unary(); }
+
+		bool hasPower = false;
+		return power(hasPower);
+	}
+
+	int power(bool& hasPower)
+	{
+		const int base = primary();
+		if (base < 0 || !accept("^")) { return base; }
+		hasPower = true;
+
+		const bool negative = accept("-");
+		skipSpace();
+		const std::size_t exponentStart = m_pos;
+		int exponent = primary();
+		if (exponent < 0) { return -1; }
+
+		// as is the associativity of "x^y^z"
+		if (accept("^")) { return -1; }
+
+		const Node& e = m_nodes[exponent];
+		const bool literal = e.op == Op::Constant && !m_literals.empty() && m_literals.back() == exponentStart;
+		if (literal && std::trunc(e.value) == e.value && std::abs(e.value) <= MaxIntegerExponent)
+		{
+			auto node = Node{Op::IntegerPower};
+			node.exponent = static_cast<int>(negative ? -e.value : e.value);
+			return add(node, base);
+		}
+
+		if (negative) { exponent = add(Op::Negate, exponent); }
+		return add(Op::Power, base, exponent);
+	}
+
+	int primary()
+	{
+		skipSpace();
+		if (m_pos >= m_text.size()) { return -1; }
+
+		const char c = m_text[m_pos];
+		if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') { return number(); }
+		if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') { return identifier(); }
+		if (accept("("))
+		{
+			const int node = comparison();
+			return node >= 0 && accept(")") ? node : -1;
+		}
+		return -1;
+	}
+
+	int number()
+	{
+		const std::size_t start = m_pos;
+		while (m_pos < m_text.size() && (std::isdigit(static_cast<unsigned char>(m_text[m_pos])) || m_text[m_pos] == '.'))
+		{
+			++m_pos;
+		}
+		if (m_pos < m_text.size() && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E'))
+		{
+			std::size_t end = m_pos + 1;
+			if (end < m_text.size() && (m_text[end] == '+' || m_text[end] == '-')) { ++end; }
+			if (end < m_text.size() && std::isdigit(static_cast<unsigned char>(m_text[end])))
+			{
+				m_pos = end;
+				while (m_pos < m_text.size() && std::isdigit(static_cast<unsigned char>(m_text[m_pos]))) { ++m_pos; }
+			}
+		}
+
+		const std::string literal = m_text.substr(start, m_pos - start);
+		char* end = nullptr;
+		auto node = Node{Op::Constant};
+		node.value = std::strtof(literal.c_str(), &end);
+		if (end != literal.c_str() + literal.size()) { return -1; }
+
+		m_literals.push_back(start);
+		return add(node);
+	}
+
+	int identifier()
+	{
+		const std::size_t start = m_pos;
+		while (m_pos < m_text.size() && (std::isalnum(static_cast<unsigned char>(m_text[m_pos])) || m_text[m_pos] == '_'))
+		{
+			++m_pos;
+		}
+		const std::string name = toLower(m_text.substr(start, m_pos - start));
+
+		if (!accept("("))
+		{
+			const Symbol* symbol = m_block.findSymbol(name);
+			if (!symbol || symbol->op == Op::Function1 || symbol->op == Op::Function2) { return -1; }
+
+			auto node = Node{symbol->op};
+			node.value = symbol->value;
+			node.source = symbol->source;
+			return add(node);
+		}
+
+		std::vector<int> args;
+		if (!accept(")"))
+		{
+			do
+			{
+				const int arg = comparison();
+				if (arg < 0) { return -1; }
+				args.push_back(arg);
+			}
+			while (accept(","));
+			if (!accept(")")) { return -1; }
+		}
+
+		return call(name, args);
+	}
+
+	int call(const std::string& name, const std::vector<int>& args)
+	{
+		const auto arity = args.size();
+		if (arity == 1)
+		{
+			if (name == "abs") { return add(Op::Abs, args[0]); }
+			if (name == "sqrt") { return add(Op::Sqrt, args[0]); }
+			if (name == "floor") { return add(Op::Floor, args[0]); }
+			if (name == "ceil") { return add(Op::Ceil, args[0]); }
+		}
+		if (arity == 2 && name == "pow") { return add(Op::Power, args[0], args[1]); }
+		if (arity == 3 && name == "clamp") { return add(Op::Clamp, args[0], args[1], args[2]); }
+		if (arity >= 2 && (name == "min" || name == "max"))
+		{
+			const Op op = name == "min" ? Op::Min : Op::Max;
+			int node = args[0];
+			for (std::size_t i = 1; i < arity; ++i) { node = add(op, node, args[i]); }
+			return node;
+		}
+
+		const Symbol* symbol = m_block.findSymbol(name);
+		if (!symbol) { return -1; }
+
+		auto node = Node{symbol->op};
+		node.function1 = symbol->function1;
+		node.function2 = symbol->function2;
+		node.data = symbol->data;
+		if (symbol->op == Op::Function1 && arity == 1) { return add(node, args[0]); }
+		if (symbol->op == Op::Function2 && arity == 2) { return add(node, args[0], args[1]); }
+		return -1;
+	}
+
+	const std::string& m_text;
+	const ExprBlock& m_block;
+	std::size_t m_pos = 0;
+	std::vector<Node> m_nodes;
+	//! start positions of the number literals
+	std::vector<std::size_t> m_literals;
+};
+
+
+
+
+ExprBlock::ExprBlock()
+{
+	addFunction("sin", [](void*, float x) { return std::sin(x); });
+	addFunction("cos", [](void*, float x) { return std::cos(x); });
+	addFunction("tan", [](void*, float x) { return std::tan(x); });
+	addFunction("asin", [](void*, float x) { return std::asin(x); });
+	addFunction("acos", [](void*, float x) { return std::acos(x); });
+	addFunction("atan", [](void*, float x) { return std::atan(x); });
+	addFunction("sinh", [](void*, float x) { return std::sinh(x); });
+	addFunction("cosh", [](void*, float x) { return std::cosh(x); });
+	addFunction("tanh", [](void*, float x) { return std::tanh(x); });
+	addFunction("exp", [](void*, float x) { return std::exp(x); });
+	addFunction("log", [](void*, float x) { return std::log(x); });
+	addFunction("log10", [](void*, float x) { return std::log10(x); });
+	addFunction("atan2", [](void*, float y, float x) { return std::atan2(y, x); });
+}
+
+
+
+
+void ExprBlock::addConstant(const std::string& name, float value)
+{
+	auto symbol = Symbol{Op::Constant};
+	symbol.value = value;
+	m_symbols.emplace_back(toLower(name), symbol);
+}
+
+
+
+
+void ExprBlock::addVariable(const std::string& name, const float* value)
+{
+	auto symbol = Symbol{Op::Variable};
+	symbol.source = value;
+	m_symbols.emplace_back(toLower(name), symbol);
+}
+
+
+
+
+void ExprBlock::addInput(const std::string& name, const float* values)
+{
+	auto symbol = Symbol{Op::Input};
+	symbol.source = values;
+	m_symbols.emplace_back(toLower(name), symbol);
+}
+
+
+
+
+void ExprBlock::addFunction(const std::string& name, Function1 function, void* data)
+{
+	auto symbol = Symbol{Op::Function1};
+	symbol.function1 = function;
+	symbol.data = data;
+	m_symbols.emplace_back(toLower(name), symbol);
+}
+
+
+
+
+void ExprBlock::addFunction(const std::string& name, Function2 function, void* data)
+{
+	auto symbol = Symbol{Op::Function2};
+	symbol.function2 = function;
+	symbol.data = data;
+	m_symbols.emplace_back(toLower(name), symbol);
+}
+
+
+
+
+bool ExprBlock::compile(const std::string& expression, fpp_t maxFrames)
+{
+	m_nodes = Parser{expression, *this}.parse();
+	m_maxFrames = maxFrames;
+	m_values.assign(m_nodes.size() * m_maxFrames, 0.f);
+	m_results.resize(m_nodes.size());
+
+	for (std::size_t node = 0; node < m_nodes.size(); ++node)
+	{
+		m_results[node] = m_nodes[node].op == Op::Input ? m_nodes[node].source : values(node);
+		if (m_nodes[node].constant)
+		{
+			evaluateNode(node, 1);
+			std::fill_n(values(node) + 1, m_maxFrames - 1, values(node)[0]);
+		}
+	}
+	return isCompiled();
+}
+
+
+
+
+void ExprBlock::clear()
+{
+	m_nodes.clear();
+	m_values.clear();
+	m_results.clear();
+}
+
+
+
+
+void ExprBlock::evaluate(fpp_t frames, float* out)
+{
+	for (std::size_t node = 0; node < m_nodes.size(); ++node)
+	{
+		const Node& n = m_nodes[node];
+		if (n.constant || n.op == Op::Input) { continue; }
+
+		if (n.varying)
+		{
+			evaluateNode(node, frames);
+		}
+		else
+		{
+			// the same for every frame of this period
+			evaluateNode(node, 1);
+			std::fill_n(values(node) + 1, frames - 1, values(node)[0]);
+		}
+	}
+	std::copy_n(m_results.back(), frames, out);
+}
+
+
+
+
+const ExprBlock::Symbol* ExprBlock::findSymbol(const std::string& name) const
+{
+	// symbols added later replace earlier ones, like in a symbol table
+	const auto it = std::find_if(m_symbols.rbegin(), m_symbols.rend(),
+		[&name](const auto& symbol) { return symbol.first == name; });
+	return it != m_symbols.rend() ? &it->second : nullptr;
+}
+
+
+
+
+void ExprBlock::evaluateNode(std::size_t node, fpp_t frames)
+{
+	const Node& n = m_nodes[node];
+	float* const dst = values(node);
+	const float* const a = n.args[0] >= 0 ? m_results[n.args[0]] : nullptr;
+	const float* const b = n.args[1] >= 0 ? m_results[n.args[1]] : nullptr;
+	const float* const c = n.args[2] >= 0 ? m_results[n.args[2]] : nullptr;
+
+	switch (n.op)
+	{
+		case Op::Constant:
+			dst[0] = n.value;
+			break;
+		case Op::Variable:
+			dst[0] = *n.source;
+			break;
+		case Op::Input:
+			break;
+		case Op::Negate:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = -a[f]; }
+			break;
+		case Op::Add:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] + b[f]; }
+			break;
+		case Op::Subtract:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] - b[f]; }
+			break;
+		case Op::Multiply:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] * b[f]; }
+			break;
+		case Op::Divide:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] / b[f]; }
+			break;
+		case Op::Modulo:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::fmod(a[f], b[f]); }
+			break;
+		case Op::Power:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::pow(a[f], b[f]); }
+			break;
+		case Op::IntegerPower:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = integerPower(a[f], n.exponent); }
+			break;
+		case Op::Less:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] < b[f] ? 1.f : 0.f; }
+			break;
+		case Op::LessEqual:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] <= b[f] ? 1.f : 0.f; }
+			break;
+		case Op::Greater:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] > b[f] ? 1.f : 0.f; }
+			break;
+		case Op::GreaterEqual:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = a[f] >= b[f] ? 1.f : 0.f; }
+			break;
+		case Op::Min:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::min(a[f], b[f]); }
+			break;
+		case Op::Max:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::max(a[f], b[f]); }
+			break;
+		case Op::Clamp:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = b[f] < a[f] ? a[f] : (b[f] > c[f] ? c[f] : b[f]); }
+			break;
+		case Op::Abs:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::abs(a[f]); }
+			break;
+		case Op::Sqrt:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::sqrt(a[f]); }
+			break;
+		case Op::Floor:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::floor(a[f]); }
+			break;
+		case Op::Ceil:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = std::ceil(a[f]); }
+			break;
+		case Op::Function1:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = n.function1(n.data, a[f]); }
+			break;
+		case Op::Function2:
+			for (fpp_t f = 0; f < frames; ++f) { dst[f] = n.function2(n.data, a[f], b[f]); }
+			break;
+	}
+}
+
+
+} // namespace lmms
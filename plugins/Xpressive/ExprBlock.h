@@ -0,0 +1,160 @@
+/*
+ * ExprBlock.h - evaluates Xpressive expressions a whole period at a time
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_EXPR_BLOCK_H
+#define LMMS_EXPR_BLOCK_H
+
+#include <string>
+#include <vector>
+
+#include "LmmsTypes.h"
+
+namespace lmms
+{
+
+
+/**
+	@brief Block compiled form of an Xpressive expression
+
+	Instead of walking the expression tree once per sample, every node is
+	evaluated for all frames of a period before its parent, so the arithmetic
+	runs in tight loops the compiler can vectorise. Each node performs the same
+	single precision operation as the corresponding ExprTk node, in the same
+	order, to keep the output identical to ExprFront::evaluate(). ExprTk may
+	still rearrange some constant expressions, so ExprSynth compares the first
+	period of each voice with ExprTk's output before relying on it.
+
+	Only the subset of the ExprTk syntax Xpressive patches commonly use is
+	supported. compile() fails for everything else, e.g. stateful functions
+	like integrate() and last(), which have to stay on the per-sample path.
+*/
+class ExprBlock
+{
+public:
+	using Function1 = float (*)(void* data, float x);
+	using Function2 = float (*)(void* data, float x, float y);
+
+	ExprBlock();
+
+	//! Symbols are looked up case insensitively, like ExprTk does
+	void addConstant(const std::string& name, float value);
+	//! A variable that may change between periods, but not within one
+	void addVariable(const std::string& name, const float* value);
+	//! A variable with a separate value for every frame of the period
+	void addInput(const std::string& name, const float* values);
+	void addFunction(const std::string& name, Function1 function, void* data = nullptr);
+	void addFunction(const std::string& name, Function2 function, void* data = nullptr);
+
+	bool compile(const std::string& expression, fpp_t maxFrames);
+
+	bool isCompiled() const
+	{
+		return !m_nodes.empty();
+	}
+
+	void clear();
+
+	//! Writes the result for @p frames frames, which must not be more
+	//! than the maximum given to compile(), to @p out
+	void evaluate(fpp_t frames, float* out);
+
+private:
+	enum class Op
+	{
+		Constant,
+		Variable,
+		Input,
+		Negate,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Modulo,
+		Power,
+		IntegerPower,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		Min,
+		Max,
+		Clamp,
+		Abs,
+		Sqrt,
+		Floor,
+		Ceil,
+		Function1,
+		Function2
+	};
+
+	struct Node
+	{
+		Op op;
+		int args[3] = {-1, -1, -1};
+		float value = 0.f;
+		const float* source = nullptr;
+		int exponent = 0;
+		Function1 function1 = nullptr;
+		Function2 function2 = nullptr;
+		void* data = nullptr;
+		//! depends on an input, so every frame has to be computed
+		bool varying = false;
+		//! depends on constants only, so it's computed by compile()
+		bool constant = false;
+	};
+
+	struct Symbol
+	{
+		Op op;
+		float value = 0.f;
+		const float* source = nullptr;
+		Function1 function1 = nullptr;
+		Function2 function2 = nullptr;
+		void* data = nullptr;
+	};
+
+	class Parser;
+
+	float* values(std::size_t node)
+	{
+		return m_values.data() + node * m_maxFrames;
+	}
+
+	const Symbol* findSymbol(const std::string& name) const;
+	void evaluateNode(std::size_t node, fpp_t frames);
+
+	std::vector<std::pair<std::string, Symbol>> m_symbols;
+	//! in evaluation order, the root comes last
+	std::vector<Node> m_nodes;
+	//! storage for the results of all nodes, one period per node
+	std::vector<float> m_values;
+	//! where the result of each node can be read from
+	std::vector<const float*> m_results;
+	fpp_t m_maxFrames = 0;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_EXPR_BLOCK_H
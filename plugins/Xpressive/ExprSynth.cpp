@@ -28,9 +28,13 @@
 #include <string>
 #include <vector>
 #include <cmath>
+#include <cstring>
 #include <random>
 #include <numbers>
 
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "ExprBlock.h"
 #include "lmms_math.h"
 #include "NotePlayHandle.h"
 #include "SampleFrame.h"
@@ -403,6 +407,7 @@ public:
 	RandomVectorFunction m_rand_vec;
 	IntegrateFunction<float> *m_integ_func;
 	LastSampleFunction<float> m_last_func;
+	ExprBlock m_block;
 
 };
 
@@ -536,7 +541,8 @@ ExprFront::ExprFront(const char * expr, int last_func_samples)
 
 		m_data->m_symbol_table.add_constant("e", std::numbers::e_v<float>);
 
-		m_data->m_symbol_table.add_constant("seed", SimpleRandom::generator() & max_float_integer_mask);
+		const float seed = SimpleRandom::generator() & max_float_integer_mask;
+		m_data->m_symbol_table.add_constant("seed", seed);
 
 		m_data->m_symbol_table.add_function("sinew", sin_wave_func);
 		m_data->m_symbol_table.add_function("squarew", square_wave_func);
@@ -552,6 +558,27 @@ ExprFront::ExprFront(const char * expr, int last_func_samples)
 		m_data->m_symbol_table.add_function("randv", m_data->m_rand_vec);
 		m_data->m_symbol_table.add_function("randsv", randsv_func);
 		m_data->m_symbol_table.add_function("last", m_data->m_last_func);
+
+		// the same symbols for the block compiled expression, except for
+		// rand() and last(), which depend on the order of evaluation
+		ExprBlock& block = m_data->m_block;
+		block.addConstant("pi", std::numbers::pi_v<float>);
+		block.addConstant("e", std::numbers::e_v<float>);
+		block.addConstant("seed", seed);
+		block.addFunction("sinew", [](void*, float x) { return sin_wave::process(x); });
+		block.addFunction("squarew", [](void*, float x) { return square_wave::process(x); });
+		block.addFunction("trianglew", [](void*, float x) { return triangle_wave::process(x); });
+		block.addFunction("saww", [](void*, float x) { return saw_wave::process(x); });
+		block.addFunction("moogsaww", [](void*, float x) { return moogsaw_wave::process(x); });
+		block.addFunction("moogw", [](void*, float x) { return moog_wave::process(x); });
+		block.addFunction("expw", [](void*, float x) { return exp_wave::process(x); });
+		block.addFunction("expnw", [](void*, float x) { return exp2_wave::process(x); });
+		block.addFunction("cent", [](void*, float x) { return harmonic_cent::process(x); });
+		block.addFunction("semitone", [](void*, float x) { return harmonic_semitone::process(x); });
+		block.addFunction("randv", [](void* data, float x) {
+			return (*static_cast<RandomVectorFunction*>(data))(x);
+		}, &m_data->m_rand_vec);
+		block.addFunction("randsv", [](void*, float x, float s) { return randsv_func(x, s); });
 	}
 	catch(...)
 	{
@@ -610,6 +637,7 @@ bool ExprFront::add_variable(const char* name, float& ref)
 {
 	try
 	{
+		m_data->m_block.addVariable(name, &ref);
 		return m_data->m_symbol_table.add_variable(name, ref);
 	}
 	catch(...)
@@ -623,6 +651,7 @@ bool ExprFront::add_constant(const char* name, float ref)
 {
 	try
 	{
+		m_data->m_block.addConstant(name, ref);
 		return m_data->m_symbol_table.add_constant(name, ref);
 	}
 	catch(...)
@@ -640,12 +669,18 @@ bool ExprFront::add_cyclic_vector(const char* name, const float* data, size_t le
 		{
 			auto wvf = new WaveValueFunctionInterpolate<float>(data, length);
 			m_data->m_cyclics_interp.push_back(wvf);
+			m_data->m_block.addFunction(name, [](void* wave, float x) {
+				return (*static_cast<WaveValueFunctionInterpolate<float>*>(wave))(x);
+			}, wvf);
 			return m_data->m_symbol_table.add_function(name, *wvf);
 		}
 		else
 		{
 			auto wvf = new WaveValueFunction<float>(data, length);
 			m_data->m_cyclics.push_back(wvf);
+			m_data->m_block.addFunction(name, [](void* wave, float x) {
+				return (*static_cast<WaveValueFunction<float>*>(wave))(x);
+			}, wvf);
 			return m_data->m_symbol_table.add_function(name, *wvf);
 		}
 	}
@@ -655,6 +690,39 @@ bool ExprFront::add_cyclic_vector(const char* name, const float* data, size_t le
 	}
 	return false;
 }
+void ExprFront::add_block_input(const char* name, const float* values)
+{
+	m_data->m_block.addInput(name, values);
+}
+
+bool ExprFront::compileBlock(fpp_t maxFrames)
+{
+	try
+	{
+		return m_valid && m_data->m_block.compile(m_data->m_expression_string, maxFrames);
+	}
+	catch(...)
+	{
+		WARN_EXPRTK;
+	}
+	return false;
+}
+
+bool ExprFront::isBlockCompiled() const
+{
+	return m_data->m_block.isCompiled();
+}
+
+void ExprFront::evaluateBlock(fpp_t frames, float* out)
+{
+	m_data->m_block.evaluate(frames, out);
+}
+
+void ExprFront::disableBlock()
+{
+	m_data->m_block.clear();
+}
+
 size_t find_occurances(const std::string& haystack, const char* const needle)
 {
 	size_t last_pos = 0;
@@ -707,7 +775,9 @@ ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSam
 	m_sample_rate(sample_rate),
 	m_pan1(pan1),
 	m_pan2(pan2),
-	m_rel_transition(rel_trans)
+	m_rel_transition(rel_trans),
+	m_o1_verified(false),
+	m_o2_verified(false)
 {
 	m_note_sample = 0;
 	m_note_rel_sample = 0;
@@ -717,7 +787,13 @@ ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSam
 	m_frequency = m_nph->frequency();
 	m_rel_inc = 1000.0 / (m_sample_rate * m_rel_transition);//rel_transition in ms. compute how much increment in each frame
 
-	auto init_expression_step2 = [this](ExprFront * e) {
+	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
+	for (auto block : {&m_block_t, &m_block_f, &m_block_rel, &m_block_trel, &m_out1, &m_out2, &m_check})
+	{
+		block->resize(frames);
+	}
+
+	auto init_expression_step2 = [this, frames](ExprFront * e) {
 		e->add_cyclic_vector("W1", m_W1->m_samples,m_W1->m_length, m_W1->m_interpolate);
 		e->add_cyclic_vector("W2", m_W2->m_samples,m_W2->m_length, m_W2->m_interpolate);
 		e->add_cyclic_vector("W3", m_W3->m_samples,m_W3->m_length, m_W3->m_interpolate);
@@ -727,6 +803,11 @@ ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSam
 		e->add_variable("trel",m_note_rel_sec);
 		e->setIntegrate(&m_note_sample,m_sample_rate);
 		e->compile();
+		e->add_block_input("t", m_block_t.data());
+		e->add_block_input("f", m_block_f.data());
+		e->add_block_input("rel", m_block_rel.data());
+		e->add_block_input("trel", m_block_trel.data());
+		e->compileBlock(frames);
 	};
 	init_expression_step2(m_exprO1);
 	init_expression_step2(m_exprO2);
@@ -755,73 +836,90 @@ void ExprSynth::renderOutput(fpp_t frames, SampleFrame* buf)
 		{
 			return;
 		}
-		float o1 = 0, o2 = 0;
 		float pn1 = m_pan1->value() * 0.5;
 		float pn2 = m_pan2->value() * 0.5;
 		const float new_freq = m_nph->frequency();
 		const float freq_inc = (new_freq - m_frequency) / frames;
 		const bool is_released = m_nph->isReleased();
 
-		expression_t *o1_rawExpr = &(m_exprO1->getData()->m_expression);
-		expression_t *o2_rawExpr = &(m_exprO2->getData()->m_expression);
-		LastSampleFunction<float> * last_func1 = &m_exprO1->getData()->m_last_func;
-		LastSampleFunction<float> * last_func2 = &m_exprO2->getData()->m_last_func;
+		// block compiled expressions are evaluated after the loop below, once all
+		// their inputs are known. Until they produced the same output as ExprTk,
+		// both are evaluated.
+		const bool o1_block = o1_valid && m_exprO1->isBlockCompiled();
+		const bool o2_block = o2_valid && m_exprO2->isBlockCompiled();
+		const bool o1_per_sample = o1_valid && !(o1_block && m_o1_verified);
+		const bool o2_per_sample = o2_valid && !(o2_block && m_o2_verified);
+
 		if (is_released && m_note_rel_sample == 0)
 		{
 			m_note_rel_sample = m_note_sample;
 		}
+		for (fpp_t frame = 0; frame < frames ; ++frame)
+		{
+			if (is_released && m_released < 1)
+			{
+				m_released = fmin(m_released+m_rel_inc, 1);
+			}
+			m_block_t[frame] = m_note_sample_sec;
+			m_block_f[frame] = m_frequency;
+			m_block_rel[frame] = m_released;
+			m_block_trel[frame] = m_note_rel_sec;
+			// evaluate() puts the result in the circular buffer for the "last" function
+			if (o1_per_sample) { m_out1[frame] = m_exprO1->evaluate(); }
+			if (o2_per_sample) { m_out2[frame] = m_exprO2->evaluate(); }
+			m_note_sample++;
+			m_note_sample_sec = m_note_sample / (float)m_sample_rate;
+			if (is_released)
+			{
+				m_note_rel_sec = (m_note_sample - m_note_rel_sample) / (float)m_sample_rate;
+			}
+			m_frequency += freq_inc;
+		}
+		m_frequency = new_freq;
+
+		const auto evaluate_block = [this, frames](ExprFront* e, bool& verified, float* out) {
+			if (verified)
+			{
+				e->evaluateBlock(frames, out);
+				return;
+			}
+			e->evaluateBlock(frames, m_check.data());
+			if (std::memcmp(m_check.data(), out, frames * sizeof(float)) == 0)
+			{
+				verified = true;
+			}
+			else
+			{
+				e->disableBlock();
+			}
+		};
+		if (o1_block) { evaluate_block(m_exprO1, m_o1_verified, m_out1.data()); }
+		if (o2_block) { evaluate_block(m_exprO2, m_o2_verified, m_out2.data()); }
+
 		if (o1_valid && o2_valid)
 		{
 			for (fpp_t frame = 0; frame < frames ; ++frame)
 			{
-				if (is_released && m_released < 1)
-				{
-					m_released = fmin(m_released+m_rel_inc, 1);
-				}
-				o1 = o1_rawExpr->value();
-				o2 = o2_rawExpr->value();
-				last_func1->setLastSample(o1);//put result in the circular buffer for the "last" function.
-				last_func2->setLastSample(o2);
+				const float o1 = m_out1[frame];
+				const float o2 = m_out2[frame];
 				buf[frame][0] = (-pn1 + 0.5) * o1 + (-pn2 + 0.5) * o2;
 				buf[frame][1] = ( pn1 + 0.5) * o1 + ( pn2 + 0.5) * o2;
-				m_note_sample++;
-				m_note_sample_sec = m_note_sample / (float)m_sample_rate;
-				if (is_released)
-				{
-					m_note_rel_sec = (m_note_sample - m_note_rel_sample) / (float)m_sample_rate;
-				}
-				m_frequency += freq_inc;
 			}
 		}
 		else
 		{
-
+			const float* out = m_out1.data();
 			if (o2_valid)
 			{
-				o1_rawExpr = o2_rawExpr;
-				last_func1 = last_func2;
+				out = m_out2.data();
 				pn1 = pn2;
 			}
 			for (fpp_t frame = 0; frame < frames ; ++frame)
 			{
-				if (is_released && m_released < 1)
-				{
-					m_released = fmin(m_released+m_rel_inc, 1);
-				}
-				o1 = o1_rawExpr->value();
-				last_func1->setLastSample(o1);
-				buf[frame][0] = (-pn1 + 0.5) * o1;
-				buf[frame][1] = ( pn1 + 0.5) * o1;
-				m_note_sample++;
-				m_note_sample_sec = m_note_sample / (float)m_sample_rate;
-				if (is_released)
-				{
-					m_note_rel_sec = (m_note_sample - m_note_rel_sample) / (float)m_sample_rate;
-				}
-				m_frequency += freq_inc;
+				buf[frame][0] = (-pn1 + 0.5) * out[frame];
+				buf[frame][1] = ( pn1 + 0.5) * out[frame];
 			}
 		}
-		m_frequency = new_freq;
 	}
 	catch(...)
 	{
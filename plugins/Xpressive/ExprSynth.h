@@ -28,6 +28,7 @@
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <vector>
 #include "Graph.h"
 
 namespace lmms
@@ -53,6 +54,14 @@ public:
 	bool add_constant(const char* name, float  ref);
 	bool add_cyclic_vector(const char* name, const float* data, size_t length, bool interp = false);
 	void setIntegrate(const unsigned int* frameCounter, unsigned int sample_rate);
+	//! Adds a variable with one value per frame to the block compiled expression
+	void add_block_input(const char* name, const float* values);
+	//! Compiles the expression a second time for evaluateBlock(). Fails if it
+	//! uses anything only ExprTk's per-sample evaluation supports.
+	bool compileBlock(fpp_t maxFrames);
+	bool isBlockCompiled() const;
+	void evaluateBlock(fpp_t frames, float* out);
+	void disableBlock();
 	ExprFrontData* getData() { return m_data; }
 private:
 	ExprFrontData *m_data;
@@ -117,6 +126,12 @@ private:
 	float m_rel_transition;
 	float m_rel_inc;
 
+	// inputs and outputs of the block compiled expressions, one value per frame
+	std::vector<float> m_block_t, m_block_f, m_block_rel, m_block_trel;
+	std::vector<float> m_out1, m_out2, m_check;
+	// whether the block compiled expression matched the per-sample one
+	bool m_o1_verified, m_o2_verified;
+
 } ;
 
 
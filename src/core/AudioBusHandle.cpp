@@ -28,6 +28,7 @@
 #include "AudioBusHandle.h"
 #include "AudioDevice.h"
 #include "AudioEngine.h"
+#include "AudioEngineWorkerThread.h"
 #include "EffectChain.h"
 #include "Mixer.h"
 #include "Engine.h"
@@ -48,9 +49,12 @@ AudioBusHandle::AudioBusHandle(const QString& name, bool hasEffectChain,
 	m_effects(hasEffectChain ? new EffectChain(nullptr) : nullptr),
 	m_volumeModel(volumeModel),
 	m_panningModel(panningModel),
-	m_mutedModel(mutedModel)
+	m_mutedModel(mutedModel),
+	m_pendingInputs(0),
+	m_jobMixerChannel(nullptr)
 {
 	Engine::audioEngine()->addAudioBusHandle(this);
+	Engine::audioEngine()->profiler().setNodeName(this, m_name);
 	setExtOutputEnabled(true);
 }
 
@@ -61,6 +65,7 @@ AudioBusHandle::~AudioBusHandle()
 {
 	setExtOutputEnabled(false);
 	Engine::audioEngine()->removeAudioBusHandle(this);
+	Engine::audioEngine()->profiler().removeNode(this);
 	BufferManager::release(m_buffer);
 }
 
@@ -90,6 +95,7 @@ void AudioBusHandle::setName(const QString& newName)
 {
 	m_name = newName;
 	Engine::audioEngine()->audioDev()->renamePort(this);
+	Engine::audioEngine()->profiler().setNodeName(this, m_name);
 }
 
 
@@ -108,8 +114,12 @@ bool AudioBusHandle::processEffects()
 
 void AudioBusHandle::doProcessing()
 {
+	AudioEngineProfiler::JobProbe probe(Engine::audioEngine()->profiler(),
+		AudioEngineProfiler::DetailType::Effects, this);
+
 	if (m_mutedModel && m_mutedModel->value())
 	{
+		notifyMixerChannel();
 		return;
 	}
 
@@ -227,10 +237,41 @@ void AudioBusHandle::doProcessing()
 	const bool anyOutputAfterEffects = processEffects();
 	if (anyOutputAfterEffects || m_bufferUsage)
 	{
-		Engine::mixer()->mixToChannel(m_buffer, m_nextMixerChannel);	// send output to mixer
+		// send output to the mixer channel which is waiting for us
+		const mix_ch_t channel = m_jobMixerChannel ? m_jobMixerChannel->index() : m_nextMixerChannel;
+		Engine::mixer()->mixToChannel(m_buffer, channel);	// send output to mixer
 																		// TODO: improve the flow here - convert to pull model
 		m_bufferUsage = false;
 	}
+
+	notifyMixerChannel();
+}
+
+
+void AudioBusHandle::prepareJob()
+{
+	// hold one input until the whole graph is set up
+	m_pendingInputs = 1;
+	m_jobMixerChannel = Engine::mixer()->addChannelInput(m_nextMixerChannel);
+}
+
+
+void AudioBusHandle::inputProcessed()
+{
+	if (--m_pendingInputs == 0)
+	{
+		AudioEngineWorkerThread::addJob(this);
+	}
+}
+
+
+void AudioBusHandle::notifyMixerChannel()
+{
+	if (m_jobMixerChannel)
+	{
+		m_jobMixerChannel->incrementDeps();
+		m_jobMixerChannel = nullptr;
+	}
 }
 
 
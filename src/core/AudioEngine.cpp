@@ -24,6 +24,8 @@
 
 #include "AudioEngine.h"
 
+#include <algorithm>
+
 #include "MixHelpers.h"
 #include "denormals.h"
 
@@ -59,6 +61,8 @@
 #include "MidiDummy.h"
 
 #include "BufferManager.h"
+#include "MicroTimer.h"
+#include "StemExporter.h"
 
 namespace lmms
 {
@@ -70,7 +74,7 @@ static thread_local bool s_renderingThread = false;
 
 
 
-AudioEngine::AudioEngine( bool renderOnly ) :
+AudioEngine::AudioEngine( bool renderOnly, fpp_t framesPerPeriod ) :
 	m_renderOnly( renderOnly ),
 	m_framesPerPeriod( DEFAULT_BUFFER_SIZE ),
 	m_baseSampleRate(std::max(ConfigManager::inst()->value("audioengine", "samplerate").toInt(), SUPPORTED_SAMPLERATES.front())),
@@ -86,6 +90,7 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_audioDev( nullptr ),
 	m_oldAudioDev( nullptr ),
 	m_audioDevStartFailed( false ),
+	m_stemExporter(nullptr),
 	m_profiler(),
 	m_clearSignal(false)
 {
@@ -127,9 +132,20 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 			m_framesPerPeriod = DEFAULT_BUFFER_SIZE;
 		}
 	}
+	else if( framesPerPeriod > 0 )
+	{
+		// larger periods would be rendered in chunks of DEFAULT_BUFFER_SIZE anyway
+		m_framesPerPeriod = std::clamp( framesPerPeriod, MINIMUM_BUFFER_SIZE, DEFAULT_BUFFER_SIZE );
+	}
 
-	// allocte the FIFO from the determined size
-	m_fifo = new Fifo( fifoSize );
+	// allocate the FIFO from the determined size. Besides the queued periods
+	// it holds the one being played and the one being rendered.
+	int ringDepth = ConfigManager::inst()->value( "audioengine", "periodringdepth" ).toInt();
+	if( ringDepth < 2 )
+	{
+		ringDepth = fifoSize + 2;
+	}
+	m_periodRing = std::make_unique<PeriodRing>( ringDepth, m_framesPerPeriod );
 
 	// now that framesPerPeriod is fixed initialize global BufferManager
 	BufferManager::init( m_framesPerPeriod );
@@ -138,14 +154,15 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_outputBufferWrite = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
 
 
+	// create all workers before starting any of them, as each one
+	// registers its own job deque in the global job queue
 	for( int i = 0; i < m_numWorkers+1; ++i )
 	{
-		auto wt = new AudioEngineWorkerThread(this);
-		if( i < m_numWorkers )
-		{
-			wt->start( QThread::TimeCriticalPriority );
-		}
-		m_workers.push_back( wt );
+		m_workers.push_back( new AudioEngineWorkerThread(this) );
+	}
+	for( int i = 0; i < m_numWorkers; ++i )
+	{
+		m_workers[i]->start( QThread::TimeCriticalPriority );
 	}
 }
 
@@ -154,23 +171,28 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 
 AudioEngine::~AudioEngine()
 {
+	// quit() also wakes the workers which are parked
 	for( int w = 0; w < m_numWorkers; ++w )
 	{
 		m_workers[w]->quit();
 	}
 
-	AudioEngineWorkerThread::startAndWaitForJobs();
-
+	bool workersFinished = true;
 	for( int w = 0; w < m_numWorkers; ++w )
 	{
-		m_workers[w]->wait( 500 );
+		workersFinished = m_workers[w]->wait( 500 ) && workersFinished;
 	}
 
-	while( m_fifo->available() )
+	// a new audio engine creates new workers, but the deques must stay as
+	// long as a worker might still use them
+	if (workersFinished)
+	{
+		AudioEngineWorkerThread::removeWorkers();
+	}
+	else
 	{
-		delete[] m_fifo->read();
+		qWarning("AudioEngine: worker threads didn't finish, keeping their job queues");
 	}
-	delete m_fifo;
 
 	delete m_midiClient;
 	delete m_audioDev;
@@ -208,7 +230,8 @@ void AudioEngine::startProcessing(bool needsFifo)
 {
 	if (needsFifo)
 	{
-		m_fifoWriter = new fifoWriter( this, m_fifo );
+		m_periodRing->reopen();
+		m_fifoWriter = new fifoWriter( this, m_periodRing.get() );
 		m_fifoWriter->start( QThread::HighPriority );
 	}
 	else
@@ -316,6 +339,10 @@ void AudioEngine::renderStageNoteSetup()
 	Mixer * mixer = Engine::mixer();
 	mixer->prepareMasterMix();
 
+	// pass on the MIDI events received during the last period, before the
+	// song, so the notes they start are rendered in this period already
+	m_midiClient->dispatchInEvents(outputSampleRate(), m_framesPerPeriod);
+
 	// create play-handles for new notes, samples etc.
 	Engine::getSong()->processNextBuffer();
 
@@ -331,25 +358,52 @@ void AudioEngine::renderStageNoteSetup()
 
 
 
-void AudioEngine::renderStageInstruments()
+void AudioEngine::renderStageGraph()
 {
-	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Instruments);
+	// All play handles, audio bus handles and mixer channels of this period
+	// form one dependency graph: PlayHandle -> AudioBusHandle -> MixerChannel
+	// -> ... -> master. Each node is queued as soon as all of its inputs are
+	// done, so e.g. a mixer channel doesn't have to wait for unrelated
+	// instruments or effect chains.
+	MicroTimer graphTimer;
+	Mixer * mixer = Engine::mixer();
 
-	AudioEngineWorkerThread::fillJobQueue(m_playHandles);
-	AudioEngineWorkerThread::startAndWaitForJobs();
-}
+	AudioEngineWorkerThread::resetJobQueue(AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic);
 
+	// Set up the input counters of all nodes before queuing anything, as the
+	// worker threads pick up jobs right away. Every node holds one extra
+	// input while the graph is being set up, which is released below.
+	mixer->prepareChannelJobs();
+	for (AudioBusHandle* busHandle : m_audioBusHandles)
+	{
+		busHandle->prepareJob();
+	}
 
+	for (PlayHandle* handle : m_playHandles)
+	{
+		AudioBusHandle* busHandle = handle->audioBusHandle();
+		busHandle->addInput();
+		if (!AudioEngineWorkerThread::addJob(handle))
+		{
+			busHandle->inputProcessed();
+		}
+	}
 
-void AudioEngine::renderStageEffects()
-{
-	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Effects);
+	for (AudioBusHandle* busHandle : m_audioBusHandles)
+	{
+		busHandle->inputProcessed();
+	}
+	mixer->startChannelJobs();
 
-	// STAGE 2: process effects of all instrument- and sampletracks
-	AudioEngineWorkerThread::fillJobQueue(m_audioBusHandles);
 	AudioEngineWorkerThread::startAndWaitForJobs();
 
-	// removed all play handles which are done
+	m_profiler.distributeJobTime(graphTimer.elapsed());
+}
+
+
+
+void AudioEngine::removeFinishedPlayHandles()
+{
 	for( PlayHandleList::Iterator it = m_playHandles.begin();
 						it != m_playHandles.end(); )
 	{
@@ -382,6 +436,9 @@ void AudioEngine::renderStageMix()
 {
 	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Mixing);
 
+	// the buses and mixer channels still hold this period until the master mix clears them
+	if (m_stemExporter) { m_stemExporter->capture(m_framesPerPeriod); }
+
 	Mixer *mixer = Engine::mixer();
 	mixer->masterMix(m_outputBufferWrite.get());
 
@@ -404,14 +461,22 @@ const SampleFrame* AudioEngine::renderNextBuffer()
 	m_profiler.startPeriod();
 	s_renderingThread = true;
 
+	// rendering is serialized by m_changeMutex, so only one thread at a
+	// time processes jobs as the inline worker
+	const auto inlineWorker = AudioEngineWorkerThread::InlineWorker{};
+
 	renderStageNoteSetup();     // STAGE 0: clear old play handles and buffers, setup new play handles
-	renderStageInstruments();   // STAGE 1: run and render all play handles
-	renderStageEffects();       // STAGE 2: process effects of all instrument- and sampletracks
-	renderStageMix();           // STAGE 3: do master mix in mixer
+	renderStageGraph();         // STAGE 1: run play handles, effects and mixer channels as one job graph
+	renderStageMix();           // STAGE 2: do master mix in mixer
 
-	s_renderingThread = false;
+	// before removing the finished play handles, so the nodes of this
+	// period's events can't be replaced by new ones at the same address
 	m_profiler.finishPeriod(outputSampleRate(), m_framesPerPeriod);
 
+	removeFinishedPlayHandles();
+
+	s_renderingThread = false;
+
 	return m_outputBufferRead.get();
 }
 
@@ -568,8 +633,21 @@ void AudioEngine::removeAudioBusHandle(AudioBusHandle* busHandle)
 }
 
 
+
+
+void AudioEngine::setStemExporter(StemExporter* exporter)
+{
+	requestChangeInModel();
+	m_stemExporter = exporter;
+	doneChangeInModel();
+}
+
+
 bool AudioEngine::addPlayHandle( PlayHandle* handle )
 {
+	// e.g. the NotePlayHandle pool is exhausted
+	if (handle == nullptr) { return false; }
+
 	// Only add play handles if we have the CPU capacity to process them.
 	// Instrument play handles are not added during playback, but when the
 	// associated instrument is created, so add those unconditionally.
@@ -1080,9 +1158,9 @@ MidiClient * AudioEngine::tryMidiClients()
 
 
 
-AudioEngine::fifoWriter::fifoWriter( AudioEngine* audioEngine, Fifo * fifo ) :
+AudioEngine::fifoWriter::fifoWriter( AudioEngine* audioEngine, PeriodRing * ring ) :
 	m_audioEngine( audioEngine ),
-	m_fifo( fifo ),
+	m_ring( ring ),
 	m_writing( true )
 {
 	setObjectName("AudioEngine::fifoWriter");
@@ -1106,15 +1184,17 @@ void AudioEngine::fifoWriter::run()
 	const fpp_t frames = m_audioEngine->framesPerPeriod();
 	while( m_writing )
 	{
-		auto buffer = new SampleFrame[frames];
+		SampleFrame* buffer = m_ring->beginWrite();
+		// the audio engine returns the period it rendered before, from its
+		// own double buffer, so it can't render into the slot directly
 		const SampleFrame* b = m_audioEngine->renderNextBuffer();
 		memcpy(buffer, b, frames * sizeof(SampleFrame));
-		m_fifo->write(buffer);
+		m_ring->endWrite();
 	}
 
 	// Let audio backend stop processing
-	m_fifo->write(nullptr);
-	m_fifo->waitUntilRead();
+	m_ring->close();
+	m_ring->waitUntilRead();
 }
 
 } // namespace lmms
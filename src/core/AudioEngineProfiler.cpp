@@ -24,20 +24,265 @@
 
 #include "AudioEngineProfiler.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdint>
+#include <thread>
+#include <QFile>
+#include <QThread>
+
+#include "NotePlayHandle.h"
 
 namespace lmms
 {
 
+namespace
+{
+
+constexpr std::size_t NodeCapacity = 1024;
+
+// incremented for every profiler, so thread indices of a previous one
+// aren't mistaken for those of the current one
+std::atomic_uint s_generations = 0;
+
+// index of the event ring owned by the current thread
+struct ThreadIndex
+{
+	unsigned generation = 0;
+	int index = -1;
+};
+thread_local ThreadIndex s_threadIndex;
+
+const char* detailName(AudioEngineProfiler::DetailType type)
+{
+	switch (type)
+	{
+		case AudioEngineProfiler::DetailType::NoteSetup: return "Notes and setup";
+		case AudioEngineProfiler::DetailType::Instruments: return "Instrument";
+		case AudioEngineProfiler::DetailType::Effects: return "Effects";
+		case AudioEngineProfiler::DetailType::Mixing: return "Mixer";
+		default: return "";
+	}
+}
+
+} // namespace
+
+
+/**
+	Keeps formatting and file IO away from the rendering thread. The rendering
+	thread pushes records into a wait-free ring, which a thread of the writer
+	drains every now and then. The names of the nodes are looked up when
+	writing the records, nodes deleted in the meantime are written without.
+*/
+class AudioEngineProfiler::Writer
+{
+public:
+	struct Record
+	{
+		enum class Kind
+		{
+			Event,
+			NotePool,
+			NotePoolExhausted,
+			PeriodTime
+		};
+
+		Kind kind;
+		DetailType type;
+		const void* node;
+		bool job;
+		int thread;
+		std::int64_t start;
+		//! duration of an event, number of notes or period time
+		int value;
+	};
+
+	Writer(const QString& fileName, bool trace, const NodeNames& nodeNames) :
+		m_file(fileName),
+		m_trace(trace),
+		m_nodeNames(nodeNames)
+	{
+		if (!m_file.open(QFile::WriteOnly | QFile::Truncate)) { return; }
+		if (m_trace)
+		{
+			// JSON array format of the Chrome trace event format
+			m_file.write("[\n");
+		}
+		m_thread = std::thread{&Writer::run, this};
+	}
+
+	~Writer()
+	{
+		if (!m_thread.joinable()) { return; }
+		{
+			const auto lock = std::lock_guard{m_mutex};
+			m_quit = true;
+		}
+		m_wakeup.notify_one();
+		m_thread.join();
+
+		if (m_trace) { m_file.write("\n]\n"); }
+	}
+
+	bool isOpen() const { return m_thread.joinable(); }
+
+	//! Only called by the rendering thread. If the ring is full, the record is dropped.
+	void push(const Record& record)
+	{
+		const auto write = m_writeIndex.load(std::memory_order_relaxed);
+		if (write - m_readIndex.load(std::memory_order_acquire) >= Size) { return; }
+		m_records[write % Size] = record;
+		m_writeIndex.store(write + 1, std::memory_order_release);
+	}
+
+private:
+	static constexpr std::size_t Size = 16384;
+
+	void run()
+	{
+		auto lock = std::unique_lock{m_mutex};
+		while (!m_quit)
+		{
+			m_wakeup.wait_for(lock, std::chrono::milliseconds{100});
+			lock.unlock();
+			flush();
+			lock.lock();
+		}
+		lock.unlock();
+		flush();
+	}
+
+	void flush()
+	{
+		auto read = m_readIndex.load(std::memory_order_relaxed);
+		while (read != m_writeIndex.load(std::memory_order_acquire))
+		{
+			const auto record = m_records[read % Size];
+			m_readIndex.store(++read, std::memory_order_release);
+			write(record);
+		}
+		m_file.flush();
+	}
+
+	void write(const Record& record)
+	{
+		switch (record.kind)
+		{
+			case Record::Kind::Event:
+				writeEvent(record);
+				break;
+			case Record::Kind::NotePool:
+				writeTraceLine(QString(R"({"name":"Note pool","ph":"C","ts":%1,"pid":1,"args":{"used":%2}})")
+					.arg(record.start)
+					.arg(record.value));
+				break;
+			case Record::Kind::NotePoolExhausted:
+				writeTraceLine(QString(R"({"name":"Note pool exhausted","ph":"i","s":"g","ts":%1,"pid":1,"args":{"dropped":%2}})")
+					.arg(record.start)
+					.arg(record.value));
+				break;
+			case Record::Kind::PeriodTime:
+				m_file.write(QString("%1\n").arg(record.value).toLatin1());
+				break;
+		}
+	}
+
+	void writeEvent(const Record& record)
+	{
+		QString name;
+		const auto nodeName = record.node ? m_nodeNames.name(record.node) : QString{};
+		if (record.type == DetailType::Count)
+		{
+			name = "Period";
+		}
+		else if (!nodeName.isEmpty())
+		{
+			name = QString("%1: %2").arg(detailName(record.type), nodeName);
+		}
+		else
+		{
+			name = detailName(record.type);
+		}
+
+		// escape the name, it's user defined
+		name.replace('\\', "\\\\").replace('"', "\\\"");
+
+		writeTraceLine(QString(R"({"name":"%1","cat":"%2","ph":"X","ts":%3,"dur":%4,"pid":1,"tid":%5})")
+			.arg(name)
+			.arg(record.job ? "job" : "stage")
+			.arg(record.start)
+			.arg(record.value)
+			.arg(record.thread));
+	}
+
+	void writeTraceLine(const QString& line)
+	{
+		if (!m_firstLine)
+		{
+			m_file.write(",\n");
+		}
+		m_firstLine = false;
+		m_file.write(line.toUtf8());
+	}
+
+	QFile m_file;
+	const bool m_trace;
+	const NodeNames& m_nodeNames;
+	bool m_firstLine = true;
+
+	std::array<Record, Size> m_records;
+	std::atomic_size_t m_writeIndex = 0;
+	std::atomic_size_t m_readIndex = 0;
+
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeup;
+	bool m_quit = false;
+};
+
+
+
+
 AudioEngineProfiler::AudioEngineProfiler() :
 	m_periodTimer(),
+	m_periodStart( now() ),
 	m_cpuLoad( 0 ),
-	m_outputFile()
+	m_writeTrace( false ),
+	m_droppedNotes( 0 ),
+	m_numThreads( 0 ),
+	m_generation( ++s_generations ),
+	m_nodes( NodeCapacity ),
+	m_rehashNodes( NodeCapacity ),
+	m_numNodes( 0 )
+{
+	// worker threads, the thread rendering periods and some spare ones for
+	// threads which render only from time to time (e.g. the export thread)
+	const auto numRings = static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1) * 2 + 8);
+	for (std::size_t i = 0; i < numRings; ++i)
+	{
+		m_eventRings.push_back(std::make_unique<EventRing>());
+	}
+	m_publishedNodes.reserve(NodeCapacity);
+}
+
+
+
+
+AudioEngineProfiler::~AudioEngineProfiler() = default;
+
+
+
+
+float AudioEngineProfiler::NodeLoad::totalLoad() const
 {
+	float total = 0.f;
+	for (const auto l : load) { total += l; }
+	return total;
 }
 
 
 
+
 void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPerPeriod )
 {
 	// Time taken to process all data and fill the audio buffer.
@@ -59,19 +304,311 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPe
 		m_detailLoad[i].store(newLoad * 0.05f + oldLoad * 0.95f, std::memory_order_relaxed);
 	}
 
-	if( m_outputFile.isOpen() )
+	if (m_writeTrace && m_writer)
+	{
+		m_writer->push({Writer::Record::Kind::Event, DetailType::Count, nullptr, false, threadIndex(), m_periodStart,
+			static_cast<int>(periodElapsed)});
+	}
+
+	// all jobs of this period are done, so the event rings can be drained
+	drainEvents();
+	updateNodeLoads(timeLimit);
+	updateNotePoolUsage();
+
+	if (!m_writeTrace && m_writer)
+	{
+		m_writer->push({Writer::Record::Kind::PeriodTime, DetailType::Count, nullptr, false, 0, 0,
+			static_cast<int>(periodElapsed)});
+	}
+}
+
+
+
+void AudioEngineProfiler::distributeJobTime(int graphTime)
+{
+	std::array<int, DetailCount> jobTime;
+	int totalJobTime = 0;
+	for (std::size_t i = 0; i < DetailCount; i++)
+	{
+		jobTime[i] = m_jobTime[i].exchange(0, std::memory_order_relaxed);
+		totalJobTime += jobTime[i];
+	}
+
+	if (totalJobTime <= 0) { return; }
+
+	for (std::size_t i = 0; i < DetailCount; i++)
+	{
+		m_detailTime[i] += static_cast<int>(static_cast<int64_t>(graphTime) * jobTime[i] / totalJobTime);
+	}
+}
+
+
+
+auto AudioEngineProfiler::notePoolUsage() const -> NotePoolUsage
+{
+	return {NotePlayHandleManager::used(), NotePlayHandleManager::highWaterMark(),
+		NotePlayHandleManager::capacity(), NotePlayHandleManager::dropped()};
+}
+
+
+
+void AudioEngineProfiler::updateNotePoolUsage()
+{
+	const auto usage = notePoolUsage();
+	const int newlyDropped = usage.dropped - m_droppedNotes;
+	m_droppedNotes = usage.dropped;
+
+	if (!m_writeTrace || !m_writer) { return; }
+
+	m_writer->push({Writer::Record::Kind::NotePool, DetailType::Count, nullptr, false, 0, m_periodStart, usage.used});
+	if (newlyDropped > 0)
+	{
+		m_writer->push({Writer::Record::Kind::NotePoolExhausted, DetailType::Count, nullptr, false, 0, m_periodStart,
+			newlyDropped});
+	}
+}
+
+
+
+std::vector<AudioEngineProfiler::NodeLoad> AudioEngineProfiler::nodeLoads(std::size_t maxCount) const
+{
+	auto nodes = std::vector<NodeLoad>{};
 	{
-		m_outputFile.write( QString( "%1\n" ).arg( periodElapsed ).toLatin1() );
+		const auto lock = std::lock_guard{m_publishMutex};
+		nodes.reserve(m_publishedNodes.size());
+		for (const auto& [node, load] : m_publishedNodes)
+		{
+			nodes.push_back({m_nodeNames.name(node), load});
+		}
 	}
+
+	std::sort(nodes.begin(), nodes.end(), [](const NodeLoad& a, const NodeLoad& b) {
+		return a.totalLoad() > b.totalLoad();
+	});
+	if (nodes.size() > maxCount)
+	{
+		nodes.resize(maxCount);
+	}
+	return nodes;
 }
 
 
 
 void AudioEngineProfiler::setOutputFile( const QString& outputFile )
 {
-	m_outputFile.close();
-	m_outputFile.setFileName( outputFile );
-	m_outputFile.open( QFile::WriteOnly | QFile::Truncate );
+	m_writer.reset();
+	m_writeTrace = outputFile.endsWith(".json", Qt::CaseInsensitive);
+
+	auto writer = std::make_unique<Writer>(outputFile, m_writeTrace, m_nodeNames);
+	if (writer->isOpen()) { m_writer = std::move(writer); }
+}
+
+
+
+bool AudioEngineProfiler::EventRing::push(const Event& event)
+{
+	const auto write = m_writeIndex.load(std::memory_order_relaxed);
+	if (write - m_readIndex.load(std::memory_order_acquire) >= Size)
+	{
+		return false;
+	}
+	m_events[write % Size] = event;
+	m_writeIndex.store(write + 1, std::memory_order_release);
+	return true;
+}
+
+
+
+bool AudioEngineProfiler::EventRing::pop(Event& event)
+{
+	const auto read = m_readIndex.load(std::memory_order_relaxed);
+	if (read == m_writeIndex.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+	event = m_events[read % Size];
+	m_readIndex.store(read + 1, std::memory_order_release);
+	return true;
+}
+
+
+
+void AudioEngineProfiler::setNodeName(const void* node, const QString& name)
+{
+	m_nodeNames.set(node, name);
+}
+
+
+
+void AudioEngineProfiler::removeNode(const void* node)
+{
+	m_nodeNames.remove(node);
+}
+
+
+
+void AudioEngineProfiler::NodeNames::set(const void* node, const QString& name)
+{
+	const auto lock = std::lock_guard{m_mutex};
+	m_names.insert(node, name);
+}
+
+
+
+void AudioEngineProfiler::NodeNames::remove(const void* node)
+{
+	const auto lock = std::lock_guard{m_mutex};
+	m_names.remove(node);
+}
+
+
+
+QString AudioEngineProfiler::NodeNames::name(const void* node) const
+{
+	const auto lock = std::lock_guard{m_mutex};
+	return m_names.value(node);
+}
+
+
+
+int AudioEngineProfiler::threadIndex()
+{
+	if (s_threadIndex.generation != m_generation)
+	{
+		s_threadIndex = {m_generation, m_numThreads++};
+	}
+	return s_threadIndex.index;
+}
+
+
+
+AudioEngineProfiler::EventRing* AudioEngineProfiler::threadRing()
+{
+	const auto index = static_cast<std::size_t>(threadIndex());
+	return index < m_eventRings.size() ? m_eventRings[index].get() : nullptr;
+}
+
+
+
+void AudioEngineProfiler::recordEvent(const void* node, DetailType type, std::int64_t start, std::int64_t end)
+{
+	// events without a node are only interesting for the trace
+	if (!node && !m_writeTrace) { return; }
+
+	if (auto ring = threadRing())
+	{
+		// if the ring is full, the event is dropped
+		ring->push({node, type, s_threadIndex.index, start, static_cast<int>(end - start)});
+	}
+}
+
+
+
+void AudioEngineProfiler::drainEvents()
+{
+	const auto numRings = std::min<std::size_t>(m_numThreads.load(), m_eventRings.size());
+	for (std::size_t i = 0; i < numRings; ++i)
+	{
+		Event event;
+		while (m_eventRings[i]->pop(event))
+		{
+			if (event.node)
+			{
+				if (auto entry = findNode(event.node))
+				{
+					entry->time[static_cast<std::size_t>(event.type)] += event.duration;
+				}
+			}
+			if (m_writeTrace && m_writer)
+			{
+				m_writer->push({Writer::Record::Kind::Event, event.type, event.node, event.node != nullptr,
+					event.thread, event.start, event.duration});
+			}
+		}
+	}
+}
+
+
+
+AudioEngineProfiler::NodeEntry* AudioEngineProfiler::findNode(const void* node)
+{
+	auto index = std::hash<const void*>{}(node) % NodeCapacity;
+	for (std::size_t i = 0; i < NodeCapacity; ++i, index = (index + 1) % NodeCapacity)
+	{
+		auto& entry = m_nodes[index];
+		if (entry.node == node) { return &entry; }
+		if (!entry.node)
+		{
+			// keep the table at most half full so lookups stay short
+			if (m_numNodes >= NodeCapacity / 2) { return nullptr; }
+			entry.node = node;
+			++m_numNodes;
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+
+
+void AudioEngineProfiler::updateNodeLoads(std::uint64_t timeLimit)
+{
+	std::size_t activeNodes = 0;
+	for (auto& entry : m_nodes)
+	{
+		if (!entry.node) { continue; }
+		float total = 0.f;
+		for (std::size_t i = 0; i < DetailCount; ++i)
+		{
+			const auto newLoad = 100.f * entry.time[i] / timeLimit;
+			entry.load[i] = newLoad * 0.05f + entry.load[i] * 0.95f;
+			entry.time[i] = 0;
+			total += entry.load[i];
+		}
+		// forget about nodes which haven't been active for a while, e.g.
+		// deleted tracks
+		if (total < 0.001f)
+		{
+			entry.node = nullptr;
+		}
+		else
+		{
+			++activeNodes;
+		}
+	}
+
+	// rebuild the table if forgotten nodes have been removed, as removing
+	// entries breaks the probe sequences of open addressing
+	if (activeNodes != m_numNodes)
+	{
+		std::swap(m_nodes, m_rehashNodes);
+		m_numNodes = 0;
+		for (auto& entry : m_nodes) { entry.node = nullptr; }
+		for (auto& old : m_rehashNodes)
+		{
+			if (!old.node) { continue; }
+			if (auto entry = findNode(old.node))
+			{
+				entry->load = old.load;
+				entry->time = {};
+			}
+			old.node = nullptr;
+		}
+	}
+
+	// publish the loads unless another thread is reading them right now
+	if (m_publishMutex.try_lock())
+	{
+		m_publishedNodes.clear();
+		for (const auto& entry : m_nodes)
+		{
+			if (entry.node)
+			{
+				m_publishedNodes.emplace_back(entry.node, entry.load);
+			}
+		}
+		m_publishMutex.unlock();
+	}
 }
 
 } // namespace lmms
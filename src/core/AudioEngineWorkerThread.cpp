@@ -25,118 +25,262 @@
 #include "AudioEngineWorkerThread.h"
 
 #include <QDebug>
-#include <QMutex>
-#include <QWaitCondition>
+
+#include <algorithm>
+#include <cassert>
 
 #include "denormals.h"
+#include "lmmsconfig.h"
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 #include "ThreadableJob.h"
 
 #if __SSE__
 #include <xmmintrin.h>
 #endif
 
+#ifdef LMMS_BUILD_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef LMMS_BUILD_WIN32
+#include <windows.h>
+#endif
+
 namespace lmms
 {
 
 AudioEngineWorkerThread::JobQueue AudioEngineWorkerThread::globalJobQueue;
-QWaitCondition * AudioEngineWorkerThread::queueReadyWaitCond = nullptr;
-QList<AudioEngineWorkerThread *> AudioEngineWorkerThread::workerThreads;
+std::mutex AudioEngineWorkerThread::s_parkMutex;
+std::condition_variable AudioEngineWorkerThread::s_parkCond;
+std::atomic<std::uint64_t> AudioEngineWorkerThread::s_wakeGeneration = 0;
+std::atomic_int AudioEngineWorkerThread::s_parkedWorkers = 0;
+
+// slot of the deque owned by the current thread - threads which are not
+// worker threads own the slot of the worker which is processed "inline" while
+// they hold an InlineWorker, and must not add jobs otherwise
+static thread_local int s_slot = -1;
+static int s_inlineSlot = -1;
+static std::atomic_bool s_inlineSlotTaken = false;
+
+static inline void cpuRelax()
+{
+#ifdef __SSE__
+	_mm_pause();
+#endif
+}
 
-// implementation of internal JobQueue
-void AudioEngineWorkerThread::JobQueue::reset( OperationMode _opMode )
+
+
+
+// implementation of the per-thread work-stealing deque
+AudioEngineWorkerThread::JobQueue::Deque::Deque() :
+	m_top( 0 ),
+	m_bottom( 0 )
 {
-	m_writeIndex = 0;
-	m_itemsDone = 0;
-	m_opMode = _opMode;
+	for (auto& item : m_items)
+	{
+		item.store(nullptr, std::memory_order_relaxed);
+	}
 }
 
 
 
 
-void AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
+bool AudioEngineWorkerThread::JobQueue::Deque::push( ThreadableJob * job )
 {
-	if( _job->requiresProcessing() )
+	const auto b = m_bottom.load(std::memory_order_relaxed);
+	const auto t = m_top.load(std::memory_order_acquire);
+	if (b - t >= static_cast<std::int64_t>(JOB_QUEUE_SIZE))
 	{
-		// update job state
-		_job->queue();
-		// actually queue the job via atomic operations
-		auto index = m_writeIndex++;
-		if (index < JOB_QUEUE_SIZE) {
-			m_items[index] = _job;
-		} else {
-			qWarning() << "Job queue is full!";
-			++m_itemsDone;
-		}
+		return false;
 	}
+	m_items[b & Mask].store(job, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	m_bottom.store(b + 1, std::memory_order_relaxed);
+	return true;
 }
 
 
 
-void AudioEngineWorkerThread::JobQueue::run()
+
+ThreadableJob * AudioEngineWorkerThread::JobQueue::Deque::pop()
 {
-	bool processedJob = true;
-	while (processedJob && m_itemsDone < m_writeIndex)
+	const auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto t = m_top.load(std::memory_order_relaxed);
+
+	if (t > b)
 	{
-		processedJob = false;
-		for (auto i = std::size_t{0}; i < m_writeIndex && i < JOB_QUEUE_SIZE; ++i)
+		// deque was empty
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	ThreadableJob * job = m_items[b & Mask].load(std::memory_order_relaxed);
+	if (t == b)
+	{
+		// last item - race against thieves for it
+		if (!m_top.compare_exchange_strong(t, t + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed))
 		{
-			ThreadableJob * job = m_items[i].exchange(nullptr);
-			if( job )
-			{
-				job->process();
-				processedJob = true;
-				++m_itemsDone;
-			}
+			job = nullptr;
 		}
-		// always exit loop if we're not in dynamic mode
-		processedJob = processedJob && ( m_opMode == OperationMode::Dynamic );
+		m_bottom.store(b + 1, std::memory_order_relaxed);
 	}
+	return job;
 }
 
 
 
 
-void AudioEngineWorkerThread::JobQueue::wait()
+ThreadableJob * AudioEngineWorkerThread::JobQueue::Deque::steal()
 {
-	while (m_itemsDone < m_writeIndex)
+	auto t = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const auto b = m_bottom.load(std::memory_order_acquire);
+	if (t >= b)
 	{
-#ifdef __SSE__
-		_mm_pause();
-#endif
+		return nullptr;
+	}
+
+	ThreadableJob * job = m_items[t & Mask].load(std::memory_order_relaxed);
+	if (!m_top.compare_exchange_strong(t, t + 1,
+			std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		// lost the race against the owner or another thief
+		return nullptr;
 	}
+	return job;
 }
 
 
 
 
+// implementation of internal JobQueue
+int AudioEngineWorkerThread::JobQueue::addSlot()
+{
+	m_deques.push_back(std::make_unique<Deque>());
+	return static_cast<int>(m_deques.size()) - 1;
+}
 
-// implementation of worker threads
 
-AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
-	QThread( audioEngine ),
-	m_quit( false )
+
+
+void AudioEngineWorkerThread::JobQueue::clearSlots()
+{
+	m_deques.clear();
+	s_inlineSlot = -1;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::reset( OperationMode )
+{
+	m_itemsQueued = 0;
+	m_itemsDone = 0;
+}
+
+
+
+
+bool AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
 {
-	// initialize global static data
-	if( queueReadyWaitCond == nullptr )
+	if( !_job->requiresProcessing() )
 	{
-		queueReadyWaitCond = new QWaitCondition;
+		return false;
 	}
 
-	// keep track of all instantiated worker threads - this is used for
-	// processing the last worker thread "inline", see comments in
-	// AudioEngineWorkerThread::startAndWaitForJobs() for details
-	workerThreads << this;
+	// update job state
+	_job->queue();
+	++m_itemsQueued;
 
-	resetJobQueue();
+	// the deques may only be pushed to by their owner
+	assert(s_slot >= 0 && "jobs added by a thread which is no worker");
+	if (s_slot < 0 || !m_deques[s_slot]->push(_job))
+	{
+		if (s_slot >= 0) { qWarning() << "Job queue is full!"; }
+		// process it right away instead of dropping it
+		_job->process();
+		++m_itemsDone;
+		return true;
+	}
+
+	if (s_parkedWorkers.load() > 0)
+	{
+		wakeWorkers();
+	}
+	return true;
+}
+
+
+
+
+bool AudioEngineWorkerThread::JobQueue::runOne( int slot )
+{
+	ThreadableJob * job = m_deques[slot]->pop();
+
+	// nothing left in our own deque, so try to steal from the others,
+	// starting with our neighbour to spread the thieves across the deques
+	const auto numDeques = static_cast<int>(m_deques.size());
+	for (int i = 1; !job && i < numDeques; ++i)
+	{
+		job = m_deques[(slot + i) % numDeques]->steal();
+	}
+
+	if (!job)
+	{
+		return false;
+	}
+
+	job->process();
+	++m_itemsDone;
+	return true;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::run( int slot )
+{
+	while (!isDone())
+	{
+		if (!runOne(slot))
+		{
+			// remaining jobs are in progress in other threads
+			cpuRelax();
+		}
+	}
 }
 
 
 
 
-AudioEngineWorkerThread::~AudioEngineWorkerThread()
+
+// implementation of worker threads
+
+AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
+	QThread( audioEngine ),
+	m_slot( globalJobQueue.addSlot() ),
+	m_spinCount( DEFAULT_SPIN_COUNT ),
+	m_pinToCore( false ),
+	m_quit( false )
 {
-	workerThreads.removeAll( this );
+	// the most recently created worker is the one which is never started,
+	// see comments in AudioEngineWorkerThread::startAndWaitForJobs()
+	s_inlineSlot = m_slot;
+
+	const auto spinCount = ConfigManager::inst()->value("audioengine", "workerspincount");
+	if (!spinCount.isEmpty())
+	{
+		m_spinCount = std::max(spinCount.toInt(), 0);
+	}
+	m_pinToCore = ConfigManager::inst()->value("audioengine", "pinworkerthreads").toInt();
+
+	resetJobQueue();
 }
 
 
@@ -146,6 +290,7 @@ void AudioEngineWorkerThread::quit()
 {
 	m_quit = true;
 	resetJobQueue();
+	wakeWorkers();
 }
 
 
@@ -153,12 +298,88 @@ void AudioEngineWorkerThread::quit()
 
 void AudioEngineWorkerThread::startAndWaitForJobs()
 {
-	queueReadyWaitCond->wakeAll();
+	wakeWorkers();
 	// The last worker-thread is never started. Instead it's processed "inline"
 	// i.e. within the global AudioEngine thread. This way we can reduce latencies
 	// that otherwise would be caused by synchronizing with another thread.
-	globalJobQueue.run();
-	globalJobQueue.wait();
+	assert(s_slot >= 0 && "startAndWaitForJobs() called without an InlineWorker");
+	globalJobQueue.run( s_slot );
+}
+
+
+
+
+AudioEngineWorkerThread::InlineWorker::InlineWorker()
+{
+	[[maybe_unused]] const bool taken = s_inlineSlotTaken.exchange(true, std::memory_order_acquire);
+	assert(!taken && "inline worker slot used by two threads");
+	s_slot = s_inlineSlot;
+}
+
+
+
+
+AudioEngineWorkerThread::InlineWorker::~InlineWorker()
+{
+	s_slot = -1;
+	s_inlineSlotTaken.store(false, std::memory_order_release);
+}
+
+
+
+
+void AudioEngineWorkerThread::wakeWorkers()
+{
+	++s_wakeGeneration;
+	if (s_parkedWorkers.load() > 0)
+	{
+		// synchronize with workers which are about to park, so they either
+		// see the new generation or receive the notification
+		{
+			const auto lock = std::lock_guard{s_parkMutex};
+		}
+		s_parkCond.notify_all();
+	}
+}
+
+
+
+
+void AudioEngineWorkerThread::park( std::uint64_t generation )
+{
+	auto lock = std::unique_lock{s_parkMutex};
+	++s_parkedWorkers;
+	s_parkCond.wait(lock, [&] { return s_wakeGeneration.load() != generation || m_quit; });
+	--s_parkedWorkers;
+}
+
+
+
+
+void AudioEngineWorkerThread::pinToCore()
+{
+	// keep the first core for the thread driving the audio device
+	const int numCores = QThread::idealThreadCount();
+	if (numCores < 2)
+	{
+		return;
+	}
+	const int core = 1 + m_slot % (numCores - 1);
+
+#if defined(LMMS_BUILD_LINUX)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+	{
+		qWarning() << "Could not pin audio worker thread to core" << core;
+	}
+#elif defined(LMMS_BUILD_WIN32)
+	if (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << core) == 0)
+	{
+		qWarning() << "Could not pin audio worker thread to core" << core;
+	}
+#endif
 }
 
 
@@ -168,13 +389,32 @@ void AudioEngineWorkerThread::run()
 {
 	disable_denormals();
 
-	QMutex m;
+	s_slot = m_slot;
+	if (m_pinToCore)
+	{
+		pinToCore();
+	}
+
+	int spins = 0;
 	while( m_quit == false )
 	{
-		m.lock();
-		queueReadyWaitCond->wait( &m );
-		globalJobQueue.run();
-		m.unlock();
+		// read the generation before looking for work, so a wake-up
+		// issued after an unsuccessful search can't get lost
+		const auto generation = s_wakeGeneration.load();
+		if (globalJobQueue.runOne(m_slot))
+		{
+			spins = 0;
+		}
+		else if (spins < m_spinCount)
+		{
+			++spins;
+			cpuRelax();
+		}
+		else
+		{
+			park(generation);
+			spins = 0;
+		}
 	}
 }
 
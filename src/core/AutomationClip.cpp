@@ -108,6 +108,7 @@ bool AutomationClip::addObject( AutomatableModel * _obj, bool _search_dup )
 	}
 
 	m_objects.push_back(_obj);
+	AutomationSchedule::invalidate();
 
 	connect( _obj, SIGNAL(destroyed(lmms::jo_id_t)),
 			this, SLOT(objectDestroyed(lmms::jo_id_t)),
@@ -1102,6 +1103,7 @@ void AutomationClip::objectDestroyed( jo_id_t _id )
 		{
 			//Assign to objIt so that this loop work even break; is removed.
 			objIt = m_objects.erase( objIt );
+			AutomationSchedule::invalidate();
 			break;
 		}
 	}
@@ -1125,6 +1127,7 @@ void AutomationClip::cleanObjects()
 		else
 		{
 			it = m_objects.erase( it );
+			AutomationSchedule::invalidate();
 		}
 	}
 }
@@ -0,0 +1,410 @@
+/*
+ * AutomationSchedule.cpp - precompiled automation timeline of the song
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AutomationSchedule.h"
+
+#include <algorithm>
+
+#include "AutomationClip.h"
+#include "AutomationTrack.h"
+#include "Engine.h"
+#include "PatternStore.h"
+#include "PatternTrack.h"
+#include "Song.h"
+
+namespace lmms
+{
+
+
+std::atomic<unsigned> AutomationSchedule::s_generation = 0;
+
+
+
+
+void AutomationSchedule::process(TimePos time, int patternIndex)
+{
+	const unsigned generation = s_generation.load(std::memory_order_acquire);
+	if (!m_compiled || generation != m_generation)
+	{
+		m_generation = generation;
+		compile();
+		m_compiled = true;
+	}
+
+	const bool patternMode = patternIndex >= 0;
+	processRecording(time, patternMode);
+
+	TimePos patTime = time;
+	if (patternMode)
+	{
+		// like PatternStore::automatedValuesAt()
+		const tick_t length = Engine::patternStore()->lengthOfPattern(patternIndex) * TimePos::ticksPerBar();
+		patTime = std::min<tick_t>(time.getTicks(), length);
+	}
+
+	for (auto& target : m_targets)
+	{
+		if (target.model.isNull()) { continue; }
+
+		float value = 0;
+		const bool automated = patternMode
+			? patternValueAt(target, patternIndex, patTime, value)
+			: valueAt(target, time, value);
+		apply(target, automated, value);
+		target.recording = false;
+	}
+}
+
+
+
+
+void AutomationSchedule::releaseModels()
+{
+	for (auto& target : m_targets)
+	{
+		if (target.automated && !target.model.isNull())
+		{
+			target.model->setUseControllerValue(true);
+		}
+		target.automated = false;
+	}
+}
+
+
+
+
+void AutomationSchedule::clear()
+{
+	m_targets.clear();
+	m_previousTargets.clear();
+	m_recordingClips.clear();
+	m_targetIndex.clear();
+	m_compiled = false;
+}
+
+
+
+
+void AutomationSchedule::compile()
+{
+	std::swap(m_previousTargets, m_targets);
+	m_targets.clear();
+	m_targetIndex.clear();
+	m_recordingClips.clear();
+
+	// the pattern store goes first so we know which models each pattern
+	// automates when we come across its clips in the song
+	for (Track* track : Engine::patternStore()->tracks())
+	{
+		addPatternStoreTrack(track);
+	}
+	for (auto& target : m_targets)
+	{
+		// keep the track order within each pattern, the last track wins
+		std::stable_sort(target.patternCandidates.begin(), target.patternCandidates.end(),
+			[](const PatternCandidate& a, const PatternCandidate& b) { return a.pattern < b.pattern; });
+	}
+
+	Song* song = Engine::getSong();
+	addSongTrack(song->globalAutomationTrack());
+	for (Track* track : song->tracks())
+	{
+		addSongTrack(track);
+	}
+	for (auto& target : m_targets)
+	{
+		// clips starting later win, on the same position the last track wins
+		std::stable_sort(target.segments.begin(), target.segments.end(),
+			[](const Segment& a, const Segment& b) { return a.start < b.start; });
+	}
+
+	// carry over the state of models which are still automated, and give
+	// control of the other ones back to their controllers as
+	// Song::processAutomations() always did
+	for (auto& previous : m_previousTargets)
+	{
+		if (previous.model.isNull()) { continue; }
+
+		const auto it = m_targetIndex.find(previous.model.data());
+		if (it != m_targetIndex.end())
+		{
+			auto& target = m_targets[it->second];
+			target.automated = previous.automated;
+			target.lastValue = previous.lastValue;
+			target.appliedValue = previous.appliedValue;
+		}
+		else if (previous.automated && previous.model->controllerConnection())
+		{
+			previous.model->setUseControllerValue(true);
+		}
+	}
+	m_previousTargets.clear();
+}
+
+
+
+
+AutomationSchedule::Target& AutomationSchedule::targetFor(AutomatableModel* model)
+{
+	const auto [it, inserted] = m_targetIndex.emplace(model, m_targets.size());
+	if (inserted)
+	{
+		m_targets.emplace_back();
+		m_targets.back().model = model;
+	}
+	return m_targets[it->second];
+}
+
+
+
+
+void AutomationSchedule::addSongTrack(Track* track)
+{
+	switch (track->type())
+	{
+	case Track::Type::Automation:
+	case Track::Type::HiddenAutomation:
+		for (Clip* clip : track->getClips())
+		{
+			auto autoClip = dynamic_cast<AutomationClip*>(clip);
+			if (!autoClip) { continue; }
+
+			for (AutomatableModel* model : autoClip->objects())
+			{
+				if (!model) { continue; }
+				targetFor(model).segments.push_back({clip->startPosition().getTicks(), track, clip, -1});
+			}
+
+			if (track->type() == Track::Type::Automation)
+			{
+				const auto& objects = autoClip->objects();
+				const auto it = objects.empty() || !objects.front()
+					? m_targetIndex.end()
+					: m_targetIndex.find(objects.front().data());
+				m_recordingClips.push_back({autoClip, false,
+					it != m_targetIndex.end() ? static_cast<int>(it->second) : -1});
+			}
+		}
+		break;
+	case Track::Type::Pattern:
+	{
+		const int pattern = static_cast<PatternTrack*>(track)->patternIndex();
+		for (std::size_t i = 0; i < m_targets.size(); ++i)
+		{
+			const auto& candidates = m_targets[i].patternCandidates;
+			const bool automatedByPattern = std::any_of(candidates.begin(), candidates.end(),
+				[pattern](const PatternCandidate& c) { return c.pattern == pattern; });
+			if (!automatedByPattern) { continue; }
+
+			for (Clip* clip : track->getClips())
+			{
+				m_targets[i].segments.push_back({clip->startPosition().getTicks(), track, clip, pattern});
+			}
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+
+
+
+void AutomationSchedule::addPatternStoreTrack(Track* track)
+{
+	if (track->type() != Track::Type::Automation) { return; }
+
+	const auto& clips = track->getClips();
+	for (std::size_t pattern = 0; pattern < clips.size(); ++pattern)
+	{
+		auto autoClip = dynamic_cast<AutomationClip*>(clips[pattern]);
+		if (!autoClip) { continue; }
+
+		for (AutomatableModel* model : autoClip->objects())
+		{
+			if (!model) { continue; }
+			targetFor(model).patternCandidates.push_back({static_cast<int>(pattern), track, autoClip});
+		}
+
+		const auto& objects = autoClip->objects();
+		const auto it = objects.empty() || !objects.front()
+			? m_targetIndex.end()
+			: m_targetIndex.find(objects.front().data());
+		m_recordingClips.push_back({autoClip, true,
+			it != m_targetIndex.end() ? static_cast<int>(it->second) : -1});
+	}
+}
+
+
+
+
+void AutomationSchedule::processRecording(TimePos time, bool patternMode)
+{
+	for (const auto& recording : m_recordingClips)
+	{
+		// only the clips of the container being played can record
+		if (recording.inPattern != patternMode) { continue; }
+
+		AutomationClip* clip = recording.clip;
+		const TimePos relTime = time - clip->startPosition();
+		if (clip->isRecording() && relTime >= 0 && relTime < clip->length())
+		{
+			const AutomatableModel* recordedModel = clip->firstObject();
+			// The automation system really needs to be reworked.
+			// For whatever reason, the values in an automation clip are stored in un-un-scaled format, so if you
+			// are automating a log knob, when you draw an curve, the values being stored are not the actual values the
+			// knob will take, but instead the unscaled version of the unscaled numbers. The tooltip shows the number you expect, but if you double-click,
+			// you can see that the true values are stored by their inverse scaled value....which is wrong, since they weren't scaled in the first place...?
+			// Anyhow, in the meantime before we redo the automation system, when recording automations, we have to get the inverseScaledValue
+			// and store that so that when playing it back, it scales the value correctly.
+			clip->recordValue(relTime, recordedModel->inverseScaledValue(recordedModel->value<float>()));
+
+			if (recording.target >= 0)
+			{
+				m_targets[recording.target].recording = true;
+			}
+		}
+	}
+}
+
+
+
+
+bool AutomationSchedule::valueAt(Target& target, TimePos time, float& value)
+{
+	const auto& segments = target.segments;
+	const tick_t ticks = time.getTicks();
+
+	// move the cursor past all segments starting at or before the current
+	// time, searching from the start only if we jumped backwards
+	const auto startsLater = [](tick_t t, const Segment& s) { return t < s.start; };
+	if (target.cursor > 0 && segments[target.cursor - 1].start > ticks)
+	{
+		target.cursor = std::upper_bound(segments.begin(), segments.begin() + target.cursor, ticks, startsLater)
+			- segments.begin();
+	}
+	else if (target.cursor < segments.size() && segments[target.cursor].start <= ticks)
+	{
+		target.cursor = std::upper_bound(segments.begin() + target.cursor, segments.end(), ticks, startsLater)
+			- segments.begin();
+	}
+
+	// the latest clip which actually has a value for the model wins
+	for (std::size_t i = target.cursor; i > 0; --i)
+	{
+		const Segment& segment = segments[i - 1];
+		if (segment.track->isMuted() || segment.clip->isMuted()) { continue; }
+
+		if (segment.pattern < 0)
+		{
+			auto clip = static_cast<AutomationClip*>(segment.clip);
+			if (!clip->hasAutomation()) { continue; }
+
+			TimePos relTime = time - clip->startPosition() - clip->startTimeOffset();
+			relTime = std::min(static_cast<int>(relTime), clip->length() - clip->startTimeOffset());
+			value = clip->valueAt(relTime);
+			return true;
+		}
+
+		const auto patternStore = Engine::patternStore();
+		TimePos patTime = time - segment.clip->startPosition();
+		patTime = std::min(patTime, segment.clip->length());
+		patTime = patTime % (patternStore->lengthOfPattern(segment.pattern) * TimePos::ticksPerBar());
+		if (patternValueAt(target, segment.pattern, patTime, value))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+
+bool AutomationSchedule::patternValueAt(const Target& target, int pattern, TimePos patTime, float& value) const
+{
+	const auto& candidates = target.patternCandidates;
+	const auto range = std::equal_range(candidates.begin(), candidates.end(), PatternCandidate{pattern, nullptr, nullptr},
+		[](const PatternCandidate& a, const PatternCandidate& b) { return a.pattern < b.pattern; });
+
+	// the clips of a pattern are placed at the bar of the pattern index
+	const TimePos time = patTime + TimePos::ticksPerBar() * pattern;
+	for (auto it = range.second; it != range.first; --it)
+	{
+		const PatternCandidate& candidate = *(it - 1);
+		AutomationClip* clip = candidate.clip;
+		if (candidate.track->isMuted() || clip->isMuted() || !clip->hasAutomation()
+			|| clip->startPosition() > time)
+		{
+			continue;
+		}
+
+		value = clip->valueAt(time - clip->startPosition() - clip->startTimeOffset());
+		return true;
+	}
+
+	return false;
+}
+
+
+
+
+void AutomationSchedule::apply(Target& target, bool automated, float value)
+{
+	AutomatableModel* model = target.model.data();
+
+	if (!automated)
+	{
+		// the model stopped being automated, so move the control back to
+		// any connected controller again
+		if (target.automated && model->controllerConnection())
+		{
+			model->setUseControllerValue(true);
+		}
+		target.automated = false;
+		return;
+	}
+
+	if (target.recording)
+	{
+		if (!model->useControllerValue())
+		{
+			model->setUseControllerValue(true);
+		}
+	}
+	else if (!target.automated || value != target.lastValue || model->useControllerValue()
+		|| model->value<float>() != target.appliedValue)
+	{
+		model->setAutomatedValue(value);
+		target.appliedValue = model->value<float>();
+	}
+
+	target.automated = true;
+	target.lastValue = value;
+}
+
+
+} // namespace lmms
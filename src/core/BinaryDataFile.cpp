@@ -0,0 +1,625 @@
+/*
+ * BinaryDataFile.cpp - binary container for DataFile with memory-mapped
+ *                      sample chunks
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "BinaryDataFile.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDomDocument>
+#include <QHash>
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr char Magic[] = "LMMSPRJB";
+constexpr quint32 FormatVersion = 1;
+constexpr qint64 HeaderSize = BinaryDataFile::MagicSize + 2 * sizeof(quint32);
+constexpr qint64 FooterSize = 3 * sizeof(quint64) + 2 * sizeof(quint32) + BinaryDataFile::MagicSize;
+constexpr quint32 NoString = 0xffffffff;
+constexpr int MaxDepth = 256;
+
+const QString ChunkPrefix = QStringLiteral("lmms-chunk:");
+
+enum class NodeType : quint8
+{
+	Element,
+	Text,
+	CData,
+	Comment,
+	ProcessingInstruction
+};
+
+enum class AttributeType : quint8
+{
+	String,
+	Chunk
+};
+
+// attributes holding base64 encoded sample data, which are stored as raw chunks
+const std::map<QString, std::set<QString>> SampleAttributes = {
+	{ "sampleclip", {"data"} },
+	{ "audiofileprocessor", {"sampledata"} },
+	{ "slicert", {"sampledata"} },
+};
+
+std::mutex s_registryMutex;
+std::map<int, std::weak_ptr<const BinaryDataFile>> s_registry;
+int s_nextId = 0;
+
+
+void setupStream(QDataStream& stream)
+{
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+
+
+
+struct Writer
+{
+	QIODevice& device;
+	quint64 offset;
+	QByteArray nodeData;
+	QDataStream nodes;
+	QHash<QString, quint32> stringIndex;
+	std::vector<QByteArray> strings;
+	std::vector<std::pair<quint64, quint64>> chunks;
+
+	Writer(QIODevice& device, quint64 offset)
+		: device(device)
+		, offset(offset)
+		, nodes(&nodeData, QIODevice::WriteOnly)
+	{
+		setupStream(nodes);
+	}
+
+	quint32 intern(const QString& str)
+	{
+		const auto it = stringIndex.constFind(str);
+		if (it != stringIndex.constEnd()) { return it.value(); }
+
+		const auto index = static_cast<quint32>(strings.size());
+		stringIndex.insert(str, index);
+		strings.push_back(str.toUtf8());
+		return index;
+	}
+
+	bool writeRaw(const char* data, qint64 size)
+	{
+		while (size > 0)
+		{
+			const auto written = device.write(data, size);
+			if (written <= 0) { return false; }
+			data += written;
+			size -= written;
+			offset += written;
+		}
+		return true;
+	}
+
+	//! Appends a chunk to the file and returns its index
+	bool writeChunk(const char* data, quint64 size, quint32& index)
+	{
+		const auto padding = (BinaryDataFile::ChunkAlignment - offset % BinaryDataFile::ChunkAlignment)
+			% BinaryDataFile::ChunkAlignment;
+		const char zeros[BinaryDataFile::ChunkAlignment] = {};
+		if (!writeRaw(zeros, padding)) { return false; }
+
+		index = static_cast<quint32>(chunks.size());
+		chunks.emplace_back(offset, size);
+		return writeRaw(data, size);
+	}
+
+	bool writeNode(const QDomNode& node);
+};
+
+
+
+
+bool isSupported(const QDomNode& node)
+{
+	return node.isElement() || node.isCDATASection() || node.isText() || node.isComment()
+		|| node.isProcessingInstruction();
+}
+
+
+
+
+bool writeChildren(Writer& w, const QDomNode& parent)
+{
+	const auto children = parent.childNodes();
+	quint32 count = 0;
+	for (int i = 0; i < children.count(); ++i)
+	{
+		if (isSupported(children.item(i))) { ++count; }
+	}
+
+	w.nodes << count;
+	for (int i = 0; i < children.count(); ++i)
+	{
+		const auto child = children.item(i);
+		if (isSupported(child) && !w.writeNode(child)) { return false; }
+	}
+	return true;
+}
+
+
+
+
+bool Writer::writeNode(const QDomNode& node)
+{
+	// check CDATA first, as CDATA sections are text nodes as well
+	if (node.isCDATASection())
+	{
+		nodes << static_cast<quint8>(NodeType::CData) << intern(node.nodeValue());
+		return true;
+	}
+	if (node.isText())
+	{
+		nodes << static_cast<quint8>(NodeType::Text) << intern(node.nodeValue());
+		return true;
+	}
+	if (node.isComment())
+	{
+		nodes << static_cast<quint8>(NodeType::Comment) << intern(node.nodeValue());
+		return true;
+	}
+	if (node.isProcessingInstruction())
+	{
+		const auto pi = node.toProcessingInstruction();
+		nodes << static_cast<quint8>(NodeType::ProcessingInstruction) << intern(pi.target()) << intern(pi.data());
+		return true;
+	}
+
+	const auto elem = node.toElement();
+	const auto sampleAttributes = SampleAttributes.find(elem.tagName());
+	const auto attributes = elem.attributes();
+
+	nodes << static_cast<quint8>(NodeType::Element) << intern(elem.tagName())
+		<< static_cast<quint32>(attributes.count());
+	for (int i = 0; i < attributes.count(); ++i)
+	{
+		const auto attribute = attributes.item(i).toAttr();
+		const auto value = attribute.value();
+		quint32 chunk = 0;
+
+		if (BinaryDataFile::isChunkReference(value))
+		{
+			// loaded from a binary file, copy the chunk from its mapped pages
+			const auto source = BinaryDataFile::findChunk(value);
+			if (!source)
+			{
+				// the file it was loaded from is gone, don't silently drop the sample
+				qWarning() << "BinaryDataFile: lost chunk" << value;
+				return false;
+			}
+			if (!writeChunk(source.data, source.size, chunk)) { return false; }
+		}
+		else if (!value.isEmpty() && sampleAttributes != SampleAttributes.end()
+			&& sampleAttributes->second.count(attribute.name()) > 0)
+		{
+			const auto data = QByteArray::fromBase64(value.toLatin1());
+			if (!writeChunk(data.constData(), data.size(), chunk)) { return false; }
+		}
+		else
+		{
+			nodes << intern(attribute.name()) << static_cast<quint8>(AttributeType::String) << intern(value);
+			continue;
+		}
+		nodes << intern(attribute.name()) << static_cast<quint8>(AttributeType::Chunk) << chunk;
+	}
+
+	return writeChildren(*this, elem);
+}
+
+
+
+
+struct Reader
+{
+	QDataStream& stream;
+	const std::vector<QString>& strings;
+	QDomDocument& doc;
+	const std::function<QString(quint32)>& chunkReference;
+	std::size_t chunkCount;
+
+	bool string(QString& str)
+	{
+		quint32 index;
+		stream >> index;
+		if (index >= strings.size()) { return false; }
+		str = strings[index];
+		return true;
+	}
+
+	bool readChildren(QDomNode parent, int depth)
+	{
+		if (depth > MaxDepth) { return false; }
+
+		quint32 count;
+		stream >> count;
+		for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+		{
+			if (!readNode(parent, depth)) { return false; }
+		}
+		return stream.status() == QDataStream::Ok;
+	}
+
+	bool readNode(QDomNode& parent, int depth)
+	{
+		quint8 type;
+		stream >> type;
+
+		QString value;
+		switch (static_cast<NodeType>(type))
+		{
+		case NodeType::Text:
+			if (!string(value)) { return false; }
+			parent.appendChild(doc.createTextNode(value));
+			return true;
+		case NodeType::CData:
+			if (!string(value)) { return false; }
+			parent.appendChild(doc.createCDATASection(value));
+			return true;
+		case NodeType::Comment:
+			if (!string(value)) { return false; }
+			parent.appendChild(doc.createComment(value));
+			return true;
+		case NodeType::ProcessingInstruction:
+		{
+			QString target;
+			if (!string(target) || !string(value)) { return false; }
+			parent.appendChild(doc.createProcessingInstruction(target, value));
+			return true;
+		}
+		case NodeType::Element:
+			break;
+		default:
+			return false;
+		}
+
+		QString name;
+		if (!string(name)) { return false; }
+		auto elem = doc.createElement(name);
+
+		quint32 attributes;
+		stream >> attributes;
+		for (quint32 i = 0; i < attributes && stream.status() == QDataStream::Ok; ++i)
+		{
+			quint8 attributeType;
+			if (!string(name)) { return false; }
+			stream >> attributeType;
+			if (static_cast<AttributeType>(attributeType) == AttributeType::Chunk)
+			{
+				quint32 chunk;
+				stream >> chunk;
+				if (chunk >= chunkCount) { return false; }
+				elem.setAttribute(name, chunkReference(chunk));
+			}
+			else
+			{
+				if (!string(value)) { return false; }
+				elem.setAttribute(name, value);
+			}
+		}
+
+		parent.appendChild(elem);
+		return readChildren(elem, depth + 1);
+	}
+};
+
+} // namespace
+
+
+
+
+BinaryDataFile::~BinaryDataFile()
+{
+	const auto lock = std::lock_guard{s_registryMutex};
+	s_registry.erase(m_id);
+}
+
+
+
+
+bool BinaryDataFile::isBinary(const QByteArray& data)
+{
+	return data.startsWith(QByteArray::fromRawData(Magic, MagicSize));
+}
+
+
+
+
+std::shared_ptr<const BinaryDataFile> BinaryDataFile::read(const QString& fileName, QDomDocument& doc,
+	QString* errorMsg)
+{
+	auto file = std::shared_ptr<BinaryDataFile>(new BinaryDataFile);
+	file->m_file.setFileName(fileName);
+	if (!file->m_file.open(QIODevice::ReadOnly))
+	{
+		if (errorMsg) { *errorMsg = file->m_file.errorString(); }
+		return nullptr;
+	}
+
+	file->m_size = file->m_file.size();
+	if (const auto mapped = file->m_file.map(0, file->m_size))
+	{
+		file->m_data = reinterpret_cast<const char*>(mapped);
+	}
+	else
+	{
+		// mapping is not supported by every file system, fall back to reading it
+		const auto bytes = file->m_file.readAll();
+		file->copy(bytes.constData(), bytes.size());
+		file->m_file.close();
+	}
+
+	return load(std::move(file), doc, errorMsg);
+}
+
+
+
+
+std::shared_ptr<const BinaryDataFile> BinaryDataFile::read(const QByteArray& data, QDomDocument& doc,
+	QString* errorMsg)
+{
+	auto file = std::shared_ptr<BinaryDataFile>(new BinaryDataFile);
+	// QByteArray only aligns its data to 8 or 16 bytes
+	file->copy(data.constData(), data.size());
+	return load(std::move(file), doc, errorMsg);
+}
+
+
+
+
+void BinaryDataFile::copy(const char* data, qint64 size)
+{
+	const auto bytes = static_cast<std::size_t>(std::max<qint64>(size, 1));
+	m_copy.reset(static_cast<char*>(::operator new[](bytes, std::align_val_t{ChunkAlignment})));
+	std::copy_n(data, size, m_copy.get());
+	m_data = m_copy.get();
+	m_size = size;
+}
+
+
+
+
+std::shared_ptr<const BinaryDataFile> BinaryDataFile::load(std::shared_ptr<BinaryDataFile> file,
+	QDomDocument& doc, QString* errorMsg)
+{
+	{
+		const auto lock = std::lock_guard{s_registryMutex};
+		file->m_id = ++s_nextId;
+		s_registry[file->m_id] = file;
+	}
+
+	if (!file->parse(doc, errorMsg)) { return nullptr; }
+	return file;
+}
+
+
+
+
+bool BinaryDataFile::parse(QDomDocument& doc, QString* errorMsg)
+{
+	const auto fail = [errorMsg](const QString& msg) {
+		if (errorMsg) { *errorMsg = msg; }
+		return false;
+	};
+
+	if (m_size < HeaderSize + FooterSize || !isBinary(QByteArray::fromRawData(m_data, MagicSize)))
+	{
+		return fail("not a binary LMMS file");
+	}
+
+	auto header = QDataStream{QByteArray::fromRawData(m_data + MagicSize, HeaderSize - MagicSize)};
+	setupStream(header);
+	quint32 version;
+	header >> version;
+	if (version > FormatVersion) { return fail(QString("unsupported format version %1").arg(version)); }
+
+	const auto footerOffset = m_size - FooterSize;
+	if (!isBinary(QByteArray::fromRawData(m_data + m_size - MagicSize, MagicSize)))
+	{
+		return fail("file is truncated");
+	}
+
+	auto footer = QDataStream{QByteArray::fromRawData(m_data + footerOffset, FooterSize)};
+	setupStream(footer);
+	quint64 nodesOffset, stringsOffset, tableOffset;
+	quint32 chunkCount, reserved;
+	footer >> nodesOffset >> stringsOffset >> tableOffset >> chunkCount >> reserved;
+
+	if (nodesOffset < static_cast<quint64>(HeaderSize) || stringsOffset < nodesOffset
+		|| tableOffset < stringsOffset || tableOffset > static_cast<quint64>(footerOffset)
+		|| static_cast<quint64>(footerOffset) - tableOffset != quint64{chunkCount} * 2 * sizeof(quint64))
+	{
+		return fail("invalid section offsets");
+	}
+
+	const auto section = [this](quint64 begin, quint64 end) {
+		auto stream = std::make_unique<QDataStream>(QByteArray::fromRawData(m_data + begin, end - begin));
+		setupStream(*stream);
+		return stream;
+	};
+
+	// chunk table
+	auto table = section(tableOffset, footerOffset);
+	m_chunks.resize(chunkCount);
+	for (auto& [offset, size] : m_chunks)
+	{
+		*table >> offset >> size;
+		if (offset < static_cast<quint64>(HeaderSize) || offset > nodesOffset || size > nodesOffset - offset)
+		{
+			return fail("invalid chunk table");
+		}
+	}
+
+	// string table
+	auto strings = std::vector<QString>{};
+	auto stringStream = section(stringsOffset, tableOffset);
+	quint32 stringCount;
+	*stringStream >> stringCount;
+	if (stringCount > tableOffset - stringsOffset) { return fail("invalid string table"); }
+	strings.reserve(stringCount);
+	for (quint32 i = 0; i < stringCount; ++i)
+	{
+		QByteArray str;
+		*stringStream >> str;
+		strings.push_back(QString::fromUtf8(str));
+	}
+	if (stringStream->status() != QDataStream::Ok) { return fail("invalid string table"); }
+
+	// settings tree
+	auto nodes = section(nodesOffset, stringsOffset);
+	quint32 docType;
+	*nodes >> docType;
+	if (docType != NoString && docType >= strings.size()) { return fail("invalid document type"); }
+	doc = docType != NoString ? QDomDocument(strings[docType]) : QDomDocument();
+
+	const auto chunkReference = std::function<QString(quint32)>{
+		[this](quint32 index) { return this->chunkReference(index); }};
+	auto reader = Reader{*nodes, strings, doc, chunkReference, m_chunks.size()};
+	if (!reader.readChildren(doc, 0)) { return fail("invalid settings tree"); }
+
+	return true;
+}
+
+
+
+
+bool BinaryDataFile::write(const QDomDocument& doc, QIODevice& device)
+{
+	QByteArray header;
+	{
+		auto stream = QDataStream{&header, QIODevice::WriteOnly};
+		setupStream(stream);
+		stream.writeRawData(Magic, static_cast<int>(MagicSize));
+		stream << FormatVersion << quint32{0};
+	}
+	if (device.write(header) != header.size()) { return false; }
+
+	auto w = Writer{device, static_cast<quint64>(header.size())};
+	w.nodes << (doc.doctype().isNull() ? NoString : w.intern(doc.doctype().name()));
+	if (!writeChildren(w, doc)) { return false; }
+
+	const auto nodesOffset = w.offset;
+	if (!w.writeRaw(w.nodeData.constData(), w.nodeData.size())) { return false; }
+	w.nodeData.clear();
+
+	QByteArray tail;
+	auto stream = QDataStream{&tail, QIODevice::WriteOnly};
+	setupStream(stream);
+
+	const auto stringsOffset = w.offset;
+	stream << static_cast<quint32>(w.strings.size());
+	for (const auto& str : w.strings) { stream << str; }
+
+	const auto tableOffset = stringsOffset + tail.size();
+	for (const auto& [offset, size] : w.chunks) { stream << offset << size; }
+
+	stream << nodesOffset << stringsOffset << static_cast<quint64>(tableOffset)
+		<< static_cast<quint32>(w.chunks.size()) << quint32{0};
+	stream.writeRawData(Magic, static_cast<int>(MagicSize));
+
+	return w.writeRaw(tail.constData(), tail.size());
+}
+
+
+
+
+bool BinaryDataFile::isChunkReference(const QString& value)
+{
+	return value.startsWith(ChunkPrefix);
+}
+
+
+
+
+BinaryDataFile::Chunk BinaryDataFile::findChunk(const QString& reference)
+{
+	if (!isChunkReference(reference)) { return {}; }
+
+	const auto parts = reference.mid(ChunkPrefix.size()).split(':');
+	bool idOk = false, indexOk = false;
+	const auto id = parts.size() == 2 ? parts[0].toInt(&idOk) : 0;
+	const auto index = parts.size() == 2 ? parts[1].toUInt(&indexOk) : 0;
+	if (!idOk || !indexOk) { return {}; }
+
+	std::shared_ptr<const BinaryDataFile> file;
+	{
+		const auto lock = std::lock_guard{s_registryMutex};
+		const auto it = s_registry.find(id);
+		if (it == s_registry.end()) { return {}; }
+		file = it->second.lock();
+	}
+	if (!file || index >= file->m_chunks.size()) { return {}; }
+
+	const auto& [offset, size] = file->m_chunks[index];
+	return {file->m_data + offset, static_cast<std::size_t>(size), std::move(file)};
+}
+
+
+
+
+void BinaryDataFile::inlineChunks(QDomElement elem)
+{
+	const auto attributes = elem.attributes();
+	for (int i = 0; i < attributes.count(); ++i)
+	{
+		auto attribute = attributes.item(i).toAttr();
+		if (!isChunkReference(attribute.value())) { continue; }
+
+		const auto chunk = findChunk(attribute.value());
+		const auto data = QByteArray::fromRawData(chunk.data, static_cast<int>(chunk.size));
+		attribute.setValue(QString::fromLatin1(data.toBase64()));
+	}
+
+	for (auto child = elem.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+	{
+		inlineChunks(child);
+	}
+}
+
+
+
+
+QString BinaryDataFile::chunkReference(std::size_t index) const
+{
+	return ChunkPrefix + QString("%1:%2").arg(m_id).arg(index);
+}
+
+
+} // namespace lmms
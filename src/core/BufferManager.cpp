@@ -26,30 +26,179 @@
 
 #include "BufferManager.h"
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "LocklessAllocator.h"
 #include "SampleFrame.h"
 
 
 namespace lmms
 {
 
+namespace
+{
+
+//! Memory used by the pool, the number of buffers depends on the period size
+constexpr std::size_t PoolBytes = 8 * 1024 * 1024;
+constexpr std::size_t MinimumPoolBuffers = 256;
+constexpr std::size_t CacheLineSize = 64;
+
+} // namespace
+
+
 fpp_t BufferManager::s_framesPerPeriod;
+std::unique_ptr<LocklessAllocator> BufferManager::s_pool;
+std::vector<std::unique_ptr<LocklessAllocator>> BufferManager::s_retiredPools;
+std::atomic_uint BufferManager::s_generation = 0;
+std::atomic_size_t BufferManager::s_heapAllocations = 0;
+std::atomic_size_t BufferManager::s_heapBuffersInUse = 0;
+
+
+//! Free buffers kept by a single thread, exchanged with the pool in batches
+class BufferManager::Magazine
+{
+public:
+	static constexpr int Size = 16;
+
+	~Magazine()
+	{
+		// give our buffers back when the thread finishes
+		flush(m_count);
+	}
+
+	SampleFrame* acquire()
+	{
+		if (!sync()) { return nullptr; }
+
+		if (m_count == 0)
+		{
+			while (m_count < Size / 2)
+			{
+				auto buf = static_cast<SampleFrame*>(m_pool->tryAlloc());
+				if (!buf) { break; }
+				m_buffers[m_count++] = buf;
+			}
+			if (m_count == 0) { return nullptr; }
+		}
+		return m_buffers[--m_count];
+	}
+
+	//! Only called for buffers of the current pool
+	void release(SampleFrame* buf)
+	{
+		sync();
+
+		if (m_count == Size) { flush(Size / 2); }
+		m_buffers[m_count++] = buf;
+	}
+
+private:
+	//! Returns the buffers of a previous pool to it, returns whether there
+	//! is a pool
+	bool sync()
+	{
+		const auto generation = s_generation.load(std::memory_order_acquire);
+		if (generation != m_generation)
+		{
+			// retired pools are kept alive, so the old pool is still valid
+			flush(m_count);
+			m_pool = s_pool.get();
+			m_generation = generation;
+		}
+		return m_pool != nullptr;
+	}
+
+	void flush(int count)
+	{
+		while (count-- > 0) { m_pool->free(m_buffers[--m_count]); }
+	}
+
+	//! Pool the buffers in the magazine belong to
+	LocklessAllocator* m_pool = nullptr;
+	std::array<SampleFrame*, Size> m_buffers;
+	int m_count = 0;
+	unsigned m_generation = 0;
+};
+
+
+
 
 void BufferManager::init( fpp_t fpp )
 {
+	if (s_pool && fpp == s_framesPerPeriod) { return; }
+
 	s_framesPerPeriod = fpp;
+
+	// buffers of the old pool may still be in use
+	if (s_pool) { s_retiredPools.push_back(std::move(s_pool)); }
+
+	const std::size_t bufferSize = sizeof(SampleFrame) * fpp;
+	const std::size_t buffers = std::max(PoolBytes / bufferSize, MinimumPoolBuffers);
+	s_pool = std::make_unique<LocklessAllocator>(buffers, bufferSize, CacheLineSize);
+	s_generation.fetch_add(1, std::memory_order_release);
 }
 
 
 SampleFrame* BufferManager::acquire()
 {
-	return new SampleFrame[s_framesPerPeriod];
+	SampleFrame* buf = threadMagazine().acquire();
+	if (!buf) { return allocateFromHeap(); }
+
+	std::uninitialized_default_construct_n(buf, s_framesPerPeriod);
+	return buf;
 }
 
 
 
 void BufferManager::release( SampleFrame* buf )
 {
+	if (s_pool && s_pool->owns(buf))
+	{
+		threadMagazine().release(buf);
+		return;
+	}
+
+	for (const auto& pool : s_retiredPools)
+	{
+		if (pool->owns(buf))
+		{
+			pool->free(buf);
+			return;
+		}
+	}
+
+	s_heapBuffersInUse.fetch_sub(1, std::memory_order_relaxed);
 	delete[] buf;
 }
 
+
+
+
+std::size_t BufferManager::capacity()
+{
+	return s_pool ? s_pool->capacity() : 0;
+}
+
+
+
+
+auto BufferManager::threadMagazine() -> Magazine&
+{
+	thread_local Magazine magazine;
+	return magazine;
+}
+
+
+
+
+SampleFrame* BufferManager::allocateFromHeap()
+{
+	s_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+	s_heapBuffersInUse.fetch_add(1, std::memory_order_relaxed);
+	return new SampleFrame[s_framesPerPeriod];
+}
+
 } // namespace lmms
@@ -0,0 +1,110 @@
+/*
+ * ClipIntervalIndex.cpp - position-ordered index of the clips of a track
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ClipIntervalIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Clip.h"
+
+namespace lmms
+{
+
+void ClipIntervalIndex::findInRange(const std::vector<Clip*>& clips, std::vector<Clip*>& result,
+	tick_t start, tick_t end)
+{
+	const auto lock = std::lock_guard{m_mutex};
+
+	// clear the flag before rebuilding, so changes made while we are
+	// rebuilding trigger another rebuild on the next query
+	if (m_dirty.exchange(false, std::memory_order_acq_rel))
+	{
+		rebuild(clips);
+	}
+
+	// only clips starting at or before the end of the range can intersect it
+	const auto limit = static_cast<std::size_t>(
+		std::upper_bound(m_starts.begin(), m_starts.end(), end) - m_starts.begin());
+	if (limit == 0) { return; }
+
+	const auto oldSize = result.size();
+	collect(1, 0, m_leaves, limit, start, result);
+
+	// merge with clips found before, e.g. on other tracks
+	if (oldSize > 0 && result.size() > oldSize)
+	{
+		std::inplace_merge(result.begin(), result.begin() + oldSize, result.end(), Clip::comparePosition);
+	}
+}
+
+
+
+
+void ClipIntervalIndex::rebuild(const std::vector<Clip*>& clips)
+{
+	// stable, so clips starting at the same position keep the order of the track
+	m_sorted.assign(clips.begin(), clips.end());
+	std::stable_sort(m_sorted.begin(), m_sorted.end(), Clip::comparePosition);
+
+	m_starts.resize(m_sorted.size());
+	std::transform(m_sorted.begin(), m_sorted.end(), m_starts.begin(),
+		[](const Clip* clip) { return clip->startPosition().getTicks(); });
+
+	m_leaves = 1;
+	while (m_leaves < m_sorted.size()) { m_leaves *= 2; }
+
+	m_maxEnds.assign(2 * m_leaves, std::numeric_limits<tick_t>::min());
+	for (std::size_t i = 0; i < m_sorted.size(); ++i)
+	{
+		m_maxEnds[m_leaves + i] = m_sorted[i]->endPosition().getTicks();
+	}
+	for (std::size_t node = m_leaves - 1; node > 0; --node)
+	{
+		m_maxEnds[node] = std::max(m_maxEnds[2 * node], m_maxEnds[2 * node + 1]);
+	}
+}
+
+
+
+
+void ClipIntervalIndex::collect(std::size_t node, std::size_t begin, std::size_t end, std::size_t limit,
+	tick_t start, std::vector<Clip*>& result) const
+{
+	// skip subtrees which are completely behind the range or whose clips
+	// all end before it
+	if (begin >= limit || m_maxEnds[node] < start) { return; }
+
+	if (end - begin == 1)
+	{
+		result.push_back(m_sorted[begin]);
+		return;
+	}
+
+	const auto mid = begin + (end - begin) / 2;
+	collect(2 * node, begin, mid, limit, start, result);
+	collect(2 * node + 1, mid, end, limit, start, result);
+}
+
+} // namespace lmms
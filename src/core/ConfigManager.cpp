@@ -320,6 +320,7 @@ void ConfigManager::addRecentlyOpenedProject(const QString & file)
 	QFileInfo recentFile(file);
 	if(recentFile.suffix().toLower() == "mmp" ||
 		recentFile.suffix().toLower() == "mmpz" ||
+		recentFile.suffix().toLower() == "mmpb" ||
 		recentFile.suffix().toLower() == "mpt")
 	{
 		m_recentlyOpenedProjects.removeAll(file);
@@ -39,6 +39,7 @@
 #include <QSaveFile>
 
 #include "base64.h"
+#include "BinaryDataFile.h"
 #include "ConfigManager.h"
 #include "Effect.h"
 #include "embed.h"
@@ -174,6 +175,15 @@ DataFile::DataFile( const QString & _fileName ) :
 		return;
 	}
 
+	if (BinaryDataFile::isBinary(inFile.peek(BinaryDataFile::MagicSize)))
+	{
+		// binary files are mapped instead of being read into memory
+		inFile.close();
+		QString errorMsg;
+		loadBinary(BinaryDataFile::read(_fileName, *this, &errorMsg), errorMsg, _fileName);
+		return;
+	}
+
 	loadData( inFile.readAll(), _fileName );
 }
 
@@ -187,6 +197,13 @@ DataFile::DataFile( const QByteArray & _data ) :
 	m_head(),
 	m_fileVersion( UPGRADE_METHODS.size() )
 {
+	if (BinaryDataFile::isBinary(_data))
+	{
+		QString errorMsg;
+		loadBinary(BinaryDataFile::read(_data, *this, &errorMsg), errorMsg, "<internal data>");
+		return;
+	}
+
 	loadData( _data, "<internal data>" );
 }
 
@@ -199,7 +216,7 @@ bool DataFile::validate( QString extension )
 	switch( m_type )
 	{
 	case Type::SongProject:
-		if( extension == "mmp" || extension == "mmpz" )
+		if( extension == "mmp" || extension == "mmpz" || extension == "mmpb" )
 		{
 			return true;
 		}
@@ -223,7 +240,7 @@ bool DataFile::validate( QString extension )
 		}
 		break;
 	case Type::Unknown:
-		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" ||
+		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" || extension == "mmpb" ||
 				extension == "xpf" || extension == "xml" ||
 				( extension == "xiz" && ! getPluginFactory()->pluginSupportingExtension(extension).isNull()) ||
 				extension == "sf2" || extension == "sf3" || extension == "pat" || extension == "mid" ||
@@ -265,7 +282,8 @@ QString DataFile::nameWithExtension( const QString & _fn ) const
 		case Type::SongProject:
 			if( extension != "mmp" &&
 					extension != "mpt" &&
-					extension != "mmpz" )
+					extension != "mmpz" &&
+					extension != "mmpb" )
 			{
 				if( ConfigManager::inst()->value( "app",
 						"nommpz" ).toInt() == 0 )
@@ -297,11 +315,10 @@ QString DataFile::nameWithExtension( const QString & _fn ) const
 
 void DataFile::write( QTextStream & _strm )
 {
-	if( type() == Type::SongProject || type() == Type::SongProjectTemplate
-					|| type() == Type::InstrumentTrackSettings )
-	{
-		cleanMetaNodes( documentElement() );
-	}
+	cleanMetaNodes();
+
+	// samples of binary files are only referenced by the tree until now
+	if (m_binaryFile) { BinaryDataFile::inlineChunks(documentElement()); }
 
 	save(_strm, 2);
 }
@@ -406,6 +423,14 @@ bool DataFile::writeFile(const QString& filename, bool withResources)
 		write( ts );
 		outfile.write( qCompress( xml.toUtf8() ) );
 	}
+	else if (extension == "mmpb")
+	{
+		cleanMetaNodes();
+		if (!BinaryDataFile::write(*this, outfile))
+		{
+			outfile.cancelWriting();
+		}
+	}
 	else
 	{
 		QTextStream ts( &outfile );
@@ -624,6 +649,18 @@ QString DataFile::typeName( Type type )
 
 
 
+void DataFile::cleanMetaNodes()
+{
+	if( type() == Type::SongProject || type() == Type::SongProjectTemplate
+					|| type() == Type::InstrumentTrackSettings )
+	{
+		cleanMetaNodes( documentElement() );
+	}
+}
+
+
+
+
 void DataFile::cleanMetaNodes( QDomElement _de )
 {
 	QDomNode node = _de.firstChild();
@@ -2137,23 +2174,55 @@ void DataFile::loadData( const QByteArray & _data, const QString & _sourceFile )
 		}
 		if( line >= 0 && col >= 0 )
 		{
-			using gui::SongEditor;
-
 			qWarning() << "at line" << line << "column" << errorMsg;
-			if (gui::getGUI() != nullptr)
-			{
-				QMessageBox::critical( nullptr,
-					SongEditor::tr( "Error in file" ),
-					SongEditor::tr( "The file %1 seems to contain "
-							"errors and therefore can't be "
-							"loaded." ).
-								arg( _sourceFile ) );
-			}
-
+			showLoadError( _sourceFile );
 			return;
 		}
 	}
 
+	loadContent( _sourceFile );
+}
+
+
+
+
+void DataFile::loadBinary(std::shared_ptr<const BinaryDataFile> file, const QString& errorMsg,
+	const QString& sourceFile)
+{
+	if (!file)
+	{
+		qWarning() << "Could not load binary file:" << errorMsg;
+		showLoadError(sourceFile);
+		return;
+	}
+
+	m_binaryFile = std::move(file);
+	loadContent(sourceFile);
+}
+
+
+
+
+void DataFile::showLoadError(const QString& sourceFile)
+{
+	using gui::SongEditor;
+
+	if (gui::getGUI() != nullptr)
+	{
+		QMessageBox::critical( nullptr,
+			SongEditor::tr( "Error in file" ),
+			SongEditor::tr( "The file %1 seems to contain "
+					"errors and therefore can't be "
+					"loaded." ).
+						arg( sourceFile ) );
+	}
+}
+
+
+
+
+void DataFile::loadContent(const QString& _sourceFile)
+{
 	QDomElement root = documentElement();
 	m_type = type( root.attribute( "type" ) );
 	m_head = root.elementsByTagName( "head" ).item( 0 ).toElement();
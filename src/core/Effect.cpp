@@ -25,17 +25,50 @@
 
 #include <QDomElement>
 
+#include <array>
+#include <cassert>
+#include <cmath>
+
 #include "Effect.h"
 #include "EffectChain.h"
 #include "EffectControls.h"
 #include "EffectView.h"
 
+#include "BufferManager.h"
 #include "ConfigManager.h"
 #include "SampleFrame.h"
 
 namespace lmms
 {
 
+namespace
+{
+
+/*
+ * In the past, the RMS was calculated then compared with a threshold of 10^(-10).
+ * Now we use a different algorithm to determine whether a buffer is non-quiet, so
+ * a new threshold is needed for the best compatibility. The following is how it's derived.
+ *
+ * Old method:
+ * RMS = average (L^2 + R^2) across stereo buffer.
+ * RMS threshold = 10^(-10)
+ *
+ * So for a single channel, it would be:
+ * RMS/2 = average M^2 across single channel buffer.
+ * RMS/2 threshold = 5^(-11)
+ *
+ * The new algorithm for determining whether a buffer is non-silent compares M with the threshold,
+ * not M^2, so the square root of M^2's threshold should give us the most compatible threshold for
+ * the new algorithm:
+ *
+ * (RMS/2)^0.5 = (5^(-11))^0.5 = 0.0001431 (approx.)
+ *
+ * In practice though, the exact value shouldn't really matter so long as it's sufficiently small.
+ */
+constexpr auto QuietThreshold = 0.0001431f;
+
+} // namespace
+
 
 Effect::Effect( const Plugin::Descriptor * _desc,
 			Model * _parent,
@@ -113,19 +146,46 @@ void Effect::loadSettings( const QDomElement & _this )
 
 bool Effect::processAudioBuffer(SampleFrame* buf, const fpp_t frames)
 {
-	if (!isOkay() || dontRun() || !isEnabled() || !isRunning())
+	if (isSleeping())
+	{
+		processBypassedImpl();
+		return false;
+	}
+
+	const auto status = bufferLayout() == BufferLayout::Planar
+		? processAsPlanar(buf, frames)
+		: processImpl(buf, frames);
+	return finishProcessing(status, std::span<const SampleFrame>{buf, frames});
+}
+
+
+
+
+bool Effect::processAudioBuffer(PlanarBufferView<float, 2> buf)
+{
+	if (isSleeping())
 	{
 		processBypassedImpl();
 		return false;
 	}
 
-	const auto status = processImpl(buf, frames);
+	const auto status = bufferLayout() == BufferLayout::Interleaved
+		? processAsInterleaved(buf)
+		: processPlanarImpl(buf);
+	return finishProcessing(status, PlanarBufferView<const float, 2>{buf});
+}
+
+
+
+
+bool Effect::finishProcessing(ProcessStatus status, auto&& output)
+{
 	switch (status)
 	{
 		case ProcessStatus::Continue:
 			break;
 		case ProcessStatus::ContinueIfNotQuiet:
-			handleAutoQuit({buf, frames});
+			handleAutoQuit(output);
 			break;
 		case ProcessStatus::Sleep:
 			return false;
@@ -139,6 +199,60 @@ bool Effect::processAudioBuffer(SampleFrame* buf, const fpp_t frames)
 
 
 
+Effect::ProcessStatus Effect::processImpl(SampleFrame*, const fpp_t)
+{
+	// only called for effects with the interleaved layout, which must override it
+	assert(false && "Effect::processImpl() not overridden");
+	return ProcessStatus::Sleep;
+}
+
+
+
+
+Effect::ProcessStatus Effect::processPlanarImpl(PlanarBufferView<float, 2>)
+{
+	// only called for effects with the planar layout, which must override it
+	assert(false && "Effect::processPlanarImpl() not overridden");
+	return ProcessStatus::Sleep;
+}
+
+
+
+
+Effect::ProcessStatus Effect::processAsPlanar(SampleFrame* buf, const fpp_t frames)
+{
+	// a buffer of the buffer manager holds both channels of a period one after another
+	SampleFrame* storage = BufferManager::acquire();
+	const auto samples = reinterpret_cast<float*>(storage);
+	const auto channels = std::array{samples, samples + Engine::audioEngine()->framesPerPeriod()};
+	const auto planar = PlanarBufferView<float, 2>{channels.data(), frames};
+
+	deinterleave<float, 2>(std::span<const SampleFrame>{buf, frames}, planar);
+	const auto status = processPlanarImpl(planar);
+	interleave<float, 2>(planar, std::span<SampleFrame>{buf, frames});
+
+	BufferManager::release(storage);
+	return status;
+}
+
+
+
+
+Effect::ProcessStatus Effect::processAsInterleaved(PlanarBufferView<float, 2> buf)
+{
+	SampleFrame* interleaved = BufferManager::acquire();
+
+	interleave<float, 2>(buf, std::span<SampleFrame>{interleaved, buf.frames()});
+	const auto status = processImpl(interleaved, buf.frames());
+	deinterleave<float, 2>(std::span<const SampleFrame>{interleaved, buf.frames()}, buf);
+
+	BufferManager::release(interleaved);
+	return status;
+}
+
+
+
+
 Effect * Effect::instantiate( const QString& pluginName,
 				Model * _parent,
 				Descriptor::SubPluginFeatures::Key * _key )
@@ -169,43 +283,59 @@ void Effect::handleAutoQuit(std::span<const SampleFrame> output)
 		return;
 	}
 
-	/*
-	 * In the past, the RMS was calculated then compared with a threshold of 10^(-10).
-	 * Now we use a different algorithm to determine whether a buffer is non-quiet, so
-	 * a new threshold is needed for the best compatibility. The following is how it's derived.
-	 *
-	 * Old method:
-	 * RMS = average (L^2 + R^2) across stereo buffer.
-	 * RMS threshold = 10^(-10)
-	 *
-	 * So for a single channel, it would be:
-	 * RMS/2 = average M^2 across single channel buffer.
-	 * RMS/2 threshold = 5^(-11)
-	 *
-	 * The new algorithm for determining whether a buffer is non-silent compares M with the threshold,
-	 * not M^2, so the square root of M^2's threshold should give us the most compatible threshold for
-	 * the new algorithm:
-	 *
-	 * (RMS/2)^0.5 = (5^(-11))^0.5 = 0.0001431 (approx.)
-	 *
-	 * In practice though, the exact value shouldn't really matter so long as it's sufficiently small.
-	 */
-	static constexpr auto threshold = 0.0001431f;
-
 	// Check whether we need to continue processing input. Restart the
 	// counter if the threshold has been exceeded.
 
 	for (const SampleFrame& frame : output)
 	{
 		const auto abs = frame.abs();
-		if (abs.left() >= threshold || abs.right() >= threshold)
+		if (abs.left() >= QuietThreshold || abs.right() >= QuietThreshold)
 		{
 			// The output buffer is not quiet
-			m_quietBufferCount = 0;
+			updateQuietBufferCount(false);
 			return;
 		}
 	}
 
+	updateQuietBufferCount(true);
+}
+
+
+
+
+void Effect::handleAutoQuit(PlanarBufferView<const float, 2> output)
+{
+	if (!m_autoQuitEnabled)
+	{
+		return;
+	}
+
+	for (proc_ch_t channel = 0; channel < output.channels(); ++channel)
+	{
+		for (const float sample : output.buffer(channel))
+		{
+			if (std::abs(sample) >= QuietThreshold)
+			{
+				updateQuietBufferCount(false);
+				return;
+			}
+		}
+	}
+
+	updateQuietBufferCount(true);
+}
+
+
+
+
+void Effect::updateQuietBufferCount(bool quiet)
+{
+	if (!quiet)
+	{
+		m_quietBufferCount = 0;
+		return;
+	}
+
 	// The output buffer is quiet, so check if auto-quit should be activated yet
 	if (++m_quietBufferCount > timeout())
 	{
@@ -25,9 +25,11 @@
 
 
 #include <QDomElement>
+#include <array>
 #include <cassert>
 
 #include "EffectChain.h"
+#include "BufferManager.h"
 #include "Effect.h"
 #include "DummyEffect.h"
 #include "MixHelpers.h"
@@ -193,16 +195,64 @@ bool EffectChain::processAudioBuffer( SampleFrame* _buf, const fpp_t _frames, bo
 
 	MixHelpers::sanitize( _buf, _frames );
 
+	// The buffer is only converted where the layout changes from one effect to
+	// the next, consecutive planar effects all process the same planar buffer
+	auto layout = Effect::BufferLayout::Interleaved;
+	SampleFrame* planarStorage = nullptr;
+	std::array<float*, 2> planarChannels{};
+	const auto planar = PlanarBufferView<float, 2>{planarChannels.data(), _frames};
+
 	bool moreEffects = false;
 	for (const auto& effect : m_effects)
 	{
-		if (hasInputNoise || effect->isRunning())
+		if (!hasInputNoise && !effect->isRunning())
+		{
+			continue;
+		}
+
+		// sleeping effects don't touch the buffer, so don't convert it for them
+		if (!effect->isSleeping() && effect->bufferLayout() != layout)
+		{
+			layout = effect->bufferLayout();
+			if (layout == Effect::BufferLayout::Planar)
+			{
+				if (!planarStorage)
+				{
+					// a buffer of the buffer manager holds both channels of a period one after another
+					assert(_frames <= Engine::audioEngine()->framesPerPeriod());
+					planarStorage = BufferManager::acquire();
+					planarChannels[0] = reinterpret_cast<float*>(planarStorage);
+					planarChannels[1] = planarChannels[0] + Engine::audioEngine()->framesPerPeriod();
+				}
+				deinterleave<float, 2>(std::span<const SampleFrame>{_buf, _frames}, planar);
+			}
+			else
+			{
+				interleave<float, 2>(planar, std::span<SampleFrame>{_buf, _frames});
+			}
+		}
+
+		if (layout == Effect::BufferLayout::Planar)
+		{
+			moreEffects |= effect->processAudioBuffer(planar);
+			MixHelpers::sanitize(planar);
+		}
+		else
 		{
 			moreEffects |= effect->processAudioBuffer(_buf, _frames);
 			MixHelpers::sanitize(_buf, _frames);
 		}
 	}
 
+	if (planarStorage)
+	{
+		if (layout == Effect::BufferLayout::Planar)
+		{
+			interleave<float, 2>(planar, std::span<SampleFrame>{_buf, _frames});
+		}
+		BufferManager::release(planarStorage);
+	}
+
 	return moreEffects;
 }
 
@@ -55,7 +55,7 @@ void* Engine::s_dndPluginKey = nullptr;
 
 
 
-void Engine::init( bool renderOnly )
+void Engine::init( bool renderOnly, fpp_t framesPerPeriod )
 {
 	Engine *engine = inst();
 
@@ -67,7 +67,7 @@ void Engine::init( bool renderOnly )
 
 	emit engine->initProgress(tr("Initializing data structures"));
 	s_projectJournal = new ProjectJournal;
-	s_audioEngine = new AudioEngine( renderOnly );
+	s_audioEngine = new AudioEngine( renderOnly, framesPerPeriod );
 	s_song = new Song;
 	s_mixer = new Mixer;
 	s_patternStore = new PatternStore;
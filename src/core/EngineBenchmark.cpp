@@ -0,0 +1,250 @@
+/*
+ * EngineBenchmark.cpp - measures the rendering performance of a project
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "EngineBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "lmmsconfig.h"
+#include "lmmsversion.h"
+
+#ifdef LMMS_BUILD_WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "AudioDevice.h"
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "Ladspa2LMMS.h"
+#include "PluginFactory.h"
+#include "Song.h"
+#include "lmms_constants.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Only provides the sample rate, the periods are not consumed by anyone
+class BenchmarkDevice : public AudioDevice
+{
+public:
+	BenchmarkDevice(sample_rate_t sampleRate, AudioEngine* audioEngine) :
+		AudioDevice(DEFAULT_CHANNELS, audioEngine)
+	{
+		setSampleRate(sampleRate);
+	}
+};
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+	if (sorted.empty()) { return 0.; }
+	const auto index = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+} // namespace
+
+
+
+
+EngineBenchmark::EngineBenchmark(sample_rate_t sampleRate, int passes) :
+	m_sampleRate(sampleRate),
+	m_passes(passes)
+{
+}
+
+
+
+
+EngineBenchmark::Result EngineBenchmark::run()
+{
+	using Clock = std::chrono::steady_clock;
+
+	AudioEngine* engine = Engine::audioEngine();
+	Song* song = Engine::getSong();
+	AudioEngineProfiler& profiler = engine->profiler();
+
+	// like ProjectRenderer, without a FIFO, but the periods are rendered
+	// right here instead of being pulled by the device
+	engine->storeAudioDevice();
+	engine->setAudioDevice(new BenchmarkDevice(m_sampleRate, engine), engine->currentQualitySettings(), false, false);
+
+	Result result;
+	result.sampleRate = engine->outputSampleRate();
+	result.framesPerPeriod = engine->framesPerPeriod();
+	result.passes = m_passes;
+
+	const double periodLength = 1000. * result.framesPerPeriod / result.sampleRate;
+	std::vector<double> latencies;
+	std::array<double, AudioEngineProfiler::DetailCount> stageTime{};
+
+	const auto start = Clock::now();
+	for (int pass = 0; pass < m_passes; ++pass)
+	{
+		song->startExport();
+		while (!song->isExportDone())
+		{
+			const auto periodStart = Clock::now();
+			engine->renderNextBuffer();
+			const auto latency = std::chrono::duration<double, std::milli>(Clock::now() - periodStart).count();
+
+			latencies.push_back(latency);
+			if (latency > periodLength) { ++result.overruns; }
+			for (std::size_t i = 0; i < AudioEngineProfiler::DetailCount; ++i)
+			{
+				stageTime[i] += profiler.detailTime(static_cast<AudioEngineProfiler::DetailType>(i));
+			}
+		}
+		song->stopExport();
+	}
+	result.renderTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+	engine->restoreAudioDevice();
+
+	result.periods = latencies.size();
+	result.audioTime = static_cast<double>(result.periods) * result.framesPerPeriod / result.sampleRate;
+
+	std::sort(latencies.begin(), latencies.end());
+	result.latencyMedian = percentile(latencies, 0.5);
+	result.latency90 = percentile(latencies, 0.9);
+	result.latency99 = percentile(latencies, 0.99);
+	result.latencyMax = latencies.empty() ? 0. : latencies.back();
+
+	for (std::size_t i = 0; i < AudioEngineProfiler::DetailCount; ++i)
+	{
+		// the stage times are measured in microseconds
+		result.stageLoad[i] = result.audioTime > 0. ? stageTime[i] / (result.audioTime * 1e4) : 0.;
+	}
+
+	for (const auto& loadTime : song->trackLoadTimes())
+	{
+		result.trackLoads.push_back({loadTime.name, loadTime.prepareTime / 1000., loadTime.attachTime / 1000.});
+	}
+
+	result.pluginDiscovery = getPluginFactory()->discoveryStatistics();
+	result.ladspaDiscovery = Engine::getLADSPAManager()->discoveryStatistics();
+
+	result.peakResidentSetSize = peakResidentSetSize();
+	return result;
+}
+
+
+
+
+QByteArray EngineBenchmark::toJson(const Result& result, const QString& project)
+{
+	using DetailType = AudioEngineProfiler::DetailType;
+	const auto stageLoad = [&result](DetailType type) {
+		return result.stageLoad[static_cast<std::size_t>(type)];
+	};
+
+	auto trackLoads = QJsonArray{};
+	for (const auto& track : result.trackLoads)
+	{
+		trackLoads.append(QJsonObject{
+			{"name", track.name},
+			{"prepare", track.prepareTime},
+			{"attach", track.attachTime}
+		});
+	}
+
+	const auto discovery = [](const PluginCache::Statistics& statistics) {
+		return QJsonObject{
+			{"milliseconds", statistics.milliseconds},
+			{"cachedLibraries", statistics.cached},
+			{"probedLibraries", statistics.probed},
+			{"warm", statistics.warm()}
+		};
+	};
+
+	const auto json = QJsonObject{
+		{"project", project},
+		{"version", LMMS_VERSION},
+		{"sampleRate", static_cast<qint64>(result.sampleRate)},
+		{"framesPerPeriod", static_cast<qint64>(result.framesPerPeriod)},
+		{"passes", result.passes},
+		{"periods", static_cast<qint64>(result.periods)},
+		{"audioSeconds", result.audioTime},
+		{"renderSeconds", result.renderTime},
+		{"realtimeFactor", result.realtimeFactor()},
+		{"periodMilliseconds", QJsonObject{
+			{"median", result.latencyMedian},
+			{"p90", result.latency90},
+			{"p99", result.latency99},
+			{"max", result.latencyMax}
+		}},
+		{"overruns", static_cast<qint64>(result.overruns)},
+		{"stageLoadPercent", QJsonObject{
+			{"noteSetup", stageLoad(DetailType::NoteSetup)},
+			{"instruments", stageLoad(DetailType::Instruments)},
+			{"effects", stageLoad(DetailType::Effects)},
+			{"mixing", stageLoad(DetailType::Mixing)}
+		}},
+		{"peakRssBytes", static_cast<qint64>(result.peakResidentSetSize)},
+		{"trackLoadMilliseconds", trackLoads},
+		{"pluginDiscovery", QJsonObject{
+			{"lmms", discovery(result.pluginDiscovery)},
+			{"ladspa", discovery(result.ladspaDiscovery)}
+		}}
+	};
+	return QJsonDocument{json}.toJson();
+}
+
+
+
+
+std::uint64_t EngineBenchmark::peakResidentSetSize()
+{
+#ifdef LMMS_BUILD_WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+#ifdef LMMS_BUILD_APPLE
+	return usage.ru_maxrss;
+#else
+	// in kilobytes everywhere else
+	return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+
+} // namespace lmms
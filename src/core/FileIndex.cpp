@@ -0,0 +1,534 @@
+/*
+ * FileIndex.cpp - Persistent index of the files below a directory
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "FileIndex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace lmms {
+
+namespace {
+
+constexpr auto Magic = quint64{0x4c4d4d5346494458}; // "LMMSFIDX"
+constexpr auto FormatVersion = quint32{1};
+
+//! The same entries as the file browser shows
+constexpr auto DirFilters = QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden;
+
+auto trigrams(const QString& name) -> std::vector<quint64>
+{
+	const auto folded = name.toCaseFolded();
+	auto result = std::vector<quint64>{};
+	for (int i = 0; i + 3 <= folded.size(); ++i)
+	{
+		result.push_back(quint64{folded[i].unicode()} << 32 | quint64{folded[i + 1].unicode()} << 16
+			| folded[i + 2].unicode());
+	}
+
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+auto suffix(const QString& name) -> QString
+{
+	const auto dot = name.lastIndexOf('.');
+	return dot < 0 ? QString{} : name.mid(dot + 1);
+}
+
+//! Lower is better
+auto rank(const QString& name, const QString& filter, bool isDir) -> int
+{
+	const auto baseName = isDir || !name.contains('.') ? name : name.left(name.lastIndexOf('.'));
+	if (baseName.compare(filter, Qt::CaseInsensitive) == 0) { return 0; }
+
+	auto position = name.indexOf(filter, 0, Qt::CaseInsensitive);
+	if (position == 0) { return 1; }
+
+	while (position > 0)
+	{
+		if (!name[position - 1].isLetterOrNumber()) { return 2; }
+		position = name.indexOf(filter, position + 1, Qt::CaseInsensitive);
+	}
+	return 3;
+}
+
+auto isExcluded(const QString& path, const QStringList& excludedPaths) -> bool
+{
+	return std::any_of(excludedPaths.begin(), excludedPaths.end(), [&path](const QString& excluded) {
+		return path.startsWith(excluded) && (path.size() == excluded.size() || path[excluded.size()] == '/');
+	});
+}
+
+auto registryMutex() -> std::mutex&
+{
+	static auto s_mutex = std::mutex{};
+	return s_mutex;
+}
+
+auto registry() -> QHash<QString, std::weak_ptr<FileIndex>>&
+{
+	static auto s_registry = QHash<QString, std::weak_ptr<FileIndex>>{};
+	return s_registry;
+}
+
+} // namespace
+
+QString FileIndex::s_cacheDirectory;
+
+FileIndex::FileIndex(const QString& directory)
+	: m_directory(directory)
+	, m_prefix(directory.endsWith('/') ? directory : directory + '/')
+{
+	connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &FileIndex::directoryChanged);
+
+	m_running = true;
+	ThreadPool::instance().enqueue([this] {
+		// Until the index is complete, searches crawl the file system instead
+		auto scans = std::vector<Scan>{Scan{-1, true}};
+		if (load())
+		{
+			m_ready.store(true, std::memory_order_release);
+			scans = allDirectories();
+			scans.insert(scans.begin(), Scan{-1, false});
+		}
+
+		{
+			const auto lock = std::lock_guard{m_mutex};
+			m_pending.insert(m_pending.begin(), scans.begin(), scans.end());
+		}
+		run(true);
+	});
+}
+
+FileIndex::~FileIndex()
+{
+	m_cancel.store(true, std::memory_order_relaxed);
+	wait();
+	if (m_dirty && isReady()) { save(); }
+}
+
+auto FileIndex::forDirectory(const QString& directory) -> std::shared_ptr<FileIndex>
+{
+	const auto path = QDir{directory}.absolutePath();
+	const auto lock = std::lock_guard{registryMutex()};
+	if (auto index = registry().value(path).lock()) { return index; }
+
+	// Searches hold the index on other threads, but the watcher must be destroyed on this one, and waiting for the
+	// background task on a thread of the pool it is queued to could block forever
+	auto index = std::shared_ptr<FileIndex>{new FileIndex{path}, [](FileIndex* fileIndex) {
+		if (QThread::currentThread() == fileIndex->thread()) { delete fileIndex; }
+		else { fileIndex->deleteLater(); }
+	}};
+	registry().insert(path, index);
+	return index;
+}
+
+auto FileIndex::find(const QString& directory) -> std::shared_ptr<FileIndex>
+{
+	const auto lock = std::lock_guard{registryMutex()};
+	return registry().value(QDir{directory}.absolutePath()).lock();
+}
+
+auto FileIndex::search(const QString& filter, const QStringList& extensions, const QStringList& excludedPaths,
+	const std::atomic<bool>* cancel) const -> std::vector<Match>
+{
+	struct Candidate
+	{
+		qint32 entry;
+		int rank;
+	};
+
+	const auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+	const auto lock = std::lock_guard{m_mutex};
+
+	auto candidates = std::vector<Candidate>{};
+	const auto check = [&](qint32 index) {
+		const auto& entry = m_entries[index];
+		if (entry.removed || !entry.name.contains(filter, Qt::CaseInsensitive)) { return; }
+		if (!entry.isDir && !extensions.contains(suffix(entry.name), Qt::CaseInsensitive)) { return; }
+		candidates.push_back({index, rank(entry.name, filter, entry.isDir)});
+	};
+
+	const auto grams = trigrams(filter);
+	if (grams.empty())
+	{
+		// Too short for the trigrams, but still much faster than crawling
+		for (qint32 index = 0; index < static_cast<qint32>(m_entries.size()); ++index)
+		{
+			if (cancelled()) { return {}; }
+			check(index);
+		}
+	}
+	else
+	{
+		// Every match contains all trigrams of the filter, so the names containing the rarest one are enough
+		const std::vector<qint32>* rarest = nullptr;
+		for (const auto gram : grams)
+		{
+			const auto it = m_trigrams.constFind(gram);
+			if (it == m_trigrams.constEnd()) { return {}; }
+			if (!rarest || it->size() < rarest->size()) { rarest = &*it; }
+		}
+
+		for (const auto index : *rarest)
+		{
+			if (cancelled()) { return {}; }
+			check(index);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [this](const Candidate& a, const Candidate& b) {
+		if (a.rank != b.rank) { return a.rank < b.rank; }
+		const auto& nameA = m_entries[a.entry].name;
+		const auto& nameB = m_entries[b.entry].name;
+		if (nameA.size() != nameB.size()) { return nameA.size() < nameB.size(); }
+		return nameA.compare(nameB, Qt::CaseInsensitive) < 0;
+	});
+
+	auto matches = std::vector<Match>{};
+	matches.reserve(candidates.size());
+	for (const auto& candidate : candidates)
+	{
+		if (cancelled()) { return {}; }
+
+		auto path = entryPath(candidate.entry);
+		if (isExcluded(path, excludedPaths)) { continue; }
+		matches.push_back({std::move(path), m_entries[candidate.entry].isDir});
+	}
+	return matches;
+}
+
+void FileIndex::refresh()
+{
+	// The first run checks everything anyway
+	if (!isReady()) { return; }
+
+	auto scans = allDirectories();
+	scans.insert(scans.begin(), Scan{-1, false});
+	schedule(scans);
+}
+
+void FileIndex::wait()
+{
+	auto lock = std::unique_lock{m_mutex};
+	m_idle.wait(lock, [this] { return !m_running; });
+}
+
+auto FileIndex::cacheDirectory() -> QString
+{
+	if (!s_cacheDirectory.isEmpty()) { return s_cacheDirectory; }
+	return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/lmms";
+}
+
+void FileIndex::setCacheDirectory(const QString& directory)
+{
+	s_cacheDirectory = directory;
+}
+
+auto FileIndex::fileName() const -> QString
+{
+	const auto hash = QCryptographicHash::hash(m_directory.toUtf8(), QCryptographicHash::Sha1).toHex();
+	return QDir{cacheDirectory()}.filePath("fileindex/" + QString::fromLatin1(hash) + ".idx");
+}
+
+auto FileIndex::load() -> bool
+{
+	auto file = QFile{fileName()};
+	if (!file.open(QIODevice::ReadOnly)) { return false; }
+
+	auto stream = QDataStream{&file};
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	auto magic = quint64{};
+	auto version = quint32{};
+	auto directory = QString{};
+	auto count = quint32{};
+	stream >> magic >> version >> directory >> m_rootModified >> count;
+	if (stream.status() != QDataStream::Ok || magic != Magic || version != FormatVersion || directory != m_directory)
+	{
+		return false;
+	}
+
+	const auto lock = std::lock_guard{m_mutex};
+	m_entries.reserve(count);
+	for (quint32 i = 0; i < count; ++i)
+	{
+		auto parent = qint32{};
+		auto isDir = false;
+		auto modified = qint64{};
+		auto name = QString{};
+		stream >> parent >> isDir >> modified >> name;
+
+		// Parents are always stored before their children
+		if (stream.status() != QDataStream::Ok || parent < -1 || parent >= static_cast<qint32>(i)
+			|| (parent >= 0 && !m_entries[parent].isDir))
+		{
+			m_entries.clear();
+			m_rootChildren.clear();
+			m_dirs.clear();
+			m_trigrams.clear();
+			return false;
+		}
+
+		m_entries[addEntry(parent, name, isDir)].modified = modified;
+	}
+
+	m_dirty = false;
+	return true;
+}
+
+void FileIndex::save()
+{
+	QDir{}.mkpath(QFileInfo{fileName()}.absolutePath());
+	auto file = QSaveFile{fileName()};
+	if (!file.open(QIODevice::WriteOnly)) { return; }
+
+	auto stream = QDataStream{&file};
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	const auto lock = std::lock_guard{m_mutex};
+
+	// Removed entries are dropped, which moves the others
+	auto newIndex = std::vector<qint32>(m_entries.size(), -1);
+	auto count = quint32{0};
+	for (std::size_t i = 0; i < m_entries.size(); ++i)
+	{
+		if (!m_entries[i].removed) { newIndex[i] = static_cast<qint32>(count++); }
+	}
+
+	stream << Magic << FormatVersion << m_directory << m_rootModified << count;
+	for (const auto& entry : m_entries)
+	{
+		if (entry.removed) { continue; }
+		stream << (entry.parent < 0 ? -1 : newIndex[entry.parent]) << entry.isDir << entry.modified << entry.name;
+	}
+
+	if (stream.status() == QDataStream::Ok && file.commit()) { m_dirty = false; }
+}
+
+void FileIndex::schedule(const std::vector<Scan>& scans)
+{
+	const auto lock = std::lock_guard{m_mutex};
+	m_pending.insert(m_pending.end(), scans.begin(), scans.end());
+	if (m_running) { return; }
+
+	m_running = true;
+	ThreadPool::instance().enqueue([this] { run(false); });
+}
+
+void FileIndex::run(bool saveWhenDone)
+{
+	while (true)
+	{
+		while (!m_cancel.load(std::memory_order_relaxed))
+		{
+			auto next = Scan{};
+			{
+				const auto lock = std::lock_guard{m_mutex};
+				if (m_pending.empty()) { break; }
+				next = m_pending.front();
+				m_pending.pop_front();
+			}
+			scan(next);
+		}
+
+		if (!m_cancel.load(std::memory_order_relaxed))
+		{
+			m_ready.store(true, std::memory_order_release);
+
+			// Changes reported by the watcher are saved on destruction
+			if (saveWhenDone && m_dirty) { save(); }
+
+			if (!m_unwatched.isEmpty())
+			{
+				QMetaObject::invokeMethod(this, [this, paths = m_unwatched] { watch(paths); }, Qt::QueuedConnection);
+				m_unwatched.clear();
+			}
+		}
+
+		// schedule() doesn't start another task while this one runs, so scans queued in the meantime must be picked up
+		// here, and m_running must be cleared in the same critical section that finds the queue empty
+		const auto lock = std::lock_guard{m_mutex};
+		if (m_pending.empty() || m_cancel.load(std::memory_order_relaxed))
+		{
+			m_running = false;
+			m_idle.notify_all();
+			return;
+		}
+	}
+}
+
+void FileIndex::scan(Scan scan)
+{
+	auto path = QString{};
+	auto modified = qint64{};
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		if (scan.dir >= 0 && m_entries[scan.dir].removed) { return; }
+		path = scan.dir < 0 ? m_directory : entryPath(scan.dir);
+		modified = scan.dir < 0 ? m_rootModified : m_entries[scan.dir].modified;
+	}
+
+	const auto info = QFileInfo{path};
+	if (!info.isDir())
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		if (scan.dir >= 0) { removeEntry(scan.dir); }
+		return;
+	}
+
+	m_unwatched << path;
+
+	// Adding or removing an entry changes the modification time of its directory
+	const auto lastModified = info.lastModified().toMSecsSinceEpoch();
+	if (!scan.force && lastModified == modified) { return; }
+
+	const auto listing = QDir{path}.entryInfoList(DirFilters, QDir::NoSort);
+
+	const auto lock = std::lock_guard{m_mutex};
+	if (scan.dir >= 0 && m_entries[scan.dir].removed) { return; }
+
+	auto stale = QHash<QString, qint32>{};
+	for (const auto child : children(scan.dir)) { stale.insert(m_entries[child].name, child); }
+
+	for (const auto& entry : listing)
+	{
+		const auto name = entry.fileName();
+		const auto isDir = entry.isDir();
+		if (const auto it = stale.constFind(name); it != stale.constEnd())
+		{
+			const auto existing = *it;
+			stale.erase(it);
+			if (m_entries[existing].isDir == isDir) { continue; }
+			removeEntry(existing);
+		}
+
+		const auto added = addEntry(scan.dir, name, isDir);
+		if (isDir) { m_pending.push_back({added, true}); }
+	}
+
+	for (const auto removed : stale) { removeEntry(removed); }
+
+	if (scan.dir < 0) { m_rootModified = lastModified; }
+	else { m_entries[scan.dir].modified = lastModified; }
+	m_dirty = true;
+}
+
+auto FileIndex::allDirectories() const -> std::vector<Scan>
+{
+	const auto lock = std::lock_guard{m_mutex};
+	auto scans = std::vector<Scan>{};
+	for (qint32 index = 0; index < static_cast<qint32>(m_entries.size()); ++index)
+	{
+		if (m_entries[index].isDir && !m_entries[index].removed) { scans.push_back({index, false}); }
+	}
+	return scans;
+}
+
+auto FileIndex::entryPath(qint32 entry) const -> QString
+{
+	auto path = m_entries[entry].name;
+	for (auto parent = m_entries[entry].parent; parent >= 0; parent = m_entries[parent].parent)
+	{
+		path.prepend(m_entries[parent].name + '/');
+	}
+	return m_prefix + path;
+}
+
+auto FileIndex::addEntry(qint32 parent, const QString& name, bool isDir) -> qint32
+{
+	const auto index = static_cast<qint32>(m_entries.size());
+	m_entries.push_back(Entry{name, parent, isDir});
+	children(parent).push_back(index);
+
+	// Entries are only ever appended, which keeps the lists sorted
+	for (const auto gram : trigrams(name)) { m_trigrams[gram].push_back(index); }
+
+	if (isDir) { m_dirs.insert(entryPath(index), index); }
+	m_dirty = true;
+	return index;
+}
+
+void FileIndex::removeEntry(qint32 entry)
+{
+	auto& siblings = children(m_entries[entry].parent);
+	siblings.erase(std::remove(siblings.begin(), siblings.end(), entry), siblings.end());
+
+	// The trigram lists are cleaned up when the index is saved and loaded again
+	auto stack = std::vector<qint32>{entry};
+	while (!stack.empty())
+	{
+		const auto index = stack.back();
+		stack.pop_back();
+
+		auto& removed = m_entries[index];
+		if (removed.isDir) { m_dirs.remove(entryPath(index)); }
+		removed.removed = true;
+		stack.insert(stack.end(), removed.children.begin(), removed.children.end());
+		removed.children.clear();
+	}
+	m_dirty = true;
+}
+
+auto FileIndex::children(qint32 dir) -> std::vector<qint32>&
+{
+	return dir < 0 ? m_rootChildren : m_entries[dir].children;
+}
+
+void FileIndex::watch(const QStringList& paths)
+{
+	const auto room = MaxWatchedDirectories - static_cast<int>(m_watcher.directories().size());
+	if (room > 0) { m_watcher.addPaths(paths.mid(0, room)); }
+}
+
+void FileIndex::directoryChanged(const QString& path)
+{
+	auto dir = qint32{-1};
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		const auto absolutePath = QDir{path}.absolutePath();
+		if (absolutePath != m_directory)
+		{
+			const auto it = m_dirs.constFind(absolutePath);
+			if (it == m_dirs.constEnd()) { return; }
+			dir = *it;
+		}
+	}
+
+	schedule({Scan{dir, true}});
+}
+
+} // namespace lmms
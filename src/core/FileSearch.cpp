@@ -28,6 +28,8 @@
 #include <chrono>
 #include <thread>
 
+#include "FileIndex.h"
+
 namespace lmms {
 FileSearch::FileSearch(const QString& filter, const QStringList& paths, const QStringList& extensions,
 	const QStringList& excludedPaths, QDir::Filters dirFilters, QDir::SortFlags sortFlags)
@@ -47,6 +49,19 @@ void FileSearch::operator()()
 	{
 		if (m_excludedPaths.contains(path)) { continue; }
 
+		// Indexed directories are searched without touching the file system, best matches first
+		if (const auto index = FileIndex::find(path); index && index->isReady())
+		{
+			for (const auto& match : index->search(m_filter, m_extensions, m_excludedPaths, &m_cancel))
+			{
+				if (m_cancel.load(std::memory_order_relaxed)) { return; }
+
+				std::this_thread::sleep_for(std::chrono::milliseconds{MillisecondsBetweenResults});
+				emit foundMatch(this, match.path);
+			}
+			continue;
+		}
+
 		auto dir = QDir{path};
 		stack.append(dir.entryInfoList(m_dirFilters, m_sortFlags));
 
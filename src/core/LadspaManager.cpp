@@ -27,6 +27,9 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
 #include <QLibrary>
 #include <QList>
 #include <QRegularExpression>
@@ -64,6 +67,12 @@ LadspaManager::LadspaManager()
 	ladspaDirectories.push_back( "/Library/Audio/Plug-Ins/LADSPA" );
 #endif
 
+	// Libraries are only loaded if they changed since the last run, or
+	// when one of their plug-ins is used
+	QElapsedTimer timer;
+	timer.start();
+	PluginCache cache( "ladspa" );
+
 	for (const auto& ladspaDirectory : ladspaDirectories)
 	{
 		// Skip empty entries as QDir will interpret it as the working directory
@@ -91,21 +100,7 @@ LadspaManager::LadspaManager()
 				continue;
 			}
 
-			QLibrary plugin_lib( f.absoluteFilePath() );
-
-			if( plugin_lib.load() == true )
-			{
-				auto descriptorFunction = (LADSPA_Descriptor_Function)plugin_lib.resolve("ladspa_descriptor");
-				if( descriptorFunction != nullptr )
-				{
-					addPlugins( descriptorFunction,
-							f.fileName() );
-				}
-			}
-			else
-			{
-				qWarning() << plugin_lib.errorString();
-			}
+			addPlugins( f, cache );
 		}
 	}
 	
@@ -115,6 +110,12 @@ LadspaManager::LadspaManager()
 		m_sortedPlugins.append(qMakePair(getName(key), key));
 	}
 	std::sort( m_sortedPlugins.begin(), m_sortedPlugins.end() );
+
+	m_statistics = cache.statistics();
+	m_statistics.milliseconds = timer.elapsed();
+	qDebug() << "LADSPA discovery:" << m_ladspaManagerMap.size() << "plugins in"
+		<< m_statistics.milliseconds << "msecs," << m_statistics.probed << "libraries probed,"
+		<< m_statistics.cached << "taken from" << cache.fileName();
 }
 
 
@@ -142,23 +143,62 @@ LadspaManagerDescription * LadspaManager::getDescription(
 
 
 
-void LadspaManager::addPlugins(
-		LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file )
+void LadspaManager::addPlugins( const QFileInfo & _file,
+						PluginCache & _cache )
 {
-	for (long pluginIndex = 0; const auto descriptor = _descriptor_func(pluginIndex); ++pluginIndex)
+	LADSPA_Descriptor_Function descriptorFunction = nullptr;
+	auto entry = _cache.find( _file );
+	if( !entry )
+	{
+		QLibrary plugin_lib( _file.absoluteFilePath() );
+		if( plugin_lib.load() == false )
+		{
+			// not cached, so it is tried again next time
+			qWarning() << plugin_lib.errorString();
+			return;
+		}
+
+		descriptorFunction = (LADSPA_Descriptor_Function)plugin_lib.resolve("ladspa_descriptor");
+
+		QJsonArray plugins;
+		for (long pluginIndex = 0; descriptorFunction != nullptr; ++pluginIndex)
+		{
+			const auto descriptor = descriptorFunction( pluginIndex );
+			if( descriptor == nullptr )
+			{
+				break;
+			}
+
+			plugins.append( QJsonObject{
+				{ "label", QString( descriptor->Label ) },
+				{ "index", static_cast<int>( pluginIndex ) },
+				{ "name", QString( descriptor->Name ) },
+				{ "inputs", getPluginInputs( descriptor ) },
+				{ "outputs", getPluginOutputs( descriptor ) },
+				{ "realTimeCapable", LADSPA_IS_HARD_RT_CAPABLE( descriptor->Properties ) != 0 }
+			} );
+		}
+		entry = QJsonObject{ { "plugins", plugins } };
+		_cache.insert( _file, *entry );
+	}
+
+	for( const auto& value : (*entry)["plugins"].toArray() )
 	{
-		ladspa_key_t key( _file, QString( descriptor->Label ) );
+		const auto plugin = value.toObject();
+		ladspa_key_t key( _file.fileName(), plugin["label"].toString() );
 		if( m_ladspaManagerMap.contains( key ) )
 		{
 			continue;
 		}
 
 		auto plugIn = new LadspaManagerDescription;
-		plugIn->descriptorFunction = _descriptor_func;
-		plugIn->index = pluginIndex;
-		plugIn->inputChannels = getPluginInputs( descriptor );
-		plugIn->outputChannels = getPluginOutputs( descriptor );
+		plugIn->descriptorFunction = descriptorFunction;
+		plugIn->index = plugin["index"].toInt();
+		plugIn->inputChannels = plugin["inputs"].toInt();
+		plugIn->outputChannels = plugin["outputs"].toInt();
+		plugIn->file = _file.absoluteFilePath();
+		plugIn->name = plugin["name"].toString();
+		plugIn->realTimeCapable = plugin["realTimeCapable"].toBool();
 
 		if( plugIn->inputChannels == 0 && plugIn->outputChannels > 0 )
 		{
@@ -186,6 +226,32 @@ void LadspaManager::addPlugins(
 
 
 
+LADSPA_Descriptor_Function LadspaManager::loadLibrary(
+					LadspaManagerDescription * _plugin )
+{
+	QLibrary plugin_lib( _plugin->file );
+	if( plugin_lib.load() == false )
+	{
+		qWarning() << plugin_lib.errorString();
+		return nullptr;
+	}
+
+	auto descriptorFunction = (LADSPA_Descriptor_Function)plugin_lib.resolve("ladspa_descriptor");
+
+	// the other plug-ins of the library don't need to resolve it again
+	for( auto plugIn : m_ladspaManagerMap )
+	{
+		if( plugIn->file == _plugin->file )
+		{
+			plugIn->descriptorFunction = descriptorFunction;
+		}
+	}
+	return descriptorFunction;
+}
+
+
+
+
 uint16_t LadspaManager::getPluginInputs(
 		const LADSPA_Descriptor * _descriptor )
 {
@@ -299,9 +365,9 @@ bool LadspaManager::isInplaceBroken( const ladspa_key_t &  _plugin )
 bool LadspaManager::isRealTimeCapable(
 					const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_HARD_RT_CAPABLE( descriptor->Properties )
-					   : false );
+	// cached, so the library doesn't need to be loaded for it
+	const LadspaManagerDescription * plugin = getDescription( _plugin );
+	return( plugin ? plugin->realTimeCapable : false );
 }
 
 
@@ -309,8 +375,9 @@ bool LadspaManager::isRealTimeCapable(
 
 QString LadspaManager::getName( const ladspa_key_t & _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? descriptor->Name : "" );
+	// cached, so the library doesn't need to be loaded for it
+	const LadspaManagerDescription * plugin = getDescription( _plugin );
+	return( plugin ? plugin->name : "" );
 }
 
 
@@ -567,10 +634,15 @@ const LADSPA_Descriptor * LadspaManager::getDescriptor(const ladspa_key_t & _plu
 	{
 		auto const plugin = *it;
 
-		LADSPA_Descriptor_Function descriptorFunction = plugin->descriptorFunction;
-		const LADSPA_Descriptor* descriptor = descriptorFunction(plugin->index);
+		LADSPA_Descriptor_Function descriptorFunction = plugin->descriptorFunction
+			? plugin->descriptorFunction
+			: loadLibrary( plugin );
+		if( descriptorFunction == nullptr )
+		{
+			return nullptr;
+		}
 
-		return descriptor;
+		return descriptorFunction(plugin->index);
 	}
 
 	return nullptr;
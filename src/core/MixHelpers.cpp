@@ -28,11 +28,18 @@
 #include <cstdio>
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 
+#include "MixHelpersKernels.h"
 #include "ValueBuffer.h"
 #include "SampleFrame.h"
 
+#if defined(LMMS_MIX_HELPERS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 
 
 static bool s_NaNHandler;
@@ -64,7 +71,7 @@ static inline void run( SampleFrame* dst, const sample_t* srcLeft, const sample_
 
 
 
-bool isSilent( const SampleFrame* src, int frames )
+static bool isSilentScalar( const SampleFrame* src, int frames )
 {
 	const float silenceThreshold = 0.0000001f;
 
@@ -89,36 +96,17 @@ void setNaNHandler( bool use )
 	s_NaNHandler = use;
 }
 
-/*! \brief Function for sanitizing a buffer of infs/nans - returns true if those are found */
-bool sanitize( SampleFrame* src, int frames )
+static bool sanitizeScalar( float* src, int samples )
 {
-	if( !useNaNHandler() )
-	{
-		return false;
-	}
-
-	for (int f = 0; f < frames; ++f)
+	for (int i = 0; i < samples; ++i)
 	{
-		auto& currentFrame = src[f];
-
-		if (currentFrame.containsInf() || currentFrame.containsNaN())
+		if (std::isinf(src[i]) || std::isnan(src[i]))
 		{
-			#ifdef LMMS_DEBUG
-					// TODO don't use printf here
-					printf("Bad data, clearing buffer. frame: ");
-					printf("%d: value %f, %f\n", f, currentFrame.left(), currentFrame.right());
-			#endif
-
-			// Clear the whole buffer if a problem is found
-			zeroSampleFrames(src, frames);
-
 			return true;
 		}
-		else
-		{
-			currentFrame.clamp(sample_t(-1000.0), sample_t(1000.0));
-		}
-	};
+
+		src[i] = std::clamp(src[i], sample_t(-1000.0), sample_t(1000.0));
+	}
 
 	return false;
 }
@@ -132,7 +120,7 @@ struct AddOp
 	}
 } ;
 
-void add( SampleFrame* dst, const SampleFrame* src, int frames )
+static void addScalar( SampleFrame* dst, const SampleFrame* src, int frames )
 {
 	run<>( dst, src, frames, AddOp() );
 }
@@ -152,7 +140,7 @@ struct AddMultipliedOp
 } ;
 
 
-void addMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
+static void addMultipliedScalar( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
 {
 	run<>( dst, src, frames, AddMultipliedOp(coeffSrc) );
 }
@@ -185,58 +173,44 @@ void addSwappedMultiplied( SampleFrame* dst, const SampleFrame* src, float coeff
 }
 
 
-void addMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
+static void addMultipliedByBufferScalar( SampleFrame* dst, const SampleFrame* src, float coeffSrc, const float* coeffSrcBuf, int frames )
 {
 	for( int f = 0; f < frames; ++f )
 	{
-		dst[f][0] += src[f][0] * coeffSrc * coeffSrcBuf->values()[f];
-		dst[f][1] += src[f][1] * coeffSrc * coeffSrcBuf->values()[f];
+		dst[f][0] += src[f][0] * coeffSrc * coeffSrcBuf[f];
+		dst[f][1] += src[f][1] * coeffSrc * coeffSrcBuf[f];
 	}
 }
 
-void addMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
+static void addMultipliedByBuffersScalar( SampleFrame* dst, const SampleFrame* src, const float* coeffSrcBuf1, const float* coeffSrcBuf2, int frames )
 {
 	for( int f = 0; f < frames; ++f )
 	{
-		dst[f][0] += src[f][0] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-		dst[f][1] += src[f][1] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
+		dst[f][0] += src[f][0] * coeffSrcBuf1[f] * coeffSrcBuf2[f];
+		dst[f][1] += src[f][1] * coeffSrcBuf1[f] * coeffSrcBuf2[f];
 	}
 
 }
 
-void addSanitizedMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
+static void addSanitizedMultipliedByBufferScalar( SampleFrame* dst, const SampleFrame* src, float coeffSrc, const float* coeffSrcBuf, int frames )
 {
-	if ( !useNaNHandler() )
-	{
-		addMultipliedByBuffer( dst, src, coeffSrc, coeffSrcBuf,
-								frames );
-		return;
-	}
-
 	for( int f = 0; f < frames; ++f )
 	{
-		dst[f][0] += ( std::isinf( src[f][0] ) || std::isnan( src[f][0] ) ) ? 0.0f : src[f][0] * coeffSrc * coeffSrcBuf->values()[f];
-		dst[f][1] += ( std::isinf( src[f][1] ) || std::isnan( src[f][1] ) ) ? 0.0f : src[f][1] * coeffSrc * coeffSrcBuf->values()[f];
+		dst[f][0] += ( std::isinf( src[f][0] ) || std::isnan( src[f][0] ) ) ? 0.0f : src[f][0] * coeffSrc * coeffSrcBuf[f];
+		dst[f][1] += ( std::isinf( src[f][1] ) || std::isnan( src[f][1] ) ) ? 0.0f : src[f][1] * coeffSrc * coeffSrcBuf[f];
 	}
 }
 
-void addSanitizedMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
+static void addSanitizedMultipliedByBuffersScalar( SampleFrame* dst, const SampleFrame* src, const float* coeffSrcBuf1, const float* coeffSrcBuf2, int frames )
 {
-	if ( !useNaNHandler() )
-	{
-		addMultipliedByBuffers( dst, src, coeffSrcBuf1, coeffSrcBuf2,
-								frames );
-		return;
-	}
-
 	for( int f = 0; f < frames; ++f )
 	{
 		dst[f][0] += ( std::isinf( src[f][0] ) || std::isnan( src[f][0] ) )
 			? 0.0f
-			: src[f][0] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
+			: src[f][0] * coeffSrcBuf1[f] * coeffSrcBuf2[f];
 		dst[f][1] += ( std::isinf( src[f][1] ) || std::isnan( src[f][1] ) )
 			? 0.0f
-			: src[f][1] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
+			: src[f][1] * coeffSrcBuf1[f] * coeffSrcBuf2[f];
 	}
 
 }
@@ -255,6 +229,163 @@ struct AddSanitizedMultipliedOp
 	const float m_coeff;
 };
 
+static void addSanitizedMultipliedScalar( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
+{
+	run<>( dst, src, frames, AddSanitizedMultipliedOp(coeffSrc) );
+}
+
+
+
+static constexpr Kernels ScalarKernels = {
+	&addScalar,
+	&addMultipliedScalar,
+	&addSanitizedMultipliedScalar,
+	&addMultipliedByBufferScalar,
+	&addSanitizedMultipliedByBufferScalar,
+	&addMultipliedByBuffersScalar,
+	&addSanitizedMultipliedByBuffersScalar,
+	&isSilentScalar,
+	&sanitizeScalar
+};
+
+
+static const Kernels& kernelsFor( SimdLevel level )
+{
+	switch( level )
+	{
+#ifdef LMMS_MIX_HELPERS_X86
+	case SimdLevel::Sse2: return Sse2Kernels;
+	case SimdLevel::Avx2: return Avx2Kernels;
+	case SimdLevel::Avx512: return Avx512Kernels;
+#endif
+	default: return ScalarKernels;
+	}
+}
+
+
+SimdLevel supportedSimdLevel()
+{
+#if defined(LMMS_MIX_HELPERS_X86) && (defined(__GNUC__) || defined(__clang__))
+	// also checks whether the OS saves the registers of the instruction set
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx512f" ) ) { return SimdLevel::Avx512; }
+	if( __builtin_cpu_supports( "avx2" ) ) { return SimdLevel::Avx2; }
+	if( __builtin_cpu_supports( "sse2" ) ) { return SimdLevel::Sse2; }
+#elif defined(LMMS_MIX_HELPERS_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid( info, 0 );
+	const int maxLeaf = info[0];
+	__cpuid( info, 1 );
+	const bool sse2 = info[3] & (1 << 26);
+	const bool osxsave = info[2] & (1 << 27);
+	if( osxsave && maxLeaf >= 7 )
+	{
+		const auto xcr0 = _xgetbv( 0 );
+		__cpuidex( info, 7, 0 );
+		// AVX-512 needs the opmask and upper ZMM registers saved as well as YMM
+		if( ( info[1] & (1 << 16) ) && ( xcr0 & 0xe6 ) == 0xe6 ) { return SimdLevel::Avx512; }
+		if( ( info[1] & (1 << 5) ) && ( xcr0 & 0x6 ) == 0x6 ) { return SimdLevel::Avx2; }
+	}
+	if( sse2 ) { return SimdLevel::Sse2; }
+#endif
+	return SimdLevel::Scalar;
+}
+
+
+static std::atomic<SimdLevel> s_simdLevel = supportedSimdLevel();
+static std::atomic<const Kernels*> s_kernels = &kernelsFor( s_simdLevel );
+
+
+SimdLevel simdLevel()
+{
+	return s_simdLevel.load( std::memory_order_relaxed );
+}
+
+void setSimdLevel( SimdLevel level )
+{
+	level = std::min( level, supportedSimdLevel() );
+	s_simdLevel.store( level, std::memory_order_relaxed );
+	s_kernels.store( &kernelsFor( level ), std::memory_order_relaxed );
+}
+
+static const Kernels& kernels()
+{
+	return *s_kernels.load( std::memory_order_relaxed );
+}
+
+
+
+bool isSilent( const SampleFrame* src, int frames )
+{
+	return kernels().isSilent( src, frames );
+}
+
+/*! \brief Function for sanitizing a buffer of infs/nans - returns true if those are found */
+bool sanitize( SampleFrame* src, int frames )
+{
+	if( !useNaNHandler() )
+	{
+		return false;
+	}
+
+	if( kernels().sanitize( src->data(), frames * 2 ) )
+	{
+		#ifdef LMMS_DEBUG
+				// TODO don't use printf here
+				printf("Bad data, clearing buffer.\n");
+		#endif
+
+		// Clear the whole buffer if a problem is found
+		zeroSampleFrames(src, frames);
+
+		return true;
+	}
+
+	return false;
+}
+
+bool sanitize( PlanarBufferView<float, 2> buf )
+{
+	if( !useNaNHandler() )
+	{
+		return false;
+	}
+
+	for( proc_ch_t channel = 0; channel < buf.channels(); ++channel )
+	{
+		if( kernels().sanitize( buf.bufferPtr( channel ), static_cast<int>( buf.frames() ) ) )
+		{
+			for( proc_ch_t ch = 0; ch < buf.channels(); ++ch )
+			{
+				std::fill_n( buf.bufferPtr( ch ), buf.frames(), 0.0f );
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void add( SampleFrame* dst, const SampleFrame* src, int frames )
+{
+	kernels().add( dst, src, frames );
+}
+
+void addMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
+{
+	kernels().addMultiplied( dst, src, coeffSrc, frames );
+}
+
+void addMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
+{
+	kernels().addMultipliedByBuffer( dst, src, coeffSrc, coeffSrcBuf->values(), frames );
+}
+
+void addMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
+{
+	kernels().addMultipliedByBuffers( dst, src, coeffSrcBuf1->values(), coeffSrcBuf2->values(), frames );
+}
+
 void addSanitizedMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
 {
 	if ( !useNaNHandler() )
@@ -263,7 +394,29 @@ void addSanitizedMultiplied( SampleFrame* dst, const SampleFrame* src, float coe
 		return;
 	}
 
-	run<>( dst, src, frames, AddSanitizedMultipliedOp(coeffSrc) );
+	kernels().addSanitizedMultiplied( dst, src, coeffSrc, frames );
+}
+
+void addSanitizedMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
+{
+	if ( !useNaNHandler() )
+	{
+		addMultipliedByBuffer( dst, src, coeffSrc, coeffSrcBuf, frames );
+		return;
+	}
+
+	kernels().addSanitizedMultipliedByBuffer( dst, src, coeffSrc, coeffSrcBuf->values(), frames );
+}
+
+void addSanitizedMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
+{
+	if ( !useNaNHandler() )
+	{
+		addMultipliedByBuffers( dst, src, coeffSrcBuf1, coeffSrcBuf2, frames );
+		return;
+	}
+
+	kernels().addSanitizedMultipliedByBuffers( dst, src, coeffSrcBuf1->values(), coeffSrcBuf2->values(), frames );
 }
 
 
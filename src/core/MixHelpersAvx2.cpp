@@ -0,0 +1,76 @@
+/*
+ * MixHelpersAvx2.cpp - AVX2 implementation of the mixing kernels
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersSimd.h"
+
+#ifdef LMMS_MIX_HELPERS_X86
+
+#include <immintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace
+{
+
+struct Avx2
+{
+	static constexpr int Width = 8;
+
+	static __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+	static __m256 set1(float x) { return _mm256_set1_ps(x); }
+	static __m256 add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+	static __m256 mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+	static __m256 min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+	static __m256 max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+
+	static __m256 abs(__m256 v) { return _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff))); }
+	static __m256 finiteMask(__m256 v)
+	{
+		return _mm256_cmp_ps(abs(v), _mm256_castsi256_ps(_mm256_set1_epi32(0x7f800000)), _CMP_LT_OQ);
+	}
+
+	static __m256 keepFinite(__m256 v, __m256 value) { return _mm256_and_ps(finiteMask(v), value); }
+	static bool allFinite(__m256 v) { return _mm256_movemask_ps(finiteMask(v)) == 0xff; }
+	static bool anyAbsAtLeast(__m256 v, __m256 threshold)
+	{
+		return _mm256_movemask_ps(_mm256_cmp_ps(abs(v), threshold, _CMP_GE_OQ)) != 0;
+	}
+
+	//! Loads 4 values of a per-frame buffer, each one duplicated for both channels
+	static __m256 expand(const float* p)
+	{
+		const __m256 v = _mm256_castps128_ps256(_mm_loadu_ps(p));
+		return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3));
+	}
+};
+
+} // namespace
+
+const Kernels Avx2Kernels = SimdKernels<Avx2>::table();
+
+} // namespace lmms::MixHelpers
+
+#endif // LMMS_MIX_HELPERS_X86
@@ -0,0 +1,75 @@
+/*
+ * MixHelpersAvx512.cpp - AVX-512 implementation of the mixing kernels
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersSimd.h"
+
+#ifdef LMMS_MIX_HELPERS_X86
+
+#include <immintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace
+{
+
+struct Avx512
+{
+	static constexpr int Width = 16;
+
+	static __m512 load(const float* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+	static __m512 set1(float x) { return _mm512_set1_ps(x); }
+	static __m512 add(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+	static __m512 mul(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+	static __m512 min(__m512 a, __m512 b) { return _mm512_min_ps(a, b); }
+	static __m512 max(__m512 a, __m512 b) { return _mm512_max_ps(a, b); }
+
+	static __mmask16 finiteMask(__m512 v)
+	{
+		return _mm512_cmp_ps_mask(_mm512_abs_ps(v), _mm512_castsi512_ps(_mm512_set1_epi32(0x7f800000)), _CMP_LT_OQ);
+	}
+
+	static __m512 keepFinite(__m512 v, __m512 value) { return _mm512_maskz_mov_ps(finiteMask(v), value); }
+	static bool allFinite(__m512 v) { return finiteMask(v) == 0xffff; }
+	static bool anyAbsAtLeast(__m512 v, __m512 threshold)
+	{
+		return _mm512_cmp_ps_mask(_mm512_abs_ps(v), threshold, _CMP_GE_OQ) != 0;
+	}
+
+	//! Loads 8 values of a per-frame buffer, each one duplicated for both channels
+	static __m512 expand(const float* p)
+	{
+		const __m512 v = _mm512_castps256_ps512(_mm256_loadu_ps(p));
+		return _mm512_permutexvar_ps(_mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7), v);
+	}
+};
+
+} // namespace
+
+const Kernels Avx512Kernels = SimdKernels<Avx512>::table();
+
+} // namespace lmms::MixHelpers
+
+#endif // LMMS_MIX_HELPERS_X86
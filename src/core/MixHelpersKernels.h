@@ -0,0 +1,79 @@
+/*
+ * MixHelpersKernels.h - table of the mixing kernels for one instruction set
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIX_HELPERS_KERNELS_H
+#define LMMS_MIX_HELPERS_KERNELS_H
+
+#include "lmmsconfig.h"
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+#define LMMS_MIX_HELPERS_X86
+#endif
+
+namespace lmms
+{
+
+class SampleFrame;
+
+namespace MixHelpers
+{
+
+/**
+	@brief The hot mixing functions implemented for one instruction set
+
+	MixHelpers.cpp holds the scalar reference implementation and picks the
+	best table the CPU supports at startup. The SIMD tables are defined in
+	their own translation units, which are the only ones compiled for their
+	instruction set.
+*/
+struct Kernels
+{
+	void (*add)(SampleFrame* dst, const SampleFrame* src, int frames);
+	void (*addMultiplied)(SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames);
+	void (*addSanitizedMultiplied)(SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames);
+	void (*addMultipliedByBuffer)(SampleFrame* dst, const SampleFrame* src, float coeffSrc,
+		const float* coeffSrcBuf, int frames);
+	void (*addSanitizedMultipliedByBuffer)(SampleFrame* dst, const SampleFrame* src, float coeffSrc,
+		const float* coeffSrcBuf, int frames);
+	void (*addMultipliedByBuffers)(SampleFrame* dst, const SampleFrame* src, const float* coeffSrcBuf1,
+		const float* coeffSrcBuf2, int frames);
+	void (*addSanitizedMultipliedByBuffers)(SampleFrame* dst, const SampleFrame* src, const float* coeffSrcBuf1,
+		const float* coeffSrcBuf2, int frames);
+	bool (*isSilent)(const SampleFrame* src, int frames);
+	//! Clamps all samples to +-1000, returns true as soon as an inf or NaN is found.
+	//! Works on plain samples, so it serves interleaved and planar buffers alike.
+	bool (*sanitize)(float* src, int samples);
+};
+
+#ifdef LMMS_MIX_HELPERS_X86
+extern const Kernels Sse2Kernels;
+extern const Kernels Avx2Kernels;
+extern const Kernels Avx512Kernels;
+#endif
+
+} // namespace MixHelpers
+
+} // namespace lmms
+
+#endif // LMMS_MIX_HELPERS_KERNELS_H
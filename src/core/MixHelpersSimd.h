@@ -0,0 +1,205 @@
+/*
+ * MixHelpersSimd.h - mixing kernels written against a vector of floats
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIX_HELPERS_SIMD_H
+#define LMMS_MIX_HELPERS_SIMD_H
+
+#include "MixHelpersKernels.h"
+
+namespace lmms::MixHelpers
+{
+
+// Everything in here is compiled for a newer instruction set than the rest
+// of LMMS and must not end up in a symbol the linker could pick for code
+// running on older CPUs. So everything has internal linkage and nothing from
+// the standard library is used.
+namespace
+{
+
+inline float* samples(SampleFrame* frames) { return reinterpret_cast<float*>(frames); }
+inline const float* samples(const SampleFrame* frames) { return reinterpret_cast<const float*>(frames); }
+
+//! x - x is NaN for infs and NaNs
+inline bool isFinite(float x) { return x - x == 0.f; }
+
+constexpr float SilenceThreshold = 0.0000001f;
+constexpr float SanitizeLimit = 1000.f;
+
+
+/**
+	@brief The kernels of @ref Kernels for the vector type @p V
+
+	@p V wraps the intrinsics of one instruction set and provides
+	`Width` floats per vector. The frames left over at the end of a buffer
+	are processed with scalar code in the same order of operations, so all
+	implementations give the same results as the scalar reference.
+*/
+template<typename V>
+struct SimdKernels
+{
+	static constexpr int Width = V::Width;
+
+	static void add(SampleFrame* dstFrames, const SampleFrame* srcFrames, int frames)
+	{
+		const auto dst = samples(dstFrames);
+		const auto src = samples(srcFrames);
+		const int count = frames * 2;
+
+		int i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			V::store(dst + i, V::add(V::load(dst + i), V::load(src + i)));
+		}
+		for (; i < count; ++i) { dst[i] += src[i]; }
+	}
+
+	template<bool Sanitized>
+	static void addMultiplied(SampleFrame* dstFrames, const SampleFrame* srcFrames, float coeffSrc, int frames)
+	{
+		const auto dst = samples(dstFrames);
+		const auto src = samples(srcFrames);
+		const int count = frames * 2;
+		const auto coeff = V::set1(coeffSrc);
+
+		int i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			const auto s = V::load(src + i);
+			auto product = V::mul(s, coeff);
+			if constexpr (Sanitized) { product = V::keepFinite(s, product); }
+			V::store(dst + i, V::add(V::load(dst + i), product));
+		}
+		for (; i < count; ++i)
+		{
+			if (Sanitized && !isFinite(src[i])) { dst[i] += 0.f; }
+			else { dst[i] += src[i] * coeffSrc; }
+		}
+	}
+
+	template<bool Sanitized>
+	static void addMultipliedByBuffer(SampleFrame* dstFrames, const SampleFrame* srcFrames, float coeffSrc,
+		const float* coeffSrcBuf, int frames)
+	{
+		const auto dst = samples(dstFrames);
+		const auto src = samples(srcFrames);
+		const int count = frames * 2;
+		const auto coeff = V::set1(coeffSrc);
+
+		int i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			const auto s = V::load(src + i);
+			auto product = V::mul(V::mul(s, coeff), V::expand(coeffSrcBuf + i / 2));
+			if constexpr (Sanitized) { product = V::keepFinite(s, product); }
+			V::store(dst + i, V::add(V::load(dst + i), product));
+		}
+		for (; i < count; ++i)
+		{
+			if (Sanitized && !isFinite(src[i])) { dst[i] += 0.f; }
+			else { dst[i] += src[i] * coeffSrc * coeffSrcBuf[i / 2]; }
+		}
+	}
+
+	template<bool Sanitized>
+	static void addMultipliedByBuffers(SampleFrame* dstFrames, const SampleFrame* srcFrames,
+		const float* coeffSrcBuf1, const float* coeffSrcBuf2, int frames)
+	{
+		const auto dst = samples(dstFrames);
+		const auto src = samples(srcFrames);
+		const int count = frames * 2;
+
+		int i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			const auto s = V::load(src + i);
+			auto product = V::mul(V::mul(s, V::expand(coeffSrcBuf1 + i / 2)), V::expand(coeffSrcBuf2 + i / 2));
+			if constexpr (Sanitized) { product = V::keepFinite(s, product); }
+			V::store(dst + i, V::add(V::load(dst + i), product));
+		}
+		for (; i < count; ++i)
+		{
+			if (Sanitized && !isFinite(src[i])) { dst[i] += 0.f; }
+			else { dst[i] += src[i] * coeffSrcBuf1[i / 2] * coeffSrcBuf2[i / 2]; }
+		}
+	}
+
+	static bool isSilent(const SampleFrame* srcFrames, int frames)
+	{
+		const auto src = samples(srcFrames);
+		const int count = frames * 2;
+		const auto threshold = V::set1(SilenceThreshold);
+
+		int i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			if (V::anyAbsAtLeast(V::load(src + i), threshold)) { return false; }
+		}
+		for (; i < count; ++i)
+		{
+			if ((src[i] < 0 ? -src[i] : src[i]) >= SilenceThreshold) { return false; }
+		}
+		return true;
+	}
+
+	static bool sanitize(float* src, int count)
+	{
+		const auto low = V::set1(-SanitizeLimit);
+		const auto high = V::set1(SanitizeLimit);
+
+		int i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			const auto s = V::load(src + i);
+			if (!V::allFinite(s)) { return true; }
+			V::store(src + i, V::min(V::max(s, low), high));
+		}
+		for (; i < count; ++i)
+		{
+			if (!isFinite(src[i])) { return true; }
+			src[i] = src[i] < -SanitizeLimit ? -SanitizeLimit : (SanitizeLimit < src[i] ? SanitizeLimit : src[i]);
+		}
+		return false;
+	}
+
+	static constexpr Kernels table()
+	{
+		return {
+			&add,
+			&addMultiplied<false>,
+			&addMultiplied<true>,
+			&addMultipliedByBuffer<false>,
+			&addMultipliedByBuffer<true>,
+			&addMultipliedByBuffers<false>,
+			&addMultipliedByBuffers<true>,
+			&isSilent,
+			&sanitize
+		};
+	}
+};
+
+} // namespace
+
+} // namespace lmms::MixHelpers
+
+#endif // LMMS_MIX_HELPERS_SIMD_H
@@ -0,0 +1,76 @@
+/*
+ * MixHelpersSse2.cpp - SSE2 implementation of the mixing kernels
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersSimd.h"
+
+#ifdef LMMS_MIX_HELPERS_X86
+
+#include <emmintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace
+{
+
+struct Sse2
+{
+	static constexpr int Width = 4;
+
+	static __m128 load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+	static __m128 set1(float x) { return _mm_set1_ps(x); }
+	static __m128 add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+	static __m128 mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+	static __m128 min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+	static __m128 max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+
+	static __m128 abs(__m128 v) { return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))); }
+	static __m128 finiteMask(__m128 v)
+	{
+		return _mm_cmplt_ps(abs(v), _mm_castsi128_ps(_mm_set1_epi32(0x7f800000)));
+	}
+
+	static __m128 keepFinite(__m128 v, __m128 value) { return _mm_and_ps(finiteMask(v), value); }
+	static bool allFinite(__m128 v) { return _mm_movemask_ps(finiteMask(v)) == 0xf; }
+	static bool anyAbsAtLeast(__m128 v, __m128 threshold)
+	{
+		return _mm_movemask_ps(_mm_cmpge_ps(abs(v), threshold)) != 0;
+	}
+
+	//! Loads 2 values of a per-frame buffer, each one duplicated for both channels
+	static __m128 expand(const float* p)
+	{
+		const __m128 v = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+		return _mm_unpacklo_ps(v, v);
+	}
+};
+
+} // namespace
+
+const Kernels Sse2Kernels = SimdKernels<Sse2>::table();
+
+} // namespace lmms::MixHelpers
+
+#endif // LMMS_MIX_HELPERS_X86
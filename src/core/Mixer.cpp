@@ -71,6 +71,7 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_lock(),
 	m_queued( false ),
 	m_dependenciesMet(0),
+	m_dependencies(0),
 	m_channelIndex(idx)
 {
 	zeroSampleFrames(m_buffer, Engine::audioEngine()->framesPerPeriod());
@@ -81,10 +82,20 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 
 MixerChannel::~MixerChannel()
 {
+	Engine::audioEngine()->profiler().removeNode(this);
 	delete[] m_buffer;
 }
 
 
+
+
+void MixerChannel::setName(const QString& name)
+{
+	m_name = name;
+	Engine::audioEngine()->profiler().setNodeName(this, m_name);
+}
+
+
 inline void MixerChannel::processed()
 {
 	for( const MixerRoute * receiverRoute : m_sends )
@@ -99,7 +110,7 @@ inline void MixerChannel::processed()
 void MixerChannel::incrementDeps()
 {
 	const auto i = m_dependenciesMet++ + 1;
-	if( i >= m_receives.size() && ! m_queued )
+	if( i == m_dependencies && ! m_queued )
 	{
 		m_queued = true;
 		AudioEngineWorkerThread::addJob( this );
@@ -163,6 +174,9 @@ void MixerChannel::unmuteReceiverForSolo()
 
 void MixerChannel::doProcessing()
 {
+	AudioEngineProfiler::JobProbe probe(Engine::audioEngine()->profiler(),
+		AudioEngineProfiler::DetailType::Mixing, this);
+
 	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
 
 	if( m_muted == false )
@@ -663,51 +677,66 @@ void Mixer::prepareMasterMix()
 
 
 
-void Mixer::masterMix( SampleFrame* _buf )
+void Mixer::prepareChannelJobs()
 {
-	const int fpp = Engine::audioEngine()->framesPerPeriod();
-
-	// add the channels that have no dependencies (no incoming senders, ie.
-	// no receives) to the jobqueue. The channels that have receives get
-	// added when their senders get processed, which is detected by
-	// dependency counting.
-	// also instantly add all muted channels as they don't need to care
-	// about their senders, and can just increment the deps of their
-	// recipients right away.
-	AudioEngineWorkerThread::resetJobQueue( AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic );
+	// update mute state of all channels first, as muted channels must not
+	// wait for anything
 	for( MixerChannel * ch : m_mixerChannels )
 	{
 		ch->m_muted = ch->m_muteModel.value();
-		if( ch->m_muted ) // instantly "process" muted channels
+		// hold one input until the whole graph is set up
+		ch->m_dependencies = ch->m_receives.size() + 1;
+		ch->m_dependenciesMet = 0;
+	}
+
+	// instantly "process" muted channels as they don't need to care about
+	// their inputs, and can just increment the deps of their recipients
+	for( MixerChannel * ch : m_mixerChannels )
+	{
+		if( ch->m_muted )
 		{
 			ch->processed();
 			ch->done();
 		}
-		else if( ch->m_receives.size() == 0 )
-		{
-			ch->m_queued = true;
-			AudioEngineWorkerThread::addJob( ch );
-		}
 	}
-	while (m_mixerChannels[0]->state() != ThreadableJob::ProcessingState::Done)
+}
+
+
+
+
+MixerChannel * Mixer::addChannelInput( mix_ch_t _ch )
+{
+	if( _ch >= numChannels() || m_mixerChannels[_ch]->m_muted )
 	{
-		bool found = false;
-		for( MixerChannel * ch : m_mixerChannels )
-		{
-			const auto s = ch->state();
-			if (s == ThreadableJob::ProcessingState::Queued
-				|| s == ThreadableJob::ProcessingState::InProgress)
-			{
-				found = true;
-				break;
-			}
-		}
-		if( !found )
+		return nullptr;
+	}
+	++m_mixerChannels[_ch]->m_dependencies;
+	return m_mixerChannels[_ch];
+}
+
+
+
+
+void Mixer::startChannelJobs()
+{
+	// release the inputs held during setup - channels whose other inputs
+	// are done already get queued right away, the others get queued when
+	// their last sender or audio bus handle is processed
+	for( MixerChannel * ch : m_mixerChannels )
+	{
+		if( ! ch->m_muted )
 		{
-			break;
+			ch->incrementDeps();
 		}
-		AudioEngineWorkerThread::startAndWaitForJobs();
 	}
+}
+
+
+
+
+void Mixer::masterMix( SampleFrame* _buf )
+{
+	const int fpp = Engine::audioEngine()->framesPerPeriod();
 
 	// handle sample-exact data in master volume fader
 	ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
@@ -761,7 +790,7 @@ void Mixer::clearChannel(mix_ch_t index)
 	ch->m_volumeModel.setValue( 1.0f );
 	ch->m_muteModel.setValue( false );
 	ch->m_soloModel.setValue( false );
-	ch->m_name = ( index == 0 ) ? tr( "Master" ) : tr( "Channel %1" ).arg( index );
+	ch->setName(index == 0 ? tr("Master") : tr("Channel %1").arg(index));
 	ch->m_volumeModel.setDisplayName( ch->m_name + ">" + tr( "Volume" ) );
 	ch->m_muteModel.setDisplayName( ch->m_name + ">" + tr( "Mute" ) );
 	ch->m_soloModel.setDisplayName( ch->m_name + ">" + tr( "Solo" ) );
@@ -849,7 +878,7 @@ void Mixer::loadSettings( const QDomElement & _this )
 		m_mixerChannels[num]->m_volumeModel.loadSettings( mixch, "volume" );
 		m_mixerChannels[num]->m_muteModel.loadSettings( mixch, "muted" );
 		m_mixerChannels[num]->m_soloModel.loadSettings( mixch, "soloed" );
-		m_mixerChannels[num]->m_name = mixch.attribute( "name" );
+		m_mixerChannels[num]->setName(mixch.attribute("name"));
 		if (mixch.hasAttribute("color"))
 		{
 			m_mixerChannels[num]->setColor(QColor{mixch.attribute("color")});
@@ -885,7 +914,7 @@ void Mixer::validateChannelName( int index, int oldIndex )
 {
 	if( m_mixerChannels[index]->m_name == tr( "Channel %1" ).arg( oldIndex ) )
 	{
-		m_mixerChannels[index]->m_name = tr( "Channel %1" ).arg( index );
+		m_mixerChannels[index]->setName(tr("Channel %1").arg(index));
 	}
 }
 
@@ -25,6 +25,9 @@
 
 #include "NotePlayHandle.h"
 
+#include <array>
+#include <cstdlib>
+
 #include "AudioEngine.h"
 #include "DetuningHelper.h"
 #include "InstrumentSoundShaping.h"
@@ -139,6 +142,7 @@ NotePlayHandle::~NotePlayHandle()
 	{
 		m_instrumentTrack->deleteNotePluginData( this );
 	}
+	m_pluginDataArena.clear();
 
 	if( m_instrumentTrack->m_notes[key()] == this )
 	{
@@ -602,25 +606,74 @@ void NotePlayHandle::resize( const bpm_t _new_tempo )
 }
 
 
-NotePlayHandle ** NotePlayHandleManager::s_available;
-QReadWriteLock NotePlayHandleManager::s_mutex;
-std::atomic_int NotePlayHandleManager::s_availableIndex;
-int NotePlayHandleManager::s_size;
+unsigned char* NotePlayHandleManager::s_storage = nullptr;
+std::atomic<std::uint32_t>* NotePlayHandleManager::s_next = nullptr;
+std::atomic<std::uint64_t> NotePlayHandleManager::s_freeHead = 0;
+std::atomic_int NotePlayHandleManager::s_used = 0;
+std::atomic_int NotePlayHandleManager::s_highWaterMark = 0;
+std::atomic_int NotePlayHandleManager::s_dropped = 0;
 
 
-void NotePlayHandleManager::init()
+//! Free handles kept by a single thread. Handles are moved between the cache
+//! and the shared stack in batches, so a thread which both acquires and
+//! releases handles (like the audio engine thread) rarely needs to touch
+//! the shared stack.
+class NotePlayHandleManager::ThreadCache
 {
-	s_available = new NotePlayHandle*[INITIAL_NPH_CACHE];
+public:
+	static constexpr int Size = 64;
+
+	~ThreadCache()
+	{
+		// give our handles back when the thread finishes
+		if (s_storage) { flush(m_count); }
+	}
+
+	int acquire()
+	{
+		if (m_count == 0)
+		{
+			while (m_count < Size / 2)
+			{
+				const int index = pop();
+				if (index < 0) { break; }
+				m_indices[m_count++] = index;
+			}
+			if (m_count == 0) { return -1; }
+		}
+		return m_indices[--m_count];
+	}
 
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * INITIAL_NPH_CACHE));
+	void release(int index)
+	{
+		if (m_count == Size) { flush(Size / 2); }
+		m_indices[m_count++] = index;
+	}
 
-	for( int i=0; i < INITIAL_NPH_CACHE; ++i )
+private:
+	void flush(int count)
 	{
-		s_available[ i ] = n;
-		++n;
+		while (count-- > 0) { push(m_indices[--m_count]); }
 	}
-	s_availableIndex = INITIAL_NPH_CACHE - 1;
-	s_size = INITIAL_NPH_CACHE;
+
+	std::array<int, Size> m_indices;
+	int m_count = 0;
+};
+
+
+
+
+void NotePlayHandleManager::init()
+{
+	s_storage = static_cast<unsigned char*>(std::malloc(sizeof(NotePlayHandle) * NPH_POOL_SIZE));
+	s_next = new std::atomic<std::uint32_t>[NPH_POOL_SIZE];
+
+	// chain all handles into the free stack
+	for (int i = 0; i < NPH_POOL_SIZE; ++i)
+	{
+		s_next[i].store(i + 1 < NPH_POOL_SIZE ? i + 2 : 0, std::memory_order_relaxed);
+	}
+	s_freeHead.store(1, std::memory_order_release);
 }
 
 
@@ -632,12 +685,19 @@ NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrac
 				int midiEventChannel,
 				NotePlayHandle::Origin origin )
 {
-	// TODO: use some lockless data structures
-	s_mutex.lockForWrite();
-	if (s_availableIndex < 0) { extend(NPH_CACHE_INCREMENT); }
-	NotePlayHandle * nph = s_available[s_availableIndex--];
-	s_mutex.unlock();
+	const int index = threadCache().acquire();
+	if (index < 0)
+	{
+		s_dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	const int used = s_used.fetch_add(1, std::memory_order_relaxed) + 1;
+	int highWaterMark = s_highWaterMark.load(std::memory_order_relaxed);
+	while (used > highWaterMark
+		&& !s_highWaterMark.compare_exchange_weak(highWaterMark, used, std::memory_order_relaxed)) {}
 
+	NotePlayHandle* nph = handle(index);
 	new( (void*)nph ) NotePlayHandle( instrumentTrack, offset, frames, noteToPlay, parent, midiEventChannel, origin );
 	return nph;
 }
@@ -646,31 +706,61 @@ NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrac
 void NotePlayHandleManager::release( NotePlayHandle * nph )
 {
 	nph->NotePlayHandle::~NotePlayHandle();
-	s_mutex.lockForRead();
-	s_available[++s_availableIndex] = nph;
-	s_mutex.unlock();
+	s_used.fetch_sub(1, std::memory_order_relaxed);
+
+	const auto index = static_cast<int>((reinterpret_cast<unsigned char*>(nph) - s_storage) / sizeof(NotePlayHandle));
+	threadCache().release(index);
 }
 
 
-void NotePlayHandleManager::extend( int c )
+auto NotePlayHandleManager::threadCache() -> ThreadCache&
 {
-	s_size += c;
-	auto tmp = new NotePlayHandle*[s_size];
-	delete[] s_available;
-	s_available = tmp;
+	thread_local ThreadCache cache;
+	return cache;
+}
 
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * c));
 
-	for( int i=0; i < c; ++i )
+int NotePlayHandleManager::pop()
+{
+	auto head = s_freeHead.load(std::memory_order_acquire);
+	while (true)
 	{
-		s_available[++s_availableIndex] = n;
-		++n;
+		const auto first = static_cast<std::uint32_t>(head);
+		if (first == 0) { return -1; }
+
+		// if another thread pops this handle in the meantime, the counter
+		// in the high bits changes and the exchange below fails
+		const std::uint64_t next = s_next[first - 1].load(std::memory_order_relaxed);
+		const std::uint64_t newHead = ((head >> 32) + 1) << 32 | next;
+		if (s_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+		{
+			return static_cast<int>(first - 1);
+		}
 	}
 }
 
+
+void NotePlayHandleManager::push(int index)
+{
+	auto head = s_freeHead.load(std::memory_order_relaxed);
+	while (true)
+	{
+		s_next[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+		const std::uint64_t newHead = ((head >> 32) + 1) << 32 | static_cast<std::uint32_t>(index + 1);
+		if (s_freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed))
+		{
+			return;
+		}
+	}
+}
+
+
 void NotePlayHandleManager::free()
 {
-	delete[] s_available;
+	std::free(s_storage);
+	s_storage = nullptr;
+	delete[] s_next;
+	s_next = nullptr;
 }
 
 
@@ -0,0 +1,106 @@
+/*
+ * NoteStartIndex.cpp - start-time index of the notes of a MIDI clip
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NoteStartIndex.h"
+
+#include <algorithm>
+
+namespace lmms
+{
+
+auto NoteStartIndex::startingAt(const NoteVector& notes, tick_t time) -> Range
+{
+	update(notes);
+	seek(time);
+
+	auto last = m_cursor;
+	while (last < m_starts.size() && m_starts[last] == time)
+	{
+		++last;
+	}
+
+	return {m_sorted.begin() + m_cursor, m_sorted.begin() + last};
+}
+
+
+
+
+auto NoteStartIndex::startingBefore(const NoteVector& notes, tick_t time) -> Range
+{
+	update(notes);
+	seek(time);
+
+	return {m_sorted.begin(), m_sorted.begin() + m_cursor};
+}
+
+
+
+
+void NoteStartIndex::update(const NoteVector& notes)
+{
+	// clear the flag before rebuilding, so changes made while we are
+	// rebuilding trigger another rebuild on the next lookup
+	if (!m_dirty.exchange(false, std::memory_order_acq_rel) && m_sorted.size() == notes.size())
+	{
+		return;
+	}
+
+	m_sorted.assign(notes.begin(), notes.end());
+	std::stable_sort(m_sorted.begin(), m_sorted.end(), Note::lessThan);
+
+	m_starts.resize(m_sorted.size());
+	std::transform(m_sorted.begin(), m_sorted.end(), m_starts.begin(),
+		[](const Note* note) { return static_cast<tick_t>(note->pos()); });
+
+	m_cursor = 0;
+}
+
+
+
+
+void NoteStartIndex::seek(tick_t time)
+{
+	const auto size = m_starts.size();
+
+	if (m_cursor > 0 && m_starts[m_cursor - 1] >= time)
+	{
+		// we jumped backwards, e.g. because of a loop
+		m_cursor = std::lower_bound(m_starts.begin(), m_starts.begin() + m_cursor, time) - m_starts.begin();
+	}
+	else if (m_cursor < size && m_starts[m_cursor] < time)
+	{
+		// usually only a few notes are passed per tick, so try them first
+		// before searching the rest of the clip
+		for (int i = 0; i < 4 && m_cursor < size && m_starts[m_cursor] < time; ++i)
+		{
+			++m_cursor;
+		}
+		if (m_cursor < size && m_starts[m_cursor] < time)
+		{
+			m_cursor = std::lower_bound(m_starts.begin() + m_cursor, m_starts.end(), time) - m_starts.begin();
+		}
+	}
+}
+
+} // namespace lmms
@@ -26,6 +26,7 @@
 #include "Oscillator.h"
 
 #include <algorithm>
+#include <mutex>
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
 	#include <thread>
 #endif
@@ -36,6 +37,8 @@
 #include "AutomatableModel.h"
 #include "fftw3.h"
 #include "fft_helpers.h"
+#include "OscillatorKernels.h"
+#include "SamplePreloader.h"
 
 
 namespace lmms
@@ -116,6 +119,56 @@ void Oscillator::update(SampleFrame* ab, const fpp_t frames, const ch_cnt_t chnl
 }
 
 
+
+
+void Oscillator::update(Oscillator& left, Oscillator& right, PlanarBufferView<sample_t, 2> buffer)
+{
+	left.updatePlanar(buffer.bufferPtr(0), buffer.frames(), false);
+	right.updatePlanar(buffer.bufferPtr(1), buffer.frames(), false);
+}
+
+
+
+
+void Oscillator::updatePlanar(sample_t* buffer, const fpp_t frames, bool modulator)
+{
+	if (m_freq >= Engine::audioEngine()->outputSampleRate() / 2)
+	{
+		std::fill_n(buffer, frames, 0.f);
+		return;
+	}
+	m_isModulator = modulator;
+	switch (static_cast<WaveShape>(m_waveShapeModel->value()))
+	{
+		case WaveShape::Sine:
+		default:
+			updatePlanar<WaveShape::Sine>(buffer, frames);
+			break;
+		case WaveShape::Triangle:
+			updatePlanar<WaveShape::Triangle>(buffer, frames);
+			break;
+		case WaveShape::Saw:
+			updatePlanar<WaveShape::Saw>(buffer, frames);
+			break;
+		case WaveShape::Square:
+			updatePlanar<WaveShape::Square>(buffer, frames);
+			break;
+		case WaveShape::MoogSaw:
+			updatePlanar<WaveShape::MoogSaw>(buffer, frames);
+			break;
+		case WaveShape::Exponential:
+			updatePlanar<WaveShape::Exponential>(buffer, frames);
+			break;
+		case WaveShape::WhiteNoise:
+			updatePlanar<WaveShape::WhiteNoise>(buffer, frames);
+			break;
+		case WaveShape::UserDefined:
+			updatePlanar<WaveShape::UserDefined>(buffer, frames);
+			break;
+	}
+}
+
+
 void Oscillator::generateSawWaveTable(int bands, sample_t* table, int firstBand)
 {
 	using namespace std::numbers;
@@ -190,6 +243,12 @@ void Oscillator::generateFromFFT(int bands, sample_t* table)
 
 std::unique_ptr<OscillatorConstants::waveform_t> Oscillator::generateAntiAliasUserWaveTable(const SampleBuffer* sampleBuffer)
 {
+	if (auto prepared = SamplePreloader::takeUserWaveTable(sampleBuffer)) { return prepared; }
+
+	// the FFT buffers are shared, and projects are prepared on the thread pool
+	static auto s_fftMutex = std::mutex{};
+	const auto lock = std::lock_guard{s_fftMutex};
+
 	auto userAntiAliasWaveTable = std::make_unique<OscillatorConstants::waveform_t>();
 	for (int i = 0; i < OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT; ++i)
 	{
@@ -828,4 +887,121 @@ inline sample_t Oscillator::getSample<Oscillator::WaveShape::UserDefined>(
 }
 
 
+
+
+// The planar counterpart of all update*() templates: the phases of a block of
+// frames are computed first, with the ramp kernel unless they depend on the
+// sub oscillator's samples, then the samples of the whole block at once
+template<Oscillator::WaveShape W>
+void Oscillator::updatePlanar(sample_t* buffer, const fpp_t frames)
+{
+	using Mode = OscillatorKernels::Mode;
+
+	// no sub oscillator renders like a mix with silence, without the mixing
+	auto algo = ModulationAlgo::Count;
+	if (m_subOsc != nullptr)
+	{
+		algo = static_cast<ModulationAlgo>(m_modulationAlgoModel->value());
+		switch (algo)
+		{
+			case ModulationAlgo::PhaseModulation:
+			case ModulationAlgo::FrequencyModulation:
+				m_subOsc->updatePlanar(buffer, frames, true);
+				break;
+			case ModulationAlgo::AmplitudeModulation:
+				m_subOsc->updatePlanar(buffer, frames, false);
+				break;
+			case ModulationAlgo::SynchronizedBySubOsc:
+				// see syncInit(), the sub oscillator only provides the phase to sync to
+				if (m_subOsc->m_subOsc != nullptr)
+				{
+					m_subOsc->m_subOsc->updatePlanar(buffer, frames, false);
+				}
+				m_subOsc->recalcPhase();
+				break;
+			case ModulationAlgo::SignalMix:
+			default:
+				algo = ModulationAlgo::SignalMix;
+				m_subOsc->updatePlanar(buffer, frames, false);
+				break;
+		}
+	}
+	recalcPhase();
+	const float osc_coeff = m_freq * m_detuning_div_samplerate;
+	const float sampleRateCorrection = 44100.0f / Engine::audioEngine()->outputSampleRate();
+	const float sub_osc_coeff = m_subOsc != nullptr ? m_subOsc->m_freq * m_subOsc->m_detuning_div_samplerate : 0.f;
+	const auto mode = algo == ModulationAlgo::AmplitudeModulation ? Mode::Multiply
+		: algo == ModulationAlgo::SignalMix ? Mode::Add
+		: Mode::Set;
+
+	// m_freq doesn't change during a period, so neither does the band of the wavetable
+	const sample_t* table = nullptr;
+	if (m_useWaveTable && !m_isModulator)
+	{
+		const int band = waveTableBandFromFreq(osc_coeff * Engine::audioEngine()->outputSampleRate());
+		if constexpr (W == WaveShape::UserDefined)
+		{
+			if (m_userAntiAliasWaveTable) { table = (*m_userAntiAliasWaveTable)[band].data(); }
+		}
+		else if constexpr (W != WaveShape::Sine && W != WaveShape::WhiteNoise)
+		{
+			table = s_waveTables[static_cast<std::size_t>(W) - FirstWaveShapeTable][band];
+		}
+	}
+
+	const auto& kernels = oscillatorKernels();
+	std::array<float, PlanarBlockSize> phases;
+
+	for (fpp_t start = 0; start < frames; start += PlanarBlockSize)
+	{
+		const fpp_t count = std::min<fpp_t>(PlanarBlockSize, frames - start);
+		sample_t* out = buffer + start;
+
+		switch (algo)
+		{
+			case ModulationAlgo::SynchronizedBySubOsc:
+				for (fpp_t frame = 0; frame < count; ++frame)
+				{
+					if (m_subOsc->syncOk(sub_osc_coeff))
+					{
+						m_phase = m_phaseOffset;
+					}
+					phases[frame] = m_phase;
+					m_phase += osc_coeff;
+				}
+				break;
+			case ModulationAlgo::FrequencyModulation:
+				for (fpp_t frame = 0; frame < count; ++frame)
+				{
+					m_phase += out[frame] * sampleRateCorrection;
+					phases[frame] = m_phase;
+					m_phase += osc_coeff;
+				}
+				break;
+			default:
+				kernels.phaseRamp(phases.data(), algo == ModulationAlgo::PhaseModulation ? out : nullptr,
+					m_phase, osc_coeff, count);
+				m_phase += count * osc_coeff;
+				break;
+		}
+
+		if (table != nullptr)
+		{
+			kernels.wavetable(out, phases.data(), table, m_volume, count, mode);
+			continue;
+		}
+		for (fpp_t frame = 0; frame < count; ++frame)
+		{
+			const sample_t sample = getSample<W>(phases[frame]) * m_volume;
+			switch (mode)
+			{
+				case Mode::Set: out[frame] = sample; break;
+				case Mode::Add: out[frame] += sample; break;
+				case Mode::Multiply: out[frame] *= sample; break;
+			}
+		}
+	}
+}
+
+
 } // namespace lmms
@@ -0,0 +1,72 @@
+/*
+ * OscillatorAvx2.cpp - AVX2 implementation of the oscillator kernels
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "OscillatorSimd.h"
+
+#ifdef LMMS_MIX_HELPERS_X86
+
+#include <immintrin.h>
+
+namespace lmms
+{
+
+namespace
+{
+
+struct Avx2
+{
+	static constexpr int Width = 8;
+
+	static __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+	static __m256 set1(float x) { return _mm256_set1_ps(x); }
+	static __m256 add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+	static __m256 sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+	static __m256 mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+	static __m256 min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+	static __m256 max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+
+	static __m256 ramp() { return _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f); }
+	static __m256 below(__m256 v, __m256 limit) { return _mm256_and_ps(_mm256_cmp_ps(v, limit, _CMP_LT_OQ), v); }
+
+	//! Not _mm256_floor_ps, which differs from the scalar code outside the range of int
+	static __m256 floor(__m256 v)
+	{
+		const __m256 t = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(v));
+		return _mm256_sub_ps(t, _mm256_and_ps(_mm256_cmp_ps(t, v, _CMP_GT_OQ), _mm256_set1_ps(1.f)));
+	}
+
+	static __m256 gather(const float* table, __m256 indices)
+	{
+		return _mm256_i32gather_ps(table, _mm256_cvttps_epi32(indices), 4);
+	}
+};
+
+} // namespace
+
+const OscillatorKernels Avx2OscillatorKernels = SimdOscillatorKernels<Avx2>::table();
+
+} // namespace lmms
+
+#endif // LMMS_MIX_HELPERS_X86
@@ -0,0 +1,75 @@
+/*
+ * OscillatorKernels.cpp - scalar oscillator kernels and their dispatch
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "OscillatorKernels.h"
+
+#include "MixHelpers.h"
+#include "OscillatorSimd.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+void phaseRampScalar(float* phases, const float* offsets, float phase, float increment, int frames)
+{
+	phaseRampScalar(phases, offsets, phase, increment, 0, frames);
+}
+
+void wavetableScalar(float* buffer, const float* phases, const float* table, float volume, int frames,
+	OscillatorKernels::Mode mode)
+{
+	using Mode = OscillatorKernels::Mode;
+	switch (mode)
+	{
+	case Mode::Set: wavetableScalar<Mode::Set>(buffer, phases, table, volume, 0, frames); break;
+	case Mode::Add: wavetableScalar<Mode::Add>(buffer, phases, table, volume, 0, frames); break;
+	case Mode::Multiply: wavetableScalar<Mode::Multiply>(buffer, phases, table, volume, 0, frames); break;
+	}
+}
+
+constexpr OscillatorKernels ScalarOscillatorKernels = {
+	&phaseRampScalar,
+	&wavetableScalar
+};
+
+} // namespace
+
+
+const OscillatorKernels& oscillatorKernels()
+{
+	switch (MixHelpers::simdLevel())
+	{
+#ifdef LMMS_MIX_HELPERS_X86
+	case MixHelpers::SimdLevel::Sse2: return Sse2OscillatorKernels;
+	// there are no AVX-512 kernels, AVX2 gathers are used instead
+	case MixHelpers::SimdLevel::Avx2:
+	case MixHelpers::SimdLevel::Avx512: return Avx2OscillatorKernels;
+#endif
+	default: return ScalarOscillatorKernels;
+	}
+}
+
+} // namespace lmms
@@ -0,0 +1,68 @@
+/*
+ * OscillatorKernels.h - block rendering kernels of Oscillator
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_OSCILLATOR_KERNELS_H
+#define LMMS_OSCILLATOR_KERNELS_H
+
+#include "MixHelpersKernels.h"
+
+namespace lmms
+{
+
+/**
+	@brief The block rendering functions of Oscillator implemented for one instruction set
+
+	Like the MixHelpers kernels, the scalar reference lives in
+	OscillatorKernels.cpp and the SIMD tables in their own translation units.
+	The table in use follows MixHelpers::simdLevel().
+*/
+struct OscillatorKernels
+{
+	//! How the rendered samples are combined with the buffer
+	enum class Mode
+	{
+		Set,
+		Add,
+		Multiply
+	};
+
+	//! Writes `phase + i * increment` to phases[i], plus offsets[i] unless @p offsets is null
+	void (*phaseRamp)(float* phases, const float* offsets, float phase, float increment, int frames);
+
+	//! Interpolates @p table, a single band-limited wavetable of OscillatorConstants::WAVETABLE_LENGTH
+	//! samples, at each of @p phases and combines the results times @p volume with @p buffer
+	void (*wavetable)(float* buffer, const float* phases, const float* table, float volume, int frames, Mode mode);
+};
+
+#ifdef LMMS_MIX_HELPERS_X86
+extern const OscillatorKernels Sse2OscillatorKernels;
+extern const OscillatorKernels Avx2OscillatorKernels;
+#endif
+
+//! The kernels for the current MixHelpers::simdLevel()
+const OscillatorKernels& oscillatorKernels();
+
+} // namespace lmms
+
+#endif // LMMS_OSCILLATOR_KERNELS_H
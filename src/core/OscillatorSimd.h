@@ -0,0 +1,183 @@
+/*
+ * OscillatorSimd.h - oscillator kernels for any instruction set
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_OSCILLATOR_SIMD_H
+#define LMMS_OSCILLATOR_SIMD_H
+
+#include "OscillatorConstants.h"
+#include "OscillatorKernels.h"
+
+namespace lmms
+{
+
+// Compiled for newer instruction sets like MixHelpersSimd.h, so the same
+// rules apply: internal linkage only and nothing from the standard library.
+namespace
+{
+
+constexpr int TableLength = OscillatorConstants::WAVETABLE_LENGTH;
+constexpr float LastIndex = static_cast<float>(TableLength - 1);
+
+//! Rounds towards minus infinity by truncating, which is what the vector code can do cheaply
+inline float floorValue(float x)
+{
+	const float t = static_cast<float>(static_cast<int>(x));
+	return t > x ? t - 1.f : t;
+}
+
+//! Limits an index to the table, also if the phase was NaN or out of the range of int
+inline float clampIndex(float x)
+{
+	x = x < LastIndex ? x : LastIndex;
+	return x > 0.f ? x : 0.f;
+}
+
+//! Linear interpolation of a table at @p phase, wrapping around at the end of the table
+inline float wavetableSample(const float* table, float phase)
+{
+	const float frame = (phase - floorValue(phase)) * static_cast<float>(TableLength);
+	const float f1 = clampIndex(floorValue(frame));
+	const float f2 = f1 + 1.f < static_cast<float>(TableLength) ? f1 + 1.f : 0.f;
+	const float a = table[static_cast<int>(f1)];
+	const float b = table[static_cast<int>(f2)];
+	return a + (frame - f1) * (b - a);
+}
+
+template<OscillatorKernels::Mode M>
+inline void combine(float& dst, float sample)
+{
+	if constexpr (M == OscillatorKernels::Mode::Set) { dst = sample; }
+	else if constexpr (M == OscillatorKernels::Mode::Add) { dst += sample; }
+	else { dst *= sample; }
+}
+
+inline void phaseRampScalar(float* phases, const float* offsets, float phase, float increment, int from, int frames)
+{
+	for (int i = from; i < frames; ++i)
+	{
+		phases[i] = phase + static_cast<float>(i) * increment;
+		if (offsets) { phases[i] += offsets[i]; }
+	}
+}
+
+template<OscillatorKernels::Mode M>
+inline void wavetableScalar(float* buffer, const float* phases, const float* table, float volume, int from,
+	int frames)
+{
+	for (int i = from; i < frames; ++i)
+	{
+		combine<M>(buffer[i], wavetableSample(table, phases[i]) * volume);
+	}
+}
+
+
+/**
+	@brief The kernels of @ref OscillatorKernels for the vector type @p V
+
+	The vectors run along time, i.e. they hold the phases of `Width`
+	consecutive frames. Besides the arithmetic of MixHelpers' vector types,
+	@p V provides `floor` with the semantics of floorValue(), `ramp` for the
+	vector (0, 1, 2, ...), `below` to keep the values of a vector that are
+	less than a limit and zero the others, and `gather` to load table values
+	at float indices.
+*/
+template<typename V>
+struct SimdOscillatorKernels
+{
+	static constexpr int Width = V::Width;
+	using Mode = OscillatorKernels::Mode;
+
+	static void phaseRamp(float* phases, const float* offsets, float phase, float increment, int frames)
+	{
+		const auto start = V::set1(phase);
+		const auto step = V::set1(increment);
+		const auto width = V::set1(static_cast<float>(Width));
+		auto index = V::ramp();
+
+		int i = 0;
+		for (; i + Width <= frames; i += Width)
+		{
+			auto p = V::add(start, V::mul(index, step));
+			if (offsets) { p = V::add(p, V::load(offsets + i)); }
+			V::store(phases + i, p);
+			index = V::add(index, width);
+		}
+		phaseRampScalar(phases, offsets, phase, increment, i, frames);
+	}
+
+	template<Mode M>
+	static void wavetable(float* buffer, const float* phases, const float* table, float volume, int frames)
+	{
+		const auto length = V::set1(static_cast<float>(TableLength));
+		const auto last = V::set1(LastIndex);
+		const auto zero = V::set1(0.f);
+		const auto one = V::set1(1.f);
+		const auto vol = V::set1(volume);
+
+		int i = 0;
+		for (; i + Width <= frames; i += Width)
+		{
+			const auto phase = V::load(phases + i);
+			const auto frame = V::mul(V::sub(phase, V::floor(phase)), length);
+			const auto f1 = V::max(V::min(V::floor(frame), last), zero);
+			const auto f2 = V::below(V::add(f1, one), length);
+			const auto a = V::gather(table, f1);
+			const auto b = V::gather(table, f2);
+			const auto sample = V::mul(V::add(a, V::mul(V::sub(frame, f1), V::sub(b, a))), vol);
+
+			if constexpr (M == Mode::Set) { V::store(buffer + i, sample); }
+			else if constexpr (M == Mode::Add)
+			{
+				V::store(buffer + i, V::add(V::load(buffer + i), sample));
+			}
+			else { V::store(buffer + i, V::mul(V::load(buffer + i), sample)); }
+		}
+		wavetableScalar<M>(buffer, phases, table, volume, i, frames);
+	}
+
+	static void wavetable(float* buffer, const float* phases, const float* table, float volume, int frames,
+		Mode mode)
+	{
+		switch (mode)
+		{
+		case Mode::Set: wavetable<Mode::Set>(buffer, phases, table, volume, frames); break;
+		case Mode::Add: wavetable<Mode::Add>(buffer, phases, table, volume, frames); break;
+		case Mode::Multiply: wavetable<Mode::Multiply>(buffer, phases, table, volume, frames); break;
+		}
+	}
+
+	static constexpr OscillatorKernels table()
+	{
+		return {
+			&phaseRamp,
+			&wavetable
+		};
+	}
+};
+
+} // namespace
+
+} // namespace lmms
+
+#endif // LMMS_OSCILLATOR_SIMD_H
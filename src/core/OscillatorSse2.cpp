@@ -0,0 +1,74 @@
+/*
+ * OscillatorSse2.cpp - SSE2 implementation of the oscillator kernels
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "OscillatorSimd.h"
+
+#ifdef LMMS_MIX_HELPERS_X86
+
+#include <emmintrin.h>
+
+namespace lmms
+{
+
+namespace
+{
+
+struct Sse2
+{
+	static constexpr int Width = 4;
+
+	static __m128 load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+	static __m128 set1(float x) { return _mm_set1_ps(x); }
+	static __m128 add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+	static __m128 sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+	static __m128 mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+	static __m128 min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+	static __m128 max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+
+	static __m128 ramp() { return _mm_setr_ps(0.f, 1.f, 2.f, 3.f); }
+	static __m128 below(__m128 v, __m128 limit) { return _mm_and_ps(_mm_cmplt_ps(v, limit), v); }
+
+	static __m128 floor(__m128 v)
+	{
+		const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+		return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.f)));
+	}
+
+	//! SSE2 has no gather, so the lanes are loaded one by one
+	static __m128 gather(const float* table, __m128 indices)
+	{
+		alignas(16) int i[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(i), _mm_cvttps_epi32(indices));
+		return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+	}
+};
+
+} // namespace
+
+const OscillatorKernels Sse2OscillatorKernels = SimdOscillatorKernels<Sse2>::table();
+
+} // namespace lmms
+
+#endif // LMMS_MIX_HELPERS_X86
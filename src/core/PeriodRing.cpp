@@ -0,0 +1,185 @@
+/*
+ * PeriodRing.cpp - preallocated ring of audio periods between renderer and device
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PeriodRing.h"
+
+#include <algorithm>
+
+#include "SampleFrame.h"
+
+namespace lmms
+{
+
+
+PeriodRing::PeriodRing(std::size_t depth, fpp_t framesPerPeriod) :
+	// one period is held by the reader, so less than two would not let
+	// the writer render ahead at all
+	m_depth(std::max<std::size_t>(depth, 2)),
+	m_framesPerPeriod(framesPerPeriod),
+	m_frames(std::make_unique<SampleFrame[]>(m_depth * framesPerPeriod))
+{
+}
+
+
+
+
+PeriodRing::~PeriodRing() = default;
+
+
+
+
+SampleFrame* PeriodRing::beginWrite()
+{
+	const auto written = m_written.load(std::memory_order_relaxed);
+	waitFor(m_writerWaiting, m_writerWake, [this, written] {
+		return written - m_released.load(std::memory_order_acquire) < m_depth;
+	});
+	return slot(written);
+}
+
+
+
+
+void PeriodRing::endWrite()
+{
+	m_written.fetch_add(1, std::memory_order_release);
+	wakeUp(m_readerWaiting, m_readerWake);
+}
+
+
+
+
+void PeriodRing::close()
+{
+	m_closed.store(true, std::memory_order_release);
+	wakeUp(m_readerWaiting, m_readerWake);
+}
+
+
+
+
+void PeriodRing::waitUntilRead()
+{
+	waitFor(m_writerWaiting, m_writerWake, [this] {
+		return m_released.load(std::memory_order_acquire) == m_written.load(std::memory_order_relaxed);
+	});
+}
+
+
+
+
+void PeriodRing::reopen()
+{
+	m_closed.store(false, std::memory_order_release);
+}
+
+
+
+
+const SampleFrame* PeriodRing::read()
+{
+	release();
+
+	const auto ready = [this] {
+		return m_written.load(std::memory_order_acquire) != m_taken || m_closed.load(std::memory_order_acquire);
+	};
+	if (!ready())
+	{
+		m_underruns.fetch_add(1, std::memory_order_relaxed);
+		waitFor(m_readerWaiting, m_readerWake, ready);
+	}
+
+	// everything written before closing is still read
+	if (m_written.load(std::memory_order_acquire) == m_taken) { return nullptr; }
+
+	return slot(m_taken++);
+}
+
+
+
+
+std::size_t PeriodRing::fillLevel() const
+{
+	const auto released = m_released.load(std::memory_order_relaxed);
+	return m_written.load(std::memory_order_relaxed) - released;
+}
+
+
+
+
+SampleFrame* PeriodRing::slot(std::size_t index) const
+{
+	return m_frames.get() + (index % m_depth) * m_framesPerPeriod;
+}
+
+
+
+
+void PeriodRing::release()
+{
+	if (m_released.load(std::memory_order_relaxed) == m_taken) { return; }
+
+	m_released.store(m_taken, std::memory_order_release);
+	wakeUp(m_writerWaiting, m_writerWake);
+}
+
+
+
+
+// The waiting side announces itself before checking the condition once more,
+// while the other side checks for a waiter after changing the condition. The
+// fences make sure at least one of them sees the other, so a wakeup can't get
+// lost. Whoever clears the flag is responsible for the post: if the other
+// side cleared it, the waiter takes the post even if it doesn't need it
+// anymore, to keep the semaphore balanced.
+template<typename Ready>
+void PeriodRing::waitFor(std::atomic<bool>& waiting, Semaphore& wake, Ready ready)
+{
+	while (!ready())
+	{
+		waiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (ready())
+		{
+			if (!waiting.exchange(false, std::memory_order_acq_rel)) { wake.wait(); }
+			return;
+		}
+		wake.wait();
+	}
+}
+
+
+
+
+void PeriodRing::wakeUp(std::atomic<bool>& waiting, Semaphore& wake)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiting.load(std::memory_order_relaxed) && waiting.exchange(false, std::memory_order_acq_rel))
+	{
+		wake.post();
+	}
+}
+
+
+} // namespace lmms
@@ -23,6 +23,7 @@
  */
  
 #include "PlayHandle.h"
+#include "AudioBusHandle.h"
 #include "AudioEngine.h"
 #include "BufferManager.h"
 #include "Engine.h"
@@ -39,7 +40,8 @@ PlayHandle::PlayHandle(const Type type, f_cnt_t offset) :
 		m_affinity(QThread::currentThread()),
 		m_playHandleBuffer(BufferManager::acquire()),
 		m_bufferReleased(true),
-		m_usesBuffer(true)
+		m_usesBuffer(true),
+		m_audioBusHandle(nullptr)
 {
 }
 
@@ -51,6 +53,23 @@ PlayHandle::~PlayHandle()
 
 
 void PlayHandle::doProcessing()
+{
+	{
+		// account the time to the track we're playing on
+		AudioEngineProfiler::JobProbe probe(Engine::audioEngine()->profiler(),
+			AudioEngineProfiler::DetailType::Instruments, m_audioBusHandle);
+		render();
+	}
+
+	// let our audio bus handle know it doesn't have to wait for us anymore
+	if( m_audioBusHandle )
+	{
+		m_audioBusHandle->inputProcessed();
+	}
+}
+
+
+void PlayHandle::render()
 {
 	if( m_usesBuffer )
 	{
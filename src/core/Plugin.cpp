@@ -225,7 +225,10 @@ Plugin * Plugin::instantiate(const QString& pluginName, Model * parent,
 	}
 	else
 	{
-		auto instantiationHook = reinterpret_cast<InstantiationHook>(pi.library->resolve("lmms_plugin_main"));
+		// plugins found through the plugin cache are loaded on first use
+		auto instantiationHook = getPluginFactory()->loadLibrary(pi)
+			? reinterpret_cast<InstantiationHook>(pi.library->resolve("lmms_plugin_main"))
+			: nullptr;
 		if (instantiationHook)
 		{
 			inst = instantiationHook(parent, data);
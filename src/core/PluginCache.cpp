@@ -0,0 +1,155 @@
+/*
+ * PluginCache.cpp - remembers what was found in plugin libraries
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PluginCache.h"
+
+#include <iterator>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "lmmsversion.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Increase when the layout of the entries changes
+constexpr int CacheFormat = 1;
+
+} // namespace
+
+QString PluginCache::s_directory;
+
+PluginCache::PluginCache(const QString& name) :
+	m_fileName(QDir(directory()).filePath(name + ".json"))
+{
+	QFile file(m_fileName);
+	if (!file.open(QIODevice::ReadOnly)) { return; }
+
+	const auto json = QJsonDocument::fromJson(file.readAll()).object();
+	// Descriptors may change between versions even if a library did not
+	if (json["format"].toInt() != CacheFormat || json["version"].toString() != LMMS_VERSION)
+	{
+		m_modified = true;
+		return;
+	}
+
+	for (const auto& value : json["libraries"].toArray())
+	{
+		const auto entry = value.toObject();
+		m_entries.insert(entry["path"].toString(), entry);
+	}
+}
+
+PluginCache::~PluginCache()
+{
+	save();
+}
+
+std::optional<QJsonObject> PluginCache::find(const QFileInfo& file)
+{
+	const auto path = file.absoluteFilePath();
+	const auto it = m_entries.constFind(path);
+	if (it != m_entries.constEnd()
+		&& static_cast<qint64>((*it)["size"].toDouble()) == file.size()
+		&& static_cast<qint64>((*it)["modified"].toDouble()) == file.lastModified().toMSecsSinceEpoch())
+	{
+		m_used.insert(path);
+		++m_statistics.cached;
+		return (*it)["data"].toObject();
+	}
+
+	++m_statistics.probed;
+	return std::nullopt;
+}
+
+void PluginCache::insert(const QFileInfo& file, const QJsonObject& entry)
+{
+	const auto path = file.absoluteFilePath();
+	m_entries.insert(path, QJsonObject{
+		{"path", path},
+		{"size", static_cast<double>(file.size())},
+		{"modified", static_cast<double>(file.lastModified().toMSecsSinceEpoch())},
+		{"data", entry}
+	});
+	m_used.insert(path);
+	m_modified = true;
+}
+
+void PluginCache::save()
+{
+	auto libraries = QJsonArray{};
+	for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+	{
+		if (m_used.contains(it.key())) { libraries.append(*it); }
+	}
+
+	// Libraries which were removed or failed to load are dropped as well
+	if (!m_modified && libraries.size() == m_entries.size()) { return; }
+
+	QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+	QSaveFile file(m_fileName);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		qWarning() << "Could not write the plugin cache" << m_fileName;
+		return;
+	}
+
+	const auto json = QJsonObject{
+		{"format", CacheFormat},
+		{"version", LMMS_VERSION},
+		{"libraries", libraries}
+	};
+	file.write(QJsonDocument{json}.toJson(QJsonDocument::Compact));
+	if (!file.commit()) { return; }
+
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		it = m_used.contains(it.key()) ? std::next(it) : m_entries.erase(it);
+	}
+	m_modified = false;
+}
+
+QString PluginCache::directory()
+{
+	if (!s_directory.isEmpty()) { return s_directory; }
+	return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/lmms";
+}
+
+void PluginCache::setDirectory(const QString& directory)
+{
+	s_directory = directory;
+}
+
+} // namespace lmms
@@ -27,12 +27,18 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonObject>
 #include <QLibrary>
+#include <QPair>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <memory>
 #include "lmmsconfig.h"
 
 #include "ConfigManager.h"
+#include "embed.h"
 #include "Plugin.h"
 
 // QT qHash specialization, needs to be in global namespace
@@ -53,12 +59,105 @@ namespace lmms
 
 std::unique_ptr<PluginFactory> PluginFactory::s_instance;
 
+//! Descriptor of a plugin discovered through the cache, which stays valid
+//! without its library
+struct PluginFactory::CachedDescriptor
+{
+	std::string name;
+	std::string displayName;
+	std::string description;
+	std::string author;
+	std::string supportedFileTypes;
+	std::unique_ptr<PixmapLoader> logo;
+	Plugin::Descriptor descriptor;
+};
+
+namespace
+{
+
+//! Logo of a plugin discovered through the cache. The artwork is embedded into
+//! the plugin library, so it is taken from the copy made when the library was
+//! probed, or the library is loaded first.
+class CachedLogoLoader : public PixmapLoader
+{
+public:
+	CachedLogoLoader(std::string name, QString copy, PluginFactory::PluginInfo info) :
+		PixmapLoader{std::move(name)},
+		m_copy{std::move(copy)},
+		m_info{std::move(info)}
+	{ }
+
+	auto pixmap(int width, int height) const -> QPixmap override
+	{
+		if (!m_copy.isEmpty() && QFileInfo::exists(m_copy))
+		{
+			return embed::getIconPixmap(m_copy.toStdString(), width, height);
+		}
+		getPluginFactory()->loadLibrary(m_info);
+		return PixmapLoader::pixmap(width, height);
+	}
+
+private:
+	QString m_copy;
+	PluginFactory::PluginInfo m_info;
+};
+
+QString fromUtf8(const char* string)
+{
+	return string ? QString::fromUtf8(string) : QString();
+}
+
+//! Copies the logo embedded into a loaded plugin library to the cache directory,
+//! so it can be shown without loading the library on the next start
+QString copyLogo(const std::string& pixmapName)
+{
+	const auto name = QString::fromStdString(pixmapName);
+	const auto resource = QFileInfo(":/artwork/" + name);
+	const auto candidates = resource.dir().entryInfoList({resource.fileName() + ".*"}, QDir::Files);
+	if (candidates.isEmpty()) { return QString(); }
+
+	QFile source(candidates.first().absoluteFilePath());
+	const auto copy = QDir(PluginCache::directory()).filePath("artwork/" + name + '.' + candidates.first().suffix());
+	QDir().mkpath(QFileInfo(copy).absolutePath());
+	QSaveFile target(copy);
+	if (!source.open(QIODevice::ReadOnly) || !target.open(QIODevice::WriteOnly)) { return QString(); }
+
+	target.write(source.readAll());
+	return target.commit() ? copy : QString();
+}
+
+QJsonObject descriptorEntry(const Plugin::Descriptor& descriptor)
+{
+	auto entry = QJsonObject{
+		{"name", fromUtf8(descriptor.name)},
+		{"displayName", fromUtf8(descriptor.displayName)},
+		{"description", fromUtf8(descriptor.description)},
+		{"author", fromUtf8(descriptor.author)},
+		{"version", descriptor.version},
+		{"type", static_cast<int>(descriptor.type)}
+	};
+	if (descriptor.supportedFileTypes)
+	{
+		entry["supportedFileTypes"] = fromUtf8(descriptor.supportedFileTypes);
+	}
+	if (descriptor.logo)
+	{
+		entry["logo"] = QString::fromStdString(descriptor.logo->pixmapName());
+		entry["logoCopy"] = copyLogo(descriptor.logo->pixmapName());
+	}
+	return entry;
+}
+
+} // namespace
+
 PluginFactory::PluginFactory()
 {
 	setupSearchPaths();
 	discoverPlugins();
 }
 
+PluginFactory::~PluginFactory() = default;
+
 void PluginFactory::setupSearchPaths()
 {
 	// Adds a search path relative to the main executable if the path exists.
@@ -143,9 +242,13 @@ QString PluginFactory::errorString(QString pluginName) const
 
 void PluginFactory::discoverPlugins()
 {
+	QElapsedTimer timer;
+	timer.start();
+
 	DescriptorMap descriptors;
 	PluginInfoList pluginInfos;
 	m_pluginByExt.clear();
+	m_helperLibraries.clear();
 
 	QSet<QFileInfo> files;
 	for (const QString& searchPath : QDir::searchPaths("plugins"))
@@ -161,92 +264,210 @@ void PluginFactory::discoverPlugins()
 	// Apply any plugin filters from environment LMMS_EXCLUDE_PLUGINS
 	filterPlugins(files);
 
-	// Cheap dependency handling: zynaddsubfx needs ZynAddSubFxCore. By loading
-	// all libraries twice we ensure that libZynAddSubFxCore is found.
+	// Only libraries which changed since the last run have to be loaded to
+	// find out what they contain
+	PluginCache cache("plugins");
+	QList<QPair<QFileInfo, QJsonObject>> cachedFiles;
+	QList<QFileInfo> probedFiles;
 	for (const QFileInfo& file : files)
 	{
-		QLibrary(file.absoluteFilePath()).load();
+		if (const auto entry = cache.find(file)) { cachedFiles.append(qMakePair(file, *entry)); }
+		else { probedFiles.append(file); }
 	}
 
-	for (const QFileInfo& file : files)
+	for (const auto& cached : cachedFiles)
 	{
-		auto library = std::make_shared<QLibrary>(file.absoluteFilePath());
-		if (! library->load()) {
-			m_errors[file.baseName()] = library->errorString();
-			qWarning("%s", library->errorString().toLocal8Bit().data());
-			continue;
+		if (!cached.second["plugin"].toBool()) { m_helperLibraries << cached.first.absoluteFilePath(); }
+	}
+
+	if (!probedFiles.isEmpty())
+	{
+		// Cheap dependency handling: zynaddsubfx needs ZynAddSubFxCore. By loading
+		// all libraries twice we ensure that libZynAddSubFxCore is found.
+		loadHelperLibraries();
+		for (const QFileInfo& file : probedFiles)
+		{
+			QLibrary(file.absoluteFilePath()).load();
 		}
+	}
 
-		Plugin::Descriptor* pluginDescriptor = nullptr;
-		if (library->resolve("lmms_plugin_main"))
+	const auto resolveDescriptor = [](QLibrary& library, const QFileInfo& file) -> Plugin::Descriptor*
+	{
+		QString descriptorName = file.baseName() + "_plugin_descriptor";
+		if( descriptorName.left(3) == "lib" )
 		{
-			QString descriptorName = file.baseName() + "_plugin_descriptor";
-			if( descriptorName.left(3) == "lib" )
-			{
-				descriptorName = descriptorName.mid(3);
-			}
+			descriptorName = descriptorName.mid(3);
+		}
 
-			pluginDescriptor = reinterpret_cast<Plugin::Descriptor*>(library->resolve(descriptorName.toUtf8().constData()));
-			if(pluginDescriptor == nullptr)
-			{
-				qWarning() << qApp->translate("PluginFactory", "LMMS plugin %1 does not have a plugin descriptor named %2!").
-							  arg(file.absoluteFilePath()).arg(descriptorName);
-				continue;
-			}
+		auto pluginDescriptor = reinterpret_cast<Plugin::Descriptor*>(library.resolve(descriptorName.toUtf8().constData()));
+		if(pluginDescriptor == nullptr)
+		{
+			qWarning() << qApp->translate("PluginFactory", "LMMS plugin %1 does not have a plugin descriptor named %2!").
+						  arg(file.absoluteFilePath()).arg(descriptorName);
 		}
+		return pluginDescriptor;
+	};
 
-		if(pluginDescriptor)
+	const auto addPlugin = [this, &descriptors, &pluginInfos](const PluginInfo& info)
+	{
+		pluginInfos << info;
+
+		auto addSupportedFileTypes =
+			[this](QString supportedFileTypes,
+				const PluginInfo& info,
+				const Plugin::Descriptor::SubPluginFeatures::Key* key = nullptr)
 		{
-			PluginInfo info;
-			info.file = file;
-			info.library = library;
-			info.descriptor = pluginDescriptor;
-			pluginInfos << info;
-
-			auto addSupportedFileTypes =
-				[this](QString supportedFileTypes,
-					const PluginInfo& info,
-					const Plugin::Descriptor::SubPluginFeatures::Key* key = nullptr)
+			if(!supportedFileTypes.isNull())
 			{
-				if(!supportedFileTypes.isNull())
+				for (const QString& ext : supportedFileTypes.split(','))
 				{
-					for (const QString& ext : supportedFileTypes.split(','))
-					{
-						//qDebug() << "Plugin " << info.name()
-						//	<< "supports" << ext;
-						PluginInfoAndKey infoAndKey;
-						infoAndKey.info = info;
-						infoAndKey.key = key
-							? *key
-							: Plugin::Descriptor::SubPluginFeatures::Key();
-						m_pluginByExt.insert(ext, infoAndKey);
-					}
+					//qDebug() << "Plugin " << info.name()
+					//	<< "supports" << ext;
+					PluginInfoAndKey infoAndKey;
+					infoAndKey.info = info;
+					infoAndKey.key = key
+						? *key
+						: Plugin::Descriptor::SubPluginFeatures::Key();
+					m_pluginByExt.insert(ext, infoAndKey);
 				}
-			};
+			}
+		};
 
-			if (info.descriptor->supportedFileTypes)
-				addSupportedFileTypes(QString(info.descriptor->supportedFileTypes), info);
+		if (info.descriptor->supportedFileTypes)
+			addSupportedFileTypes(QString(info.descriptor->supportedFileTypes), info);
 
-			if (info.descriptor->subPluginFeatures)
+		if (info.descriptor->subPluginFeatures)
+		{
+			Plugin::Descriptor::SubPluginFeatures::KeyList
+				subPluginKeys;
+			info.descriptor->subPluginFeatures->listSubPluginKeys(
+				info.descriptor,
+				subPluginKeys);
+			for(const Plugin::Descriptor::SubPluginFeatures::Key& key
+				: subPluginKeys)
 			{
-				Plugin::Descriptor::SubPluginFeatures::KeyList
-					subPluginKeys;
-				info.descriptor->subPluginFeatures->listSubPluginKeys(
-					info.descriptor,
-					subPluginKeys);
-				for(const Plugin::Descriptor::SubPluginFeatures::Key& key
-					: subPluginKeys)
-				{
-					addSupportedFileTypes(key.additionalFileExtensions(), info, &key);
-				}
+				addSupportedFileTypes(key.additionalFileExtensions(), info, &key);
 			}
+		}
 
-			descriptors.insert(info.descriptor->type, info.descriptor);
+		descriptors.insert(info.descriptor->type, info.descriptor);
+	};
+
+	for (const auto& [file, entry] : cachedFiles)
+	{
+		if (!entry["plugin"].toBool()) { continue; }
+
+		PluginInfo info;
+		info.file = file;
+		info.library = std::make_shared<QLibrary>(file.absoluteFilePath());
+		if (entry["subPlugins"].toBool())
+		{
+			// Sub plugins can only be listed by the plugin itself
+			if (!loadLibrary(info)) { continue; }
+			info.descriptor = resolveDescriptor(*info.library, file);
+		}
+		else
+		{
+			info.descriptor = cachedDescriptor(info, entry["descriptor"].toObject());
 		}
+
+		if (info.descriptor) { addPlugin(info); }
+	}
+
+	for (const QFileInfo& file : probedFiles)
+	{
+		auto library = std::make_shared<QLibrary>(file.absoluteFilePath());
+		if (! library->load()) {
+			m_errors[file.baseName()] = library->errorString();
+			qWarning("%s", library->errorString().toLocal8Bit().data());
+			continue;
+		}
+
+		if (!library->resolve("lmms_plugin_main"))
+		{
+			cache.insert(file, QJsonObject{{"plugin", false}});
+			continue;
+		}
+
+		Plugin::Descriptor* pluginDescriptor = resolveDescriptor(*library, file);
+		if (!pluginDescriptor) { continue; }
+
+		cache.insert(file, QJsonObject{
+			{"plugin", true},
+			{"subPlugins", pluginDescriptor->subPluginFeatures != nullptr},
+			{"descriptor", descriptorEntry(*pluginDescriptor)}
+		});
+
+		PluginInfo info;
+		info.file = file;
+		info.library = library;
+		info.descriptor = pluginDescriptor;
+		addPlugin(info);
 	}
 
 	m_pluginInfos = pluginInfos;
 	m_descriptors = descriptors;
+
+	m_statistics = cache.statistics();
+	m_statistics.milliseconds = timer.elapsed();
+	qDebug() << "Plugin discovery:" << m_pluginInfos.size() << "plugins in" << m_statistics.milliseconds << "msecs,"
+		<< m_statistics.probed << "libraries probed," << m_statistics.cached << "taken from" << cache.fileName();
+}
+
+bool PluginFactory::loadLibrary(const PluginInfo& info)
+{
+	if (info.isNull()) { return false; }
+	if (info.library->isLoaded()) { return true; }
+
+	loadHelperLibraries();
+	if (!info.library->load())
+	{
+		m_errors[info.file.baseName()] = info.library->errorString();
+		qWarning("%s", info.library->errorString().toLocal8Bit().data());
+		return false;
+	}
+	return true;
+}
+
+void PluginFactory::loadHelperLibraries()
+{
+	if (m_helpersLoaded) { return; }
+	m_helpersLoaded = true;
+
+	for (const QString& helper : m_helperLibraries)
+	{
+		QLibrary(helper).load();
+	}
+}
+
+Plugin::Descriptor* PluginFactory::cachedDescriptor(const PluginInfo& info, const QJsonObject& entry)
+{
+	auto cached = std::make_unique<CachedDescriptor>();
+	cached->name = entry["name"].toString().toStdString();
+	cached->displayName = entry["displayName"].toString().toStdString();
+	cached->description = entry["description"].toString().toStdString();
+	cached->author = entry["author"].toString().toStdString();
+	cached->supportedFileTypes = entry["supportedFileTypes"].toString().toStdString();
+	if (entry.contains("logo"))
+	{
+		cached->logo = std::make_unique<CachedLogoLoader>(entry["logo"].toString().toStdString(),
+			entry["logoCopy"].toString(), info);
+	}
+
+	cached->descriptor = Plugin::Descriptor{
+		cached->name.c_str(),
+		cached->displayName.c_str(),
+		cached->description.c_str(),
+		cached->author.c_str(),
+		entry["version"].toInt(),
+		static_cast<Plugin::Type>(entry["type"].toInt()),
+		cached->logo.get(),
+		entry.contains("supportedFileTypes") ? cached->supportedFileTypes.c_str() : nullptr,
+		nullptr
+	};
+
+	m_cachedDescriptors.push_back(std::move(cached));
+	return &m_cachedDescriptors.back()->descriptor;
 }
 
 // Builds QList<QRegularExpression> based on environment variable envVar
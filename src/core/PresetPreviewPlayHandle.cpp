@@ -182,7 +182,10 @@ PresetPreviewPlayHandle::PresetPreviewPlayHandle( const QString & _preset_file,
 
 	s_previewTC->setPreviewNote( m_previewNote );
 
-	Engine::audioEngine()->addPlayHandle( m_previewNote );
+	if (m_previewNote)
+	{
+		Engine::audioEngine()->addPlayHandle( m_previewNote );
+	}
 
 	Engine::audioEngine()->doneChangeInModel();
 	s_previewTC->unlockData();
@@ -196,7 +199,7 @@ PresetPreviewPlayHandle::~PresetPreviewPlayHandle()
 {
 	Engine::audioEngine()->requestChangeInModel();
 	// not muted by other preset-preview-handle?
-	if (s_previewTC->testAndSetPreviewNote(m_previewNote, nullptr))
+	if (m_previewNote && s_previewTC->testAndSetPreviewNote(m_previewNote, nullptr))
 	{
 		m_previewNote->noteOff();
 	}
@@ -217,7 +220,7 @@ void PresetPreviewPlayHandle::play( SampleFrame* _working_buffer )
 
 bool PresetPreviewPlayHandle::isFinished() const
 {
-	return m_previewNote->isMuted();
+	return !m_previewNote || m_previewNote->isMuted();
 }
 
 
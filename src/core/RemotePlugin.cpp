@@ -34,6 +34,7 @@
 #endif
 
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 #include "Engine.h"
 #include "MidiEvent.h"
 #include "Song.h"
@@ -43,6 +44,9 @@
 #include <QDir>
 #include <QUuid>
 
+#include <algorithm>
+#include <cassert>
+
 #ifndef SYNC_WITH_SHM_FIFO
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -316,6 +320,7 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 #endif
 
 	sendMessage(message(IdSyncKey).addString(Engine::getSong()->syncKey()));
+	m_pipelined = ConfigManager::inst()->value("audioengine", "pipelinedremoteplugins").toInt() != 0;
 	resizeSharedProcessingMemory();
 
 	if( waitForInitDoneMsg )
@@ -334,27 +339,8 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 {
 	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
 
-	if( m_failed || !isRunning() )
-	{
-		if( _out_buf != nullptr )
-		{
-			zeroSampleFrames(_out_buf, frames);
-		}
-		return false;
-	}
-
-	if (!m_audioBuffer)
+	if( !isReadyToProcess() )
 	{
-		// m_audioBuffer being zero means we didn't initialize everything so
-		// far so process one message each time (and hope we get
-		// information like SHM-key etc.) until we process messages
-		// in a later stage of this procedure
-		if( m_audioBufferSize == 0 )
-		{
-			lock();
-			fetchAndProcessAllMessages();
-			unlock();
-		}
 		if( _out_buf != nullptr )
 		{
 			zeroSampleFrames(_out_buf, frames);
@@ -362,7 +348,7 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		return false;
 	}
 
-	memset( m_audioBuffer.get(), 0, m_audioBufferSize );
+	float* buffer = beginPeriod();
 
 	ch_cnt_t inputs = std::min<ch_cnt_t>(m_inputCount, DEFAULT_CHANNELS);
 
@@ -374,19 +360,18 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 			{
 				for( fpp_t frame = 0; frame < frames; ++frame )
 				{
-					m_audioBuffer[ch * frames + frame] =
+					buffer[ch * frames + frame] =
 							_in_buf[frame][ch];
 				}
 			}
 		}
 		else if( inputs == DEFAULT_CHANNELS )
 		{
-			auto target = m_audioBuffer.get();
-			copyFromSampleFrames(target, _in_buf, frames);
+			copyFromSampleFrames(buffer, _in_buf, frames);
 		}
 		else
 		{
-			auto o = (SampleFrame*)m_audioBuffer.get();
+			auto o = (SampleFrame*)buffer;
 			for( ch_cnt_t ch = 0; ch < inputs; ++ch )
 			{
 				for( fpp_t frame = 0; frame < frames; ++frame )
@@ -397,18 +382,18 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		}
 	}
 
-	lock();
-	sendMessage( IdStartProcessing );
-
-	if( m_failed || _out_buf == nullptr || m_outputCount == 0 )
+	const float* result = finishPeriod( _out_buf != nullptr );
+	if( result == nullptr )
 	{
-		unlock();
+		// a remote without outputs leaves the output untouched, so e.g.
+		// effects processing in place pass their input through
+		if( _out_buf != nullptr && m_outputCount > 0 )
+		{
+			zeroSampleFrames(_out_buf, frames);
+		}
 		return false;
 	}
 
-	waitForMessage( IdProcessingDone );
-	unlock();
-
 	const ch_cnt_t outputs = std::min<ch_cnt_t>(m_outputCount,
 							DEFAULT_CHANNELS);
 	if( m_splitChannels )
@@ -417,19 +402,19 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		{
 			for( fpp_t frame = 0; frame < frames; ++frame )
 			{
-				_out_buf[frame][ch] = m_audioBuffer[( m_inputCount+ch )*
+				_out_buf[frame][ch] = result[( m_inputCount+ch )*
 								frames + frame];
 			}
 		}
 	}
 	else if( outputs == DEFAULT_CHANNELS )
 	{
-		auto source = m_audioBuffer.get() + m_inputCount * frames;
+		auto source = result + m_inputCount * frames;
 		copyToSampleFrames(_out_buf, source, frames);
 	}
 	else
 	{
-		auto o = (SampleFrame*)(m_audioBuffer.get() + m_inputCount * frames);
+		auto o = (const SampleFrame*)(result + m_inputCount * frames);
 		// clear buffer, if plugin didn't fill up both channels
 		zeroSampleFrames(_out_buf, frames);
 
@@ -449,6 +434,208 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 
 
 
+bool RemotePlugin::process( PlanarBufferView<const float, 2> in, PlanarBufferView<float, 2> out )
+{
+	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
+	assert( in.empty() || in.frames() == frames );
+	assert( out.empty() || out.frames() == frames );
+
+	const auto clearOutput = [&]( ch_cnt_t firstChannel )
+	{
+		for( ch_cnt_t ch = firstChannel; !out.empty() && ch < out.channels(); ++ch )
+		{
+			std::fill_n( out[ch], frames, 0.0f );
+		}
+	};
+
+	if( !isReadyToProcess() )
+	{
+		clearOutput( 0 );
+		return false;
+	}
+
+	float* buffer = beginPeriod();
+
+	// with split channels the shared memory has the same layout as the
+	// planar buffers, so each channel is copied as a whole
+	const ch_cnt_t inputs = std::min<ch_cnt_t>(m_inputCount, DEFAULT_CHANNELS);
+	for( ch_cnt_t ch = 0; !in.empty() && ch < inputs; ++ch )
+	{
+		if( m_splitChannels )
+		{
+			std::copy_n( in[ch], frames, buffer + ch * frames );
+		}
+		else
+		{
+			for( fpp_t frame = 0; frame < frames; ++frame )
+			{
+				buffer[frame * DEFAULT_CHANNELS + ch] = in[ch][frame];
+			}
+		}
+	}
+
+	const float* result = finishPeriod( !out.empty() );
+	if( result == nullptr )
+	{
+		// a remote without outputs leaves the output untouched
+		if( m_outputCount > 0 )
+		{
+			clearOutput( 0 );
+		}
+		return false;
+	}
+
+	const ch_cnt_t outputs = std::min<ch_cnt_t>(m_outputCount, DEFAULT_CHANNELS);
+	const float* source = result + m_inputCount * frames;
+	for( ch_cnt_t ch = 0; ch < outputs; ++ch )
+	{
+		if( m_splitChannels )
+		{
+			std::copy_n( source + ch * frames, frames, out[ch] );
+		}
+		else
+		{
+			for( fpp_t frame = 0; frame < frames; ++frame )
+			{
+				out[ch][frame] = source[frame * DEFAULT_CHANNELS + ch];
+			}
+		}
+	}
+	// clear the channels the plugin didn't fill
+	clearOutput( outputs );
+
+	return true;
+}
+
+
+
+
+void RemotePlugin::setPipelined( bool on )
+{
+	lock();
+	if( on != m_pipelined )
+	{
+		// let the remote finish the period it's working on before the
+		// shared memory is replaced
+		waitForPendingPeriods( 0 );
+		m_pipelined = on;
+		resizeSharedProcessingMemory();
+	}
+	unlock();
+}
+
+
+
+
+f_cnt_t RemotePlugin::latency() const
+{
+	return m_pipelined ? Engine::audioEngine()->framesPerPeriod() : 0;
+}
+
+
+
+
+bool RemotePlugin::isReadyToProcess()
+{
+	if( m_failed || !isRunning() )
+	{
+		return false;
+	}
+
+	if (!m_audioBuffer)
+	{
+		// m_audioBuffer being zero means we didn't initialize everything so
+		// far so process one message each time (and hope we get
+		// information like SHM-key etc.) until we process messages
+		// in a later stage of this procedure
+		if( m_audioBufferSize == 0 )
+		{
+			lock();
+			fetchAndProcessAllMessages();
+			unlock();
+		}
+		return false;
+	}
+
+	return true;
+}
+
+
+
+
+float* RemotePlugin::beginPeriod()
+{
+	// the remote isn't using this half of the shared memory anymore: in
+	// pipelined mode, it was last processed two periods ago and collected
+	// during the previous one
+	float* buffer = m_audioBuffer.get() + m_currentHalf * m_periodBufferSize;
+	std::fill_n( buffer, m_periodBufferSize, 0.0f );
+	return buffer;
+}
+
+
+
+
+const float* RemotePlugin::finishPeriod( bool wantOutput )
+{
+	lock();
+
+	if( !m_pipelined )
+	{
+		sendMessage( IdStartProcessing );
+		++m_pendingPeriods;
+
+		if( m_failed || !wantOutput || m_outputCount == 0
+			|| !waitForPendingPeriods( 0 ) )
+		{
+			unlock();
+			return nullptr;
+		}
+
+		unlock();
+		return m_audioBuffer.get();
+	}
+
+	sendMessage( message( IdStartProcessing ).addInt( m_currentHalf ) );
+	++m_pendingPeriods;
+
+	// collect the period started during the previous call, while the remote
+	// works on the one we just started
+	const bool havePrevious = m_previousPeriodStarted;
+	m_previousPeriodStarted = true;
+	m_currentHalf = 1 - m_currentHalf;
+
+	const bool done = waitForPendingPeriods( 1 );
+	unlock();
+
+	if( m_failed || !wantOutput || m_outputCount == 0 || !havePrevious || !done )
+	{
+		return nullptr;
+	}
+
+	return m_audioBuffer.get() + m_currentHalf * m_periodBufferSize;
+}
+
+
+
+
+bool RemotePlugin::waitForPendingPeriods( int maxPending )
+{
+	while( m_pendingPeriods > maxPending )
+	{
+		if( m_failed || isInvalid()
+			|| waitForMessage( IdProcessingDone ).id != IdProcessingDone )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+
 void RemotePlugin::processMidiEvent( const MidiEvent & _e,
 							const f_cnt_t _offset )
 {
@@ -482,7 +669,9 @@ void RemotePlugin::hideUI()
 
 void RemotePlugin::resizeSharedProcessingMemory()
 {
-	const size_t s = (m_inputCount + m_outputCount) * Engine::audioEngine()->framesPerPeriod();
+	// in pipelined mode, the host fills one half while the remote processes the other
+	const size_t periodSize = (m_inputCount + m_outputCount) * Engine::audioEngine()->framesPerPeriod();
+	const size_t s = periodSize * (m_pipelined ? 2 : 1);
 	try
 	{
 		m_audioBuffer.create(s);
@@ -494,6 +683,9 @@ void RemotePlugin::resizeSharedProcessingMemory()
 		return;
 	}
 	m_audioBufferSize = s * sizeof(float);
+	m_periodBufferSize = periodSize;
+	m_currentHalf = 0;
+	m_previousPeriodStarted = false;
 	sendMessage(message(IdChangeSharedMemoryKey).addString(m_audioBuffer.key()));
 }
 
@@ -571,6 +763,13 @@ bool RemotePlugin::processMessage( const message & _m )
 			break;
 
 		case IdProcessingDone:
+			// may also be received while waiting for another reply
+			if( m_pendingPeriods > 0 )
+			{
+				--m_pendingPeriods;
+			}
+			break;
+
 		case IdQuit:
 		default:
 			break;
@@ -27,7 +27,11 @@
 
 #include "RenderManager.h"
 
+#include "AudioBusHandle.h"
+#include "InstrumentTrack.h"
+#include "Mixer.h"
 #include "PatternStore.h"
+#include "SampleTrack.h"
 #include "Song.h"
 
 
@@ -60,8 +64,11 @@ void RenderManager::abortProcessing()
 	if ( m_activeRenderer ) {
 		disconnect( m_activeRenderer.get(), SIGNAL(finished()),
 				this, SLOT(renderNextTrack()));
+		disconnect( m_activeRenderer.get(), SIGNAL(finished()),
+				this, SLOT(finishStems()));
 		m_activeRenderer->abortProcessing();
 	}
+	abortStems();
 	restoreMutedState();
 }
 
@@ -91,46 +98,110 @@ void RenderManager::renderNextTrack()
 		// for multi-render, prefix each output file with a different number
 		int trackNum = m_tracksToRender.size() + 1;
 
-		render( pathForTrack(renderTrack, trackNum) );
+		render( pathForTrack(renderTrack->name(), trackNum) );
+	}
+}
+
+// Find all currently unmuted tracks that produce audio
+std::vector<Track*> RenderManager::unmutedTracks()
+{
+	std::vector<Track*> tracks;
+	for (const TrackContainer* container : {static_cast<TrackContainer*>(Engine::getSong()),
+			static_cast<TrackContainer*>(Engine::patternStore())})
+	{
+		for (const auto& tk : container->tracks())
+		{
+			Track::Type type = tk->type();
+
+			// Don't render automation tracks
+			if ( tk->isMuted() == false &&
+					( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+			{
+				tracks.push_back(tk);
+			}
+		}
 	}
+	return tracks;
 }
 
 // Render the song into individual tracks
 void RenderManager::renderTracks()
 {
-	const TrackContainer::TrackList& tl = Engine::getSong()->tracks();
+	m_unmuted = unmutedTracks();
 
-	// find all currently unnmuted tracks -- we want to render these.
-	for (const auto& tk : tl)
+	// copy the list of unmuted tracks into our rendering queue.
+	// we need to remember which tracks were unmuted to restore state at the end.
+	m_tracksToRender = m_unmuted;
+
+	renderNextTrack();
+}
+
+// Render the song once, capturing the tracks or mixer channels along the way
+void RenderManager::renderStems(StemSource source)
+{
+	m_stems = std::make_unique<StemExporter>(m_outputSettings, m_format);
+
+	const auto addStem = [this](StemExporter::Source stem, const QString& path)
 	{
-		Track::Type type = tk->type();
+		if (!m_stems->addStem(stem, path))
+		{
+			qWarning( "Could not open %s for writing", qUtf8Printable(path) );
+		}
+	};
 
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+	if (source == StemSource::Tracks)
+	{
+		// number the tracks like renderTracks does
+		const std::vector<Track*> tracks = unmutedTracks();
+		for (std::size_t i = 0; i < tracks.size(); ++i)
 		{
-			m_unmuted.push_back(tk);
+			Track* track = tracks[i];
+			AudioBusHandle* bus = track->type() == Track::Type::Instrument
+				? static_cast<InstrumentTrack*>(track)->audioBusHandle()
+				: static_cast<SampleTrack*>(track)->audioBusHandle();
+
+			// a muted bus keeps the buffer of its last period
+			addStem({bus->buffer(), nullptr, track->getMutedModel()},
+				pathForTrack(track->name(), i + 1));
 		}
 	}
-
-	const TrackContainer::TrackList& t2 = Engine::patternStore()->tracks();
-	for (const auto& tk : t2)
+	else
 	{
-		Track::Type type = tk->type();
-
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+		// the channel buffers are taken before their fader, which is applied
+		// the same way as when the mixer sends them on
+		Mixer* mixer = Engine::mixer();
+		for (mix_ch_t i = 1; i < mixer->numChannels(); ++i)
 		{
-			m_unmuted.push_back(tk);
+			MixerChannel* channel = mixer->mixerChannel(i);
+			addStem({channel->m_buffer, &channel->m_volumeModel, &channel->m_muteModel},
+				pathForTrack(channel->m_name, i));
 		}
 	}
 
-	// copy the list of unmuted tracks into our rendering queue.
-	// we need to remember which tracks were unmuted to restore state at the end.
-	m_tracksToRender = m_unmuted;
+	Engine::audioEngine()->setStemExporter(m_stems.get());
 
-	renderNextTrack();
+	// the master mix is written next to the stems
+	render( pathForTrack(Engine::mixer()->mixerChannel(0)->m_name, 0) );
+}
+
+void RenderManager::finishStems()
+{
+	Engine::audioEngine()->setStemExporter(nullptr);
+	m_stems->finish();
+	m_stems.reset();
+
+	m_activeRenderer.reset();
+	emit finished();
+}
+
+void RenderManager::abortStems()
+{
+	if (m_stems)
+	{
+		Engine::audioEngine()->setStemExporter(nullptr);
+		m_stems->abort();
+		m_stems.reset();
+	}
 }
 
 // Render the song into a single track
@@ -156,13 +227,14 @@ void RenderManager::render(QString outputPath)
 		// when it is finished, render the next track.
 		// if we have not queued any tracks, renderNextTrack will just clean up
 		connect( m_activeRenderer.get(), SIGNAL(finished()),
-				this, SLOT(renderNextTrack()));
+				this, m_stems ? SLOT(finishStems()) : SLOT(renderNextTrack()));
 
 		m_activeRenderer->startProcessing();
 	}
 	else
 	{
 		qDebug( "Renderer failed to acquire a file device!" );
+		abortStems();
 		renderNextTrack();
 	}
 }
@@ -179,10 +251,10 @@ void RenderManager::restoreMutedState()
 }
 
 // Determine the output path for a track when rendering tracks individually
-QString RenderManager::pathForTrack(const Track *track, int num)
+QString RenderManager::pathForTrack(const QString& trackName, int num)
 {
 	QString extension = ProjectRenderer::getFileExtensionFromFormat( m_format );
-	QString name = track->name();
+	QString name = trackName;
 	name = name.remove(QRegularExpression(FILENAME_FILTER));
 	name = QString( "%1_%2%3" ).arg( num ).arg( name ).arg( extension );
 	return QDir(m_outputPath).filePath(name);
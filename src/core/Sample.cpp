@@ -24,14 +24,24 @@
 
 #include "Sample.h"
 
+#include "SampleBufferCache.h"
 #include "lmms_math.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace lmms {
 
+Sample::PlaybackState::PlaybackState(bool varyingPitch, int interpolationMode)
+	: m_resampler(interpolationMode, DEFAULT_CHANNELS)
+	, m_scratch(Engine::audioEngine()->framesPerPeriod() * s_maxScratchRatio
+		+ *std::max_element(s_interpolationMargins.begin(), s_interpolationMargins.end()))
+	, m_varyingPitch(varyingPitch)
+{
+}
+
 Sample::Sample(const QString& audioFile)
-	: m_buffer(std::make_shared<SampleBuffer>(audioFile))
+	: m_buffer(SampleBufferCache::instance().fromFile(audioFile))
 	, m_startFrame(0)
 	, m_endFrame(m_buffer->size())
 	, m_loopStartFrame(0)
@@ -40,7 +50,7 @@ Sample::Sample(const QString& audioFile)
 }
 
 Sample::Sample(const QByteArray& base64, int sampleRate)
-	: m_buffer(std::make_shared<SampleBuffer>(base64, sampleRate))
+	: m_buffer(SampleBufferCache::instance().fromBase64(QString::fromUtf8(base64), sampleRate))
 	, m_startFrame(0)
 	, m_endFrame(m_buffer->size())
 	, m_loopStartFrame(0)
@@ -133,17 +143,33 @@ bool Sample::play(SampleFrame* dst, PlaybackState* state, size_t numFrames, floa
 
 	state->m_frameIndex = std::max<int>(m_startFrame, state->m_frameIndex);
 
-	auto playBuffer = std::vector<SampleFrame>(numFrames / resampleRatio + marginSize);
-	playRaw(playBuffer.data(), playBuffer.size(), state, loopMode);
+	if (resampleRatio == 1.0f && !state->m_varyingPitch)
+	{
+		// nothing to resample, so read straight into the output
+		playRaw(dst, numFrames, state, loopMode);
+		advance(state, numFrames, loopMode);
+	}
+	else
+	{
+		const auto scratchSize = static_cast<std::size_t>(numFrames / resampleRatio) + marginSize;
+		auto& scratch = state->m_scratch;
+		if (scratch.size() < scratchSize)
+		{
+			// only for ratios beyond s_maxScratchRatio or periods larger than
+			// the audio engine's
+			scratch.resize(scratchSize);
+		}
+		playRaw(scratch.data(), scratchSize, state, loopMode);
 
-	state->resampler().setRatio(resampleRatio);
+		state->resampler().setRatio(resampleRatio);
 
-	const auto resampleResult
-		= state->resampler().resample(&playBuffer[0][0], playBuffer.size(), &dst[0][0], numFrames, resampleRatio);
-	advance(state, resampleResult.inputFramesUsed, loopMode);
+		const auto resampleResult
+			= state->resampler().resample(&scratch[0][0], scratchSize, &dst[0][0], numFrames, resampleRatio);
+		advance(state, resampleResult.inputFramesUsed, loopMode);
 
-	const auto outputFrames = static_cast<f_cnt_t>(resampleResult.outputFramesGenerated);
-	if (outputFrames < numFrames) { std::fill_n(dst + outputFrames, numFrames - outputFrames, SampleFrame{}); }
+		const auto outputFrames = static_cast<f_cnt_t>(resampleResult.outputFramesGenerated);
+		if (outputFrames < numFrames) { std::fill_n(dst + outputFrames, numFrames - outputFrames, SampleFrame{}); }
+	}
 
 	if (!approximatelyEqual(m_amplification, 1.0f))
 	{
@@ -174,43 +200,74 @@ void Sample::setAllPointFrames(int startFrame, int endFrame, int loopStartFrame,
 
 void Sample::playRaw(SampleFrame* dst, size_t numFrames, const PlaybackState* state, Loop loopMode) const
 {
-	if (m_buffer->size() < 1) { return; }
+	if (m_buffer->size() < 1)
+	{
+		std::fill_n(dst, numFrames, SampleFrame{});
+		return;
+	}
 
+	const int endFrame = m_endFrame;
+	const int loopStartFrame = m_loopStartFrame;
+	const int loopEndFrame = m_loopEndFrame;
 	auto index = state->m_frameIndex;
 	auto backwards = state->m_backwards;
 
-	for (size_t i = 0; i < numFrames; ++i)
+	// The loop points are only checked where a block of consecutive frames
+	// ends. If a block would be empty (e.g. because the loop points
+	// coincide), a single frame is copied like the loop points dictate.
+	while (numFrames > 0)
 	{
+		auto available = 0;
 		switch (loopMode)
 		{
 		case Loop::Off:
-			if (index < 0 || index >= m_endFrame) { return; }
+			if (index < 0 || index >= endFrame)
+			{
+				std::fill_n(dst, numFrames, SampleFrame{});
+				return;
+			}
+			available = backwards ? index + 1 : endFrame - index;
 			break;
 		case Loop::On:
-			if (index < m_loopStartFrame && backwards) { index = m_loopEndFrame - 1; }
-			else if (index >= m_loopEndFrame) { index = m_loopStartFrame; }
+			if (index < loopStartFrame && backwards) { index = loopEndFrame - 1; }
+			else if (index >= loopEndFrame) { index = loopStartFrame; }
+			available = backwards ? index - loopStartFrame + 1 : loopEndFrame - index;
 			break;
 		case Loop::PingPong:
-			if (index < m_loopStartFrame && backwards)
+			if (index < loopStartFrame && backwards)
 			{
-				index = m_loopStartFrame;
+				index = loopStartFrame;
 				backwards = false;
 			}
-			else if (index >= m_loopEndFrame)
+			else if (index >= loopEndFrame)
 			{
-				index = m_loopEndFrame - 1;
+				index = loopEndFrame - 1;
 				backwards = true;
 			}
-			break;
-		default:
+			available = backwards ? index - loopStartFrame + 1 : loopEndFrame - index;
 			break;
 		}
 
-		dst[i] = m_buffer->data()[m_reversed ? m_buffer->size() - index - 1 : index];
-		backwards ? --index : ++index;
+		const auto count = std::min<size_t>(numFrames, std::max(available, 1));
+		copyFrames(dst, index, count, backwards);
+
+		dst += count;
+		numFrames -= count;
+		index += backwards ? -static_cast<int>(count) : static_cast<int>(count);
 	}
 }
 
+void Sample::copyFrames(SampleFrame* dst, int index, size_t numFrames, bool backwards) const
+{
+	const auto data = m_buffer->data();
+	const bool reversed = m_reversed;
+	const auto first = reversed ? static_cast<int>(m_buffer->size()) - index - 1 : index;
+
+	// reading a reversed sample backwards walks forwards through the buffer
+	if (backwards == reversed) { std::copy_n(data + first, numFrames, dst); }
+	else { std::reverse_copy(data + first + 1 - numFrames, data + first + 1, dst); }
+}
+
 void Sample::advance(PlaybackState* state, size_t advanceAmount, Loop loopMode) const
 {
 	state->m_frameIndex += (state->m_backwards ? -1 : 1) * advanceAmount;
@@ -24,6 +24,9 @@
 
 #include "SampleBuffer.h"
 #include <cstring>
+#include <QDebug>
+
+#include "BinaryDataFile.h"
 
 #include "PathUtil.h"
 #include "SampleDecoder.h"
@@ -57,6 +60,20 @@ SampleBuffer::SampleBuffer(const QString& audioFile)
 SampleBuffer::SampleBuffer(const QString& base64, int sampleRate)
 	: m_sampleRate(sampleRate)
 {
+	// samples of binary project files are copied straight from the mapped file
+	if (const auto chunk = BinaryDataFile::findChunk(base64))
+	{
+		m_data.resize(chunk.size / sizeof(SampleFrame));
+		std::memcpy(reinterpret_cast<char*>(m_data.data()), chunk.data, m_data.size() * sizeof(SampleFrame));
+		return;
+	}
+	if (BinaryDataFile::isChunkReference(base64))
+	{
+		// the binary file it referenced has been closed, the reference isn't base64
+		qWarning() << "SampleBuffer: lost chunk" << base64;
+		return;
+	}
+
 	// TODO: Replace with non-Qt equivalent
 	const auto bytes = QByteArray::fromBase64(base64.toUtf8());
 	m_data.resize(bytes.size() / sizeof(SampleFrame));
@@ -0,0 +1,187 @@
+/*
+ * SampleBufferCache.cpp - shares the sample buffers of equal samples
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleBufferCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <algorithm>
+
+#include "BinaryDataFile.h"
+#include "ConfigManager.h"
+#include "PathUtil.h"
+#include "SampleBuffer.h"
+
+namespace lmms {
+
+namespace {
+auto bufferBytes(const SampleBuffer& buffer) -> std::size_t
+{
+	return buffer.size() * sizeof(SampleFrame);
+}
+} // namespace
+
+SampleBufferCache::SampleBufferCache()
+	// in MiB, unset by default
+	: m_budget(static_cast<std::size_t>(std::max(ConfigManager::inst()->value("app", "samplecachebudget").toInt(), 0))
+		* 1024 * 1024)
+{
+}
+
+auto SampleBufferCache::instance() -> SampleBufferCache&
+{
+	static auto s_cache = SampleBufferCache{};
+	return s_cache;
+}
+
+auto SampleBufferCache::fromFile(const QString& audioFile) -> std::shared_ptr<const SampleBuffer>
+{
+	const auto absolutePath = PathUtil::toAbsolute(audioFile);
+	const auto lastModified = QFileInfo{absolutePath}.lastModified().toMSecsSinceEpoch();
+	const auto key = "file:" + absolutePath.toUtf8() + ':' + QByteArray::number(lastModified);
+
+	if (auto buffer = find(key)) { return buffer; }
+	return insert(key, std::make_shared<const SampleBuffer>(audioFile));
+}
+
+auto SampleBufferCache::fromBase64(const QString& base64, int sampleRate) -> std::shared_ptr<const SampleBuffer>
+{
+	// hash the raw data, so samples from XML and binary projects are shared as well
+	auto bytes = QByteArray{};
+	const auto chunk = BinaryDataFile::findChunk(base64);
+	if (chunk) { bytes = QByteArray::fromRawData(chunk.data, static_cast<int>(chunk.size)); }
+	else if (BinaryDataFile::isChunkReference(base64))
+	{
+		qWarning() << "SampleBufferCache: lost chunk" << base64;
+		return SampleBuffer::emptyBuffer();
+	}
+	else { bytes = QByteArray::fromBase64(base64.toUtf8()); }
+
+	const auto hash = QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+	const auto key = "data:" + hash.toHex() + ':' + QByteArray::number(sampleRate);
+
+	if (auto buffer = find(key)) { return buffer; }
+
+	const auto frames = reinterpret_cast<const SampleFrame*>(bytes.constData());
+	return insert(key, std::make_shared<const SampleBuffer>(frames, bytes.size() / sizeof(SampleFrame), sampleRate));
+}
+
+auto SampleBufferCache::memoryUsage() const -> std::size_t
+{
+	const auto lock = std::lock_guard{m_mutex};
+	auto bytes = std::size_t{0};
+	for (const auto& entry : m_buffers)
+	{
+		if (const auto buffer = entry.lock()) { bytes += bufferBytes(*buffer); }
+	}
+	return bytes;
+}
+
+auto SampleBufferCache::budget() const -> std::size_t
+{
+	const auto lock = std::lock_guard{m_mutex};
+	return m_budget;
+}
+
+void SampleBufferCache::setBudget(std::size_t bytes)
+{
+	const auto lock = std::lock_guard{m_mutex};
+	m_budget = bytes;
+	trimRetained();
+}
+
+void SampleBufferCache::clear()
+{
+	const auto lock = std::lock_guard{m_mutex};
+	m_retained.clear();
+	m_retainedBytes = 0;
+}
+
+auto SampleBufferCache::find(const QByteArray& key) -> std::shared_ptr<const SampleBuffer>
+{
+	const auto lock = std::lock_guard{m_mutex};
+	const auto it = m_buffers.constFind(key);
+	if (it == m_buffers.constEnd()) { return nullptr; }
+
+	auto buffer = it->lock();
+	if (buffer) { retain(buffer); }
+	return buffer;
+}
+
+auto SampleBufferCache::insert(const QByteArray& key, std::shared_ptr<const SampleBuffer> buffer)
+	-> std::shared_ptr<const SampleBuffer>
+{
+	const auto lock = std::lock_guard{m_mutex};
+	auto& entry = m_buffers[key];
+	if (auto existing = entry.lock())
+	{
+		// decoded by another thread in the meantime
+		retain(existing);
+		return existing;
+	}
+
+	entry = buffer;
+	retain(buffer);
+
+	// drop the entries of freed buffers once in a while
+	if (static_cast<int>(m_buffers.size()) >= m_pruneSize)
+	{
+		for (auto it = m_buffers.begin(); it != m_buffers.end();)
+		{
+			it = it->expired() ? m_buffers.erase(it) : std::next(it);
+		}
+		m_pruneSize = std::max(64, 2 * static_cast<int>(m_buffers.size()));
+	}
+
+	return buffer;
+}
+
+void SampleBufferCache::retain(const std::shared_ptr<const SampleBuffer>& buffer)
+{
+	if (m_budget == 0) { return; }
+
+	const auto it = std::find(m_retained.begin(), m_retained.end(), buffer);
+	if (it != m_retained.end())
+	{
+		m_retained.splice(m_retained.begin(), m_retained, it);
+		return;
+	}
+
+	m_retained.push_front(buffer);
+	m_retainedBytes += bufferBytes(*buffer);
+	trimRetained();
+}
+
+void SampleBufferCache::trimRetained()
+{
+	while (m_retainedBytes > m_budget && !m_retained.empty())
+	{
+		m_retainedBytes -= bufferBytes(*m_retained.back());
+		m_retained.pop_back();
+	}
+}
+
+} // namespace lmms
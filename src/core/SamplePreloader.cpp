@@ -0,0 +1,243 @@
+/*
+ * SamplePreloader.cpp - prepares the samples of a project on the thread pool
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SamplePreloader.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <QDomElement>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "Oscillator.h"
+#include "PathUtil.h"
+#include "SampleBuffer.h"
+#include "SampleBufferCache.h"
+#include "ThreadPool.h"
+
+namespace lmms
+{
+
+SamplePreloader* SamplePreloader::s_instance = nullptr;
+
+
+int SamplePreloader::Task::wait()
+{
+	int time = 0;
+	for (const auto& job : m_jobs) { time += job.get(); }
+	return time;
+}
+
+
+
+
+SamplePreloader::SamplePreloader()
+{
+	s_instance = this;
+}
+
+
+
+
+SamplePreloader::~SamplePreloader()
+{
+	// jobs which haven't started yet return immediately
+	m_cancelled = true;
+	for (const auto& job : m_jobs) { job.wait(); }
+	s_instance = nullptr;
+}
+
+
+
+
+SamplePreloader::Task SamplePreloader::prepare(const QDomElement& track)
+{
+	auto task = Task{};
+	collect(track, task);
+	return task;
+}
+
+
+
+
+bool SamplePreloader::isActive()
+{
+	return s_instance != nullptr;
+}
+
+
+
+
+std::shared_ptr<const SampleBuffer> SamplePreloader::sampleFromFile(const QString& path)
+{
+	if (s_instance == nullptr) { return nullptr; }
+
+	const auto lock = std::lock_guard{s_instance->m_mutex};
+	return s_instance->m_files.value(PathUtil::toAbsolute(path));
+}
+
+
+
+
+std::shared_ptr<const SampleBuffer> SamplePreloader::sampleFromBase64(const QString& base64, int sampleRate)
+{
+	if (s_instance == nullptr) { return nullptr; }
+
+	const auto lock = std::lock_guard{s_instance->m_mutex};
+	auto buffer = s_instance->m_embedded.value(base64);
+	return buffer && static_cast<int>(buffer->sampleRate()) == sampleRate ? buffer : nullptr;
+}
+
+
+
+
+std::unique_ptr<OscillatorConstants::waveform_t> SamplePreloader::takeUserWaveTable(const SampleBuffer* buffer)
+{
+	if (s_instance == nullptr) { return nullptr; }
+
+	const auto lock = std::lock_guard{s_instance->m_mutex};
+	const auto it = s_instance->m_waveTables.find(buffer);
+	if (it == s_instance->m_waveTables.end()) { return nullptr; }
+
+	auto waveTable = std::move(it->second);
+	s_instance->m_waveTables.erase(it);
+	return waveTable;
+}
+
+
+
+
+void SamplePreloader::collect(const QDomElement& elem, Task& task)
+{
+	const auto tag = elem.tagName();
+	const auto sampleRate = Engine::audioEngine()->outputSampleRate();
+
+	// keep in sync with the loadSettings() of these classes
+	if (tag == "sampleclip" || tag == "audiofileprocessor" || tag == "slicert")
+	{
+		const auto dataAttribute = tag == "sampleclip" ? "data" : "sampledata";
+		if (const auto src = elem.attribute("src"); !src.isEmpty())
+		{
+			addJob({src}, task);
+		}
+		else if (const auto data = elem.attribute(dataAttribute); !data.isEmpty())
+		{
+			const auto rate = tag == "sampleclip" && elem.hasAttribute("sample_rate")
+				? elem.attribute("sample_rate").toInt()
+				: static_cast<int>(sampleRate);
+			addJob({data, true, rate}, task);
+		}
+	}
+	else if (tag == "tripleoscillator")
+	{
+		for (int i = 1; i <= 3; ++i)
+		{
+			const auto userWaveFile = elem.attribute("userwavefile" + QString::number(i));
+			if (!userWaveFile.isEmpty()) { addJob({userWaveFile, false, 0, true}, task); }
+		}
+	}
+	else if (const auto userWaveFile = elem.attribute("userwavefile"); !userWaveFile.isEmpty())
+	{
+		// envelopes and LFOs
+		addJob({userWaveFile}, task);
+	}
+
+	for (auto child = elem.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+	{
+		collect(child, task);
+	}
+}
+
+
+
+
+void SamplePreloader::addJob(Job job, Task& task)
+{
+	if (!job.embedded) { job.source = PathUtil::toAbsolute(job.source); }
+
+	auto& scheduled = job.embedded ? m_scheduledEmbedded : m_scheduledFiles;
+	if (scheduled.contains(job.source))
+	{
+		// started by this or an earlier track, which is created first
+		if (!job.waveTable) { return; }
+	}
+	scheduled.insert(job.source);
+
+	auto future = ThreadPool::instance().enqueue([this, job] { return run(job); }).share();
+	m_jobs.push_back(future);
+	task.m_jobs.push_back(std::move(future));
+}
+
+
+
+
+int SamplePreloader::run(const Job& job)
+{
+	using namespace std::chrono;
+
+	if (m_cancelled) { return 0; }
+	const auto start = steady_clock::now();
+	const auto elapsed = [start] {
+		return static_cast<int>(duration_cast<microseconds>(steady_clock::now() - start).count());
+	};
+
+	std::shared_ptr<const SampleBuffer> buffer;
+	{
+		// the same file might be used for a user wave table and a sample
+		const auto lock = std::lock_guard{m_mutex};
+		buffer = job.embedded ? m_embedded.value(job.source) : m_files.value(job.source);
+	}
+
+	if (!buffer)
+	{
+		try
+		{
+			auto& cache = SampleBufferCache::instance();
+			buffer = job.embedded ? cache.fromBase64(job.source, job.sampleRate) : cache.fromFile(job.source);
+		}
+		catch (const std::runtime_error&)
+		{
+			// the error is reported when the track loads the sample itself
+			return elapsed();
+		}
+	}
+
+	auto waveTable = std::unique_ptr<OscillatorConstants::waveform_t>{};
+	if (job.waveTable) { waveTable = Oscillator::generateAntiAliasUserWaveTable(buffer.get()); }
+
+	const auto lock = std::lock_guard{m_mutex};
+	auto& buffers = job.embedded ? m_embedded : m_files;
+	if (const auto existing = buffers.value(job.source))
+	{
+		// decoded by another job in the meantime, which may have been handed out already
+		buffer = existing;
+	}
+	else { buffers.insert(job.source, buffer); }
+	if (waveTable) { m_waveTables[buffer.get()] = std::move(waveTable); }
+
+	return elapsed();
+}
+
+
+} // namespace lmms
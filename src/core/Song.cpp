@@ -96,7 +96,7 @@ Song::Song() :
 	m_elapsedBars( 0 ),
 	m_loopRenderCount(1),
 	m_loopRenderRemaining(1),
-	m_oldAutomatedValues()
+	m_automationSchedule()
 {
 	for (double& millisecondsElapsed : m_elapsedMilliSeconds) { millisecondsElapsed = 0; }
 	connect( &m_tempoModel, SIGNAL(dataChanged()),
@@ -352,12 +352,7 @@ void Song::processNextBuffer()
 
 void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp_t)
 {
-	AutomatedValueMap values;
-
-	QSet<const AutomatableModel*> recordedModels;
-
-	TrackContainer* container = this;
-	int clipNum = -1;
+	int patternIndex = -1;
 
 	switch (m_playMode)
 	{
@@ -368,70 +363,14 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp
 		if (tracklist.empty()) { return; }
 		Q_ASSERT(tracklist.at(0)->type() == Track::Type::Pattern);
 		auto patternTrack = dynamic_cast<PatternTrack*>(tracklist.at(0));
-		container = Engine::patternStore();
-		clipNum = patternTrack->patternIndex();
+		patternIndex = patternTrack->patternIndex();
 	}
 		break;
 	default:
 		return;
 	}
 
-	values = container->automatedValuesAt(timeStart, clipNum);
-	const TrackList& tracks = container->tracks();
-
-	Track::clipVector clips;
-	for (Track* track : tracks)
-	{
-		if (track->type() == Track::Type::Automation) {
-			track->getClipsInRange(clips, 0, timeStart);
-		}
-	}
-
-	// Process recording
-	for (Clip* clip : clips)
-	{
-		auto p = dynamic_cast<AutomationClip *>(clip);
-		TimePos relTime = timeStart - p->startPosition();
-		if (p->isRecording() && relTime >= 0 && relTime < p->length())
-		{
-			const AutomatableModel* recordedModel = p->firstObject();
-			// The automation system really needs to be reworked.
-			// For whatever reason, the values in an automation clip are stored in un-un-scaled format, so if you
-			// are automating a log knob, when you draw an curve, the values being stored are not the actual values the
-			// knob will take, but instead the unscaled version of the unscaled numbers. The tooltip shows the number you expect, but if you double-click,
-			// you can see that the true values are stored by their inverse scaled value....which is wrong, since they weren't scaled in the first place...?
-			// Anyhow, in the meantime before we redo the automation system, when recording automations, we have to get the inverseScaledValue
-			// and store that so that when playing it back, it scales the value correctly.
-			p->recordValue(relTime, recordedModel->inverseScaledValue(recordedModel->value<float>()));
-
-			recordedModels << recordedModel;
-		}
-	}
-
-	// Checks if an automated model stopped being automated by automation clip
-	// so we can move the control back to any connected controller again
-	for (auto it = m_oldAutomatedValues.begin(); it != m_oldAutomatedValues.end(); it++)
-	{
-		AutomatableModel * am = it.key();
-		if (am->controllerConnection() && !values.contains(am))
-		{
-			am->setUseControllerValue(true);
-		}
-	}
-	m_oldAutomatedValues = values;
-
-	// Apply values
-	for (auto it = values.begin(); it != values.end(); it++)
-	{
-		if (! recordedModels.contains(it.key()))
-		{
-			it.key()->setAutomatedValue(it.value());
-		}
-		else if (!it.key()->useControllerValue())
-		{
-			it.key()->setUseControllerValue(true);
-		}
-	}
+	m_automationSchedule.process(timeStart, patternIndex);
 }
 
 void Song::processMetronome(size_t bufferOffset)
@@ -707,12 +646,7 @@ void Song::stop()
 
 	// Moves the control of the models that were processed on the last frame
 	// back to their controllers.
-	for (auto it = m_oldAutomatedValues.begin(); it != m_oldAutomatedValues.end(); it++)
-	{
-		AutomatableModel * am = it.key();
-		am->setUseControllerValue(true);
-	}
-	m_oldAutomatedValues.clear();
+	m_automationSchedule.releaseModels();
 
 	m_playMode = PlayMode::None;
 
@@ -911,8 +845,8 @@ void Song::clearProject()
 	m_masterPitchModel.reset();
 	m_timeSigModel.reset();
 
-	// Clear the m_oldAutomatedValues AutomatedValueMap
-	m_oldAutomatedValues.clear();
+	// Forget about the models automated so far
+	m_automationSchedule.clear();
 
 	AutomationClip::globalAutomationClip( &m_tempoModel )->clear();
 	AutomationClip::globalAutomationClip( &m_masterVolumeModel )->
@@ -1111,6 +1045,7 @@ void Song::loadProject( const QString & fileName )
 
 	QDomNodeList tclist=dataFile.content().elementsByTagName("trackcontainer");
 	m_nLoadingTrack=0;
+	m_trackLoadTimes.clear();
 	for( int i=0,n=tclist.count(); i<n; ++i )
 	{
 		QDomNode nd=tclist.at(i).firstChild();
@@ -0,0 +1,183 @@
+/*
+ * StemExporter.cpp - writes the stems of a rendered song into separate files
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "StemExporter.h"
+
+#include <QFile>
+#include <algorithm>
+
+#include "AudioFileDevice.h"
+#include "Engine.h"
+#include "ThreadPool.h"
+#include "lmms_constants.h"
+
+namespace lmms
+{
+
+
+StemExporter::StemExporter(const OutputSettings& outputSettings, ProjectRenderer::ExportFileFormat format) :
+	m_outputSettings(outputSettings),
+	m_format(format)
+{
+}
+
+
+
+
+StemExporter::~StemExporter()
+{
+	close(false);
+}
+
+
+
+
+bool StemExporter::addStem(Source source, const QString& outputPath)
+{
+	const auto factory = ProjectRenderer::fileEncodeDevices[static_cast<std::size_t>(m_format)].m_getDevInst;
+	if (!factory) { return false; }
+
+	bool successful = false;
+	auto device = std::unique_ptr<AudioFileDevice>{factory(
+		outputPath, m_outputSettings, DEFAULT_CHANNELS, Engine::audioEngine(), successful)};
+	if (!successful) { return false; }
+
+	auto stem = std::make_unique<Stem>();
+	stem->source = source;
+	stem->device = std::move(device);
+	stem->filling.resize(ChunkFrames);
+	stem->encoding.resize(ChunkFrames);
+	m_stems.push_back(std::move(stem));
+	return true;
+}
+
+
+
+
+void StemExporter::capture(fpp_t frames)
+{
+	for (auto& stem : m_stems)
+	{
+		f_cnt_t done = 0;
+		while (done < frames)
+		{
+			const auto count = std::min<f_cnt_t>(frames - done, ChunkFrames - stem->filled);
+			copyPeriod(*stem, done, count);
+			stem->filled += count;
+			done += count;
+
+			if (stem->filled == ChunkFrames) { encode(*stem); }
+		}
+	}
+}
+
+
+
+
+void StemExporter::finish()
+{
+	for (auto& stem : m_stems)
+	{
+		if (stem->filled > 0) { encode(*stem); }
+	}
+	close(false);
+}
+
+
+
+
+void StemExporter::abort()
+{
+	close(true);
+}
+
+
+
+
+void StemExporter::copyPeriod(Stem& stem, f_cnt_t offset, fpp_t frames)
+{
+	SampleFrame* dst = stem.filling.data() + stem.filled;
+	const Source& source = stem.source;
+
+	if (source.muted && source.muted->value())
+	{
+		zeroSampleFrames(dst, frames);
+		return;
+	}
+
+	std::copy_n(source.buffer + offset, frames, dst);
+	if (!source.volume) { return; }
+
+	if (const ValueBuffer* volBuf = source.volume->valueBuffer())
+	{
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			dst[f] *= volBuf->values()[offset + f];
+		}
+	}
+	else
+	{
+		const float v = source.volume->value();
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			dst[f] *= v;
+		}
+	}
+}
+
+
+
+
+void StemExporter::encode(Stem& stem)
+{
+	// the previous chunk of this stem has to be written first, after
+	// that its buffer can be filled again
+	if (stem.pending.valid()) { stem.pending.wait(); }
+
+	std::swap(stem.filling, stem.encoding);
+	const f_cnt_t frames = stem.filled;
+	stem.filled = 0;
+
+	stem.pending = ThreadPool::instance().enqueue(
+		[device = stem.device.get(), buffer = stem.encoding.data(), frames] { device->write(buffer, frames); });
+}
+
+
+
+
+void StemExporter::close(bool remove)
+{
+	for (auto& stem : m_stems)
+	{
+		if (stem->pending.valid()) { stem->pending.wait(); }
+
+		const QString file = stem->device->outputFile();
+		stem->device.reset();
+		if (remove) { QFile(file).remove(); }
+	}
+	m_stems.clear();
+}
+
+
+} // namespace lmms
@@ -33,6 +33,7 @@
 #include <QVariant>
 
 #include "AutomationClip.h"
+#include "AutomationSchedule.h"
 #include "AutomationTrack.h"
 #include "ConfigManager.h"
 #include "Engine.h"
@@ -341,6 +342,7 @@ void Track::loadSettings(const QDomElement& element)
 Clip * Track::addClip( Clip * clip )
 {
 	m_clips.push_back( clip );
+	clipsChanged();
 
 	emit clipAdded( clip );
 
@@ -360,6 +362,7 @@ void Track::removeClip( Clip * clip )
 	if( it != m_clips.end() )
 	{
 		m_clips.erase( it );
+		clipsChanged();
 		if( Engine::getSong() )
 		{
 			Engine::getSong()->updateLength();
@@ -448,6 +451,8 @@ int Track::getClipNum( const Clip * clip )
  *  the given time period.
  *
  *  We return the Clips we find in order by time, earliest Clips first.
+ *  The lookup uses the track's ClipIntervalIndex, so it only costs
+ *  O(log n + k) for k clips found.
  *
  *  \param clipV The list to contain the found clips.
  *  \param start The MIDI start time of the range.
@@ -456,17 +461,25 @@ int Track::getClipNum( const Clip * clip )
 void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
 							const TimePos & end )
 {
-	for( Clip* clip : m_clips )
+	m_clipIndex.findInRange( m_clips, clipV, start.getTicks(), end.getTicks() );
+}
+
+
+
+
+void Track::clipsChanged()
+{
+	m_clipIndex.invalidate();
+
+	switch (m_type)
 	{
-		int s = clip->startPosition();
-		int e = clip->endPosition();
-		if( ( s <= end ) && ( e >= start ) )
-		{
-			// Clip is within given range
-			// Insert sorted by Clip's position
-			clipV.insert(std::upper_bound(clipV.begin(), clipV.end(), clip, Clip::comparePosition),
-						clip);
-		}
+	case Type::Automation:
+	case Type::HiddenAutomation:
+	case Type::Pattern:
+		AutomationSchedule::invalidate();
+		break;
+	default:
+		break;
 	}
 }
 
@@ -484,6 +497,8 @@ void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
 void Track::swapPositionOfClips( int clipNum1, int clipNum2 )
 {
 	qSwap( m_clips[clipNum1], m_clips[clipNum2] );
+	// the order of clips at the same position depends on m_clips
+	clipsChanged();
 
 	const TimePos pos = m_clips[clipNum1]->startPosition();
 
@@ -24,17 +24,22 @@
  */
 
 
+#include <chrono>
+#include <optional>
+#include <vector>
 #include <QCoreApplication>
 #include <QProgressDialog>
 #include <QDomElement>
 #include <QWriteLocker>
 
 #include "AutomationClip.h"
+#include "AutomationSchedule.h"
 #include "embed.h"
 #include "TrackContainer.h"
 #include "PatternClip.h"
 #include "PatternStore.h"
 #include "PatternTrack.h"
+#include "SamplePreloader.h"
 #include "Song.h"
 
 #include "GuiApplication.h"
@@ -105,6 +110,21 @@ void TrackContainer::loadSettings( const QDomElement & _this )
 		}
 	}
 
+	// Samples and wave tables of all tracks are prepared on the thread pool,
+	// while the tracks are created one after another below. The tracks of
+	// nested containers are prepared together with their parent track.
+	std::optional<SamplePreloader> preloader;
+	std::vector<SamplePreloader::Task> tasks;
+	if (!SamplePreloader::isActive())
+	{
+		preloader.emplace();
+		for (auto elem = _this.firstChildElement(); !elem.isNull(); elem = elem.nextSiblingElement())
+		{
+			if (!elem.attribute("metadata").toInt()) { tasks.push_back(preloader->prepare(elem)); }
+		}
+	}
+	auto task = tasks.begin();
+
 	QDomNode node = _this.firstChild();
 	while( !node.isNull() )
 	{
@@ -138,7 +158,16 @@ void TrackContainer::loadSettings( const QDomElement & _this )
 				pd->setLabelText( tr("Loading Track %1 (%2/Total %3)").arg( trackName ).
 						  arg( pd->value() + 1 ).arg( Engine::getSong()->getLoadingTrackCount() ) );
 			}
+
+			using namespace std::chrono;
+			const int prepareTime = preloader ? (task++)->wait() : 0;
+			const auto start = steady_clock::now();
 			Track::create( node.toElement(), this );
+			const auto attachTime = duration_cast<microseconds>(steady_clock::now() - start).count();
+			if (preloader && Engine::getSong()->isLoadingProject())
+			{
+				Engine::getSong()->addTrackLoadTime({trackName, prepareTime, static_cast<int>(attachTime)});
+			}
 		}
 		node = node.nextSibling();
 	}
@@ -182,6 +211,7 @@ void TrackContainer::addTrack( Track * _track )
 		m_tracksMutex.lockForWrite();
 		m_tracks.push_back( _track );
 		m_tracksMutex.unlock();
+		AutomationSchedule::invalidate();
 		_track->unlock();
 		emit trackAdded( _track );
 	}
@@ -205,6 +235,7 @@ void TrackContainer::removeTrack( Track * _track )
 		}
 		m_tracks.erase(it);
 		lockTracksAccess.unlock();
+		AutomationSchedule::invalidate();
 
 		if( Engine::getSong() )
 		{
@@ -241,7 +241,6 @@ void AudioAlsa::stopProcessing()
 
 void AudioAlsa::run()
 {
-	auto temp = new SampleFrame[audioEngine()->framesPerPeriod()];
 	auto outbuf = new int_sample_t[audioEngine()->framesPerPeriod() * channels()];
 	auto pcmbuf = new int_sample_t[m_periodSize * channels()];
 
@@ -259,7 +258,8 @@ void AudioAlsa::run()
 			if( outbuf_pos == 0 )
 			{
 				// frames depend on the sample rate
-				const fpp_t frames = getNextBuffer( temp );
+				const SampleFrame* temp = nullptr;
+				const fpp_t frames = readNextBuffer( temp );
 				if( !frames )
 				{
 					quit = true;
@@ -306,7 +306,6 @@ void AudioAlsa::run()
 		}
 	}
 
-	delete[] temp;
 	delete[] outbuf;
 	delete[] pcmbuf;
 }
@@ -34,8 +34,7 @@ AudioDevice::AudioDevice( const ch_cnt_t _channels, AudioEngine*  _audioEngine )
 	m_supportsCapture( false ),
 	m_sampleRate( _audioEngine->outputSampleRate() ),
 	m_channels( _channels ),
-	m_audioEngine( _audioEngine ),
-	m_buffer(new SampleFrame[audioEngine()->framesPerPeriod()])
+	m_audioEngine( _audioEngine )
 {
 }
 
@@ -44,7 +43,6 @@ AudioDevice::AudioDevice( const ch_cnt_t _channels, AudioEngine*  _audioEngine )
 
 AudioDevice::~AudioDevice()
 {
-	delete[] m_buffer;
 	m_devMutex.tryLock();
 	unlock();
 }
@@ -54,8 +52,9 @@ AudioDevice::~AudioDevice()
 
 void AudioDevice::processNextBuffer()
 {
-	const fpp_t frames = getNextBuffer( m_buffer );
-	if (frames) { writeBuffer(m_buffer, frames); }
+	const SampleFrame* buffer = nullptr;
+	const fpp_t frames = readNextBuffer( buffer );
+	if (frames) { writeBuffer(buffer, frames); }
 	else
 	{
 		m_inProcess = false;
@@ -64,17 +63,19 @@ void AudioDevice::processNextBuffer()
 
 fpp_t AudioDevice::getNextBuffer(SampleFrame* _ab)
 {
-	fpp_t frames = audioEngine()->framesPerPeriod();
-	const SampleFrame* b = audioEngine()->nextBuffer();
+	const SampleFrame* b = nullptr;
+	const fpp_t frames = readNextBuffer(b);
 
-	if (!b) { return 0; }
-
-	memcpy(_ab, b, frames * sizeof(SampleFrame));
-
-	if (audioEngine()->hasFifoWriter()) { delete[] b; }
+	if (frames) { memcpy(_ab, b, frames * sizeof(SampleFrame)); }
 	return frames;
 }
 
+fpp_t AudioDevice::readNextBuffer(const SampleFrame*& buffer)
+{
+	buffer = audioEngine()->nextBuffer();
+	return buffer ? audioEngine()->framesPerPeriod() : 0;
+}
+
 
 
 
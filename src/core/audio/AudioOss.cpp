@@ -254,12 +254,12 @@ void AudioOss::stopProcessing()
 
 void AudioOss::run()
 {
-	auto temp = new SampleFrame[audioEngine()->framesPerPeriod()];
 	auto outbuf = new int_sample_t[audioEngine()->framesPerPeriod() * channels()];
 
 	while( true )
 	{
-		const fpp_t frames = getNextBuffer( temp );
+		const SampleFrame* temp = nullptr;
+		const fpp_t frames = readNextBuffer( temp );
 		if( !frames )
 		{
 			break;
@@ -272,7 +272,6 @@ void AudioOss::run()
 		}
 	}
 
-	delete[] temp;
 	delete[] outbuf;
 }
 
@@ -229,12 +229,10 @@ void AudioPulseAudio::run()
 	}
 	else
 	{
-		const fpp_t fpp = audioEngine()->framesPerPeriod();
-		auto temp = new SampleFrame[fpp];
-		while( getNextBuffer( temp ) )
+		const SampleFrame* temp = nullptr;
+		while( readNextBuffer( temp ) )
 		{
 		}
-		delete[] temp;
 	}
 
 	pa_context_disconnect( context );
@@ -249,13 +247,13 @@ void AudioPulseAudio::run()
 void AudioPulseAudio::streamWriteCallback( pa_stream *s, size_t length )
 {
 	const fpp_t fpp = audioEngine()->framesPerPeriod();
-	auto temp = new SampleFrame[fpp];
 	auto pcmbuf = (int_sample_t*)pa_xmalloc(fpp * channels() * sizeof(int_sample_t));
 
 	size_t fd = 0;
 	while( fd < length/4 && m_quit == false )
 	{
-		const fpp_t frames = getNextBuffer( temp );
+		const SampleFrame* temp = nullptr;
+		const fpp_t frames = readNextBuffer( temp );
 		if( !frames )
 		{
 			m_quit = true;
@@ -271,7 +269,6 @@ void AudioPulseAudio::streamWriteCallback( pa_stream *s, size_t length )
 	}
 
 	pa_xfree( pcmbuf );
-	delete[] temp;
 }
 
 
@@ -140,12 +140,12 @@ void AudioSndio::stopProcessing()
 
 void AudioSndio::run()
 {
-	SampleFrame* temp = new SampleFrame[audioEngine()->framesPerPeriod()];
 	int_sample_t * outbuf = new int_sample_t[audioEngine()->framesPerPeriod() * channels()];
 
 	while( true )
 	{
-		const fpp_t frames = getNextBuffer( temp );
+		const SampleFrame* temp = nullptr;
+		const fpp_t frames = readNextBuffer( temp );
 		if( !frames )
 		{
 			break;
@@ -158,7 +158,6 @@ void AudioSndio::run()
 		}
 	}
 
-	delete[] temp;
 	delete[] outbuf;
 }
 
@@ -368,6 +368,43 @@ void Lv2Proc::copyBuffersToCore(SampleFrame* buf,
 
 
 
+void Lv2Proc::copyBuffersFromCore(PlanarBufferView<const float, 2> buf,
+									unsigned firstChan, unsigned num)
+{
+	inPorts().m_left->copyBuffersFromCore(buf.bufferPtr(firstChan), buf.frames());
+	if (num > 1)
+	{
+		// see above
+		if (inPorts().m_right)
+		{
+			inPorts().m_right->copyBuffersFromCore(buf.bufferPtr(firstChan + 1), buf.frames());
+		}
+		else
+		{
+			inPorts().m_left->averageWithBuffersFromCore(buf.bufferPtr(firstChan + 1), buf.frames());
+		}
+	}
+}
+
+
+
+
+void Lv2Proc::copyBuffersToCore(PlanarBufferView<float, 2> buf,
+								unsigned firstChan, unsigned num) const
+{
+	outPorts().m_left->copyBuffersToCore(buf.bufferPtr(firstChan), buf.frames());
+	if (num > 1)
+	{
+		// see above
+		Lv2Ports::Audio* ap = outPorts().m_right
+			? outPorts().m_right : outPorts().m_left;
+		ap->copyBuffersToCore(buf.bufferPtr(firstChan + 1), buf.frames());
+	}
+}
+
+
+
+
 void Lv2Proc::run(fpp_t frames)
 {
 	if (m_worker)
@@ -60,6 +60,7 @@
 #include "MainApplication.h"
 #include "ConfigManager.h"
 #include "DataFile.h"
+#include "EngineBenchmark.h"
 #include "NotePlayHandle.h"
 #include "embed.h"
 #include "Engine.h"
@@ -166,9 +167,11 @@ void printHelp()
 		"  compress <in>                         Compress file <in>\n"
 		"  render <project> [options...]         Render given project file\n"
 		"  rendertracks <project> [options...]   Render each track to a different file\n"
+		"  bench <project> [options...]          Measure how fast the project renders\n"
 		"  upgrade <in> [out]                    Upgrade file <in> and save as <out>\n"
 		"                                        Standard out is used if no output file\n"
-		"                                        is specified\n"
+		"                                        is specified, an <out> ending in .mmpb\n"
+		"                                        is written in the binary format\n"
 		"  makebundle <in> [out]                 Make a project bundle from the project\n"
 		"                                        file <in> saving the resulting bundle\n"
 		"                                        as <out>\n"
@@ -209,10 +212,26 @@ void printHelp()
 		"          If not specified, render will overwrite the input file\n"
 		"          For \"rendertracks\", this might be required\n"
 		"  -p, --profile <out>            Dump profiling information to file <out>\n"
+		"          If <out> ends with .json, a Chrome trace / Perfetto file\n"
+		"          with the timing of each track and mixer channel is written\n"
+		"      --stems <source>           For \"rendertracks\", render the song\n"
+		"          only once and export a stem of each source next to the master\n"
+		"          Possible values:\n"
+		"            - tracks: every unmuted track, before the mixer\n"
+		"            - mixer: every mixer channel, after its effects and fader\n"
 		"  -s, --samplerate <samplerate>  Specify output samplerate in Hz\n"
 		"          Range: 44100 (default) to 192000\n"
 		"          Possible values: 1, 2, 4, 8\n"
-		"          Default: 2\n\n",
+		"          Default: 2\n"
+		"\nOptions for \"bench\":\n"
+		"      --buffersize <frames>      Render periods of <frames> frames\n"
+		"          Range: 32 to 256 (default)\n"
+		"  -o, --output <path>            Write the results as JSON to <path>\n"
+		"          If not specified, they are written to standard out\n"
+		"      --passes <passes>          Render the project <passes> times\n"
+		"          Default: 3\n"
+		"  -s, --samplerate <samplerate>  Specify the samplerate in Hz\n"
+		"          Range: 44100 (default) to 192000\n\n",
 		LMMS_VERSION, LMMS_PROJECT_COPYRIGHT );
 }
 
@@ -260,6 +279,11 @@ int main( int argc, char * * argv )
 	bool allowRoot = false;
 	bool renderLoop = false;
 	bool renderTracks = false;
+	bool renderStems = false;
+	bool benchmark = false;
+	int benchmarkPasses = 3;
+	fpp_t benchmarkFrames = DEFAULT_BUFFER_SIZE;
+	auto stemSource = RenderManager::StemSource::Tracks;
 	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
 
 	// first of two command-line parsing stages
@@ -286,6 +310,11 @@ int main( int argc, char * * argv )
 			coreOnly = true;
 			renderTracks = true;
 		}
+		else if (arg == "bench")
+		{
+			coreOnly = true;
+			benchmark = true;
+		}
 		else if (arg == "--allowroot")
 		{
 			allowRoot = true;
@@ -489,10 +518,76 @@ int main( int argc, char * * argv )
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 			renderOut = fileToLoad;
 		}
+		else if( arg == "bench" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				return noInputFileError();
+			}
+
+			fileToLoad = QString::fromLocal8Bit( argv[i] );
+		}
+		else if( arg == "--passes" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No number of passes specified" );
+			}
+
+			benchmarkPasses = QString( argv[i] ).toInt();
+			if( benchmarkPasses < 1 )
+			{
+				return usageError( QString( "Invalid number of passes %1" ).arg( argv[i] ) );
+			}
+		}
+		else if( arg == "--buffersize" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No buffer size specified" );
+			}
+
+			benchmarkFrames = QString( argv[i] ).toUInt();
+			if( benchmarkFrames < MINIMUM_BUFFER_SIZE || benchmarkFrames > DEFAULT_BUFFER_SIZE )
+			{
+				return usageError( QString( "Invalid buffer size %1" ).arg( argv[i] ) );
+			}
+		}
 		else if( arg == "--loop" || arg == "-l" )
 		{
 			renderLoop = true;
 		}
+		else if( arg == "--stems" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				return usageError( "No stem source specified" );
+			}
+
+			QString const source( argv[i] );
+
+			if( source == "tracks" )
+			{
+				stemSource = RenderManager::StemSource::Tracks;
+			}
+			else if( source == "mixer" )
+			{
+				stemSource = RenderManager::StemSource::MixerChannels;
+			}
+			else
+			{
+				return usageError( QString( "Invalid stem source %1" ).arg( argv[i] ) );
+			}
+			renderStems = true;
+		}
 		else if( arg == "--output" || arg == "-o" )
 		{
 			++i;
@@ -749,6 +844,49 @@ int main( int argc, char * * argv )
 
 	bool destroyEngine = false;
 
+	// measure the engine without starting the GUI or an audio device,
+	// the results are the only thing written to standard out
+	if( benchmark )
+	{
+		Engine::init( true, benchmarkFrames );
+
+		fprintf( stderr, "Loading project...\n" );
+		Engine::getSong()->loadProject( fileToLoad );
+		if( Engine::getSong()->isEmpty() )
+		{
+			fprintf( stderr, "The project %s is empty, aborting!\n", fileToLoad.toUtf8().constData() );
+			exit( EXIT_FAILURE );
+		}
+
+		fprintf( stderr, "Rendering %d passes...\n", benchmarkPasses );
+		const auto result = EngineBenchmark{os.getSampleRate(), benchmarkPasses}.run();
+		const QByteArray json = EngineBenchmark::toJson( result, fileToLoad );
+
+		int ret = EXIT_SUCCESS;
+		if( renderOut.isEmpty() )
+		{
+			fwrite( json.constData(), sizeof(char), json.size(), stdout );
+		}
+		else
+		{
+			QFile out( renderOut );
+			if( out.open( QFile::WriteOnly | QFile::Truncate ) )
+			{
+				out.write( json );
+			}
+			else
+			{
+				fprintf( stderr, "Could not open %s for writing\n", renderOut.toUtf8().constData() );
+				ret = EXIT_FAILURE;
+			}
+		}
+
+		delete app;
+		Engine::destroy();
+		NotePlayHandleManager::free();
+		return ret;
+	}
+
 	// if we have an output file for rendering, just render the song
 	// without starting the GUI
 	if( !renderOut.isEmpty() )
@@ -792,7 +930,11 @@ int main( int argc, char * * argv )
 		}
 
 		// start now!
-		if ( renderTracks )
+		if ( renderTracks && renderStems )
+		{
+			r->renderStems( stemSource );
+		}
+		else if ( renderTracks )
 		{
 			r->renderTracks();
 		}
@@ -60,6 +60,7 @@ void MidiClient::applyPortName( MidiPort* )
 
 void MidiClient::addPort( MidiPort* port )
 {
+	const auto lock = std::lock_guard{m_portsMutex};
 	m_midiPorts.push_back( port );
 }
 
@@ -73,6 +74,7 @@ void MidiClient::removePort( MidiPort* port )
 		return;
 	}
 
+	const auto lock = std::lock_guard{m_portsMutex};
 	auto it = std::find(m_midiPorts.begin(), m_midiPorts.end(), port);
 	if( it != m_midiPorts.end() )
 	{
@@ -83,6 +85,27 @@ void MidiClient::removePort( MidiPort* port )
 
 
 
+void MidiClient::dispatchInEvents( sample_rate_t sampleRate, fpp_t framesPerPeriod )
+{
+	// if a port is being added or removed right now, its events simply
+	// wait for the next period
+	auto lock = std::unique_lock{m_portsMutex, std::try_to_lock};
+	if( !lock.owns_lock() )
+	{
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	for( MidiPort* port : m_midiPorts )
+	{
+		port->dispatchInEvents( m_lastDispatch, now, sampleRate, framesPerPeriod );
+	}
+	m_lastDispatch = now;
+}
+
+
+
+
 void MidiClient::subscribeReadablePort( MidiPort*, const QString& , bool )
 {
 }
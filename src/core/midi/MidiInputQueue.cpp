@@ -0,0 +1,134 @@
+/*
+ * MidiInputQueue.cpp - timestamped queue for incoming MIDI events
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MidiInputQueue.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "MidiEventProcessor.h"
+
+namespace lmms
+{
+
+MidiInputQueue::MidiInputQueue(std::size_t capacity) :
+	m_buffer(capacity),
+	m_reader(m_buffer)
+{
+}
+
+
+
+
+bool MidiInputQueue::push(const MidiEvent& event, const TimePos& time, Clock::time_point arrival)
+{
+	const auto entry = Entry{event, time, arrival};
+
+	while (m_writeLock.test_and_set(std::memory_order_acquire)) {} // spin
+
+	const bool written = m_buffer.write(&entry, 1) == 1;
+	if (written)
+	{
+		const auto depth = m_depth.fetch_add(1, std::memory_order_relaxed) + 1;
+		if (depth > m_maxDepth.load(std::memory_order_relaxed))
+		{
+			m_maxDepth.store(depth, std::memory_order_relaxed);
+		}
+	}
+	else
+	{
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	m_writeLock.clear(std::memory_order_release);
+	return written;
+}
+
+
+
+
+void MidiInputQueue::dispatch(MidiEventProcessor& processor, Clock::time_point previousPeriod,
+	Clock::time_point periodStart, sample_rate_t sampleRate, fpp_t framesPerPeriod)
+{
+	if (m_resetRequested.exchange(false))
+	{
+		m_maxDepth = m_depth.load();
+		m_dropped = 0;
+		m_latencyCount = 0;
+		m_latencyMean = 0.;
+		m_latencySquaredDiffs = 0.;
+	}
+
+	// events pushed while dispatching are left for the next period, and the
+	// few that arrived just after the period started end up on its last frame
+	for (auto count = m_reader.read_space(); count > 0; --count)
+	{
+		const Entry entry = m_reader.read(1)[0];
+		m_depth.fetch_sub(1, std::memory_order_relaxed);
+
+		f_cnt_t offset = 0;
+		if (previousPeriod != Clock::time_point{} && entry.arrival > previousPeriod)
+		{
+			const auto frames = std::chrono::duration<double>(entry.arrival - previousPeriod).count() * sampleRate;
+			offset = static_cast<f_cnt_t>(std::min(frames, static_cast<double>(framesPerPeriod - 1)));
+		}
+
+		processor.processInEvent(entry.event, entry.time, offset);
+		recordLatency(std::chrono::duration<double>(periodStart - entry.arrival).count()
+			+ static_cast<double>(offset) / sampleRate);
+	}
+}
+
+
+
+
+MidiInputQueue::Stats MidiInputQueue::stats() const
+{
+	auto stats = Stats{};
+	stats.depth = m_depth.load(std::memory_order_relaxed);
+	stats.maxDepth = m_maxDepth.load(std::memory_order_relaxed);
+	stats.dropped = m_dropped.load(std::memory_order_relaxed);
+	stats.latency = m_latency.load(std::memory_order_relaxed);
+	stats.jitter = m_jitter.load(std::memory_order_relaxed);
+	return stats;
+}
+
+
+
+
+void MidiInputQueue::recordLatency(double seconds)
+{
+	// Welford's algorithm
+	++m_latencyCount;
+	const double delta = seconds - m_latencyMean;
+	m_latencyMean += delta / m_latencyCount;
+	m_latencySquaredDiffs += delta * (seconds - m_latencyMean);
+
+	m_latency.store(static_cast<float>(m_latencyMean * 1000.), std::memory_order_relaxed);
+	m_jitter.store(static_cast<float>(std::sqrt(m_latencySquaredDiffs / m_latencyCount) * 1000.),
+		std::memory_order_relaxed);
+}
+
+
+} // namespace lmms
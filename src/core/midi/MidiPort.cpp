@@ -149,13 +149,23 @@ void MidiPort::processInEvent( const MidiEvent& event, const TimePos& time )
 			}
 		}
 
-		m_midiEventProcessor->processInEvent( inEvent, time );
+		m_inputQueue.push( inEvent, time );
 	}
 }
 
 
 
 
+void MidiPort::dispatchInEvents( MidiInputQueue::Clock::time_point previousPeriod,
+				MidiInputQueue::Clock::time_point periodStart,
+				sample_rate_t sampleRate, fpp_t framesPerPeriod )
+{
+	m_inputQueue.dispatch( *m_midiEventProcessor, previousPeriod, periodStart, sampleRate, framesPerPeriod );
+}
+
+
+
+
 void MidiPort::processOutEvent( const MidiEvent& event, const TimePos& time )
 {
 	// When output is enabled, route midi events if the selected channel matches
@@ -44,6 +44,7 @@
 #include "ConfigManager.h"
 #include "DataFile.h"
 #include "Engine.h"
+#include "FileIndex.h"
 #include "FileRevealer.h"
 #include "FileSearch.h"
 #include "GuiApplication.h"
@@ -133,6 +134,12 @@ FileBrowser::FileBrowser(Type type, const QString& directories, const QString& f
 
 	m_previousFilterValue = "";
 
+	// Content directories can be large, so searching them is answered from an index
+	for (const auto& dir : {m_userDir, m_factoryDir})
+	{
+		if (!dir.isEmpty()) { m_indexes.push_back(FileIndex::forDirectory(dir)); }
+	}
+
 	if (m_type == Type::Favorites)
 	{
 		connect(ConfigManager::inst(), &ConfigManager::favoritesChanged, [this] {
@@ -334,6 +341,8 @@ void FileBrowser::reloadTree()
 
 	m_fileBrowserTreeWidget->clear();
 
+	for (const auto& index : m_indexes) { index->refresh(); }
+
 	auto paths = m_directories.isEmpty() ? QStringList{} : m_directories.split('*');
 
 	if (m_showUserContent && !m_showUserContent->isChecked())
@@ -1247,7 +1256,7 @@ void FileItem::determineFileType()
 	m_handling = FileHandling::NotSupported;
 
 	const QString ext = extension();
-	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" )
+	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" || ext == "mmpb" )
 	{
 		m_type = FileType::Project;
 		m_handling = FileHandling::LoadAsProject;
@@ -1331,7 +1340,7 @@ QString FileItem::extension(const QString & file )
 
 QString FileItem::defaultFilters()
 {
-	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz"};
+	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz", "*.mmpb"};
 	const auto presetFilters = QStringList{"*.xpf", "*.xml", "*.xiz", "*.lv2"};
 	const auto soundFontFilters = QStringList{"*.sf2", "*.sf3"};
 	const auto patchFilters = QStringList{"*.pat"};
@@ -32,7 +32,9 @@
 #include "FileDialog.h"
 #include "GuiApplication.h"
 #include "PathUtil.h"
+#include "SampleBufferCache.h"
 #include "SampleDecoder.h"
+#include "SamplePreloader.h"
 
 namespace lmms::gui {
 QString SampleLoader::openAudioFile(const QString& previousFile)
@@ -90,10 +92,11 @@ QString SampleLoader::openWaveformFile(const QString& previousFile)
 std::shared_ptr<const SampleBuffer> SampleLoader::createBufferFromFile(const QString& filePath)
 {
 	if (filePath.isEmpty()) { return SampleBuffer::emptyBuffer(); }
+	if (auto buffer = SamplePreloader::sampleFromFile(filePath)) { return buffer; }
 
 	try
 	{
-		return std::make_shared<SampleBuffer>(filePath);
+		return SampleBufferCache::instance().fromFile(filePath);
 	}
 	catch (const std::runtime_error& error)
 	{
@@ -105,10 +108,11 @@ std::shared_ptr<const SampleBuffer> SampleLoader::createBufferFromFile(const QSt
 std::shared_ptr<const SampleBuffer> SampleLoader::createBufferFromBase64(const QString& base64, int sampleRate)
 {
 	if (base64.isEmpty()) { return SampleBuffer::emptyBuffer(); }
+	if (auto buffer = SamplePreloader::sampleFromBase64(base64, sampleRate)) { return buffer; }
 
 	try
 	{
-		return std::make_shared<SampleBuffer>(base64, sampleRate);
+		return SampleBufferCache::instance().fromBase64(base64, sampleRate);
 	}
 	catch (const std::runtime_error& error)
 	{
@@ -31,6 +31,7 @@
 
 #include "TrackContainer.h"
 #include "AudioEngine.h"
+#include "AutomationSchedule.h"
 #include "DataFile.h"
 #include "MainWindow.h"
 #include "FileBrowser.h"
@@ -206,6 +207,8 @@ void TrackContainerView::moveTrackView( TrackView * trackView, int indexTo )
 
 	m_tc->m_tracks.erase(m_tc->m_tracks.begin() + indexFrom);
 	m_tc->m_tracks.insert(m_tc->m_tracks.begin() + indexTo, track);
+	// the track order decides which automation wins on the same position
+	AutomationSchedule::invalidate();
 	m_trackViews.move( indexFrom, indexTo );
 
 	realignTracks();
@@ -230,7 +230,7 @@ void InstrumentTrackView::createMixerLine()
 	int channelIndex = getGUI()->mixerView()->addNewChannel();
 	auto channel = Engine::mixer()->mixerChannel(channelIndex);
 
-	channel->m_name = getTrack()->name();
+	channel->setName(getTrack()->name());
 	channel->setColor(getTrack()->color());
 
 	assignMixerLine(channelIndex);
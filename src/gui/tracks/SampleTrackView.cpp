@@ -232,7 +232,7 @@ void SampleTrackView::createMixerLine()
 	int channelIndex = getGUI()->mixerView()->addNewChannel();
 	auto channel = Engine::mixer()->mixerChannel(channelIndex);
 
-	channel->m_name = getTrack()->name();
+	channel->setName(getTrack()->name());
 	channel->setColor(getTrack()->color());
 
 	assignMixerLine(channelIndex);
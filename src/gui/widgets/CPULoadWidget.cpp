@@ -98,13 +98,39 @@ void CPULoadWidget::updateCpuLoad()
 	if (new_load != m_currentLoad)
 	{
 		auto engine = Engine::audioEngine();
-		setToolTip(
+		auto toolTip =
 			tr("DSP total: %1%").arg(new_load) + "\n"
 			+ tr(" - Notes and setup: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::NoteSetup)) + "\n"
 			+ tr(" - Instruments: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Instruments)) + "\n"
 			+ tr(" - Effects: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Effects)) + "\n"
-			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing))
-		);
+			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing));
+
+		// CPU time of the most demanding tracks and mixer channels
+		const auto nodes = engine->profiler().nodeLoads(MaxNodesInToolTip);
+		if (!nodes.empty())
+		{
+			toolTip += "\n" + tr("Heaviest tracks and channels:");
+			for (const auto& node : nodes)
+			{
+				toolTip += "\n" + tr(" - %1: %2%").arg(node.name).arg(static_cast<int>(node.totalLoad()));
+			}
+		}
+
+		const auto notePool = engine->profiler().notePoolUsage();
+		toolTip += "\n" + tr("Notes: %1 of %2 in use (peak %3)")
+			.arg(notePool.used).arg(notePool.capacity).arg(notePool.highWaterMark);
+		if (notePool.dropped > 0)
+		{
+			toolTip += "\n" + tr("%1 notes dropped because too many notes were playing").arg(notePool.dropped);
+		}
+
+		if (engine->hasFifoWriter())
+		{
+			const auto& ring = engine->periodRing();
+			toolTip += "\n" + tr("Audio buffers: %1 of %2 filled, %3 underruns")
+				.arg(ring.fillLevel()).arg(ring.depth()).arg(ring.underruns());
+		}
+		setToolTip(toolTip);
 		m_currentLoad = new_load;
 		m_changed = true;
 		update();
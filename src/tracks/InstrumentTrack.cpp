@@ -754,36 +754,12 @@ bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 			cur_start -= c->startPosition() + c->startTimeOffset();
 		}
 
-		// get all notes from the given clip...
-		const NoteVector & notes = c->notes();
-		// ...and set our index to zero
-		auto nit = notes.begin();
+		const auto clipEnd = c->length() - c->startTimeOffset();
 
-		// very effective algorithm for playing notes that are
-		// posated within the current sample-frame
-
-		if( cur_start > 0 )
-		{
-			// skip notes which end before start-bar
-			while( nit != notes.end() && ( *nit )->endPos() < cur_start )
-			{
-				++nit;
-			}
-		}
-
-		while (nit != notes.end() && (*nit)->pos() < c->length() - c->startTimeOffset())
+		const auto playNote = [&](const Note* currentNote)
 		{
-			const auto currentNote = *nit;
-			// Skip any notes note at the current time pos or not overlapping with the start.
-			if (!(currentNote->pos() == cur_start
-				|| (cur_start == -c->startTimeOffset() && (*nit)->pos() < cur_start && (*nit)->endPos() > cur_start)))
-			{
-				++nit;
-				continue;
-			}
-
 			// Calculate the overlap of the note over the clip end.
-			const auto noteOverlap = std::max(0, currentNote->endPos() - (c->length() - c->startTimeOffset()));
+			const auto noteOverlap = std::max(0, currentNote->endPos() - clipEnd);
 			// If the note is a Step Note, frames will be 0 so the NotePlayHandle
 			// plays for the whole length of the sample
 			const auto noteFrames = currentNote->type() == Note::Type::Step
@@ -791,6 +767,9 @@ bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 				: (currentNote->endPos() - cur_start - noteOverlap) * frames_per_tick;
 
 			NotePlayHandle* notePlayHandle = NotePlayHandleManager::acquire(this, _offset, noteFrames, *currentNote);
+			// the pool of note play handles is exhausted
+			if (!notePlayHandle) { return; }
+
 			notePlayHandle->setPatternTrack(pattern_track);
 			// are we playing global song?
 			if( _clip_num < 0 )
@@ -802,7 +781,29 @@ bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 
 			Engine::audioEngine()->addPlayHandle( notePlayHandle );
 			played_a_note = true;
-			++nit;
+		};
+
+		// when starting to play the clip, also play the notes which began
+		// before its visible part but are still running
+		if (cur_start == -c->startTimeOffset())
+		{
+			for (const Note* currentNote : c->notesStartingBefore(cur_start))
+			{
+				if (currentNote->endPos() > cur_start && currentNote->pos() < clipEnd)
+				{
+					playNote(currentNote);
+				}
+			}
+		}
+
+		// the index of the clip remembers where we stopped in the last
+		// tick, so we only have to look at the notes starting right now
+		if (cur_start < clipEnd)
+		{
+			for (const Note* currentNote : c->notesStartingAt(cur_start))
+			{
+				playNote(currentNote);
+			}
 		}
 	}
 	unlock();
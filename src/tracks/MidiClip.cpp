@@ -114,6 +114,8 @@ void MidiClip::init()
 {
 	connect( Engine::getSong(), SIGNAL(timeSignatureChanged(int,int)),
 				this, SLOT(changeTimeSignature()));
+	// editors move notes around and emit dataChanged() afterwards
+	connect(this, &MidiClip::dataChanged, this, [this] { m_noteStartIndex.invalidate(); }, Qt::DirectConnection);
 	saveJournallingState( false );
 
 	updateLength();
@@ -125,6 +127,8 @@ void MidiClip::init()
 
 void MidiClip::updateLength()
 {
+	m_noteStartIndex.invalidate();
+
 	if( m_clipType == Type::BeatClip )
 	{
 		changeLength( beatClipLength() );
@@ -255,6 +259,7 @@ void MidiClip::rearrangeAllNotes()
 {
 	// sort notes by start time
 	std::sort(m_notes.begin(), m_notes.end(), Note::lessThan);
+	m_noteStartIndex.invalidate();
 }
 
 
@@ -0,0 +1,146 @@
+/*
+ * BasicFiltersTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "BasicFilters.h"
+
+#include <QObject>
+#include <QtTest>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "SampleFrame.h"
+
+using namespace lmms;
+
+class BasicFiltersTest : public QObject
+{
+	Q_OBJECT
+private:
+	using Filter = BasicFilters<>;
+	using Buffer = std::vector<SampleFrame>;
+
+	static constexpr int SampleRate = 44100;
+	static constexpr int FilterTypes = static_cast<int>(Filter::FilterType::Tripole) + 1;
+
+	static Buffer noise(int frames)
+	{
+		auto rng = std::mt19937{42};
+		auto values = std::uniform_real_distribution<float>{-1.f, 1.f};
+		Buffer buf(frames);
+		for (auto& frame : buf) { frame = SampleFrame(values(rng), values(rng)); }
+		return buf;
+	}
+
+	//! Filters frames @p begin to @p end of @p buf sample by sample, like
+	//! before the block API existed
+	static void update(Filter& filter, Buffer& buf, std::size_t begin, std::size_t end)
+	{
+		for (auto frame = begin; frame < end; ++frame)
+		{
+			buf[frame].setLeft(filter.update(buf[frame].left(), 0));
+			buf[frame].setRight(filter.update(buf[frame].right(), 1));
+		}
+	}
+
+private slots:
+	//! With constant cutoff and resonance, the block kernels have to match
+	//! update() for every filter type, including the double filters
+	void testMatchesUpdate()
+	{
+		for (int type = 0; type < FilterTypes; ++type)
+		{
+			// an odd number of frames, so the last frame isn't part of a pair
+			const Buffer input = noise(301);
+
+			auto reference = Filter{SampleRate};
+			reference.setFilterType(static_cast<Filter::FilterType>(type));
+			reference.calcFilterCoeffs(800.f, 2.f);
+			Buffer expected = input;
+			update(reference, expected, 0, expected.size());
+
+			auto constant = Filter{SampleRate};
+			constant.setFilterType(static_cast<Filter::FilterType>(type));
+			Buffer actual = input;
+			constant.process(actual.data(), 200, 800.f, 2.f);
+			constant.process(actual.data() + 200, 101, 800.f, 2.f);
+
+			auto modulated = Filter{SampleRate};
+			modulated.setFilterType(static_cast<Filter::FilterType>(type));
+			const std::vector<float> freq(input.size(), 800.f);
+			const std::vector<float> q(input.size(), 2.f);
+			Buffer actualModulated = input;
+			modulated.process(actualModulated.data(), 301, freq.data(), q.data());
+
+			for (std::size_t frame = 0; frame < input.size(); ++frame)
+			{
+				for (int ch = 0; ch < 2; ++ch)
+				{
+					if (actual[frame][ch] != expected[frame][ch] || actualModulated[frame][ch] != expected[frame][ch])
+					{
+						QFAIL(qPrintable(QString{"filter type %1 differs at frame %2"}.arg(type).arg(frame)));
+					}
+				}
+			}
+		}
+	}
+
+	//! A cutoff step has to be smoothed instead of changing the coefficients
+	//! at once, and the smoothing has to settle within a few milliseconds
+	void testSmoothsCutoffSteps()
+	{
+		const Buffer input = noise(SampleRate / 10);
+
+		auto smoothed = Filter{SampleRate};
+		smoothed.setFilterType(Filter::FilterType::LowPass);
+		Buffer actual = input;
+		smoothed.process(actual.data(), 64, 200.f, 1.f);
+		smoothed.process(actual.data() + 64, static_cast<fpp_t>(input.size() - 64), 5000.f, 1.f);
+
+		auto stepped = Filter{SampleRate};
+		stepped.setFilterType(Filter::FilterType::LowPass);
+		stepped.calcFilterCoeffs(200.f, 1.f);
+		Buffer expected = input;
+		update(stepped, expected, 0, 64);
+		stepped.calcFilterCoeffs(5000.f, 1.f);
+		update(stepped, expected, 64, expected.size());
+
+		for (int frame = 0; frame < 64; ++frame)
+		{
+			QCOMPARE(actual[frame].left(), expected[frame].left());
+		}
+		QVERIFY(std::abs(actual[64].left() - expected[64].left()) > 1e-4f);
+		QVERIFY(std::abs(actual[65].left() - expected[65].left()) > 1e-4f);
+
+		// the difference in the filter state fades out once the smoothing has settled
+		for (std::size_t frame = input.size() - 100; frame < input.size(); ++frame)
+		{
+			QVERIFY(std::abs(actual[frame].left() - expected[frame].left()) < 1e-4f);
+			QVERIFY(std::abs(actual[frame].right() - expected[frame].right()) < 1e-4f);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(BasicFiltersTest)
+#include "BasicFiltersTest.moc"
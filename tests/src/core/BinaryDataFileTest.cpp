@@ -0,0 +1,162 @@
+/*
+ * BinaryDataFileTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QBuffer>
+#include <QObject>
+#include <QTextStream>
+#include <QtTest>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "BinaryDataFile.h"
+#include "DataFile.h"
+#include "SampleBuffer.h"
+
+class BinaryDataFileTest : public QObject
+{
+	Q_OBJECT
+private:
+	//! Creates a song with the embedded sample @p base64
+	static lmms::DataFile song(const QString& base64)
+	{
+		using namespace lmms;
+
+		auto dataFile = DataFile{DataFile::Type::SongProject};
+		auto track = dataFile.createElement("track");
+		track.setAttribute("name", QString::fromUtf8("Sämple"));
+		dataFile.content().appendChild(track);
+
+		auto clip = dataFile.createElement("sampleclip");
+		clip.setAttribute("data", base64);
+		clip.setAttribute("len", 192);
+		track.appendChild(clip);
+		track.appendChild(dataFile.createComment("comment"));
+		track.appendChild(dataFile.createCDATASection("<cdata>"));
+		return dataFile;
+	}
+
+	static QString toXml(lmms::DataFile& dataFile)
+	{
+		QString xml;
+		QTextStream ts(&xml);
+		dataFile.write(ts);
+		return xml;
+	}
+
+	static QByteArray toBinary(lmms::DataFile& dataFile)
+	{
+		QByteArray bytes;
+		QBuffer buffer(&bytes);
+		buffer.open(QIODevice::WriteOnly);
+		if (!lmms::BinaryDataFile::write(dataFile, buffer)) { return {}; }
+		return bytes;
+	}
+
+private slots:
+	void testRoundTrip()
+	{
+		using namespace lmms;
+
+		std::vector<SampleFrame> frames(1000);
+		for (std::size_t i = 0; i < frames.size(); ++i) { frames[i] = SampleFrame(i * 0.001f, -(i * 0.001f)); }
+		const auto base64 = SampleBuffer{frames.data(), frames.size(), 44100}.toBase64();
+
+		auto original = song(base64);
+		const auto xml = toXml(original);
+		const auto binary = toBinary(original);
+		QVERIFY(BinaryDataFile::isBinary(binary));
+		QVERIFY(binary.size() < xml.toUtf8().size());
+
+		auto loaded = DataFile{binary};
+		QCOMPARE(loaded.type(), DataFile::Type::SongProject);
+
+		// the sample is only referenced until it is needed
+		const auto clip = loaded.content().firstChildElement("track").firstChildElement("sampleclip");
+		QVERIFY(BinaryDataFile::isChunkReference(clip.attribute("data")));
+		QCOMPARE(clip.attribute("len"), QString{"192"});
+
+		const auto chunk = BinaryDataFile::findChunk(clip.attribute("data"));
+		QVERIFY(static_cast<bool>(chunk));
+		QCOMPARE(reinterpret_cast<std::uintptr_t>(chunk.data) % BinaryDataFile::ChunkAlignment, std::uintptr_t{0});
+
+		const auto buffer = SampleBuffer{clip.attribute("data"), 44100};
+		QCOMPARE(buffer.size(), frames.size());
+		QVERIFY(std::equal(frames.begin(), frames.end(), buffer.data(), [](const auto& a, const auto& b) {
+			return a.left() == b.left() && a.right() == b.right();
+		}));
+
+		// writing a loaded binary file again copies its chunks, and XML gets the original text back
+		QCOMPARE(toBinary(loaded).size(), binary.size());
+		auto reloaded = DataFile{toXml(loaded).toUtf8()};
+		const auto track = reloaded.content().firstChildElement("track");
+		QCOMPARE(track.attribute("name"), QString::fromUtf8("Sämple"));
+		QCOMPARE(track.firstChildElement("sampleclip").attribute("data"), base64);
+		QCOMPARE(track.childNodes().count(), 3);
+		QVERIFY(track.childNodes().item(1).isComment());
+		QCOMPARE(track.childNodes().item(2).toCDATASection().data(), QString{"<cdata>"});
+	}
+
+	void testReferencesExpire()
+	{
+		using namespace lmms;
+
+		auto original = song(QString::fromLatin1(QByteArray(64, 'x').toBase64()));
+		QString reference;
+		{
+			auto loaded = DataFile{toBinary(original)};
+			reference = loaded.content().firstChildElement("track").firstChildElement("sampleclip").attribute("data");
+			QVERIFY(static_cast<bool>(BinaryDataFile::findChunk(reference)));
+		}
+		QVERIFY(!BinaryDataFile::findChunk(reference));
+
+		// an expired reference must neither be decoded as base64 nor be saved as an empty sample
+		QCOMPARE(SampleBuffer(reference, 44100).size(), std::size_t{0});
+		auto dangling = song(reference);
+		QVERIFY(toBinary(dangling).isEmpty());
+	}
+
+	void testRejectsCorruptFiles()
+	{
+		using namespace lmms;
+
+		auto original = song(QString{});
+		const auto binary = toBinary(original);
+
+		QDomDocument doc;
+		QString error;
+		QVERIFY(BinaryDataFile::read(binary, doc, &error) != nullptr);
+		QVERIFY(BinaryDataFile::read(binary.left(binary.size() - 1), doc, &error) == nullptr);
+		QVERIFY(!error.isEmpty());
+
+		auto damaged = binary;
+		damaged[damaged.size() / 2] = '\xff';
+		damaged[damaged.size() / 2 + 1] = '\xff';
+		BinaryDataFile::read(damaged, doc, &error); // must not crash
+	}
+};
+
+QTEST_GUILESS_MAIN(BinaryDataFileTest)
+#include "BinaryDataFileTest.moc"
@@ -0,0 +1,136 @@
+/*
+ * BufferManagerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "BufferManager.h"
+
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "SampleFrame.h"
+
+using lmms::BufferManager;
+using lmms::SampleFrame;
+
+class BufferManagerTest : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr lmms::fpp_t FramesPerPeriod = 256;
+
+private slots:
+	void initTestCase()
+	{
+		BufferManager::init(FramesPerPeriod);
+	}
+
+	void testBuffersAreAlignedAndCleared()
+	{
+		SampleFrame* buf = BufferManager::acquire();
+		QCOMPARE(reinterpret_cast<std::uintptr_t>(buf) % 64, std::uintptr_t{0});
+		QVERIFY(std::all_of(buf, buf + FramesPerPeriod, [](const SampleFrame& f) {
+			return f.left() == 0.f && f.right() == 0.f;
+		}));
+
+		buf[0] = SampleFrame(1.f, 1.f);
+		BufferManager::release(buf);
+		buf = BufferManager::acquire();
+		QCOMPARE(buf[0].left(), 0.f);
+		BufferManager::release(buf);
+	}
+
+	//! The play handles and audio buses of a busy project acquire and
+	//! release their buffers every period, without touching the heap
+	void testNoHeapAllocationsPerPeriod()
+	{
+		const auto heapAllocations = BufferManager::heapAllocations();
+
+		std::vector<SampleFrame*> buffers;
+		for (int period = 0; period < 1000; ++period)
+		{
+			for (int i = 0; i < 100; ++i) { buffers.push_back(BufferManager::acquire()); }
+			for (auto buf : buffers) { BufferManager::release(buf); }
+			buffers.clear();
+		}
+
+		QCOMPARE(BufferManager::heapAllocations(), heapAllocations);
+	}
+
+	void testNoHeapAllocationsWithThreads()
+	{
+		const auto heapAllocations = BufferManager::heapAllocations();
+
+		// buffers acquired by one thread and released by another end up in
+		// the magazine of the releasing thread and have to find their way back
+		std::vector<SampleFrame*> handedOver(200);
+		std::thread producer([&] {
+			for (auto& buf : handedOver) { buf = BufferManager::acquire(); }
+		});
+		producer.join();
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&, t] {
+				for (int i = t; i < 200; i += 4) { BufferManager::release(handedOver[i]); }
+
+				std::vector<SampleFrame*> buffers;
+				for (int round = 0; round < 1000; ++round)
+				{
+					for (int i = 0; i < 20; ++i) { buffers.push_back(BufferManager::acquire()); }
+					for (auto buf : buffers) { BufferManager::release(buf); }
+					buffers.clear();
+				}
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+
+		QCOMPARE(BufferManager::heapAllocations(), heapAllocations);
+	}
+
+	void testFallsBackToHeapWhenExhausted()
+	{
+		const auto heapAllocations = BufferManager::heapAllocations();
+
+		std::vector<SampleFrame*> buffers;
+		for (std::size_t i = 0; i < BufferManager::capacity() + 10; ++i)
+		{
+			buffers.push_back(BufferManager::acquire());
+		}
+		QCOMPARE(BufferManager::heapAllocations(), heapAllocations + 10);
+		QCOMPARE(BufferManager::heapBuffersInUse(), std::size_t{10});
+
+		std::sort(buffers.begin(), buffers.end());
+		QVERIFY(std::adjacent_find(buffers.begin(), buffers.end()) == buffers.end());
+
+		for (auto buf : buffers) { BufferManager::release(buf); }
+		QCOMPARE(BufferManager::heapBuffersInUse(), std::size_t{0});
+	}
+};
+
+QTEST_GUILESS_MAIN(BufferManagerTest)
+#include "BufferManagerTest.moc"
@@ -0,0 +1,173 @@
+/*
+ * EffectChainTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "EffectChain.h"
+
+#include <QtTest>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "Effect.h"
+#include "Engine.h"
+#include "SampleFrame.h"
+
+using namespace lmms;
+
+namespace
+{
+
+Plugin::Descriptor testEffectDescriptor =
+{
+	"testeffect", "Test effect", "", "", 0x0100, Plugin::Type::Effect, nullptr, nullptr, nullptr
+};
+
+//! Scales the left channel and adds an offset to the right one, so the
+//! results depend on the order of the effects
+class TestEffect : public Effect
+{
+public:
+	TestEffect(BufferLayout layout, float offset) :
+		Effect(&testEffectDescriptor, nullptr, nullptr),
+		m_layout(layout),
+		m_offset(offset)
+	{
+		startRunning();
+	}
+
+	BufferLayout bufferLayout() const override { return m_layout; }
+	EffectControls* controls() override { return nullptr; }
+
+	static void apply(float& left, float& right, float offset)
+	{
+		left *= 0.5f;
+		right += offset;
+	}
+
+	int calls = 0;
+	//! the left channel of the last planar buffer processed
+	const float* planarLeft = nullptr;
+
+protected:
+	ProcessStatus processImpl(SampleFrame* buf, const fpp_t frames) override
+	{
+		++calls;
+		for (fpp_t f = 0; f < frames; ++f) { apply(buf[f][0], buf[f][1], m_offset); }
+		return ProcessStatus::Continue;
+	}
+
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> buf) override
+	{
+		++calls;
+		planarLeft = buf[0];
+		for (f_cnt_t f = 0; f < buf.frames(); ++f) { apply(buf[0][f], buf[1][f], m_offset); }
+		return ProcessStatus::Continue;
+	}
+
+private:
+	BufferLayout m_layout;
+	float m_offset;
+};
+
+} // namespace
+
+class EffectChainTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		Engine::destroy();
+	}
+
+	void testMixedLayouts()
+	{
+		using Layout = Effect::BufferLayout;
+		const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
+
+		EffectChain chain(nullptr);
+		std::vector<TestEffect*> effects{
+			new TestEffect(Layout::Planar, 1.f),
+			new TestEffect(Layout::Planar, 2.f),
+			new TestEffect(Layout::Interleaved, 3.f),
+			new TestEffect(Layout::Planar, 4.f),
+			new TestEffect(Layout::Interleaved, 5.f)
+		};
+		for (auto effect : effects) { chain.appendEffect(effect); }
+
+		auto rng = std::mt19937{1};
+		auto values = std::uniform_real_distribution<float>{-1.f, 1.f};
+		std::vector<SampleFrame> buf(frames);
+		for (auto& frame : buf) { frame = SampleFrame(values(rng), values(rng)); }
+
+		auto expected = buf;
+		for (auto& frame : expected)
+		{
+			for (float offset : {1.f, 2.f, 3.f, 4.f, 5.f}) { TestEffect::apply(frame[0], frame[1], offset); }
+		}
+
+		QVERIFY(chain.processAudioBuffer(buf.data(), frames, true));
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			QCOMPARE(buf[f].left(), expected[f].left());
+			QCOMPARE(buf[f].right(), expected[f].right());
+		}
+
+		// every effect processed its own layout, and neighbouring planar
+		// effects shared one planar buffer
+		for (auto effect : effects) { QCOMPARE(effect->calls, 1); }
+		QVERIFY(effects[0]->planarLeft != nullptr);
+		QCOMPARE(effects[1]->planarLeft, effects[0]->planarLeft);
+	}
+
+	void testConvertsForSingleEffects()
+	{
+		const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
+		std::vector<SampleFrame> buf(frames, SampleFrame(1.f, 1.f));
+
+		// effects called directly with the other layout convert the buffer themselves
+		TestEffect planar(Effect::BufferLayout::Planar, 1.f);
+		QVERIFY(planar.processAudioBuffer(buf.data(), frames));
+		QCOMPARE(planar.calls, 1);
+		QCOMPARE(buf[frames - 1].left(), 0.5f);
+		QCOMPARE(buf[frames - 1].right(), 2.f);
+
+		std::vector<float> samples(2 * frames, 1.f);
+		std::array<float*, 2> channels{samples.data(), samples.data() + frames};
+		TestEffect interleaved(Effect::BufferLayout::Interleaved, 1.f);
+		QVERIFY(interleaved.processAudioBuffer(PlanarBufferView<float, 2>{channels.data(), frames}));
+		QCOMPARE(interleaved.calls, 1);
+		QCOMPARE(channels[0][frames - 1], 0.5f);
+		QCOMPARE(channels[1][frames - 1], 2.f);
+	}
+};
+
+QTEST_GUILESS_MAIN(EffectChainTest)
+#include "EffectChainTest.moc"
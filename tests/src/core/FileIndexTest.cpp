@@ -0,0 +1,113 @@
+/*
+ * FileIndexTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "FileIndex.h"
+
+class FileIndexTest : public QObject
+{
+	Q_OBJECT
+private:
+	void createFile(const QString& path)
+	{
+		QDir{m_library}.mkpath(QFileInfo{QDir{m_library}.filePath(path)}.absolutePath());
+		QFile file(QDir{m_library}.filePath(path));
+		QVERIFY(file.open(QIODevice::WriteOnly));
+	}
+
+	auto names(const std::vector<lmms::FileIndex::Match>& matches) const -> QStringList
+	{
+		auto result = QStringList{};
+		for (const auto& match : matches) { result << QDir{m_library}.relativeFilePath(match.path); }
+		return result;
+	}
+
+	QTemporaryDir m_directory;
+	QString m_library;
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		QVERIFY(m_directory.isValid());
+		FileIndex::setCacheDirectory(m_directory.filePath("cache"));
+		m_library = m_directory.filePath("library");
+
+		createFile("Kick.wav");
+		createFile("drums/kick_hard.wav");
+		createFile("drums/snare.wav");
+		createFile("loops/bigkick loop.ogg");
+		createFile("loops/kick.txt");
+	}
+
+	void testRanking()
+	{
+		using namespace lmms;
+		const auto index = FileIndex::forDirectory(m_library);
+		index->wait();
+		QVERIFY(index->isReady());
+
+		QCOMPARE(names(index->search("kick", {"wav", "ogg"})),
+			(QStringList{"Kick.wav", "drums/kick_hard.wav", "loops/bigkick loop.ogg"}));
+		QCOMPARE(names(index->search("KICK", {"wav"}, {QDir{m_library}.filePath("drums")})), QStringList{"Kick.wav"});
+		QCOMPARE(names(index->search("dr", {"wav"})), QStringList{"drums"});
+		QVERIFY(index->search("hihat", {"wav"}).empty());
+	}
+
+	void testWatcher()
+	{
+		using namespace lmms;
+		const auto index = FileIndex::forDirectory(m_library);
+		index->wait();
+		// deliver the directories to watch
+		QCoreApplication::processEvents();
+
+		createFile("drums/kick_soft.wav");
+		QTRY_VERIFY(names(index->search("kick_", {"wav"})).contains("drums/kick_soft.wav"));
+
+		QVERIFY(QFile::remove(QDir{m_library}.filePath("drums/kick_hard.wav")));
+		QTRY_VERIFY(!names(index->search("kick_", {"wav"})).contains("drums/kick_hard.wav"));
+	}
+
+	//! The index is saved and loaded again instead of crawling the library
+	void testPersistence()
+	{
+		using namespace lmms;
+		QVERIFY(!FileIndex::find(m_library));
+		QCOMPARE(QDir{m_directory.filePath("cache/fileindex")}.entryList(QDir::Files).size(), 1);
+
+		const auto index = FileIndex::forDirectory(m_library);
+		index->wait();
+		QCOMPARE(names(index->search("kick", {"wav"})), (QStringList{"Kick.wav", "drums/kick_soft.wav"}));
+	}
+};
+
+QTEST_GUILESS_MAIN(FileIndexTest)
+#include "FileIndexTest.moc"
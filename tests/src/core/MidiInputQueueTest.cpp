@@ -0,0 +1,164 @@
+/*
+ * MidiInputQueueTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MidiInputQueue.h"
+
+#include <QObject>
+#include <QtTest>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "MidiEventProcessor.h"
+
+using lmms::MidiInputQueue;
+
+class MidiInputQueueTest : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr lmms::sample_rate_t SampleRate = 48000;
+	static constexpr lmms::fpp_t FramesPerPeriod = 256;
+
+	struct Recorder : public lmms::MidiEventProcessor
+	{
+		struct Received
+		{
+			int key;
+			lmms::f_cnt_t offset;
+		};
+		std::vector<Received> events;
+
+		void processInEvent(const lmms::MidiEvent& event, const lmms::TimePos&, lmms::f_cnt_t offset) override
+		{
+			events.push_back({event.key(), offset});
+		}
+		void processOutEvent(const lmms::MidiEvent&, const lmms::TimePos&, lmms::f_cnt_t) override {}
+	};
+
+	static lmms::MidiEvent noteOn(int key)
+	{
+		return lmms::MidiEvent(lmms::MidiNoteOn, 0, key, 100);
+	}
+
+	static MidiInputQueue::Clock::duration frames(int count)
+	{
+		return std::chrono::duration_cast<MidiInputQueue::Clock::duration>(
+			std::chrono::duration<double>(static_cast<double>(count) / SampleRate));
+	}
+
+private slots:
+	//! Events keep their distance within the period, one period later
+	void testFrameOffsets()
+	{
+		MidiInputQueue queue;
+		Recorder recorder;
+		const auto previous = MidiInputQueue::Clock::now();
+		const auto start = previous + frames(FramesPerPeriod);
+
+		queue.push(noteOn(1), {}, previous + frames(10));
+		queue.push(noteOn(2), {}, previous + frames(100));
+		// arrived while the period was being dispatched
+		queue.push(noteOn(3), {}, start + frames(50));
+		QCOMPARE(queue.stats().depth, std::size_t{3});
+
+		queue.dispatch(recorder, previous, start, SampleRate, FramesPerPeriod);
+		QCOMPARE(recorder.events.size(), std::size_t{3});
+		QCOMPARE(recorder.events[0].key, 1);
+		QVERIFY(std::abs(static_cast<int>(recorder.events[0].offset) - 10) <= 1);
+		QVERIFY(std::abs(static_cast<int>(recorder.events[1].offset) - 100) <= 1);
+		QCOMPARE(recorder.events[2].offset, static_cast<lmms::f_cnt_t>(FramesPerPeriod - 1));
+
+		const auto stats = queue.stats();
+		QCOMPARE(stats.depth, std::size_t{0});
+		QCOMPARE(stats.maxDepth, std::size_t{3});
+	}
+
+	void testFirstPeriodStartsAtZero()
+	{
+		MidiInputQueue queue;
+		Recorder recorder;
+		const auto now = MidiInputQueue::Clock::now();
+		queue.push(noteOn(1), {}, now);
+		queue.dispatch(recorder, {}, now + frames(20), SampleRate, FramesPerPeriod);
+		QCOMPARE(recorder.events.size(), std::size_t{1});
+		QCOMPARE(recorder.events[0].offset, lmms::f_cnt_t{0});
+	}
+
+	//! With sample-accurate offsets, the latency is one period for every event
+	void testLatencyAndJitter()
+	{
+		MidiInputQueue queue;
+		Recorder recorder;
+		auto previous = MidiInputQueue::Clock::now();
+		for (int period = 0; period < 10; ++period)
+		{
+			const auto start = previous + frames(FramesPerPeriod);
+			for (int i = 0; i < 4; ++i) { queue.push(noteOn(i), {}, previous + frames(i * 60 + period)); }
+			queue.dispatch(recorder, previous, start, SampleRate, FramesPerPeriod);
+			previous = start;
+		}
+
+		const auto stats = queue.stats();
+		const float periodLength = 1000.f * FramesPerPeriod / SampleRate;
+		QVERIFY(std::abs(stats.latency - periodLength) < 0.05f);
+		QVERIFY(stats.jitter < 0.05f);
+	}
+
+	void testDropsWhenFull()
+	{
+		MidiInputQueue queue(8);
+		std::size_t pushed = 0;
+		while (queue.push(noteOn(1), {})) { ++pushed; }
+		QVERIFY(pushed >= 8);
+		QCOMPARE(queue.stats().dropped, std::size_t{1});
+
+		Recorder recorder;
+		queue.resetStats();
+		queue.dispatch(recorder, {}, MidiInputQueue::Clock::now(), SampleRate, FramesPerPeriod);
+		QCOMPARE(recorder.events.size(), pushed);
+		QCOMPARE(queue.stats().dropped, std::size_t{0});
+	}
+
+	void testMultipleWriters()
+	{
+		MidiInputQueue queue(4096);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&queue, t] {
+				for (int i = 0; i < 500; ++i) { queue.push(noteOn(t), {}); }
+			});
+		}
+		for (auto& thread : threads) { thread.join(); }
+
+		Recorder recorder;
+		queue.dispatch(recorder, {}, MidiInputQueue::Clock::now(), SampleRate, FramesPerPeriod);
+		QCOMPARE(recorder.events.size(), std::size_t{2000});
+		QCOMPARE(queue.stats().dropped, std::size_t{0});
+	}
+};
+
+QTEST_GUILESS_MAIN(MidiInputQueueTest)
+#include "MidiInputQueueTest.moc"
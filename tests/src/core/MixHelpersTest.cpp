@@ -0,0 +1,235 @@
+/*
+ * MixHelpersTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpers.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "SampleFrame.h"
+#include "ValueBuffer.h"
+
+using namespace lmms;
+using namespace lmms::MixHelpers;
+
+Q_DECLARE_METATYPE(lmms::MixHelpers::SimdLevel)
+
+class MixHelpersTest : public QObject
+{
+	Q_OBJECT
+private:
+	using Buffer = std::vector<SampleFrame>;
+
+	//! Runs every dispatched kernel on copies of @p dst and returns the results
+	static std::vector<Buffer> runKernels(const Buffer& dst, const Buffer& src, ValueBuffer& buf1, ValueBuffer& buf2)
+	{
+		const int frames = static_cast<int>(src.size());
+		std::vector<Buffer> results;
+		const auto run = [&](auto kernel) {
+			Buffer out = dst;
+			kernel(out.data());
+			results.push_back(out);
+		};
+
+		run([&](SampleFrame* out) { add(out, src.data(), frames); });
+		run([&](SampleFrame* out) { addMultiplied(out, src.data(), 0.3f, frames); });
+		run([&](SampleFrame* out) { addMultipliedByBuffer(out, src.data(), 0.7f, &buf1, frames); });
+		run([&](SampleFrame* out) { addMultipliedByBuffers(out, src.data(), &buf1, &buf2, frames); });
+		run([&](SampleFrame* out) { addSanitizedMultiplied(out, src.data(), 0.3f, frames); });
+		run([&](SampleFrame* out) { addSanitizedMultipliedByBuffer(out, src.data(), 0.7f, &buf1, frames); });
+		run([&](SampleFrame* out) { addSanitizedMultipliedByBuffers(out, src.data(), &buf1, &buf2, frames); });
+		run([&](SampleFrame* out) { out[0] = SampleFrame(sanitize(out, frames)); });
+		run([&](SampleFrame* out) { out[0] = SampleFrame(isSilent(src.data() + 6, frames - 6)); });
+		return results;
+	}
+
+	static bool bitEqual(const Buffer& a, const Buffer& b)
+	{
+		return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(SampleFrame)) == 0;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		setNaNHandler(true);
+		qDebug() << "Supported SIMD level:" << static_cast<int>(supportedSimdLevel());
+	}
+
+	void cleanup()
+	{
+		setSimdLevel(supportedSimdLevel());
+	}
+
+	void testSetSimdLevel()
+	{
+		setSimdLevel(SimdLevel::Scalar);
+		QCOMPARE(simdLevel(), SimdLevel::Scalar);
+		setSimdLevel(SimdLevel::Avx512);
+		QCOMPARE(simdLevel(), supportedSimdLevel());
+	}
+
+	//! The SIMD kernels keep the order of operations of the scalar ones, so
+	//! their results have to be bit-exact, including the odd frames at the end
+	//! of a buffer and the handling of infs and NaNs
+	void testMatchesScalar()
+	{
+		auto rng = std::mt19937{42};
+		auto values = std::uniform_real_distribution<float>{-2000.f, 2000.f};
+
+		for (int frames : {7, 8, 9, 31, 64, 257})
+		{
+			Buffer src(frames);
+			Buffer dst(frames);
+			ValueBuffer buf1(frames);
+			ValueBuffer buf2(frames);
+			for (auto& frame : src) { frame = SampleFrame(values(rng), values(rng)); }
+			for (auto& frame : dst) { frame = SampleFrame(values(rng), values(rng)); }
+			for (int i = 0; i < frames; ++i)
+			{
+				buf1.values()[i] = values(rng) / 1000.f;
+				buf2.values()[i] = values(rng) / 1000.f;
+			}
+
+			// quiet samples for isSilent, and bad ones for the sanitized kernels
+			for (int i = 6; i < frames - 1; ++i) { src[i] = SampleFrame(1e-8f, -1e-8f); }
+			src[2].setRight(std::numeric_limits<float>::infinity());
+			src[4].setLeft(std::numeric_limits<float>::quiet_NaN());
+			dst[3].setLeft(-0.f);
+
+			setSimdLevel(SimdLevel::Scalar);
+			const auto expected = runKernels(dst, src, buf1, buf2);
+
+			for (auto level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512})
+			{
+				setSimdLevel(level);
+				if (simdLevel() != level) { continue; }
+
+				const auto actual = runKernels(dst, src, buf1, buf2);
+				for (std::size_t kernel = 0; kernel < expected.size(); ++kernel)
+				{
+					if (!bitEqual(actual[kernel], expected[kernel]))
+					{
+						QFAIL(qPrintable(QString{"kernel %1 differs at level %2 for %3 frames"}
+							.arg(kernel).arg(static_cast<int>(level)).arg(frames)));
+					}
+				}
+			}
+		}
+	}
+
+	void testSanitize()
+	{
+		Buffer buf(33, SampleFrame(0.5f));
+		buf[5] = SampleFrame(5000.f, -5000.f);
+		QVERIFY(!sanitize(buf.data(), static_cast<int>(buf.size())));
+		QCOMPARE(buf[5].left(), 1000.f);
+		QCOMPARE(buf[5].right(), -1000.f);
+
+		buf[30].setRight(std::numeric_limits<float>::infinity());
+		QVERIFY(sanitize(buf.data(), static_cast<int>(buf.size())));
+		QVERIFY(std::all_of(buf.begin(), buf.end(), [](const SampleFrame& f) { return f.left() == 0.f; }));
+	}
+
+	void testSanitizePlanar()
+	{
+		// an odd number of frames, so the SIMD kernels also clamp a remainder
+		std::vector<float> samples(2 * 33, 0.5f);
+		std::array<float*, 2> channels{samples.data(), samples.data() + 33};
+		const auto buf = PlanarBufferView<float, 2>{channels.data(), 33};
+
+		channels[0][32] = 5000.f;
+		channels[1][4] = -5000.f;
+		QVERIFY(!sanitize(buf));
+		QCOMPARE(channels[0][32], 1000.f);
+		QCOMPARE(channels[1][4], -1000.f);
+
+		channels[1][32] = std::numeric_limits<float>::quiet_NaN();
+		QVERIFY(sanitize(buf));
+		QVERIFY(std::all_of(samples.begin(), samples.end(), [](float s) { return s == 0.f; }));
+	}
+
+	void benchmarkKernels_data()
+	{
+		QTest::addColumn<SimdLevel>("level");
+		QTest::addColumn<int>("kernel");
+
+		const char* levels[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+		const char* kernels[] = {"add", "addSanitizedMultiplied", "addSanitizedMultipliedByBuffers", "sanitize",
+			"isSilent"};
+		for (int level = 0; level <= static_cast<int>(supportedSimdLevel()); ++level)
+		{
+			for (int kernel = 0; kernel < 5; ++kernel)
+			{
+				QTest::addRow("%s %s", kernels[kernel], levels[level]) << static_cast<SimdLevel>(level) << kernel;
+			}
+		}
+	}
+
+	//! Mixes periods of 256 frames like the mixer channels do, and reports
+	//! the throughput in frames per second
+	void benchmarkKernels()
+	{
+		QFETCH(SimdLevel, level);
+		QFETCH(int, kernel);
+
+		constexpr int Frames = 256;
+		constexpr int Periods = 1000;
+		Buffer src(Frames, SampleFrame(0.5f, -0.25f));
+		Buffer dst(Frames);
+		ValueBuffer buf(Frames);
+		std::fill_n(buf.values(), Frames, 0.5f);
+		setSimdLevel(level);
+
+		qint64 iterations = 0;
+		QElapsedTimer timer;
+		timer.start();
+		QBENCHMARK
+		{
+			for (int period = 0; period < Periods; ++period)
+			{
+				switch (kernel)
+				{
+				case 0: add(dst.data(), src.data(), Frames); break;
+				case 1: addSanitizedMultiplied(dst.data(), src.data(), 0.5f, Frames); break;
+				case 2: addSanitizedMultipliedByBuffers(dst.data(), src.data(), &buf, &buf, Frames); break;
+				case 3: sanitize(src.data(), Frames); break;
+				case 4: QVERIFY(!isSilent(src.data(), Frames)); break;
+				}
+			}
+			++iterations;
+		}
+		const auto seconds = timer.nsecsElapsed() / 1e9;
+		qDebug() << qPrintable(QString::number(iterations * Periods * Frames / seconds / 1e6, 'f', 1)) << "Mframes/s";
+	}
+};
+
+QTEST_GUILESS_MAIN(MixHelpersTest)
+#include "MixHelpersTest.moc"
@@ -0,0 +1,273 @@
+/*
+ * OscillatorTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Oscillator.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "AutomatableModel.h"
+#include "Engine.h"
+#include "MixHelpers.h"
+
+using namespace lmms;
+
+Q_DECLARE_METATYPE(lmms::MixHelpers::SimdLevel)
+
+class OscillatorTest : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr int NumOscillators = 3;
+
+	//! One channel of a voice, chained like the oscillators of TripleOscillator
+	struct Chain
+	{
+		Chain(const std::array<int, NumOscillators>& shapes, const std::array<int, NumOscillators>& algos,
+			float frequency, bool useWaveTable)
+			: freq{frequency}
+		{
+			const float sampleRate = Engine::audioEngine()->outputSampleRate();
+			for (int i = NumOscillators - 1; i >= 0; --i)
+			{
+				shape[i].setRange(0, Oscillator::NumWaveShapes - 1);
+				shape[i].setValue(shapes[i]);
+				algo[i].setRange(0, Oscillator::NumModulationAlgos - 1);
+				algo[i].setValue(algos[i]);
+				detuning[i] = (1.f + 0.5f * i) / sampleRate;
+				volume[i] = 0.3f;
+				osc[i] = std::make_unique<Oscillator>(&shape[i], &algo[i], freq, detuning[i], phaseOffset[i],
+					volume[i], i == NumOscillators - 1 ? nullptr : osc[i + 1].get());
+				osc[i]->setUseWaveTable(useWaveTable);
+			}
+		}
+
+		std::array<IntModel, NumOscillators> shape;
+		std::array<IntModel, NumOscillators> algo;
+		float freq;
+		std::array<float, NumOscillators> detuning{};
+		std::array<float, NumOscillators> phaseOffset{};
+		std::array<float, NumOscillators> volume{};
+		std::array<std::unique_ptr<Oscillator>, NumOscillators> osc;
+	};
+
+	struct Voice
+	{
+		Voice(const std::array<int, NumOscillators>& shapes, const std::array<int, NumOscillators>& algos,
+			bool useWaveTable, float frequency = 44100.f / 64)
+			: left{shapes, algos, frequency, useWaveTable}
+			, right{shapes, algos, frequency, useWaveTable}
+		{
+		}
+
+		void renderInterleaved(SampleFrame* buffer, fpp_t frames)
+		{
+			left.osc[0]->update(buffer, frames, 0);
+			right.osc[0]->update(buffer, frames, 1);
+		}
+
+		void renderPlanar(float* samples, fpp_t frames)
+		{
+			auto channels = std::array{samples, samples + frames};
+			Oscillator::update(*left.osc[0], *right.osc[0], PlanarBufferView<float, 2>{channels.data(), frames});
+		}
+
+		Chain left;
+		Chain right;
+	};
+
+	//! Renders some periods of a voice with the planar update, both channels one after another
+	static std::vector<float> renderPlanar(const std::array<int, NumOscillators>& shapes,
+		const std::array<int, NumOscillators>& algos, bool useWaveTable, fpp_t frames, int periods)
+	{
+		auto voice = Voice{shapes, algos, useWaveTable};
+		std::vector<float> out(2 * frames * periods);
+		for (int period = 0; period < periods; ++period)
+		{
+			voice.renderPlanar(out.data() + 2 * frames * period, frames);
+		}
+		return out;
+	}
+
+	//! All combinations of the shapes which are deterministic and modulation algorithms, each row
+	//! holding the shapes of the three oscillators followed by their modulation algorithms
+	static std::vector<std::array<int, 2 * NumOscillators>> combinations()
+	{
+		constexpr int NumShapes = static_cast<int>(Oscillator::WaveShape::WhiteNoise);
+		std::vector<std::array<int, 2 * NumOscillators>> result;
+		for (int shape = 0; shape < NumShapes; ++shape)
+		{
+			for (int algo1 = 0; algo1 < static_cast<int>(Oscillator::NumModulationAlgos); ++algo1)
+			{
+				for (int algo2 = 0; algo2 < static_cast<int>(Oscillator::NumModulationAlgos); ++algo2)
+				{
+					result.push_back({shape, (shape + 1) % NumShapes, (shape + 3) % NumShapes, algo1, algo2, 0});
+				}
+			}
+		}
+		return result;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		MixHelpers::setSimdLevel(MixHelpers::supportedSimdLevel());
+		Engine::destroy();
+	}
+
+	//! The planar update only differs from the interleaved one in rounding: it computes the phases from
+	//! the start of each block instead of accumulating them and interpolates with another formula
+	void testMatchesInterleaved()
+	{
+		constexpr fpp_t Frames = 100;
+		constexpr int Periods = 4;
+
+		for (bool useWaveTable : {false, true})
+		{
+			for (const auto& c : combinations())
+			{
+				const auto shapes = std::array{c[0], c[1], c[2]};
+				const auto algos = std::array{c[3], c[4], c[5]};
+				auto voice = Voice{shapes, algos, useWaveTable};
+				const auto planar = renderPlanar(shapes, algos, useWaveTable, Frames, Periods);
+
+				std::vector<SampleFrame> interleaved(Frames);
+				for (int period = 0; period < Periods; ++period)
+				{
+					voice.renderInterleaved(interleaved.data(), Frames);
+					const float* left = planar.data() + 2 * Frames * period;
+					const float* right = left + Frames;
+					for (fpp_t frame = 0; frame < Frames; ++frame)
+					{
+						if (std::abs(interleaved[frame].left() - left[frame]) > 1e-5f
+							|| std::abs(interleaved[frame].right() - right[frame]) > 1e-5f)
+						{
+							QFAIL(qPrintable(QString{"shapes %1 %2 %3, algorithms %4 %5 differ at frame %6"}
+								.arg(c[0]).arg(c[1]).arg(c[2]).arg(c[3]).arg(c[4]).arg(period * Frames + frame)));
+						}
+					}
+				}
+			}
+		}
+	}
+
+	//! The SIMD kernels keep the order of operations of the scalar ones, so the planar update
+	//! must give bit-exact results at all SIMD levels
+	void testSimdMatchesScalar()
+	{
+		// not a multiple of the vector widths, to include the scalar tails of the kernels
+		constexpr fpp_t Frames = 203;
+		constexpr int Periods = 2;
+
+		for (const auto& c : combinations())
+		{
+			const auto shapes = std::array{c[0], c[1], c[2]};
+			const auto algos = std::array{c[3], c[4], c[5]};
+
+			MixHelpers::setSimdLevel(MixHelpers::SimdLevel::Scalar);
+			const auto expected = renderPlanar(shapes, algos, true, Frames, Periods);
+
+			for (auto level : {MixHelpers::SimdLevel::Sse2, MixHelpers::SimdLevel::Avx2})
+			{
+				MixHelpers::setSimdLevel(level);
+				if (MixHelpers::simdLevel() != level) { continue; }
+
+				const auto actual = renderPlanar(shapes, algos, true, Frames, Periods);
+				if (std::memcmp(actual.data(), expected.data(), expected.size() * sizeof(float)) != 0)
+				{
+					QFAIL(qPrintable(QString{"shapes %1 %2 %3, algorithms %4 %5 differ at level %6"}
+						.arg(c[0]).arg(c[1]).arg(c[2]).arg(c[3]).arg(c[4]).arg(static_cast<int>(level))));
+				}
+			}
+		}
+		MixHelpers::setSimdLevel(MixHelpers::supportedSimdLevel());
+	}
+
+	void benchmarkVoices_data()
+	{
+		QTest::addColumn<bool>("planar");
+		QTest::addColumn<MixHelpers::SimdLevel>("level");
+
+		QTest::addRow("interleaved") << false << MixHelpers::supportedSimdLevel();
+		const char* levels[] = {"scalar", "SSE2", "AVX2"};
+		const auto supported = std::min(MixHelpers::supportedSimdLevel(), MixHelpers::SimdLevel::Avx2);
+		for (int level = 0; level <= static_cast<int>(supported); ++level)
+		{
+			QTest::addRow("planar %s", levels[level]) << true << static_cast<MixHelpers::SimdLevel>(level);
+		}
+	}
+
+	//! Renders a voice of three mixed band-limited oscillators per channel in periods of 256 frames,
+	//! the default TripleOscillator patch with other wave shapes, and reports how many of these voices
+	//! a single core can render in real time
+	void benchmarkVoices()
+	{
+		QFETCH(bool, planar);
+		QFETCH(MixHelpers::SimdLevel, level);
+
+		constexpr fpp_t Frames = 256;
+		constexpr int Periods = 1000;
+		const int mix = static_cast<int>(Oscillator::ModulationAlgo::SignalMix);
+		const auto shapes = std::array{static_cast<int>(Oscillator::WaveShape::Saw),
+			static_cast<int>(Oscillator::WaveShape::Square), static_cast<int>(Oscillator::WaveShape::Triangle)};
+		auto voice = Voice{shapes, {mix, mix, mix}, true, 261.63f};
+		std::vector<SampleFrame> interleaved(Frames);
+		std::vector<float> samples(2 * Frames);
+		MixHelpers::setSimdLevel(level);
+
+		qint64 iterations = 0;
+		QElapsedTimer timer;
+		timer.start();
+		QBENCHMARK
+		{
+			for (int period = 0; period < Periods; ++period)
+			{
+				if (planar) { voice.renderPlanar(samples.data(), Frames); }
+				else { voice.renderInterleaved(interleaved.data(), Frames); }
+			}
+			++iterations;
+		}
+		const auto seconds = timer.nsecsElapsed() / 1e9;
+		const auto frames = static_cast<double>(iterations) * Periods * Frames;
+		qDebug() << qPrintable(QString::number(frames / seconds / Engine::audioEngine()->outputSampleRate(), 'f', 1))
+			<< "voices per core";
+		MixHelpers::setSimdLevel(MixHelpers::supportedSimdLevel());
+	}
+};
+
+QTEST_GUILESS_MAIN(OscillatorTest)
+#include "OscillatorTest.moc"
@@ -0,0 +1,125 @@
+/*
+ * PeriodRingTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PeriodRing.h"
+
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "SampleFrame.h"
+
+using lmms::PeriodRing;
+using lmms::SampleFrame;
+
+class PeriodRingTest : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr lmms::fpp_t Frames = 64;
+
+	static void writePeriod(PeriodRing& ring, float value)
+	{
+		SampleFrame* buffer = ring.beginWrite();
+		std::fill_n(buffer, Frames, SampleFrame(value));
+		ring.endWrite();
+	}
+
+private slots:
+	void testReadInOrder()
+	{
+		PeriodRing ring(3, Frames);
+		writePeriod(ring, 1.f);
+		writePeriod(ring, 2.f);
+		writePeriod(ring, 3.f);
+		QCOMPARE(ring.fillLevel(), std::size_t{3});
+
+		QCOMPARE(ring.read()[0].left(), 1.f);
+		// the period being read still occupies its slot
+		QCOMPARE(ring.fillLevel(), std::size_t{3});
+		QCOMPARE(ring.read()[Frames - 1].left(), 2.f);
+		QCOMPARE(ring.fillLevel(), std::size_t{2});
+
+		writePeriod(ring, 4.f);
+		ring.close();
+		QCOMPARE(ring.read()[0].left(), 3.f);
+		QCOMPARE(ring.read()[0].left(), 4.f);
+		QVERIFY(ring.read() == nullptr);
+		QCOMPARE(ring.fillLevel(), std::size_t{0});
+		QCOMPARE(ring.underruns(), std::size_t{0});
+	}
+
+	//! The writer renders ahead and blocks while the ring is full, the
+	//! reader blocks while it is empty, just like the fifo writer and the
+	//! audio device do
+	void testWriterAndReaderThreads()
+	{
+		constexpr int Periods = 10000;
+		PeriodRing ring(4, Frames);
+
+		for (int round = 0; round < 3; ++round)
+		{
+			ring.reopen();
+			std::thread writer([&] {
+				for (int i = 0; i < Periods; ++i) { writePeriod(ring, static_cast<float>(i)); }
+				ring.close();
+				ring.waitUntilRead();
+			});
+
+			int read = 0;
+			int outOfOrder = 0;
+			while (const SampleFrame* buffer = ring.read())
+			{
+				if (buffer[0].left() != read || buffer[Frames - 1].left() != read) { ++outOfOrder; }
+				++read;
+			}
+			writer.join();
+
+			QCOMPARE(read, Periods);
+			QCOMPARE(outOfOrder, 0);
+			QCOMPARE(ring.fillLevel(), std::size_t{0});
+		}
+	}
+
+	void testCountsUnderruns()
+	{
+		PeriodRing ring(2, Frames);
+		std::thread writer([&] {
+			// give the reader time to find the ring empty
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			writePeriod(ring, 1.f);
+			ring.close();
+		});
+
+		QCOMPARE(ring.read()[0].left(), 1.f);
+		writer.join();
+		QVERIFY(ring.read() == nullptr);
+		QCOMPARE(ring.underruns(), std::size_t{1});
+	}
+};
+
+QTEST_GUILESS_MAIN(PeriodRingTest)
+#include "PeriodRingTest.moc"
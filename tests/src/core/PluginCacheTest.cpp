@@ -0,0 +1,117 @@
+/*
+ * PluginCacheTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "PluginCache.h"
+
+class PluginCacheTest : public QObject
+{
+	Q_OBJECT
+private:
+	static void writeLibrary(const QString& fileName, const QByteArray& content)
+	{
+		QFile file(fileName);
+		QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		file.write(content);
+	}
+
+	QTemporaryDir m_directory;
+
+private slots:
+	void initTestCase()
+	{
+		QVERIFY(m_directory.isValid());
+		lmms::PluginCache::setDirectory(m_directory.filePath("cache"));
+	}
+
+	void testWarmStart()
+	{
+		using namespace lmms;
+		const auto library = m_directory.filePath("libfoo.so");
+		writeLibrary(library, "foo");
+
+		{
+			PluginCache cache("warm");
+			QVERIFY(!cache.find(QFileInfo(library)));
+			cache.insert(QFileInfo(library), QJsonObject{{"plugin", true}});
+			QCOMPARE(cache.statistics().probed, 1);
+		}
+
+		PluginCache cache("warm");
+		const auto entry = cache.find(QFileInfo(library));
+		QVERIFY(entry);
+		QCOMPARE((*entry)["plugin"].toBool(), true);
+		QVERIFY(cache.statistics().warm());
+	}
+
+	//! Libraries which were rebuilt have to be probed again
+	void testChangedLibrary()
+	{
+		using namespace lmms;
+		const auto library = m_directory.filePath("libbar.so");
+		writeLibrary(library, "bar");
+
+		{
+			PluginCache cache("changed");
+			cache.insert(QFileInfo(library), QJsonObject{{"plugin", false}});
+		}
+
+		writeLibrary(library, "rebuilt bar");
+		PluginCache cache("changed");
+		QVERIFY(!cache.find(QFileInfo(library)));
+		QVERIFY(!cache.statistics().warm());
+	}
+
+	//! Entries of libraries which are gone are dropped when saving
+	void testRemovedLibrary()
+	{
+		using namespace lmms;
+		const auto kept = m_directory.filePath("libkept.so");
+		const auto removed = m_directory.filePath("libremoved.so");
+		writeLibrary(kept, "kept");
+		writeLibrary(removed, "removed");
+
+		{
+			PluginCache cache("removed");
+			cache.insert(QFileInfo(kept), QJsonObject{});
+			cache.insert(QFileInfo(removed), QJsonObject{});
+		}
+		{
+			PluginCache cache("removed");
+			QVERIFY(cache.find(QFileInfo(kept)));
+		}
+
+		PluginCache cache("removed");
+		QVERIFY(cache.find(QFileInfo(kept)));
+		QVERIFY(!cache.find(QFileInfo(removed)));
+	}
+};
+
+QTEST_GUILESS_MAIN(PluginCacheTest)
+#include "PluginCacheTest.moc"
@@ -0,0 +1,118 @@
+/*
+ * SampleBufferCacheTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QObject>
+#include <QtTest>
+
+#include <vector>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "SampleBuffer.h"
+#include "SampleBufferCache.h"
+
+class SampleBufferCacheTest : public QObject
+{
+	Q_OBJECT
+private:
+	static QString sample(int numFrames, float value)
+	{
+		std::vector<lmms::SampleFrame> frames(numFrames, lmms::SampleFrame(value));
+		return lmms::SampleBuffer{frames.data(), frames.size(), 44100}.toBase64();
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void cleanup()
+	{
+		using namespace lmms;
+		SampleBufferCache::instance().setBudget(0);
+	}
+
+	void testSharesEqualSamples()
+	{
+		using namespace lmms;
+
+		auto& cache = SampleBufferCache::instance();
+		const auto data = sample(100, 0.5f);
+		const auto usage = cache.memoryUsage();
+
+		const auto first = cache.fromBase64(data, 44100);
+		const auto second = cache.fromBase64(data, 44100);
+		QCOMPARE(first, second);
+		QCOMPARE(first->size(), std::size_t{100});
+		QCOMPARE(cache.memoryUsage(), usage + 100 * sizeof(SampleFrame));
+
+		QVERIFY(cache.fromBase64(data, 48000) != first);
+		QVERIFY(cache.fromBase64(sample(100, 0.25f), 44100) != first);
+	}
+
+	void testBuffersAreWeaklyReferenced()
+	{
+		using namespace lmms;
+
+		auto& cache = SampleBufferCache::instance();
+		const auto data = sample(200, 0.75f);
+		const auto usage = cache.memoryUsage();
+		{
+			const auto buffer = cache.fromBase64(data, 44100);
+			QCOMPARE(cache.memoryUsage(), usage + 200 * sizeof(SampleFrame));
+		}
+		QCOMPARE(cache.memoryUsage(), usage);
+	}
+
+	void testBudget()
+	{
+		using namespace lmms;
+
+		auto& cache = SampleBufferCache::instance();
+		cache.setBudget(300 * sizeof(SampleFrame));
+		const auto usage = cache.memoryUsage();
+
+		const SampleBuffer* first = cache.fromBase64(sample(200, 0.1f), 44100).get();
+		QCOMPARE(cache.memoryUsage(), usage + 200 * sizeof(SampleFrame));
+		QCOMPARE(cache.fromBase64(sample(200, 0.1f), 44100).get(), first);
+
+		// the least recently used buffer is freed when the budget is exceeded
+		cache.fromBase64(sample(200, 0.2f), 44100);
+		QCOMPARE(cache.memoryUsage(), usage + 200 * sizeof(SampleFrame));
+
+		cache.clear();
+		QCOMPARE(cache.memoryUsage(), usage);
+	}
+};
+
+QTEST_GUILESS_MAIN(SampleBufferCacheTest)
+#include "SampleBufferCacheTest.moc"
@@ -0,0 +1,94 @@
+/*
+ * SamplePreloaderTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QDomDocument>
+#include <QObject>
+#include <QtTest>
+
+#include <vector>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "SampleBuffer.h"
+#include "SampleLoader.h"
+#include "SamplePreloader.h"
+
+class SamplePreloaderTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testEmbeddedSamples()
+	{
+		using namespace lmms;
+
+		std::vector<SampleFrame> frames(100, SampleFrame(0.25f, -0.5f));
+		const auto base64 = SampleBuffer{frames.data(), frames.size(), 48000}.toBase64();
+
+		auto doc = QDomDocument{};
+		auto track = doc.createElement("track");
+		for (int i = 0; i < 2; ++i)
+		{
+			auto clip = doc.createElement("sampleclip");
+			clip.setAttribute("data", base64);
+			clip.setAttribute("sample_rate", 48000);
+			track.appendChild(clip);
+		}
+
+		QVERIFY(!SamplePreloader::isActive());
+		{
+			auto preloader = SamplePreloader{};
+			QVERIFY(SamplePreloader::isActive());
+
+			auto task = preloader.prepare(track);
+			QVERIFY(task.wait() >= 0);
+
+			// both clips share the buffer decoded once on the thread pool
+			const auto prepared = SamplePreloader::sampleFromBase64(base64, 48000);
+			QVERIFY(prepared != nullptr);
+			QCOMPARE(prepared->size(), frames.size());
+			QCOMPARE(prepared->data()[99].right(), -0.5f);
+			QCOMPARE(gui::SampleLoader::createBufferFromBase64(base64, 48000), prepared);
+
+			// a different sample rate needs a buffer of its own
+			QVERIFY(SamplePreloader::sampleFromBase64(base64, 44100) == nullptr);
+		}
+		QVERIFY(!SamplePreloader::isActive());
+		QVERIFY(SamplePreloader::sampleFromBase64(base64, 48000) == nullptr);
+	}
+};
+
+QTEST_GUILESS_MAIN(SamplePreloaderTest)
+#include "SamplePreloaderTest.moc"
@@ -0,0 +1,120 @@
+/*
+ * SampleTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <vector>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "Sample.h"
+
+class SampleTest : public QObject
+{
+	Q_OBJECT
+private:
+	static std::vector<lmms::SampleFrame> ramp(int numFrames)
+	{
+		std::vector<lmms::SampleFrame> frames(numFrames);
+		for (int i = 0; i < numFrames; ++i) { frames[i] = lmms::SampleFrame(i + 1.f, -(i + 1.f)); }
+		return frames;
+	}
+
+	//! Plays @p sample at its own rate in periods of @p period frames and
+	//! returns the indices of the frames played (0 for silence)
+	static std::vector<int> playIndices(const lmms::Sample& sample, lmms::Sample::Loop loopMode, int numFrames,
+		int period)
+	{
+		using namespace lmms;
+
+		auto state = Sample::PlaybackState{};
+		std::vector<SampleFrame> out(numFrames);
+		for (int offset = 0; offset < numFrames; offset += period)
+		{
+			sample.play(out.data() + offset, &state, std::min(period, numFrames - offset), DefaultBaseFreq, loopMode);
+		}
+
+		std::vector<int> indices;
+		for (const auto& frame : out) { indices.push_back(static_cast<int>(frame.left())); }
+		return indices;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testLoopModes()
+	{
+		using namespace lmms;
+
+		const auto frames = ramp(8);
+		auto sample = Sample{frames.data(), frames.size(), static_cast<int>(Engine::audioEngine()->outputSampleRate())};
+		sample.setAllPointFrames(0, 8, 2, 5);
+
+		// the period length must not matter
+		for (int period : {1, 3, 7, 64})
+		{
+			QCOMPARE(playIndices(sample, Sample::Loop::Off, 12, period),
+				(std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0}));
+			QCOMPARE(playIndices(sample, Sample::Loop::On, 12, period),
+				(std::vector<int>{1, 2, 3, 4, 5, 3, 4, 5, 3, 4, 5, 3}));
+			QCOMPARE(playIndices(sample, Sample::Loop::PingPong, 12, period),
+				(std::vector<int>{1, 2, 3, 4, 5, 5, 4, 3, 3, 4, 5, 5}));
+		}
+
+		sample.setReversed(true);
+		QCOMPARE(playIndices(sample, Sample::Loop::Off, 10, 4), (std::vector<int>{8, 7, 6, 5, 4, 3, 2, 1, 0, 0}));
+		QCOMPARE(playIndices(sample, Sample::Loop::On, 10, 4), (std::vector<int>{8, 7, 6, 5, 4, 6, 5, 4, 6, 5}));
+	}
+
+	void testResampledPlayback()
+	{
+		using namespace lmms;
+
+		const auto frames = ramp(1000);
+		auto sample = Sample{frames.data(), frames.size(), static_cast<int>(Engine::audioEngine()->outputSampleRate())};
+		auto state = Sample::PlaybackState{};
+		std::vector<SampleFrame> out(256);
+
+		// an octave up reads twice the frames
+		QVERIFY(sample.play(out.data(), &state, out.size(), DefaultBaseFreq * 2));
+		QVERIFY(state.frameIndex() > 400);
+		QVERIFY(out.back().left() > 400.f);
+
+		while (sample.play(out.data(), &state, out.size(), DefaultBaseFreq * 2)) {}
+		QVERIFY(state.frameIndex() >= sample.endFrame());
+	}
+};
+
+QTEST_GUILESS_MAIN(SampleTest)
+#include "SampleTest.moc"
@@ -0,0 +1,118 @@
+/*
+ * VoiceArenaTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "VoiceArena.h"
+
+#include <QObject>
+#include <QtTest>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace lmms;
+
+class VoiceArenaTest : public QObject
+{
+	Q_OBJECT
+private:
+	//! Records its destruction in a shared log
+	struct Tracked
+	{
+		Tracked(std::vector<int>& log, int id) : log(log), id(id) {}
+		~Tracked() { log.push_back(id); }
+
+		std::vector<int>& log;
+		int id;
+	};
+
+	static bool inArena(const void* object, const void* arena, std::size_t size)
+	{
+		const auto address = reinterpret_cast<std::uintptr_t>(object);
+		const auto begin = reinterpret_cast<std::uintptr_t>(arena);
+		return address >= begin && address < begin + size;
+	}
+
+private slots:
+	void testDestroysInReverseOrder()
+	{
+		std::vector<int> log;
+		VoiceArena<256> arena;
+		const auto first = arena.create<Tracked>(log, 1);
+		const auto second = arena.create<Tracked>(log, 2);
+		QCOMPARE(first->id, 1);
+		QCOMPARE(second->id, 2);
+		QVERIFY(arena.used() > 2 * sizeof(Tracked));
+
+		arena.clear();
+		QCOMPARE(log, (std::vector<int>{2, 1}));
+		QCOMPARE(arena.used(), std::size_t{0});
+
+		// the destructor clears the arena as well
+		{
+			VoiceArena<256> other;
+			other.create<Tracked>(log, 3);
+		}
+		QCOMPARE(log, (std::vector<int>{2, 1, 3}));
+	}
+
+	void testReusesMemory()
+	{
+		std::vector<int> log;
+		auto arena = std::make_unique<VoiceArena<256>>();
+		const void* first = arena->create<Tracked>(log, 1);
+		arena->clear();
+		QCOMPARE(static_cast<const void*>(arena->create<Tracked>(log, 2)), first);
+		QVERIFY(inArena(first, arena.get(), sizeof(VoiceArena<256>)));
+	}
+
+	void testAlignsObjects()
+	{
+		VoiceArena<256> arena;
+		arena.create<char>('a');
+		const auto value = arena.create<double>(1.5);
+		QCOMPARE(reinterpret_cast<std::uintptr_t>(value) % alignof(double), std::uintptr_t{0});
+		QCOMPARE(*value, 1.5);
+	}
+
+	//! Objects which don't fit anymore are put on the heap, and are destroyed
+	//! together with the ones in the arena
+	void testFallsBackToHeap()
+	{
+		std::vector<int> log;
+		auto arena = std::make_unique<VoiceArena<128>>();
+		const auto first = arena->create<Tracked>(log, 1);
+		const auto large = arena->create<std::array<char, 200>>();
+		const auto last = arena->create<Tracked>(log, 2);
+		QVERIFY(inArena(first, arena.get(), sizeof(VoiceArena<128>)));
+		QVERIFY(!inArena(large, arena.get(), sizeof(VoiceArena<128>)));
+		QVERIFY(inArena(last, arena.get(), sizeof(VoiceArena<128>)));
+
+		arena->clear();
+		QCOMPARE(log, (std::vector<int>{2, 1}));
+	}
+};
+
+QTEST_GUILESS_MAIN(VoiceArenaTest)
+#include "VoiceArenaTest.moc"
@@ -0,0 +1,181 @@
+/*
+ * ExprFrontTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ExprSynth.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QtTest>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using lmms::ExprFront;
+
+class ExprFrontTest : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr lmms::sample_rate_t SampleRate = 44100;
+	static constexpr lmms::fpp_t Frames = 256;
+
+	//! The symbols ExprSynth and Xpressive::playNote provide, with the
+	//! variables changing every frame both as ExprTk variables and block inputs
+	struct Voice
+	{
+		explicit Voice(const char* expression) :
+			expr(expression, SampleRate)
+		{
+			for (std::size_t i = 0; i < wave.size(); ++i) { wave[i] = std::sin(i * 0.1f); }
+			expr.add_constant("key", 57);
+			expr.add_constant("srate", SampleRate);
+			expr.add_constant("v", 0.8f);
+			expr.add_variable("A1", a1);
+			expr.add_cyclic_vector("W1", wave.data(), wave.size());
+			expr.add_cyclic_vector("W2", wave.data(), wave.size(), true);
+			expr.add_variable("t", t);
+			expr.add_variable("f", f);
+			expr.add_variable("rel", rel);
+			expr.add_variable("trel", trel);
+			expr.compile();
+			expr.add_block_input("t", blockT.data());
+			expr.add_block_input("f", blockF.data());
+			expr.add_block_input("rel", blockRel.data());
+			expr.add_block_input("trel", blockTrel.data());
+			expr.compileBlock(Frames);
+		}
+
+		//! Sets the inputs for @p frame of @p period
+		void setFrame(int period, lmms::fpp_t frame)
+		{
+			const auto sample = period * Frames + frame;
+			t = blockT[frame] = sample / static_cast<float>(SampleRate);
+			f = blockF[frame] = 440.f + period * 0.37f;
+			rel = blockRel[frame] = period > 5 ? 1.f : 0.f;
+			trel = blockTrel[frame] = period > 5 ? t - 0.03f : 0.f;
+		}
+
+		ExprFront expr;
+		std::array<float, 64> wave;
+		float a1 = 0.25f, t = 0.f, f = 0.f, rel = 0.f, trel = 0.f;
+		std::array<float, Frames> blockT, blockF, blockRel, blockTrel;
+	};
+
+private slots:
+	void testMatchesExprTk_data()
+	{
+		QTest::addColumn<QString>("expression");
+		for (const char* expression : {
+			"sinew(t*f)",
+			"0.5*saww(t*f) + 0.5*squarew(t*f*2.01)*exp(-t*3)",
+			"trianglew(t*f + A1*W1(t*4))*(1-rel)",
+			"moogsaww(t*f)*min(t*50, 1)*max(1 - trel*2, 0)",
+			"W2(t*f)*v + moogw(t*semitone(12)*f)*0.2 + expw(f*t)*0.1 + expnw(t*f)*0.1",
+			"clamp(-0.5, sin(2*pi*f*t)*2, 0.5) + abs(cos(t))*(t < 0.01)",
+			"randv(t*srate)*0.1 + randsv(t*1000, seed)*0.1",
+			"sqrt(t)*floor(t*8)/8 + ceil(t) - t^2 + t^3*0.5 + 1/(t+1)^2 + pow(t, 1.5) + t % 0.1",
+			"cent(A1*100)*f/key - e"
+		})
+		{
+			QTest::newRow(expression) << QString{expression};
+		}
+	}
+
+	//! The block compiled expression has to be bit exact, as ExprSynth only
+	//! uses it if it matches ExprTk's output
+	void testMatchesExprTk()
+	{
+		QFETCH(QString, expression);
+		const auto text = expression.toStdString();
+		auto voice = std::make_unique<Voice>(text.c_str());
+		QVERIFY(voice->expr.isValid());
+		QVERIFY(voice->expr.isBlockCompiled());
+
+		std::vector<float> expected(Frames);
+		std::vector<float> actual(Frames);
+		for (int period = 0; period < 10; ++period)
+		{
+			for (lmms::fpp_t frame = 0; frame < Frames; ++frame)
+			{
+				voice->setFrame(period, frame);
+				expected[frame] = voice->expr.evaluate();
+			}
+			voice->expr.evaluateBlock(Frames, actual.data());
+			QVERIFY(std::memcmp(expected.data(), actual.data(), Frames * sizeof(float)) == 0);
+		}
+	}
+
+	void testStatefulExpressionsAreNotBlockCompiled()
+	{
+		for (const char* expression : {"sinew(integrate(f))", "last(1)*0.5 + rand*0.1", "t == 0", "-t^2"})
+		{
+			Voice voice{expression};
+			QVERIFY(voice.expr.isValid());
+			QVERIFY(!voice.expr.isBlockCompiled());
+		}
+	}
+
+	void benchmarkVoices_data()
+	{
+		QTest::addColumn<bool>("block");
+		QTest::newRow("ExprTk") << false;
+		QTest::newRow("block compiled") << true;
+	}
+
+	//! Renders one second of a typical patch and reports how many voices one
+	//! core could render in real time
+	void benchmarkVoices()
+	{
+		QFETCH(bool, block);
+		auto voice = std::make_unique<Voice>(
+			"(0.6*saww(t*f) + 0.4*squarew(t*f*1.005))*exp(-t*2)*(1-rel) + 0.2*sinew(t*f*semitone(-12))");
+		QVERIFY(voice->expr.isBlockCompiled());
+
+		std::vector<float> out(Frames);
+		constexpr int Periods = SampleRate / Frames;
+		qint64 iterations = 0;
+		QElapsedTimer timer;
+		timer.start();
+		QBENCHMARK
+		{
+			for (int period = 0; period < Periods; ++period)
+			{
+				for (lmms::fpp_t frame = 0; frame < Frames; ++frame)
+				{
+					voice->setFrame(period, frame);
+					if (!block) { out[frame] = voice->expr.evaluate(); }
+				}
+				if (block) { voice->expr.evaluateBlock(Frames, out.data()); }
+			}
+			++iterations;
+		}
+		const auto seconds = timer.nsecsElapsed() / 1e9;
+		const auto rendered = static_cast<double>(iterations) * Periods * Frames / SampleRate;
+		qDebug() << qPrintable(QString::number(rendered / seconds, 'f', 1)) << "voices per core";
+	}
+};
+
+QTEST_GUILESS_MAIN(ExprFrontTest)
+#include "ExprFrontTest.moc"
@@ -26,6 +26,7 @@
 
 
 #include "AutomationClip.h"
+#include "AutomationSchedule.h"
 #include "AutomationTrack.h"
 #include "DetuningHelper.h"
 #include "InstrumentTrack.h"
@@ -212,6 +213,56 @@ private slots:
 		QCOMPARE(song->automatedValuesAt(TimePos::ticksPerBar() + 5)[&model], 0.5f);
 	}
 
+	void testSchedule()
+	{
+		using namespace lmms;
+
+		FloatModel model(0, 0, 1, 0.01f);
+
+		auto song = Engine::getSong();
+		AutomationTrack track(song);
+
+		AutomationClip c1(&track);
+		c1.setProgressionType(AutomationClip::ProgressionType::Linear);
+		c1.putValue(0, 0.0, false);
+		c1.putValue(10, 1.0, false);
+		c1.movePosition(0);
+		c1.addObject(&model);
+
+		AutomationClip c2(&track);
+		c2.setProgressionType(AutomationClip::ProgressionType::Discrete);
+		c2.putValue(0, 0.5, false);
+		c2.movePosition(100);
+		c2.addObject(&model);
+
+		// the compiled schedule must agree with automatedValuesAt(), also
+		// after jumping backwards
+		AutomationSchedule schedule;
+		for (int time : {0, 5, 10, 50, 100, 150, 5, 120, 0})
+		{
+			schedule.process(time);
+			QCOMPARE(model.value<float>(), song->automatedValuesAt(time)[&model]);
+		}
+
+		// muting is picked up while playing
+		c2.toggleMute();
+		schedule.process(150);
+		QCOMPARE(model.value<float>(), 1.0f);
+		c2.toggleMute();
+		schedule.process(150);
+		QCOMPARE(model.value<float>(), 0.5f);
+
+		// moving a clip recompiles the schedule
+		c2.movePosition(200);
+		schedule.process(150);
+		QCOMPARE(model.value<float>(), 1.0f);
+
+		// values changed by the user are overwritten on the next tick
+		model.setValue(0.25f);
+		schedule.process(150);
+		QCOMPARE(model.value<float>(), 1.0f);
+	}
+
 	void testGlobalAutomation()
 	{
 		using namespace lmms;
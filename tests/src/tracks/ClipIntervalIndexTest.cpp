@@ -0,0 +1,181 @@
+/*
+ * ClipIntervalIndexTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "AutomationClip.h"
+#include "AutomationTrack.h"
+#include "Engine.h"
+#include "Song.h"
+
+class ClipIntervalIndexTest : public QObject
+{
+	Q_OBJECT
+private:
+	using ClipList = std::vector<std::unique_ptr<lmms::AutomationClip>>;
+
+	//! Creates @p count clips with random positions and lengths on @p track
+	static ClipList createClips(lmms::Track* track, int count, lmms::tick_t maxPosition)
+	{
+		using namespace lmms;
+
+		auto rng = std::mt19937{1234};
+		auto positions = std::uniform_int_distribution<tick_t>{0, maxPosition};
+		auto lengths = std::uniform_int_distribution<tick_t>{1, 4 * TimePos::ticksPerBar()};
+
+		ClipList clips;
+		for (int i = 0; i < count; ++i)
+		{
+			auto clip = std::make_unique<AutomationClip>(track);
+			clip->movePosition(positions(rng));
+			clip->changeLength(lengths(rng));
+			clips.push_back(std::move(clip));
+		}
+		return clips;
+	}
+
+	//! The linear scan getClipsInRange used to do
+	static lmms::Track::clipVector bruteForce(const lmms::Track& track, lmms::tick_t start, lmms::tick_t end)
+	{
+		using namespace lmms;
+
+		Track::clipVector result;
+		for (Clip* clip : track.getClips())
+		{
+			if (clip->startPosition() <= end && clip->endPosition() >= start)
+			{
+				result.insert(std::upper_bound(result.begin(), result.end(), clip, Clip::comparePosition), clip);
+			}
+		}
+		return result;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testMatchesLinearScan()
+	{
+		using namespace lmms;
+
+		AutomationTrack track(Engine::getSong());
+		auto clips = createClips(&track, 500, 1000 * TimePos::ticksPerBar());
+		// a single long clip spanning most of the song
+		clips.front()->changeLength(900 * TimePos::ticksPerBar());
+
+		for (tick_t start = 0; start < 1000 * TimePos::ticksPerBar(); start += 997)
+		{
+			Track::clipVector found;
+			track.getClipsInRange(found, start, start + 2 * TimePos::ticksPerBar());
+			QCOMPARE(found, bruteForce(track, start, start + 2 * TimePos::ticksPerBar()));
+		}
+	}
+
+	void testUpdatedOnMoveAndResize()
+	{
+		using namespace lmms;
+
+		AutomationTrack track(Engine::getSong());
+		auto clips = createClips(&track, 100, 100 * TimePos::ticksPerBar());
+
+		Track::clipVector found;
+		track.getClipsInRange(found, 0, 200 * TimePos::ticksPerBar());
+		QCOMPARE(found.size(), std::size_t{100});
+
+		clips[10]->movePosition(500 * TimePos::ticksPerBar());
+		clips[20]->changeLength(600 * TimePos::ticksPerBar());
+		clips.pop_back();
+
+		const tick_t start = 400 * TimePos::ticksPerBar();
+		found.clear();
+		track.getClipsInRange(found, start, start + TimePos::ticksPerBar());
+		QCOMPARE(found, bruteForce(track, start, start + TimePos::ticksPerBar()));
+		QCOMPARE(found.size(), std::size_t{1});
+
+		found.clear();
+		track.getClipsInRange(found, 500 * TimePos::ticksPerBar(), 500 * TimePos::ticksPerBar());
+		QCOMPARE(found.size(), std::size_t{2});
+	}
+
+	void testMergesWithPreviousResults()
+	{
+		using namespace lmms;
+
+		AutomationTrack track1(Engine::getSong());
+		AutomationTrack track2(Engine::getSong());
+		auto clips1 = createClips(&track1, 50, 50 * TimePos::ticksPerBar());
+		auto clips2 = createClips(&track2, 50, 50 * TimePos::ticksPerBar());
+
+		Track::clipVector found;
+		track1.getClipsInRange(found, 0, 20 * TimePos::ticksPerBar());
+		track2.getClipsInRange(found, 0, 20 * TimePos::ticksPerBar());
+		QVERIFY(std::is_sorted(found.begin(), found.end(), Clip::comparePosition));
+	}
+
+	void benchmarkRangeQuery_data()
+	{
+		QTest::addColumn<bool>("indexed");
+		QTest::newRow("linear scan") << false;
+		QTest::newRow("interval index") << true;
+	}
+
+	//! Range queries as done by InstrumentTrack::play on a track with 10k clips
+	void benchmarkRangeQuery()
+	{
+		using namespace lmms;
+		QFETCH(bool, indexed);
+
+		AutomationTrack track(Engine::getSong());
+		const auto clips = createClips(&track, 10000, 20000 * TimePos::ticksPerBar());
+
+		tick_t start = 0;
+		QBENCHMARK
+		{
+			const auto end = start + 1;
+			const auto found = indexed ? [&] {
+				Track::clipVector result;
+				track.getClipsInRange(result, start, end);
+				return result;
+			}() : bruteForce(track, start, end);
+			start = (start + 193) % (20000 * TimePos::ticksPerBar());
+			QVERIFY(found.size() < clips.size());
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(ClipIntervalIndexTest)
+#include "ClipIntervalIndexTest.moc"
@@ -0,0 +1,185 @@
+/*
+ * NoteStartIndexTest.cpp
+ *
+ * Copyright (c) 2026 LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Engine.h"
+#include "Note.h"
+#include "NoteStartIndex.h"
+
+class NoteStartIndexTest : public QObject
+{
+	Q_OBJECT
+private:
+	//! Creates @p count notes with random positions and lengths, sorted by position
+	static lmms::NoteVector createNotes(int count, lmms::tick_t maxPosition)
+	{
+		using namespace lmms;
+
+		auto rng = std::mt19937{1234};
+		auto positions = std::uniform_int_distribution<tick_t>{0, maxPosition};
+		auto lengths = std::uniform_int_distribution<tick_t>{1, TimePos::ticksPerBar()};
+
+		NoteVector notes;
+		for (int i = 0; i < count; ++i)
+		{
+			notes.push_back(new Note(lengths(rng), positions(rng)));
+		}
+		std::sort(notes.begin(), notes.end(), Note::lessThan);
+		return notes;
+	}
+
+	static void deleteNotes(lmms::NoteVector& notes)
+	{
+		for (auto note : notes) { delete note; }
+		notes.clear();
+	}
+
+	//! The linear scan InstrumentTrack::play used to do
+	static lmms::NoteVector linearScan(const lmms::NoteVector& notes, lmms::tick_t time)
+	{
+		using namespace lmms;
+
+		auto it = notes.begin();
+		while (it != notes.end() && (*it)->endPos() < time) { ++it; }
+
+		NoteVector result;
+		for (; it != notes.end(); ++it)
+		{
+			if ((*it)->pos() == time) { result.push_back(*it); }
+		}
+		return result;
+	}
+
+	static lmms::NoteVector toVector(lmms::NoteStartIndex::Range range)
+	{
+		return lmms::NoteVector(range.begin(), range.end());
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testMatchesLinearScan()
+	{
+		using namespace lmms;
+
+		auto notes = createNotes(2000, 100 * TimePos::ticksPerBar());
+		NoteStartIndex index;
+
+		// play forwards, then loop back into the middle of the clip
+		const auto check = [&](tick_t time) {
+			QCOMPARE(toVector(index.startingAt(notes, time)), linearScan(notes, time));
+		};
+		for (tick_t time = 0; time < 100 * TimePos::ticksPerBar(); ++time) { check(time); }
+		for (tick_t time = 50 * TimePos::ticksPerBar(); time < 60 * TimePos::ticksPerBar(); ++time) { check(time); }
+		// seek forwards
+		for (tick_t time = 0; time < 100 * TimePos::ticksPerBar(); time += 997) { check(time); }
+
+		const tick_t time = 30 * TimePos::ticksPerBar();
+		const auto before = toVector(index.startingBefore(notes, time));
+		QVERIFY(std::all_of(before.begin(), before.end(), [time](const Note* n) { return n->pos() < time; }));
+		QCOMPARE(before.size(), static_cast<std::size_t>(std::count_if(notes.begin(), notes.end(),
+			[time](const Note* n) { return n->pos() < time; })));
+
+		deleteNotes(notes);
+	}
+
+	void testInvalidate()
+	{
+		using namespace lmms;
+
+		auto notes = createNotes(100, 10 * TimePos::ticksPerBar());
+		NoteStartIndex index;
+		const tick_t newPos = 20 * TimePos::ticksPerBar();
+		QVERIFY(toVector(index.startingAt(notes, newPos)).empty());
+
+		// moved notes are only found after the index was invalidated
+		notes.front()->setPos(newPos);
+		std::sort(notes.begin(), notes.end(), Note::lessThan);
+		index.invalidate();
+		QCOMPARE(toVector(index.startingAt(notes, newPos)), NoteVector{notes.back()});
+
+		// adding notes is noticed without invalidating
+		notes.push_back(new Note(TimePos::ticksPerBar(), newPos + 1));
+		QCOMPARE(toVector(index.startingAt(notes, newPos + 1)), NoteVector{notes.back()});
+
+		deleteNotes(notes);
+	}
+
+	void benchmarkPlayback_data()
+	{
+		QTest::addColumn<bool>("indexed");
+		QTest::newRow("linear scan") << false;
+		QTest::newRow("note start index") << true;
+	}
+
+	//! Plays a clip with 5k notes tick by tick, as done by InstrumentTrack::play
+	void benchmarkPlayback()
+	{
+		using namespace lmms;
+		QFETCH(bool, indexed);
+
+		const tick_t length = 200 * TimePos::ticksPerBar();
+		auto notes = createNotes(5000, length);
+		NoteStartIndex index;
+
+		std::size_t played = 0;
+		QBENCHMARK
+		{
+			for (tick_t time = 0; time < length; ++time)
+			{
+				if (indexed)
+				{
+					const auto range = index.startingAt(notes, time);
+					played += range.end() - range.begin();
+				}
+				else
+				{
+					played += linearScan(notes, time).size();
+				}
+			}
+		}
+		QVERIFY(played > 0);
+		qDebug() << length << "ticks per iteration";
+
+		deleteNotes(notes);
+	}
+};
+
+QTEST_GUILESS_MAIN(NoteStartIndexTest)
+#include "NoteStartIndexTest.moc"